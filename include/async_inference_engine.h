@@ -0,0 +1,155 @@
+#ifndef STREAM_DAEMON_ASYNC_INFERENCE_ENGINE_H_
+#define STREAM_DAEMON_ASYNC_INFERENCE_ENGINE_H_
+
+#include "common.h"
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace stream_daemon {
+
+/**
+ * @brief Keeps several frames in flight on one model's input/output streams
+ *
+ * Submit() queues a frame and returns at once. A writer thread pushes
+ * inputs to the device while up to max_in_flight earlier frames are still
+ * on it; a reader thread reads every output of each frame, in write order,
+ * into buffers taken from a pool and completes the request. Callers
+ * letterbox and parse while the device works on other frames, instead of
+ * one frame per model holding a lock across write and blocking read.
+ *
+ * The device is reached only through DeviceIo, so the engine runs against
+ * a simulated device in tests.
+ */
+class AsyncInferenceEngine {
+public:
+    using OutputBuffers = std::vector<std::vector<uint8_t>>;
+
+    // One frame's outputs (one buffer per output stream); the buffers go
+    // back to the pool when the last reference is dropped
+    using Outputs = std::shared_ptr<const OutputBuffers>;
+
+    using Completion = std::function<void(Result<Outputs>)>;
+
+    struct DeviceIo {
+        // Write one input frame (may block while the device queue is full)
+        std::function<VoidResult(const uint8_t* data, size_t size)> write;
+        // Read output stream `index` of the oldest frame not yet read
+        std::function<VoidResult(size_t index, uint8_t* data, size_t size)> read;
+    };
+
+    /**
+     * @param io Device streams (used from the writer and reader threads only)
+     * @param input_size Bytes per input frame
+     * @param output_sizes Bytes per frame of each output stream
+     * @param max_in_flight Frames written but not yet read (min 1)
+     */
+    AsyncInferenceEngine(DeviceIo io,
+                         size_t input_size,
+                         std::vector<size_t> output_sizes,
+                         int max_in_flight = kInferenceMaxInFlight);
+
+    ~AsyncInferenceEngine();
+
+    // Non-copyable
+    AsyncInferenceEngine(const AsyncInferenceEngine&) = delete;
+    AsyncInferenceEngine& operator=(const AsyncInferenceEngine&) = delete;
+
+    /**
+     * @brief Queue one frame; completion runs on the reader thread
+     *        (writer thread for write errors, caller once stopped)
+     * @param input input_size bytes, valid until written (input_owner keeps it alive)
+     * @param input_owner Released right after the frame was written
+     * @param completion Outputs or error; keep it short, it delays the next read
+     */
+    void Submit(const uint8_t* input,
+                std::shared_ptr<const void> input_owner,
+                Completion completion);
+
+    /**
+     * @brief Queue one frame and get its outputs as a future
+     */
+    [[nodiscard]] std::future<Result<Outputs>> Submit(
+        const uint8_t* input,
+        std::shared_ptr<const void> input_owner = nullptr);
+
+    /**
+     * @brief Finish frames already on the device, fail queued ones, join threads
+     */
+    void Stop();
+
+    [[nodiscard]] int GetMaxInFlight() const noexcept { return max_in_flight_; }
+
+    /**
+     * @brief Frames written to the device and not yet read
+     */
+    [[nodiscard]] int GetInFlight() const;
+
+    /**
+     * @brief Frames waiting to be written
+     */
+    [[nodiscard]] size_t GetQueued() const;
+
+    /**
+     * @brief Total time with at least one frame on the device (utilisation
+     *        is its growth over wall time)
+     */
+    [[nodiscard]] std::chrono::steady_clock::duration GetBusyTime() const;
+
+private:
+    struct Request {
+        const uint8_t* input{nullptr};
+        std::shared_ptr<const void> input_owner;
+        Completion completion;
+    };
+
+    struct OutputPool {
+        std::mutex mutex;
+        std::vector<std::unique_ptr<OutputBuffers>> free;
+    };
+
+    void WriterLoop();
+    void ReaderLoop();
+
+    // Adjust in_flight_ and the busy time it implies; caller holds mutex_
+    void AddInFlight(int delta);
+
+    // Take pooled buffers (or allocate); Publish wraps them for the caller
+    std::unique_ptr<OutputBuffers> AcquireOutputs();
+    void RecycleOutputs(std::unique_ptr<OutputBuffers> buffers);
+    Outputs Publish(std::unique_ptr<OutputBuffers> buffers) const;
+
+    DeviceIo io_;
+    const size_t input_size_;
+    const std::vector<size_t> output_sizes_;
+    const int max_in_flight_;
+
+    // Shared with released Outputs, which may outlive the engine
+    std::shared_ptr<OutputPool> output_pool_;
+
+    mutable std::mutex mutex_;
+    std::condition_variable write_cv_;   // Queued frame and in-flight room, or stop
+    std::condition_variable read_cv_;    // Written frame, or writer stopped
+    std::deque<Request> queued_;         // Not yet written
+    std::deque<Request> written_;        // On the device, in write order
+    int in_flight_{0};                   // written_ plus the frame being read
+    std::chrono::steady_clock::time_point busy_since_;     // When in_flight_ left 0
+    std::chrono::steady_clock::duration busy_time_{0};     // Closed busy periods
+    bool running_{true};
+    bool writer_stopped_{false};
+
+    std::thread writer_thread_;
+    std::thread reader_thread_;
+};
+
+}  // namespace stream_daemon
+
+#endif  // STREAM_DAEMON_ASYNC_INFERENCE_ENGINE_H_
@@ -2,6 +2,7 @@
 #define STREAM_DAEMON_BATCH_INFERENCE_MANAGER_H_
 
 #include "common.h"
+#include "frame_buffer.h"
 #include "hailo_inference.h"
 #include <atomic>
 #include <chrono>
@@ -25,8 +26,11 @@ namespace stream_daemon {
  * for efficient inference when using batch-enabled HEF models.
  *
  * For batch=2 models:
- * - If 1 camera connected: runs with padding (less efficient but works)
+ * - If 1 camera connected: runs a partial batch (no padding frames)
  * - If 2 cameras connected: batches both frames for optimal throughput
+ *
+ * Each frame carries its stream's InferenceRequest (model context and
+ * confidence threshold), so streams with different settings can share a batch.
  */
 class BatchInferenceManager {
 public:
@@ -51,17 +55,22 @@ public:
     /**
      * @brief Submit a frame for batch inference
      * @param stream_id ID of the stream submitting the frame
-     * @param rgb_data RGB pixel data
-     * @param width Frame width
-     * @param height Frame height
+     * @param frame Refcounted RGB/YUV frame (kept alive until the batch is processed)
+     * @param source_width Decoded source width (0 if frame is the source itself)
+     * @param source_height Decoded source height (0 if frame is the source itself)
+     * @param request Stream's model context and confidence threshold
      * @param callback Function to call with results (may be called from worker thread)
+     * @param region Part of the frame to run on (empty = whole frame); detections
+     *        come back relative to the region
      */
     void SubmitFrame(
         const std::string& stream_id,
-        const uint8_t* rgb_data,
-        int width,
-        int height,
-        ResultCallback callback);
+        FrameRef frame,
+        int source_width,
+        int source_height,
+        InferenceRequest request,
+        ResultCallback callback,
+        const BoundingBox& region = BoundingBox{});
 
     /**
      * @brief Register a stream for batch processing
@@ -96,9 +105,11 @@ public:
 private:
     struct PendingFrame {
         std::string stream_id;
-        std::vector<uint8_t> rgb_data;  // Copy of frame data
-        int width;
-        int height;
+        FrameRef frame;  // Shared with the GStreamer sample, never copied
+        int source_width{0};   // Non-zero when frame was letterboxed by the pipeline
+        int source_height{0};
+        BoundingBox region;    // Crop before letterbox (empty = whole frame)
+        InferenceRequest request;  // Stream's context and threshold
         ResultCallback callback;
         std::chrono::steady_clock::time_point submit_time;
     };
@@ -108,7 +119,6 @@ private:
 
     std::shared_ptr<HailoInference> inference_;
     int batch_timeout_ms_;
-    float confidence_threshold_{0.25f};
 
     // Pending frames queue
     std::queue<PendingFrame> pending_frames_;
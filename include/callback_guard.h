@@ -0,0 +1,106 @@
+#ifndef STREAM_DAEMON_CALLBACK_GUARD_H_
+#define STREAM_DAEMON_CALLBACK_GUARD_H_
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <utility>
+
+namespace stream_daemon {
+
+/**
+ * @brief Hand-off of work to another thread (e.g. the GLib main loop) without raw `this`
+ *
+ * A queued callback holds a Ticket instead of the owner's pointer. The
+ * ticket runs the callback under the guard's mutex, and only while the
+ * owner is alive and has not called Invalidate() since the ticket was
+ * issued. Owner code that changes what callbacks use takes Lock(), so the
+ * two never interleave; Detach() (owner destructor) waits for a running
+ * callback and disables the rest.
+ *
+ * Callbacks run with the mutex held and must not call Lock() (not recursive).
+ *
+ * @tparam T Owner type
+ */
+template <typename T>
+class CallbackGuard {
+    struct State {
+        std::mutex mutex;
+        T* owner{nullptr};
+        std::atomic<uint64_t> epoch{0};
+    };
+
+public:
+    class Ticket {
+    public:
+        Ticket() = default;
+
+        /**
+         * @brief Call fn(owner) unless the owner is gone or the ticket was invalidated
+         * @return true if fn ran
+         */
+        template <typename Fn>
+        bool Run(Fn&& fn) const {
+            if (!state_) {
+                return false;
+            }
+            std::lock_guard<std::mutex> lock(state_->mutex);
+            if (!state_->owner || state_->epoch.load() != epoch_) {
+                return false;
+            }
+            std::forward<Fn>(fn)(*state_->owner);
+            return true;
+        }
+
+    private:
+        friend class CallbackGuard;
+
+        Ticket(std::shared_ptr<State> state, uint64_t epoch)
+            : state_(std::move(state)), epoch_(epoch) {}
+
+        std::shared_ptr<State> state_;
+        uint64_t epoch_{0};
+    };
+
+    explicit CallbackGuard(T* owner) : state_(std::make_shared<State>()) {
+        state_->owner = owner;
+    }
+    ~CallbackGuard() { Detach(); }
+
+    // Non-copyable (tickets point at this guard's state)
+    CallbackGuard(const CallbackGuard&) = delete;
+    CallbackGuard& operator=(const CallbackGuard&) = delete;
+
+    /**
+     * @brief Ticket for a callback queued now (never blocks)
+     */
+    [[nodiscard]] Ticket Issue() const { return Ticket(state_, state_->epoch.load()); }
+
+    /**
+     * @brief Exclude callbacks while the owner changes state they use
+     */
+    [[nodiscard]] std::unique_lock<std::mutex> Lock() {
+        return std::unique_lock<std::mutex>(state_->mutex);
+    }
+
+    /**
+     * @brief Drop every ticket issued so far (call under Lock() or from a callback)
+     */
+    void Invalidate() noexcept { state_->epoch.fetch_add(1); }
+
+    /**
+     * @brief Owner is going away: wait for a running callback, drop all tickets
+     */
+    void Detach() {
+        std::lock_guard<std::mutex> lock(state_->mutex);
+        state_->owner = nullptr;
+    }
+
+private:
+    std::shared_ptr<State> state_;
+};
+
+}  // namespace stream_daemon
+
+#endif  // STREAM_DAEMON_CALLBACK_GUARD_H_
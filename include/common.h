@@ -25,7 +25,46 @@ inline constexpr float kDefaultConfidenceThreshold = 0.5f;
 inline constexpr int kDefaultGrpcPort = 50051;
 inline constexpr std::string_view kDefaultNatsUrl = "nats://localhost:4222";
 inline constexpr int kMaxStreams = 4;
-inline constexpr int kReconnectDelaySeconds = 3;
+inline constexpr int kReconnectDelaySeconds = 3;          // Base delay (doubles per attempt)
+inline constexpr int kMaxReconnectDelaySeconds = 60;
+inline constexpr double kReconnectJitter = 0.2;           // +/- 20%
+inline constexpr int kMaxConcurrentPipelineBuilds = 2;
+inline constexpr int kPipelineBuildTimeoutMs = 10000;
+inline constexpr int kDefaultPreviewWidth = 640;
+inline constexpr int kDefaultTeardownWorkers = 2;
+inline constexpr int kDefaultTeardownTimeoutMs = 3000;
+inline constexpr size_t kDefaultTeardownMaxPending = 32;  // Queued teardowns before Submit() refuses
+inline constexpr size_t kDefaultTeardownMaxWedged = 2;    // Stuck teardown workers replaced at once
+inline constexpr size_t kLatencyWindowSize = 512;         // Samples per latency percentile window
+inline constexpr int kSnapshotIdleTimeoutMs = 10000;      // Close main-stream decode when unused
+inline constexpr int kSnapshotRetryDelayMs = 5000;
+inline constexpr int kSnapshotMaxAgeMs = 1000;            // Older main-stream frames fall back to inference
+inline constexpr int kSnapshotRefreshMs = 1000;           // Snapshot re-encode interval without image publishing
+inline constexpr std::string_view kClearUrl = "none";     // Update: clears inference/snapshot URL ("" keeps it)
+inline constexpr size_t kPreviewRingSize = 4;             // Preview frames kept for PTS pairing
+inline constexpr uint8_t kLetterboxPadValue = 114;        // YOLO gray
+inline constexpr size_t kLetterboxPlanCacheSize = 8;      // Distinct source geometries per model
+inline constexpr int64_t kParallelPreprocessMinPixels = 2560 * 1440;  // Smaller sources resize on one thread
+inline constexpr int kMinPreprocessBandRows = 32;         // Output rows per band at least
+inline constexpr float kDefaultTileOverlap = 0.2f;        // Fraction of a tile shared with its neighbour
+inline constexpr float kTileMergeOverlap = 0.5f;          // Cross-tile NMS (intersection over smaller box)
+inline constexpr float kDefaultIouThreshold = 0.45f;      // Host NMS for raw YOLO outputs
+inline constexpr float kDefaultRoiCropMargin = 0.05f;     // Fraction of the frame added around event regions
+inline constexpr int kDefaultMotionMaxSkipMs = 2000;      // Motion gate re-runs inference at least this often
+inline constexpr int kInferenceMaxInFlight = 4;           // Frames written to the device and not yet read
+inline constexpr int kInferenceErrorBackoffMs = 100;      // Pause after a failed device write/read
+inline constexpr int kInferenceBatchFlushMs = 5;          // Device runs a partial batch after this long
+inline constexpr int kDefaultSimulatedLatencyMs = 15;     // Simulated device: write-to-output latency
+inline constexpr double kDefaultSimulatedFps = 120.0;     // Simulated device: frames completed per second
+inline constexpr int kDefaultSimulatedQueueDepth = 4;     // Simulated device: frames queued before Write() blocks
+inline constexpr int kDefaultRecordingFrames = 32;        // Output frames captured per inference recording
+inline constexpr int kDefaultSchedulerMaxInFlight = 8;    // Frames admitted to the NPU at once (all models)
+inline constexpr int kDefaultInferenceDeadlineMs = 1000;  // Frames waiting longer for the NPU are dropped
+inline constexpr int kSchedulerRateWindowMs = 2000;       // Window for per-stream achieved inference rate
+inline constexpr double kSchedulerMinRateBurst = 2.0;     // Owed frames a min-rate stream can bank
+inline constexpr int kDevicePoolSampleMs = 500;           // Min interval between device utilisation samples
+inline constexpr double kDevicePoolSmoothing = 0.5;       // EWMA weight of the newest utilisation sample
+inline constexpr double kDevicePoolRebalanceMargin = 0.1; // Load gap a stream move must beat (streams' cost units)
 
 // ============================================================================
 // Enums
@@ -59,6 +98,29 @@ enum class StreamState {
     return StreamState::kStopped;
 }
 
+// Inference scheduler class: higher classes are always admitted first
+// (a stream's min rate is guaranteed in any class)
+enum class InferencePriority {
+    kCritical,
+    kNormal,
+    kBackground
+};
+
+[[nodiscard]] constexpr std::string_view InferencePriorityToString(InferencePriority priority) noexcept {
+    switch (priority) {
+        case InferencePriority::kCritical:   return "critical";
+        case InferencePriority::kNormal:     return "normal";
+        case InferencePriority::kBackground: return "background";
+    }
+    return "unknown";
+}
+
+[[nodiscard]] constexpr InferencePriority StringToInferencePriority(std::string_view str) noexcept {
+    if (str == "critical")   return InferencePriority::kCritical;
+    if (str == "background") return InferencePriority::kBackground;
+    return InferencePriority::kNormal;
+}
+
 // ============================================================================
 // Data Structures
 // ============================================================================
@@ -90,13 +152,90 @@ struct StreamConfig {
     int height{kDefaultHeight};
     int fps{kDefaultFps};
     float confidence_threshold{kDefaultConfidenceThreshold};
+
+    // Dual-branch pipeline: scale to model input for inference,
+    // separate downscaled branch for JPEG/snapshots only
+    bool dual_branch{false};
+    int preview_width{kDefaultPreviewWidth};
+
+    // Inference decimation (camera FPS / frame counting unaffected)
+    double inference_fps{0.0};         // 0 = every frame
+    int inference_every_n{1};          // 1 = every frame
+
+    // Reconnect by replacing only rtspsrc (decoder/appsink stay PLAYING)
+    bool soft_restart{true};
+
+    // Upstream QoS so the decoder skips frames inference will not use.
+    // Opt-in: it changes the decoded frame rate, so existing configs keep
+    // decoding every frame unless they ask for it
+    bool decode_skip{false};
+
+    // Reuse another stream's decode pipeline when it opens the same URL
+    bool share_source{true};
+
+    // Appsink takes the decoder's NV12/I420; inference converts while letterboxing
+    bool native_yuv{true};
+
+    // Tiled inference for small objects: the full frame plus overlapping tiles
+    // are batched per frame and merged with cross-tile NMS
+    bool tiled{false};
+    int tile_size{0};                  // Tile width in source pixels (0 = model input width)
+    float tile_overlap{kDefaultTileOverlap};
+
+    // Crop inference to the bounding rectangle of all event polygons/lines
+    // (plus margin); detections are mapped back to full-frame coordinates
+    bool roi_crop{false};
+    float roi_crop_margin{kDefaultRoiCropMargin};
+
+    // Skip inference while a downscaled luma difference shows no motion;
+    // skipped frames republish the previous detections (or nothing)
+    bool motion_gate{false};
+    int motion_max_skip_ms{kDefaultMotionMaxSkipMs};
+    bool motion_republish{true};
+
+    // Share of the NPU when streams contend (see InferenceScheduler)
+    InferencePriority inference_priority{InferencePriority::kNormal};
+    double inference_weight{1.0};      // Share within the priority class
+    double inference_min_fps{0.0};     // Guaranteed inference rate (0 = none)
+    int inference_deadline_ms{kDefaultInferenceDeadlineMs};  // Drop after waiting this long (0 = never)
 };
 
+// Keep in sync with StreamConfig fields (used to detect URL-only updates)
+inline bool operator==(const StreamConfig& a, const StreamConfig& b) {
+    return a.width == b.width && a.height == b.height && a.fps == b.fps &&
+           a.confidence_threshold == b.confidence_threshold &&
+           a.dual_branch == b.dual_branch && a.preview_width == b.preview_width &&
+           a.inference_fps == b.inference_fps &&
+           a.inference_every_n == b.inference_every_n &&
+           a.soft_restart == b.soft_restart &&
+           a.decode_skip == b.decode_skip &&
+           a.share_source == b.share_source &&
+           a.native_yuv == b.native_yuv &&
+           a.tiled == b.tiled && a.tile_size == b.tile_size &&
+           a.tile_overlap == b.tile_overlap &&
+           a.roi_crop == b.roi_crop && a.roi_crop_margin == b.roi_crop_margin &&
+           a.motion_gate == b.motion_gate &&
+           a.motion_max_skip_ms == b.motion_max_skip_ms &&
+           a.motion_republish == b.motion_republish &&
+           a.inference_priority == b.inference_priority &&
+           a.inference_weight == b.inference_weight &&
+           a.inference_min_fps == b.inference_min_fps &&
+           a.inference_deadline_ms == b.inference_deadline_ms;
+}
+
+inline bool operator!=(const StreamConfig& a, const StreamConfig& b) {
+    return !(a == b);
+}
+
 struct StreamInfo {
     std::string stream_id;
     std::string rtsp_url;
     std::string hef_path;
     std::string model_id;              // App ID (for tracking)
+    std::string inference_url;         // Low-res substream decoded for inference (empty = rtsp_url)
+    std::string snapshot_url;          // Main stream for snapshots/event images
+                                       // (empty = rtsp_url when inference_url is set)
+                                       // On update both: empty = unchanged, kClearUrl = clear
     StreamConfig config;
 
     // Model configuration for inference
@@ -105,12 +244,56 @@ struct StreamInfo {
     std::vector<std::string> labels;   // Class labels
 };
 
+/**
+ * @brief Optional URL after an update: empty keeps current, kClearUrl clears it
+ */
+[[nodiscard]] inline std::string ResolveUrlUpdate(const std::string& current,
+                                                  const std::string& requested) {
+    if (requested == kClearUrl) {
+        return std::string();
+    }
+    return requested.empty() ? current : requested;
+}
+
+struct LatencySummary {
+    uint64_t count{0};
+    int64_t last_ms{0};
+    double mean_ms{0.0};
+    int64_t p50_ms{0};
+    int64_t p95_ms{0};
+    int64_t p99_ms{0};
+    int64_t max_ms{0};
+};
+
+// Per-stage processing time (microseconds, recent window)
+struct StageTiming {
+    uint64_t count{0};
+    int64_t last_us{0};
+    double mean_us{0.0};
+    int64_t p95_us{0};
+    int64_t max_us{0};
+};
+
 struct StreamStatus {
     std::string stream_id;
     std::string rtsp_url;
     std::string model_id;
     StreamState state{StreamState::kStopped};
     uint64_t frame_count{0};
+    uint64_t dropped_frames{0};        // Replaced in the mailbox before processing
+    uint64_t motion_skipped{0};        // Frames the motion gate kept off the NPU
+    uint64_t soft_restarts{0};         // Reconnects that only replaced rtspsrc
+    int64_t reconnect_ttff_ms{-1};     // Last failure -> first frame time (-1 = none yet)
+    double decode_skip_fps{0.0};       // Decoder output rate requested via QoS (0 = off)
+    std::string shared_source_id;      // Stream whose pipeline feeds this one ("" = own)
+    LatencySummary queue_latency;      // Capture -> frame worker (network, decode, queues)
+    LatencySummary publish_latency;    // Capture -> publish (adds inference and batching)
+    StageTiming preprocess_timing;     // Letterbox/convert per frame (model-wide)
+    StageTiming inference_timing;      // Device queue, write/read and parse per call (model-wide)
+    double inference_rate_fps{0.0};    // Frames the scheduler admitted per second (recent window)
+    double scheduler_wait_ms{0.0};     // Mean wait for an NPU slot
+    uint64_t scheduler_dropped{0};     // Frames dropped past their deadline waiting for the NPU
+    std::string device_id;             // Accelerator running its model ("" = default device)
     double current_fps{0.0};
     uint64_t uptime_seconds{0};
     std::string last_error;
@@ -123,16 +306,21 @@ struct EventStatus {
     std::vector<std::string> labels;   // 해당 이벤트에 걸린 라벨들
 };
 
+// Immutable JPEG blob shared between snapshot storage and published events
+using JpegBlob = std::shared_ptr<const std::vector<uint8_t>>;
+
 struct DetectionEvent {
     std::string stream_id;
     int64_t timestamp{0};              // Unix timestamp in milliseconds
+    int64_t capture_timestamp{0};      // Frame capture time, Unix ms (RTCP NTP when available)
+    int64_t publish_timestamp{0};      // Handed to NATS / callbacks, Unix ms
     uint64_t frame_number{0};
     double fps{0.0};
     int width{0};                      // Frame width
     int height{0};                     // Frame height
     std::vector<Detection> detections; // 객체 정보
     std::unordered_map<std::string, EventStatus> events;  // event_id -> status
-    std::vector<uint8_t> image_data;   // JPEG encoded frame (optional)
+    JpegBlob image_data;               // JPEG encoded frame (optional, shared)
 };
 
 // ============================================================================
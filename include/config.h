@@ -46,10 +46,26 @@ struct DefaultStreamConfig {
  * @brief Hailo configuration
  */
 struct HailoConfig {
-    std::string device_id;                  // 빈 문자열이면 자동 선택
-    int batch_size{1};
+    std::string device_id;                  // 빈 문자열이면 자동 선택, "a,b" = 장치 풀, "a+b" = 한 VDevice로 묶음
+    int batch_size{1};                      // >1: HEF 배치 대신 사용 (1 = HEF 값)
+    bool quantized_outputs{false};          // raw YOLO 출력을 UINT8/UINT16 그대로 읽음 (NMS 출력은 FLOAT32)
     std::string post_process_so{"/usr/lib/hailo-post-processes/libyolo_hailortpp_post.so"};
     std::string function_name{"yolov8"};
+
+    // Inference backend: "hailort" (device) or "simulated" (replays recordings)
+    std::string backend{"hailort"};
+    // hailort: save <model stem>.rec here (empty = off); simulated: load it from here
+    std::string recording_dir;
+    int simulated_latency_ms{kDefaultSimulatedLatencyMs};
+    double simulated_fps{kDefaultSimulatedFps};
+
+    // Frames all streams may have on the NPU at once, admitted by weight and
+    // priority (0 = no scheduler); keep >= the largest model batch size
+    int max_in_flight{kDefaultSchedulerMaxInFlight};
+
+    // Devices one model may be configured on when device_id lists several
+    // (0 = all); streams are placed on the least-loaded of them
+    int max_model_replicas{0};
 };
 
 /**
@@ -0,0 +1,70 @@
+#ifndef STREAM_DAEMON_CPU_WORKER_POOL_H_
+#define STREAM_DAEMON_CPU_WORKER_POOL_H_
+
+#include "common.h"
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace stream_daemon {
+
+/**
+ * @brief Fixed-size pool for splitting CPU-bound frame work (e.g. row bands)
+ *
+ * ParallelFor() runs fn(0..count-1) on the workers and the calling thread,
+ * and returns when every index has finished. The caller claims indices too,
+ * so concurrent calls from several streams cannot starve each other: a call
+ * whose helpers are still queued behind another stream's work simply runs
+ * more of its own indices.
+ */
+class CpuWorkerPool {
+public:
+    /**
+     * @param num_workers Worker threads in addition to the caller (0 = run inline)
+     */
+    explicit CpuWorkerPool(int num_workers);
+
+    ~CpuWorkerPool();
+
+    // Non-copyable
+    CpuWorkerPool(const CpuWorkerPool&) = delete;
+    CpuWorkerPool& operator=(const CpuWorkerPool&) = delete;
+
+    /**
+     * @brief Process-wide pool with one worker per core besides the caller
+     */
+    static CpuWorkerPool& Shared();
+
+    /**
+     * @brief Run fn(index) for every index in [0, count), blocking until all finish
+     */
+    void ParallelFor(int count, const std::function<void(int)>& fn);
+
+    /**
+     * @brief Threads a ParallelFor call can use (workers + caller)
+     */
+    [[nodiscard]] int GetConcurrency() const noexcept {
+        return static_cast<int>(workers_.size()) + 1;
+    }
+
+private:
+    struct Batch;
+
+    void WorkerLoop();
+    static void RunIndices(Batch& batch);
+
+    std::deque<std::function<void()>> queue_;
+    std::mutex queue_mutex_;
+    std::condition_variable queue_cv_;
+    bool running_{true};  // Guarded by queue_mutex_
+
+    std::vector<std::thread> workers_;
+};
+
+}  // namespace stream_daemon
+
+#endif  // STREAM_DAEMON_CPU_WORKER_POOL_H_
@@ -0,0 +1,87 @@
+#ifndef STREAM_DAEMON_DECODE_SKIP_CONTROLLER_H_
+#define STREAM_DAEMON_DECODE_SKIP_CONTROLLER_H_
+
+#include <algorithm>
+
+namespace stream_daemon {
+
+/**
+ * @brief Decides when to ask the decoder to skip frames (upstream QoS)
+ *
+ * Fed once per FPS window with the source frame rate (encoded frames, so it
+ * does not change while throttling) and the rate the processor can actually
+ * use (inference_fps / every_n / measured processing throughput). Throttling
+ * engages when demand stays below engage_ratio of the source rate for
+ * `windows` consecutive windows, and releases above release_ratio, so the
+ * decoder is not toggled on every fluctuation.
+ */
+class DecodeSkipController {
+public:
+    struct Params {
+        double engage_ratio{0.6};
+        double release_ratio{0.85};
+        int windows{3};
+    };
+
+    DecodeSkipController() = default;
+    explicit DecodeSkipController(Params params) : params_(params) {}
+
+    /**
+     * @brief Feed one observation window
+     * @param source_fps Encoded frame rate entering the decoder
+     * @param demand_fps Frame rate the processor can use
+     * @return true if the throttling state changed
+     */
+    bool Update(double source_fps, double demand_fps) noexcept {
+        if (source_fps <= 0.0) {
+            return false;
+        }
+
+        const double ratio = demand_fps / source_fps;
+        const bool want_throttle = throttling_ ? ratio < params_.release_ratio
+                                               : ratio < params_.engage_ratio;
+
+        if (want_throttle) {
+            target_fps_ = std::min(demand_fps, source_fps);
+        }
+
+        if (want_throttle == throttling_) {
+            streak_ = 0;
+            return false;
+        }
+
+        if (++streak_ < params_.windows) {
+            return false;
+        }
+
+        streak_ = 0;
+        throttling_ = want_throttle;
+        if (!throttling_) {
+            target_fps_ = 0.0;
+        }
+        return true;
+    }
+
+    void Reset() noexcept {
+        throttling_ = false;
+        streak_ = 0;
+        target_fps_ = 0.0;
+    }
+
+    [[nodiscard]] bool IsThrottling() const noexcept { return throttling_; }
+
+    /**
+     * @brief Output rate to request from the decoder (0 when not throttling)
+     */
+    [[nodiscard]] double TargetFps() const noexcept { return throttling_ ? target_fps_ : 0.0; }
+
+private:
+    Params params_;
+    bool throttling_{false};
+    int streak_{0};
+    double target_fps_{0.0};
+};
+
+}  // namespace stream_daemon
+
+#endif  // STREAM_DAEMON_DECODE_SKIP_CONTROLLER_H_
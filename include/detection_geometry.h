@@ -0,0 +1,192 @@
+#ifndef STREAM_DAEMON_DETECTION_GEOMETRY_H_
+#define STREAM_DAEMON_DETECTION_GEOMETRY_H_
+
+#include "common.h"
+
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+#include <vector>
+
+namespace stream_daemon {
+
+/**
+ * @brief Map pixel bounding boxes from one frame geometry to another
+ *
+ * For two encodings of the same camera view (e.g. substream used for
+ * inference vs. main stream used for the event image), axes are scaled
+ * independently. Keypoints are normalized and need no mapping.
+ */
+inline void ScaleDetections(std::vector<Detection>& detections,
+                            int src_width, int src_height,
+                            int dst_width, int dst_height) {
+    if (src_width <= 0 || src_height <= 0 || dst_width <= 0 || dst_height <= 0 ||
+        (src_width == dst_width && src_height == dst_height)) {
+        return;
+    }
+
+    const double sx = static_cast<double>(dst_width) / src_width;
+    const double sy = static_cast<double>(dst_height) / src_height;
+
+    for (auto& det : detections) {
+        // Scale edges, not origin + size, so adjacent boxes stay adjacent
+        const int x0 = static_cast<int>(std::lround(det.bbox.x * sx));
+        const int y0 = static_cast<int>(std::lround(det.bbox.y * sy));
+        const int x1 = static_cast<int>(std::lround((det.bbox.x + det.bbox.width) * sx));
+        const int y1 = static_cast<int>(std::lround((det.bbox.y + det.bbox.height) * sy));
+        det.bbox.x = x0;
+        det.bbox.y = y0;
+        det.bbox.width = x1 - x0;
+        det.bbox.height = y1 - y0;
+    }
+}
+
+/**
+ * @brief Pixel rectangle of a normalized region grown by a margin
+ *
+ * The margin is a fraction of the frame size added on every side, so
+ * objects whose reference point is inside the region but whose box extends
+ * past it are still seen whole. Clipped to the frame; the origin is even so
+ * NV12/I420 crops need no adjustment.
+ */
+inline BoundingBox NormalizedRegionToPixels(float min_x, float min_y, float max_x, float max_y,
+                                            float margin, int frame_width, int frame_height) {
+    const auto to_pixels = [margin](float lo, float hi, int size, int& origin, int& extent) {
+        const float start = std::clamp(std::min(lo, hi) - margin, 0.0f, 1.0f);
+        const float end = std::clamp(std::max(lo, hi) + margin, 0.0f, 1.0f);
+        origin = static_cast<int>(std::floor(start * size)) & ~1;
+        extent = std::min(size, static_cast<int>(std::ceil(end * size))) - origin;
+    };
+
+    BoundingBox region;
+    to_pixels(min_x, max_x, frame_width, region.x, region.width);
+    to_pixels(min_y, max_y, frame_height, region.y, region.height);
+    return region;
+}
+
+/**
+ * @brief Overlapping tiles of tile_w x tile_h covering a frame
+ *
+ * Tiles are spread evenly along each axis so that neighbours overlap by at
+ * least the overlap fraction; the last tile ends at the frame edge. Axes not
+ * larger than the tile get a single tile of the frame size. Origins are even
+ * so NV12/I420 crops need no adjustment.
+ */
+inline std::vector<BoundingBox> ComputeTiles(int frame_width, int frame_height,
+                                             int tile_width, int tile_height,
+                                             float overlap) {
+    std::vector<BoundingBox> tiles;
+    if (frame_width <= 0 || frame_height <= 0 || tile_width <= 0 || tile_height <= 0) {
+        return tiles;
+    }
+    overlap = std::clamp(overlap, 0.0f, 0.9f);
+
+    const auto origins = [overlap](int frame_size, int tile_size) {
+        if (frame_size <= tile_size) {
+            return std::vector<int>{0};
+        }
+        const double stride = tile_size * (1.0 - overlap);
+        const int count = static_cast<int>(std::ceil((frame_size - tile_size) / stride)) + 1;
+        std::vector<int> result(count);
+        for (int i = 0; i < count; ++i) {
+            const double origin = static_cast<double>(frame_size - tile_size) * i / (count - 1);
+            result[i] = static_cast<int>(std::lround(origin)) & ~1;
+        }
+        return result;
+    };
+
+    const std::vector<int> xs = origins(frame_width, tile_width);
+    const std::vector<int> ys = origins(frame_height, tile_height);
+    tiles.reserve(xs.size() * ys.size());
+    for (int y : ys) {
+        for (int x : xs) {
+            tiles.push_back({x, y,
+                             std::min(tile_width, frame_width - x),
+                             std::min(tile_height, frame_height - y)});
+        }
+    }
+    return tiles;
+}
+
+/**
+ * @brief Move detections of a cropped region back into frame coordinates
+ *
+ * Boxes are offset by the region origin; keypoints (normalized to the
+ * region) are renormalized to the frame.
+ */
+inline void OffsetDetections(std::vector<Detection>& detections, const BoundingBox& region,
+                             int frame_width, int frame_height) {
+    if (frame_width <= 0 || frame_height <= 0) {
+        return;
+    }
+
+    for (auto& det : detections) {
+        det.bbox.x += region.x;
+        det.bbox.y += region.y;
+        for (auto& kp : det.keypoints) {
+            kp.x = (region.x + kp.x * region.width) / frame_width;
+            kp.y = (region.y + kp.y * region.height) / frame_height;
+        }
+    }
+}
+
+/**
+ * @brief Per-class greedy NMS for detections merged from several crops
+ *
+ * Overlap is intersection over the smaller box rather than IoU: an object
+ * cut at a tile edge yields a partial box that lies mostly inside the full
+ * box from the neighbouring tile, which IoU would rate as a poor match.
+ */
+inline void SuppressOverlappingDetections(std::vector<Detection>& detections,
+                                          float overlap_threshold) {
+    if (detections.size() < 2) {
+        return;
+    }
+
+    std::vector<size_t> order(detections.size());
+    std::iota(order.begin(), order.end(), 0);
+    std::stable_sort(order.begin(), order.end(), [&detections](size_t a, size_t b) {
+        return detections[a].confidence > detections[b].confidence;
+    });
+
+    const auto area = [](const BoundingBox& box) {
+        return static_cast<int64_t>(std::max(0, box.width)) * std::max(0, box.height);
+    };
+
+    std::vector<bool> suppressed(detections.size(), false);
+    std::vector<Detection> kept;
+    for (size_t i = 0; i < order.size(); ++i) {
+        if (suppressed[order[i]]) {
+            continue;
+        }
+        const Detection& best = detections[order[i]];
+        const int64_t best_area = area(best.bbox);
+
+        for (size_t j = i + 1; j < order.size(); ++j) {
+            const Detection& other = detections[order[j]];
+            if (suppressed[order[j]] || other.class_id != best.class_id) {
+                continue;
+            }
+
+            const int x0 = std::max(best.bbox.x, other.bbox.x);
+            const int y0 = std::max(best.bbox.y, other.bbox.y);
+            const int x1 = std::min(best.bbox.x + best.bbox.width, other.bbox.x + other.bbox.width);
+            const int y1 = std::min(best.bbox.y + best.bbox.height, other.bbox.y + other.bbox.height);
+            if (x1 <= x0 || y1 <= y0) {
+                continue;
+            }
+
+            const int64_t intersection = static_cast<int64_t>(x1 - x0) * (y1 - y0);
+            const int64_t smaller = std::min(best_area, area(other.bbox));
+            if (smaller > 0 && static_cast<double>(intersection) / smaller > overlap_threshold) {
+                suppressed[order[j]] = true;
+            }
+        }
+        kept.push_back(std::move(detections[order[i]]));
+    }
+    detections = std::move(kept);
+}
+
+}  // namespace stream_daemon
+
+#endif  // STREAM_DAEMON_DETECTION_GEOMETRY_H_
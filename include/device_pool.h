@@ -0,0 +1,155 @@
+#ifndef STREAM_DAEMON_DEVICE_POOL_H_
+#define STREAM_DAEMON_DEVICE_POOL_H_
+
+#include "common.h"
+#include "hailo_inference.h"
+
+#include <chrono>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace stream_daemon {
+
+/**
+ * @brief Places streams' models on several accelerators by measured load
+ *
+ * Each device id (see HailoRtBackend: one PCIe device, a '+' group or empty
+ * for the default) gets its own VDevice. A model is configured on a device
+ * the first time a stream of it is placed there, so a busy model ends up
+ * with a replica per device (at most max_replicas) while every stream runs
+ * on exactly one of them.
+ *
+ * Load is the device time a stream costs: each replica's busy fraction
+ * (AsyncInferenceEngine busy time over wall time, smoothed) split evenly over
+ * its streams. Streams of a replica not yet measured count as the pool-wide
+ * average cost (one unit while nothing has been measured). New streams go
+ * to the least-loaded device; Rebalance moves streams off the busiest device
+ * while that narrows the gap by more than kDevicePoolRebalanceMargin.
+ *
+ * Thread-safe.
+ */
+class DevicePool {
+public:
+    using Clock = std::chrono::steady_clock;
+    using NowFn = std::function<Clock::time_point()>;
+
+    struct StreamPlacement {
+        std::string device_id;
+        std::shared_ptr<HailoInference> inference;
+    };
+
+    struct StreamMove {
+        std::string stream_id;
+        std::string from_device;
+        std::string to_device;
+        std::shared_ptr<HailoInference> inference;  // Replica on to_device
+    };
+
+    struct DeviceStats {
+        std::string device_id;
+        double utilisation{0.0};   // Busy fraction, summed over its models
+        double load{0.0};          // Placement cost (see class comment)
+        size_t streams{0};
+        size_t models{0};
+    };
+
+    /**
+     * @brief Split a HailoConfig::device_id list ("a,b+c") into device ids
+     *
+     * Blanks around ids are dropped; an empty list is the default device ({""}).
+     */
+    [[nodiscard]] static std::vector<std::string> ParseDeviceIds(const std::string& list);
+
+    /**
+     * @param device_ids Devices to place on (empty = the default device only)
+     * @param max_replicas Devices one model may be configured on (0 = all)
+     * @param now Wall time the busy time is divided by (tests step it by hand;
+     *        busy time itself is always measured by the engines)
+     */
+    explicit DevicePool(std::vector<std::string> device_ids, int max_replicas = 0,
+                        NowFn now = Clock::now);
+
+    // Non-copyable
+    DevicePool(const DevicePool&) = delete;
+    DevicePool& operator=(const DevicePool&) = delete;
+
+    /**
+     * @brief Place a stream's model (idempotent while the model is unchanged)
+     *
+     * A stream that switches model is released from the old one first.
+     *
+     * @return Device and model instance the stream should run on
+     */
+    [[nodiscard]] Result<StreamPlacement> AssignStream(const std::string& stream_id,
+                                                       const std::string& hef_path);
+
+    /**
+     * @brief Forget a stream; an idle replica is released when another remains
+     */
+    void ReleaseStream(const std::string& stream_id);
+
+    /**
+     * @brief Move streams from busy to idle devices
+     *
+     * Placements are updated before returning; callers hand each move's
+     * instance to the stream (streams keep the old one until they switch).
+     */
+    [[nodiscard]] std::vector<StreamMove> Rebalance();
+
+    /**
+     * @brief Take a utilisation sample now (normally at most every kDevicePoolSampleMs)
+     */
+    void SampleUtilisation();
+
+    [[nodiscard]] std::optional<StreamPlacement> GetPlacement(const std::string& stream_id) const;
+    [[nodiscard]] std::vector<DeviceStats> GetStats() const;
+
+    [[nodiscard]] const std::vector<std::string>& GetDeviceIds() const noexcept { return device_ids_; }
+
+private:
+    // One model configured on one device
+    struct Replica {
+        std::shared_ptr<HailoInference> inference;
+        size_t streams{0};
+        double utilisation{0.0};
+        bool measured{false};                // A full sample interval has passed
+        Clock::duration last_busy{0};
+        Clock::time_point last_sample;
+    };
+
+    struct Assignment {
+        std::string hef_path;
+        std::string device_id;
+    };
+
+    using ReplicaKey = std::pair<std::string, std::string>;  // hef path, device id
+
+    // Caller holds mutex_ for all of these
+    void SampleLocked(Clock::time_point now, bool force);
+    double AverageCostLocked() const;
+    double StreamCostLocked(const Replica& replica, double average) const;
+    std::map<std::string, double> DeviceLoadsLocked() const;
+    size_t ReplicaCountLocked(const std::string& hef_path) const;
+    bool CanPlaceLocked(const std::string& hef_path, const std::string& device_id) const;
+    Result<Replica*> ReplicaForLocked(const std::string& hef_path, const std::string& device_id);
+    void AttachLocked(Replica& replica);
+    void DetachLocked(const std::string& hef_path, const std::string& device_id);
+
+    const std::vector<std::string> device_ids_;
+    const size_t max_replicas_;
+    const NowFn now_;
+
+    mutable std::mutex mutex_;
+    std::map<ReplicaKey, Replica> replicas_;
+    std::map<std::string, Assignment> assignments_;  // By stream id
+    Clock::time_point last_sample_;
+};
+
+}  // namespace stream_daemon
+
+#endif  // STREAM_DAEMON_DEVICE_POOL_H_
@@ -17,6 +17,12 @@ struct Point2D {
     float y{0.0f};
 };
 
+// 정규화 좌표 사각형 (min/max 꼭짓점)
+struct RegionBounds {
+    Point2D min;
+    Point2D max;
+};
+
 // 이벤트 타입
 enum class EventType {
     kROI,              // 영역 감지
@@ -177,6 +183,15 @@ public:
      */
     [[nodiscard]] size_t GetSettingCount() const;
 
+    /**
+     * @brief 모든 이벤트 폴리곤/라인을 감싸는 사각형 (정규화 좌표)
+     *
+     * Used to crop inference to where events can fire. nullopt when no
+     * setting has points, or when a spatial setting without points (e.g. a
+     * heatmap over the whole view) needs the full frame.
+     */
+    [[nodiscard]] std::optional<RegionBounds> GetRegionBounds() const;
+
     /**
      * @brief 특정 이벤트 설정 조회
      */
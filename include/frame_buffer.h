@@ -0,0 +1,118 @@
+#ifndef STREAM_DAEMON_FRAME_BUFFER_H_
+#define STREAM_DAEMON_FRAME_BUFFER_H_
+
+#include "common.h"
+#include "frame_view.h"
+
+#include <gst/gst.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+namespace stream_daemon {
+
+/**
+ * @brief Refcounted, read-only handle to a decoded GStreamer frame
+ *
+ * Holds a reference on the GstSample and keeps its GstBuffer mapped for
+ * the lifetime of the handle. The pixels can therefore be passed from the
+ * appsink streaming thread to the batch worker without being copied; the
+ * buffer goes back to the decoder pool when the last FrameRef is dropped.
+ */
+class FrameBuffer {
+public:
+    /**
+     * @brief Take a reference on the sample and map its buffer for reading
+     * @param sample Sample pulled from appsink (caller keeps its own ref)
+     * @param geometry Layout negotiated on the sample caps; per-buffer
+     *        GstVideoMeta strides/offsets take precedence when present
+     */
+    [[nodiscard]] static Result<std::shared_ptr<const FrameBuffer>> FromSample(
+        GstSample* sample, const FrameGeometry& geometry);
+
+    ~FrameBuffer();
+
+    // Non-copyable, non-movable (owns a GstMapInfo)
+    FrameBuffer(const FrameBuffer&) = delete;
+    FrameBuffer& operator=(const FrameBuffer&) = delete;
+    FrameBuffer(FrameBuffer&&) = delete;
+    FrameBuffer& operator=(FrameBuffer&&) = delete;
+
+    [[nodiscard]] const FrameView& View() const noexcept { return view_; }
+    [[nodiscard]] const uint8_t* Data() const noexcept { return map_.data; }
+    [[nodiscard]] size_t Size() const noexcept { return map_.size; }
+    [[nodiscard]] int Width() const noexcept { return view_.width; }
+    [[nodiscard]] int Height() const noexcept { return view_.height; }
+
+private:
+    FrameBuffer(GstSample* sample, GstBuffer* buffer);
+
+    GstSample* sample_{nullptr};
+    GstBuffer* buffer_{nullptr};
+    GstMapInfo map_{};
+    FrameView view_;
+};
+
+/**
+ * @brief Caches the FrameGeometry of an appsink's caps
+ *
+ * Caps objects are shared by every sample until renegotiation, so a pointer
+ * comparison is enough on the hot path; the caps are only parsed again
+ * (gst_video_info_from_caps) when they actually change.
+ */
+class FrameGeometryCache {
+public:
+    FrameGeometryCache() = default;
+    ~FrameGeometryCache() { Reset(); }
+
+    // Non-copyable (holds a caps reference)
+    FrameGeometryCache(const FrameGeometryCache&) = delete;
+    FrameGeometryCache& operator=(const FrameGeometryCache&) = delete;
+
+    /**
+     * @brief Geometry for the given caps (nullptr if not raw video)
+     */
+    [[nodiscard]] const FrameGeometry* Get(GstCaps* caps);
+
+    /**
+     * @brief Drop the cached caps (call when the pipeline is destroyed)
+     */
+    void Reset();
+
+private:
+    GstCaps* caps_{nullptr};
+    FrameGeometry geometry_;
+    bool valid_{false};
+};
+
+using FrameRef = std::shared_ptr<const FrameBuffer>;
+
+/**
+ * @brief Deleter for owning GstSample references
+ */
+struct GstSampleDeleter {
+    void operator()(GstSample* sample) const noexcept { gst_sample_unref(sample); }
+};
+
+/**
+ * @brief Decoded sample queued for the frame worker, with its capture time
+ *
+ * The capture time is resolved on the streaming thread, where the sink's
+ * clock and base time are valid; the worker never touches the sink.
+ */
+struct CapturedSample {
+    GstSample* sample{nullptr};  // Owned reference
+    int64_t capture_ms{0};       // Unix ms
+};
+
+struct CapturedSampleDeleter {
+    void operator()(CapturedSample* captured) const noexcept {
+        gst_sample_unref(captured->sample);
+        delete captured;
+    }
+};
+
+}  // namespace stream_daemon
+
+#endif  // STREAM_DAEMON_FRAME_BUFFER_H_
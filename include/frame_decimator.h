@@ -0,0 +1,91 @@
+#ifndef STREAM_DAEMON_FRAME_DECIMATOR_H_
+#define STREAM_DAEMON_FRAME_DECIMATOR_H_
+
+#include <cstdint>
+
+namespace stream_daemon {
+
+/**
+ * @brief Selects which decoded frames get inference
+ *
+ * Decouples the inference rate from the camera rate. Two modes can be
+ * combined: every Nth frame, and a target rate in Hz. The rate mode keeps a
+ * fixed schedule (next due time advances by exactly one period) so the long
+ * term rate stays at the target regardless of arrival jitter.
+ *
+ * Not thread-safe; used from the appsink streaming thread only.
+ */
+class FrameDecimator {
+public:
+    FrameDecimator() = default;
+
+    /**
+     * @brief Configure decimation (resets state)
+     * @param target_fps Inference rate in Hz (<= 0 = no rate limit)
+     * @param every_n Process one frame out of every N (<= 1 = every frame)
+     */
+    void Configure(double target_fps, int every_n) noexcept {
+        period_us_ = target_fps > 0.0 ? static_cast<int64_t>(1'000'000.0 / target_fps) : 0;
+        every_n_ = every_n > 1 ? every_n : 1;
+        Reset();
+    }
+
+    /**
+     * @brief Forget the schedule (e.g. after reconnect)
+     */
+    void Reset() noexcept {
+        frame_index_ = 0;
+        next_due_us_ = -1;
+    }
+
+    /**
+     * @brief True if all frames pass through
+     */
+    [[nodiscard]] bool IsPassThrough() const noexcept {
+        return period_us_ == 0 && every_n_ == 1;
+    }
+
+    /**
+     * @brief Decide whether the frame arriving at now_us gets inference
+     * @param now_us Monotonic arrival time in microseconds
+     */
+    [[nodiscard]] bool ShouldProcess(int64_t now_us) noexcept {
+        if (every_n_ > 1) {
+            const bool hit = (frame_index_ % static_cast<uint64_t>(every_n_)) == 0;
+            ++frame_index_;
+            if (!hit) {
+                return false;
+            }
+        }
+
+        if (period_us_ == 0) {
+            return true;
+        }
+
+        if (next_due_us_ < 0) {
+            next_due_us_ = now_us + period_us_;
+            return true;
+        }
+
+        if (now_us < next_due_us_) {
+            return false;
+        }
+
+        next_due_us_ += period_us_;
+        // Stalled for more than a period (reconnect, slow consumer): resync
+        if (next_due_us_ <= now_us) {
+            next_due_us_ = now_us + period_us_;
+        }
+        return true;
+    }
+
+private:
+    int64_t period_us_{0};
+    int every_n_{1};
+    uint64_t frame_index_{0};
+    int64_t next_due_us_{-1};
+};
+
+}  // namespace stream_daemon
+
+#endif  // STREAM_DAEMON_FRAME_DECIMATOR_H_
@@ -0,0 +1,215 @@
+#ifndef STREAM_DAEMON_FRAME_VIEW_H_
+#define STREAM_DAEMON_FRAME_VIEW_H_
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+namespace stream_daemon {
+
+/**
+ * @brief Pixel formats understood by the CPU image kernels
+ */
+enum class PixelFormat {
+    kUnknown,
+    kRGB,     // packed 24-bit, 1 plane
+    kNV12,    // Y plane + interleaved UV plane (2x2 subsampled)
+    kI420     // Y, U, V planes (2x2 subsampled)
+};
+
+/**
+ * @brief YUV -> RGB matrix of NV12/I420 frames (from the caps colorimetry)
+ */
+enum class YuvMatrix {
+    kBt601,
+    kBt709
+};
+
+inline constexpr int kMaxFramePlanes = 3;
+
+/**
+ * @brief Non-owning, stride-aware view of a video frame
+ *
+ * Rows are addressed through Row() so padded strides (e.g. 4-byte aligned
+ * RGB rows of odd-width streams) are handled without repacking.
+ */
+struct FrameView {
+    PixelFormat format{PixelFormat::kUnknown};
+    int width{0};
+    int height{0};
+    int num_planes{0};
+    std::array<const uint8_t*, kMaxFramePlanes> planes{};
+    std::array<int, kMaxFramePlanes> strides{};
+    YuvMatrix yuv_matrix{YuvMatrix::kBt601};
+    bool yuv_full_range{false};         // false = 16-235 luma (decoder default)
+
+    /**
+     * @brief View over a packed RGB buffer
+     * @param stride Row stride in bytes (0 = width * 3)
+     */
+    [[nodiscard]] static FrameView Rgb(const uint8_t* data, int width, int height,
+                                       int stride = 0) noexcept {
+        FrameView view;
+        view.format = PixelFormat::kRGB;
+        view.width = width;
+        view.height = height;
+        view.num_planes = 1;
+        view.planes[0] = data;
+        view.strides[0] = stride > 0 ? stride : width * 3;
+        return view;
+    }
+
+    /**
+     * @brief View over NV12 planes (Y, interleaved UV)
+     */
+    [[nodiscard]] static FrameView Nv12(const uint8_t* y, int y_stride,
+                                        const uint8_t* uv, int uv_stride,
+                                        int width, int height) noexcept {
+        FrameView view;
+        view.format = PixelFormat::kNV12;
+        view.width = width;
+        view.height = height;
+        view.num_planes = 2;
+        view.planes = {y, uv, nullptr};
+        view.strides = {y_stride, uv_stride, 0};
+        return view;
+    }
+
+    /**
+     * @brief View over I420 planes (Y, U, V)
+     */
+    [[nodiscard]] static FrameView I420(const uint8_t* y, int y_stride,
+                                        const uint8_t* u, int u_stride,
+                                        const uint8_t* v, int v_stride,
+                                        int width, int height) noexcept {
+        FrameView view;
+        view.format = PixelFormat::kI420;
+        view.width = width;
+        view.height = height;
+        view.num_planes = 3;
+        view.planes = {y, u, v};
+        view.strides = {y_stride, u_stride, v_stride};
+        return view;
+    }
+
+    [[nodiscard]] bool IsValid() const noexcept {
+        return format != PixelFormat::kUnknown && width > 0 && height > 0 &&
+               num_planes > 0 && planes[0] != nullptr;
+    }
+
+    /**
+     * @brief True for RGB rows without padding (single memcpy is possible)
+     */
+    [[nodiscard]] bool IsPackedRgb() const noexcept {
+        return format == PixelFormat::kRGB && strides[0] == width * 3;
+    }
+
+    [[nodiscard]] bool IsYuv() const noexcept {
+        return format == PixelFormat::kNV12 || format == PixelFormat::kI420;
+    }
+
+    [[nodiscard]] const uint8_t* Row(int plane, int y) const noexcept {
+        return planes[plane] + static_cast<ptrdiff_t>(y) * strides[plane];
+    }
+
+    // Chroma plane size of the 2x2 subsampled formats
+    [[nodiscard]] int ChromaWidth() const noexcept { return (width + 1) / 2; }
+    [[nodiscard]] int ChromaHeight() const noexcept { return (height + 1) / 2; }
+
+    /**
+     * @brief Zero-copy view of a rectangle, clipped to the frame
+     *
+     * NV12/I420 origins are rounded down to even coordinates so the chroma
+     * planes stay aligned with luma (the size is kept).
+     */
+    [[nodiscard]] FrameView Crop(int x, int y, int crop_width, int crop_height) const noexcept {
+        if (IsYuv()) {
+            x &= ~1;
+            y &= ~1;
+        }
+        x = x < 0 ? 0 : x;
+        y = y < 0 ? 0 : y;
+        crop_width = x + crop_width > width ? width - x : crop_width;
+        crop_height = y + crop_height > height ? height - y : crop_height;
+
+        FrameView view = *this;
+        if (crop_width <= 0 || crop_height <= 0) {
+            view.width = 0;
+            view.height = 0;
+            return view;
+        }
+        view.width = crop_width;
+        view.height = crop_height;
+
+        switch (format) {
+            case PixelFormat::kRGB:
+                view.planes[0] = Row(0, y) + static_cast<ptrdiff_t>(x) * 3;
+                break;
+            case PixelFormat::kNV12:
+                view.planes[0] = Row(0, y) + x;
+                view.planes[1] = Row(1, y / 2) + x;    // Interleaved UV: 2 bytes per chroma sample
+                break;
+            case PixelFormat::kI420:
+                view.planes[0] = Row(0, y) + x;
+                view.planes[1] = Row(1, y / 2) + x / 2;
+                view.planes[2] = Row(2, y / 2) + x / 2;
+                break;
+            case PixelFormat::kUnknown:
+                break;
+        }
+        return view;
+    }
+};
+
+/**
+ * @brief Frame layout negotiated on the caps (GstVideoInfo geometry)
+ *
+ * Computed once per caps change and bound to each mapped buffer.
+ */
+struct FrameGeometry {
+    PixelFormat format{PixelFormat::kUnknown};
+    int width{0};
+    int height{0};
+    int num_planes{0};
+    std::array<size_t, kMaxFramePlanes> offsets{};
+    std::array<int, kMaxFramePlanes> strides{};
+    size_t size{0};
+    YuvMatrix yuv_matrix{YuvMatrix::kBt601};
+    bool yuv_full_range{false};
+
+    /**
+     * @brief Packed RGB geometry (used as fallback when caps are unavailable)
+     */
+    [[nodiscard]] static FrameGeometry Rgb(int width, int height) noexcept {
+        FrameGeometry geometry;
+        geometry.format = PixelFormat::kRGB;
+        geometry.width = width;
+        geometry.height = height;
+        geometry.num_planes = 1;
+        geometry.strides[0] = width * 3;
+        geometry.size = static_cast<size_t>(geometry.strides[0]) * height;
+        return geometry;
+    }
+
+    /**
+     * @brief Bind the geometry to a mapped buffer
+     */
+    [[nodiscard]] FrameView Bind(const uint8_t* base) const noexcept {
+        FrameView view;
+        view.format = format;
+        view.width = width;
+        view.height = height;
+        view.num_planes = num_planes;
+        view.yuv_matrix = yuv_matrix;
+        view.yuv_full_range = yuv_full_range;
+        for (int i = 0; i < num_planes && i < kMaxFramePlanes; ++i) {
+            view.planes[i] = base + offsets[i];
+            view.strides[i] = strides[i];
+        }
+        return view;
+    }
+};
+
+}  // namespace stream_daemon
+
+#endif  // STREAM_DAEMON_FRAME_VIEW_H_
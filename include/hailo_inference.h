@@ -1,8 +1,14 @@
 #ifndef STREAM_DAEMON_HAILO_INFERENCE_H_
 #define STREAM_DAEMON_HAILO_INFERENCE_H_
 
+#include "async_inference_engine.h"
 #include "common.h"
-#include <hailo/hailort.hpp>
+#include "frame_view.h"
+#include "image_ops.h"
+#include "inference_backend.h"
+#include "latency_stats.h"
+#include "model_context.h"
+#include <chrono>
 #include <memory>
 #include <mutex>
 #include <string>
@@ -17,40 +23,60 @@ class BatchInferenceManager;
 namespace stream_daemon {
 
 /**
- * @brief Wrapper for HailoRT inference with NMS output parsing
+ * @brief Model inference with NMS output parsing
  *
- * Uses HailoRT VStreams API for inference and properly parses
- * NMS detection output from YOLOv8 models.
+ * Runs the model on an IInferenceBackend (HailoRT VStreams by default, or a
+ * simulated device, see SetBackendFactory) and parses NMS and raw YOLOv8
+ * detection output.
  *
  * Designed for multi-stream support:
- * - VDevice is shared across all model instances
+ * - VDevice is shared across all model instances (HailoRtBackend)
  * - Hailo scheduler handles concurrent inference efficiently
  * - Thread-safe for parallel camera processing
+ * - Each caller letterboxes into its own input buffer (large frames split
+ *   into row bands on CpuWorkerPool::Shared()) and hands it to the model's
+ *   AsyncInferenceEngine, which keeps several frames queued on the device;
+ *   callers preprocess and parse while other frames are on the NPU
  */
 class HailoInference {
 public:
     /**
-     * @brief Get or create inference instance for a model
+     * @brief Get or create inference instance for a model on a device
      *
      * Uses shared VDevice for efficient multi-stream processing.
-     * Same HEF path returns the same instance (cached).
+     * Same HEF path and device returns the same instance (cached); the same
+     * HEF on two devices is two instances (see DevicePool).
      *
      * @param hef_path Path to the HEF model file
+     * @param device_id Device to configure it on (empty = default device)
      * @return Shared HailoInference instance or error
      */
     [[nodiscard]] static Result<std::shared_ptr<HailoInference>> GetInstance(
-        const std::string& hef_path);
+        const std::string& hef_path,
+        const std::string& device_id = "");
 
     /**
-     * @brief Release instance for a model
+     * @brief Release instance for a model (on one device)
      */
-    static void ReleaseInstance(const std::string& hef_path);
+    static void ReleaseInstance(const std::string& hef_path, const std::string& device_id = "");
 
     /**
      * @brief Shutdown all instances and release VDevice
      */
     static void Shutdown();
 
+    /**
+     * @brief Backend for models created from now on
+     *
+     * Existing instances keep their backend; call before the first GetInstance
+     * (models cannot be created until a factory is set).
+     *
+     * @param on_shutdown Called by Shutdown() after the instances are dropped
+     *        (e.g. to release devices the backends share)
+     */
+    static void SetBackendFactory(InferenceBackendFactory factory,
+                                  std::function<void()> on_shutdown = {});
+
     ~HailoInference();
 
     // Non-copyable
@@ -61,35 +87,70 @@ public:
      * @brief Frame data for batch inference
      */
     struct FrameInput {
-        const uint8_t* rgb_data;
-        int width;
-        int height;
+        FrameView frame;        // RGB, NV12 or I420, any row stride
         std::string stream_id;  // To map results back
+        int source_width{0};    // Set when frame is already letterboxed by the pipeline
+        int source_height{0};
+        InferenceRequest request;  // This frame's context and threshold
     };
 
     /**
-     * @brief Run inference on RGB frame and get detections
-     * @param rgb_data RGB pixel data (width * height * 3 bytes)
-     * @param width Frame width
-     * @param height Frame height
-     * @param confidence_threshold Minimum confidence for detections
+     * @brief Run inference on a decoded frame and get detections
+     * @param frame RGB, NV12 or I420 frame view (row stride may include padding);
+     *        YUV is converted while letterboxing into the input buffer
+     * @param request Model context and confidence threshold for this call
      * @return Vector of detected objects
      */
     [[nodiscard]] std::vector<Detection> RunInference(
-        const uint8_t* rgb_data,
-        int width,
-        int height,
-        float confidence_threshold = 0.25f);
+        const FrameView& frame,
+        const InferenceRequest& request = {});
+
+    /**
+     * @brief Run inference on a frame the pipeline already letterboxed to model size
+     *
+     * Used by the dual-branch pipeline: the frame is written to the device as-is
+     * and detections are mapped back to the decoded source geometry.
+     *
+     * @param model_frame RGB frame view at model input size
+     * @param source_width Width of the decoded source frame
+     * @param source_height Height of the decoded source frame
+     * @param request Model context and confidence threshold for this call
+     */
+    [[nodiscard]] std::vector<Detection> RunInferenceLetterboxed(
+        const FrameView& model_frame,
+        int source_width,
+        int source_height,
+        const InferenceRequest& request = {});
 
     /**
      * @brief Run batch inference on multiple frames
-     * @param frames Vector of frame inputs (up to batch_size)
-     * @param confidence_threshold Minimum confidence for detections
+     *
+     * Every frame is written once; fewer frames than the batch size make a
+     * partial batch (no padding frames), more are pipelined as further batches.
+     *
+     * @param frames Vector of frame inputs (normally up to batch_size), each
+     *        parsed with its own request
      * @return Map of stream_id to detections
      */
     [[nodiscard]] std::unordered_map<std::string, std::vector<Detection>> RunBatchInference(
-        const std::vector<FrameInput>& frames,
-        float confidence_threshold = 0.25f);
+        const std::vector<FrameInput>& frames);
+
+    /**
+     * @brief Run inference on crops of one frame and merge the detections
+     *
+     * Crops are submitted through RunBatchInference in groups of the model
+     * batch size; detections are mapped back to frame coordinates and
+     * overlapping ones from neighbouring crops merged with cross-tile NMS.
+     * Crops smaller or larger than the model input are letterboxed as usual.
+     *
+     * @param frame RGB, NV12 or I420 frame view
+     * @param tiles Regions in frame pixels (see ComputeTiles)
+     * @param request Model context and confidence threshold for every tile
+     */
+    [[nodiscard]] std::vector<Detection> RunTiledInference(
+        const FrameView& frame,
+        const std::vector<BoundingBox>& tiles,
+        const InferenceRequest& request = {});
 
     /**
      * @brief Get model batch size
@@ -107,6 +168,27 @@ public:
      */
     bool IsReady() const { return is_ready_; }
 
+    /**
+     * @brief Device this instance runs on (empty = default device)
+     */
+    const std::string& GetDeviceId() const { return device_id_; }
+
+    /**
+     * @brief Total time this model had frames on the device
+     */
+    [[nodiscard]] std::chrono::steady_clock::duration GetBusyTime() const;
+
+    /**
+     * @brief Letterbox/convert time per frame
+     */
+    [[nodiscard]] StageTiming GetPreprocessTiming() const { return preprocess_timer_.Summary(); }
+
+    /**
+     * @brief Submit-to-detections time per call: queueing behind frames in
+     *        flight, device write/read and parsing (whole batch for batch models)
+     */
+    [[nodiscard]] StageTiming GetInferenceTiming() const { return inference_timer_.Summary(); }
+
     /**
      * @brief Get or create BatchInferenceManager for this model
      * Returns nullptr if batch_size == 1
@@ -115,28 +197,57 @@ public:
     std::shared_ptr<BatchInferenceManager> GetBatchManager(int batch_timeout_ms = 50);
 
     /**
-     * @brief Set model configuration for proper output parsing
-     * @param task "det" for detection, "pose" for pose estimation
-     * @param num_keypoints Number of keypoints (for pose models)
-     * @param labels Class labels
+     * @brief Context for reading this model's outputs the way `spec` declares
+     *
+     * Streams with equal specs share one context. Never blocks inference:
+     * the network group is configured once, contexts only describe parsing.
+     */
+    [[nodiscard]] std::shared_ptr<const ModelContext> GetContext(const ModelSpec& spec);
+
+    /**
+     * @brief Non-default contexts still held by a stream (diagnostics)
+     */
+    [[nodiscard]] size_t GetContextCount();
+
+    /**
+     * @brief Context for requests without one (default ModelSpec)
      */
-    void SetModelConfig(const std::string& task, int num_keypoints,
-                        const std::vector<std::string>& labels);
+    [[nodiscard]] std::shared_ptr<const ModelContext> GetDefaultContext() const {
+        return default_context_;
+    }
 
 private:
     HailoInference() = default;
 
     // Letterbox info for coordinate transformation
-    struct LetterboxInfo {
-        float scale{1.0f};   // Scale factor applied
-        int pad_x{0};        // Padding on left (and right)
-        int pad_y{0};        // Padding on top (and bottom)
-        int new_w{0};        // Resized width before padding
-        int new_h{0};        // Resized height before padding
+    using LetterboxInfo = LetterboxGeometry;
+
+    // Model-size input buffer with its own resizer (tables and painted borders)
+    struct InputSlot {
+        std::vector<uint8_t> buffer;
+        LetterboxResizer resizer;
     };
 
-    VoidResult Initialize(const std::string& hef_path);
+    VoidResult Initialize(const std::string& hef_path, const std::string& device_id);
+
+    // Take a free input slot (or create one); it returns to the free list on release
+    std::shared_ptr<InputSlot> AcquireInputSlot();
+
+    // Letterbox (YUV: convert) or copy frame into the slot buffer (no lock held)
+    LetterboxInfo Preprocess(const FrameView& frame, InputSlot& slot) const;
+
+    // Context and threshold a request runs with
+    const ModelContext& ContextFor(const InferenceRequest& request) const;
+    static float ThresholdFor(const InferenceRequest& request, const ModelContext& context);
+
+    // Parse one frame's outputs with the context's decoder
+    std::vector<Detection> ParseOutputs(const AsyncInferenceEngine::OutputBuffers& outputs,
+                                        const InferenceRequest& request,
+                                        const LetterboxInfo& letterbox,
+                                        int frame_width,
+                                        int frame_height);
     std::vector<Detection> ParseNmsOutput(const std::vector<uint8_t>& output_data,
+                                           const ModelContext& context,
                                            float confidence_threshold,
                                            int frame_width,
                                            int frame_height,
@@ -145,8 +256,8 @@ private:
     // Raw YOLO output parsing (for non-NMS models like best12.hef)
     std::vector<Detection> ParseRawYoloOutput(
         const std::vector<std::vector<uint8_t>>& output_buffers,
+        const ModelContext& context,
         float confidence_threshold,
-        float iou_threshold,
         int frame_width,
         int frame_height,
         const LetterboxInfo& letterbox);
@@ -157,21 +268,23 @@ private:
         const std::vector<float>& scores,
         float iou_threshold);
 
-    // Letterbox resize helper
-    static LetterboxInfo LetterboxResize(const uint8_t* src, int src_w, int src_h,
-                                          uint8_t* dst, int dst_w, int dst_h,
-                                          uint8_t pad_value = 114);
+    // Letterbox geometry (scale and centered padding) for src -> dst
+    static LetterboxInfo ComputeLetterbox(int src_w, int src_h, int dst_w, int dst_h);
+
+    // Copy a model-size RGB view into a packed buffer (drops row padding)
+    static void CopyPacked(const FrameView& src, uint8_t* dst);
 
-    // Static members for VDevice sharing (multi-stream efficiency)
-    static std::shared_ptr<hailort::VDevice> shared_vdevice_;
+    // Cache key: model path, plus "@device" off the default device
+    static std::string InstanceKey(const std::string& hef_path, const std::string& device_id);
+
+    // Instance cache (one per model path and device) and backend selection
     static std::unordered_map<std::string, std::shared_ptr<HailoInference>> instances_;
     static std::mutex static_mutex_;
+    static InferenceBackendFactory backend_factory_;
+    static std::function<void()> backend_shutdown_;
 
-    // Per-instance HailoRT objects
-    std::shared_ptr<hailort::ConfiguredNetworkGroup> network_group_;
-    std::vector<hailort::InputVStream> input_vstreams_;
-    std::vector<hailort::OutputVStream> output_vstreams_;
     std::string hef_path_;
+    std::string device_id_;
 
     // Model info
     int input_width_{640};
@@ -179,25 +292,33 @@ private:
     int batch_size_{1};  // Batch size from HEF model
     size_t input_frame_size_{0};
 
-    // NMS output info
-    int num_classes_{80};
-    int max_bboxes_per_class_{100};
-    bool is_nms_output_{false};
-    bool is_raw_yolo_output_{false};  // For multi-output models without NMS (e.g., best12.hef)
+    // Output layout found at Initialize (decoder, NMS shape) with the default
+    // spec; never changes afterwards
+    std::shared_ptr<const ModelContext> default_context_;
+
+    // Contexts handed out by GetContext, one per distinct spec still in use
+    // (streams own them; expired entries are pruned on lookup)
+    std::vector<std::weak_ptr<const ModelContext>> contexts_;
+    std::mutex contexts_mutex_;
+
+    // Input buffers, one per concurrent caller (batch: one per batch slot)
+    std::vector<std::unique_ptr<InputSlot>> free_input_slots_;
+    std::mutex input_slot_mutex_;
 
-    // Model config (set via SetModelConfig)
-    std::string task_{"det"};           // "det" or "pose"
-    int num_keypoints_{0};              // Number of keypoints for pose model
-    std::vector<std::string> labels_;   // Class labels
+    std::vector<size_t> output_frame_sizes_;  // Size of each output stream
 
-    // Input/Output buffers (per-instance for thread safety)
-    std::vector<uint8_t> input_buffer_;
-    std::vector<std::vector<uint8_t>> output_buffers_;  // One buffer per output vstream
-    std::vector<size_t> output_frame_sizes_;            // Size of each output
+    // Device streams of this model
+    std::unique_ptr<IInferenceBackend> backend_;
+
+    // Writes/reads the backend on its own threads (declared after it so it
+    // stops first); output buffers are pooled per frame in flight
+    std::unique_ptr<AsyncInferenceEngine> engine_;
 
     // State
     bool is_ready_{false};
-    mutable std::mutex inference_mutex_;
+
+    StageTimer preprocess_timer_;
+    StageTimer inference_timer_;
 
     // Batch manager (created on demand for batch > 1)
     std::shared_ptr<BatchInferenceManager> batch_manager_;
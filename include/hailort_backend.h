@@ -0,0 +1,94 @@
+#ifndef STREAM_DAEMON_HAILORT_BACKEND_H_
+#define STREAM_DAEMON_HAILORT_BACKEND_H_
+
+#include "inference_backend.h"
+
+#include <hailo/hailort.hpp>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace stream_daemon {
+
+/**
+ * @brief IInferenceBackend on a Hailo device via HailoRT VStreams
+ *
+ * Models on the same device id share one VDevice; the HailoRT scheduler
+ * switches network groups between them. A device id is one PCIe device
+ * ("0000:01:00.0"), several joined with '+' (one VDevice over a group of
+ * modules) or empty (HailoRT picks). Inputs are UINT8; outputs are
+ * dequantised to FLOAT32 by HailoRT, or with quantized_outputs left in the
+ * device's UINT8/UINT16 (NMS outputs stay FLOAT32) for HailoInference to
+ * threshold and dequantise itself.
+ *
+ * The batch size comes from the HEF's network group params unless one is
+ * requested; with batch > 1 the scheduler runs a partial batch after
+ * kInferenceBatchFlushMs, so callers never pad batches themselves.
+ */
+class HailoRtBackend : public IInferenceBackend {
+public:
+    /**
+     * @param batch_size Batch to configure (0 or 1 = the HEF's own)
+     * @param device_id Device or '+'-joined device group to run on (empty = any)
+     * @param quantized_outputs Read non-NMS outputs as the device produces them
+     */
+    explicit HailoRtBackend(int batch_size = 0, std::string device_id = "",
+                            bool quantized_outputs = false)
+        : requested_batch_size_(batch_size)
+        , device_id_(std::move(device_id))
+        , quantized_outputs_(quantized_outputs) {}
+    ~HailoRtBackend() override = default;
+
+    // Non-copyable
+    HailoRtBackend(const HailoRtBackend&) = delete;
+    HailoRtBackend& operator=(const HailoRtBackend&) = delete;
+
+    [[nodiscard]] VoidResult Configure(const std::string& hef_path) override;
+
+    [[nodiscard]] const std::vector<TensorInfo>& GetInputs() const override { return inputs_; }
+    [[nodiscard]] const std::vector<TensorInfo>& GetOutputs() const override { return outputs_; }
+    [[nodiscard]] int GetBatchSize() const override { return batch_size_; }
+
+    [[nodiscard]] VoidResult Write(const uint8_t* data, size_t size) override;
+    [[nodiscard]] VoidResult Read(size_t index, uint8_t* data, size_t size) override;
+
+    [[nodiscard]] std::string_view GetName() const noexcept override { return "hailort"; }
+
+    /**
+     * @brief Drop the shared VDevices (models configured on them keep their reference)
+     */
+    static void ReleaseSharedDevice();
+
+private:
+    static Result<std::shared_ptr<hailort::VDevice>> AcquireSharedDevice(
+        const std::string& device_id);
+
+    static TensorInfo ToTensorInfo(const hailo_vstream_info_t& info, size_t frame_size,
+                                   TensorDataType type);
+    // nullopt for formats the output decoders cannot read (e.g. AUTO)
+    static std::optional<TensorDataType> ToTensorDataType(hailo_format_type_t type);
+
+    // Static members for VDevice sharing (multi-stream efficiency), per device id
+    static std::map<std::string, std::shared_ptr<hailort::VDevice>> shared_vdevices_;
+    static std::mutex vdevice_mutex_;
+
+    // Keeps the device alive as long as this model's streams
+    std::shared_ptr<hailort::VDevice> vdevice_;
+    std::shared_ptr<hailort::ConfiguredNetworkGroup> network_group_;
+    std::vector<hailort::InputVStream> input_vstreams_;
+    std::vector<hailort::OutputVStream> output_vstreams_;
+
+    std::vector<TensorInfo> inputs_;
+    std::vector<TensorInfo> outputs_;
+    int requested_batch_size_{0};
+    std::string device_id_;
+    bool quantized_outputs_{false};
+    int batch_size_{1};
+};
+
+}  // namespace stream_daemon
+
+#endif  // STREAM_DAEMON_HAILORT_BACKEND_H_
@@ -0,0 +1,206 @@
+#ifndef STREAM_DAEMON_IMAGE_OPS_H_
+#define STREAM_DAEMON_IMAGE_OPS_H_
+
+#include "common.h"
+#include "cpu_worker_pool.h"
+#include "frame_view.h"
+
+#include <cstdint>
+#include <string_view>
+#include <vector>
+
+namespace stream_daemon {
+
+/**
+ * @brief Letterbox geometry (scale and centered padding) for src -> dst
+ */
+struct LetterboxGeometry {
+    float scale{1.0f};   // Scale factor applied
+    int pad_x{0};        // Padding on left (and right)
+    int pad_y{0};        // Padding on top (and bottom)
+    int new_w{0};        // Resized width before padding
+    int new_h{0};        // Resized height before padding
+};
+
+[[nodiscard]] LetterboxGeometry ComputeLetterboxGeometry(int src_w, int src_h,
+                                                         int dst_w, int dst_h) noexcept;
+
+enum class ResizeInterpolation {
+    kNearest,    // Legacy sampling, bit-exact with the original scalar loop
+    kBilinear    // Pixel-center aligned, 7-bit fixed-point weights
+};
+
+/**
+ * @brief CPU kernel variants (selected at runtime)
+ */
+enum class SimdLevel {
+    kScalar,
+    kSse41,
+    kAvx2,
+    kNeon
+};
+
+[[nodiscard]] std::string_view SimdLevelToString(SimdLevel level) noexcept;
+
+/**
+ * @brief Best kernel variant supported by the running CPU
+ */
+[[nodiscard]] SimdLevel DetectSimdLevel() noexcept;
+
+[[nodiscard]] bool IsSimdLevelSupported(SimdLevel level) noexcept;
+
+/**
+ * @brief Letterbox resize of RGB or YUV frames into a packed RGB model input
+ *
+ * Source column/row indices and interpolation weights are computed once per
+ * (format, src, dst) geometry and cached, so the per-frame work is table
+ * lookups plus the blend. Bilinear resampling runs a horizontal pass per
+ * source row (kept for the next output row when shared) and a vectorised
+ * vertical pass. All SIMD levels produce output identical to the scalar
+ * kernel.
+ *
+ * NV12/I420 sources are converted in the same pass: luma and chroma are
+ * resampled at the output positions and only the output pixels go through
+ * the colour matrix, so no full-resolution RGB frame is ever produced.
+ *
+ * Pad borders are painted only when the geometry or pad value written to a
+ * destination buffer changes; call Invalidate() after writing the buffer by
+ * other means (e.g. a pre-scaled copy) so the next Resize() repaints them.
+ *
+ * With a worker pool set, sources of at least min_parallel_pixels are split
+ * into horizontal output bands resized concurrently; each band has its own
+ * row scratch, so the output is identical to the single-threaded pass.
+ *
+ * Not thread-safe; the owner serializes calls (HailoInference gives each
+ * input buffer its own resizer).
+ */
+class LetterboxResizer {
+public:
+    explicit LetterboxResizer(ResizeInterpolation interpolation = ResizeInterpolation::kBilinear,
+                              SimdLevel level = DetectSimdLevel());
+
+    /**
+     * @brief Resize src (RGB, NV12 or I420) into dst (packed dst_w x dst_h RGB)
+     * @return Geometry for mapping detections back to source coordinates
+     */
+    LetterboxGeometry Resize(const FrameView& src, uint8_t* dst, int dst_w, int dst_h,
+                             uint8_t pad_value = kLetterboxPadValue);
+
+    /**
+     * @brief Split large sources into row bands on pool (nullptr = single thread)
+     * @param min_parallel_pixels Smaller sources stay on the calling thread
+     */
+    void SetWorkerPool(CpuWorkerPool* pool,
+                       int64_t min_parallel_pixels = kParallelPreprocessMinPixels);
+
+    /**
+     * @brief Forget the painted borders of a destination buffer
+     */
+    void Invalidate(const uint8_t* dst);
+
+    /**
+     * @brief Forget all destination buffers (e.g. after reallocating them)
+     */
+    void InvalidateAll();
+
+    [[nodiscard]] ResizeInterpolation GetInterpolation() const noexcept { return interpolation_; }
+    [[nodiscard]] SimdLevel GetSimdLevel() const noexcept { return level_; }
+
+    /**
+     * @brief Row bands used by the last Resize() (1 = single thread)
+     */
+    [[nodiscard]] int GetLastBandCount() const noexcept { return last_bands_; }
+
+private:
+    // Per-geometry lookup tables
+    struct Plan {
+        PixelFormat format{PixelFormat::kUnknown};
+        int src_w{0};
+        int src_h{0};
+        int dst_w{0};
+        int dst_h{0};
+        LetterboxGeometry geometry;
+        std::vector<int32_t> x_offset0;   // Byte offset of the left sample in a source row
+        std::vector<int32_t> x_offset1;   // Byte offset of the right sample (bilinear)
+        std::vector<int16_t> x_weight;    // Q7 weight of the right sample
+        std::vector<int32_t> y_index0;
+        std::vector<int32_t> y_index1;
+        std::vector<int16_t> y_weight;    // Q7 weight of the lower row
+        int gather_columns{0};            // Leading columns safe for 4-byte loads
+
+        // Chroma plane taps per output pixel (NV12/I420)
+        std::vector<int32_t> cx_offset0;
+        std::vector<int32_t> cx_offset1;
+        std::vector<int16_t> cx_weight;
+        std::vector<int32_t> cy_index0;
+        std::vector<int32_t> cy_index1;
+        std::vector<int16_t> cy_weight;
+    };
+
+    // Horizontally resampled source rows (bilinear), keyed by source row
+    struct RowCache {
+        std::vector<int16_t> rows[2];
+        int y[2]{-1, -1};
+
+        void Reset(size_t size);
+    };
+
+    // Per-band working rows
+    struct Scratch {
+        RowCache rows;                        // RGB rows or luma
+        RowCache chroma[2];                   // NV12: UV; I420: U, V
+
+        // Output-resolution Y/U/V rows handed to the colour conversion
+        std::vector<uint8_t> luma_row;
+        std::vector<uint8_t> chroma_row[2];
+    };
+
+    // Border state of one destination buffer
+    struct PaintedBuffer {
+        const uint8_t* dst{nullptr};
+        int dst_w{0};
+        int dst_h{0};
+        int pad_x{0};
+        int pad_y{0};
+        int new_w{0};
+        int new_h{0};
+        uint8_t pad_value{0};
+    };
+
+    const Plan& GetPlan(PixelFormat format, int src_w, int src_h, int dst_w, int dst_h);
+    void BuildPlan(Plan& plan) const;
+    void BuildChromaTables(Plan& plan) const;
+
+    void PaintBorders(const Plan& plan, uint8_t* dst, uint8_t pad_value);
+    int BandCount(const Plan& plan) const;
+
+    // Resize output rows [y_begin, y_end) of the letterboxed area
+    void ResizeRows(const Plan& plan, const FrameView& src, uint8_t* dst,
+                    int y_begin, int y_end, Scratch& scratch) const;
+    void ResizeNearest(const Plan& plan, const FrameView& src, uint8_t* dst,
+                       int y_begin, int y_end) const;
+    void ResizeBilinear(const Plan& plan, const FrameView& src, uint8_t* dst,
+                        int y_begin, int y_end, Scratch& scratch) const;
+    void ResizeYuv(const Plan& plan, const FrameView& src, uint8_t* dst,
+                   int y_begin, int y_end, Scratch& scratch) const;
+
+    // Return the cached row for src_y, running fill(row) into a free slot on a miss
+    template <typename Fill>
+    static const int16_t* CachedRow(RowCache& cache, int src_y, Fill&& fill);
+
+    ResizeInterpolation interpolation_;
+    SimdLevel level_;
+
+    std::vector<Plan> plans_;                 // Most recently used last
+    std::vector<PaintedBuffer> painted_;
+
+    std::vector<Scratch> scratch_;            // One per band
+
+    CpuWorkerPool* pool_{nullptr};
+    int64_t min_parallel_pixels_{kParallelPreprocessMinPixels};
+    int last_bands_{1};
+};
+
+}  // namespace stream_daemon
+
+#endif  // STREAM_DAEMON_IMAGE_OPS_H_
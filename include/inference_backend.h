@@ -0,0 +1,109 @@
+#ifndef STREAM_DAEMON_INFERENCE_BACKEND_H_
+#define STREAM_DAEMON_INFERENCE_BACKEND_H_
+
+#include "common.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace stream_daemon {
+
+/**
+ * @brief Element type of a tensor as exchanged with the backend
+ */
+enum class TensorDataType {
+    kUint8,
+    kUint16,
+    kFloat32
+};
+
+[[nodiscard]] std::string_view TensorDataTypeToString(TensorDataType type) noexcept;
+[[nodiscard]] size_t TensorDataTypeSize(TensorDataType type) noexcept;
+
+/**
+ * @brief Quantisation of a tensor: real = (quantized - zero_point) * scale
+ */
+struct QuantInfo {
+    float scale{1.0f};
+    float zero_point{0.0f};
+
+    [[nodiscard]] float Dequantize(uint32_t code) const noexcept {
+        return (static_cast<float>(code) - zero_point) * scale;
+    }
+};
+
+/**
+ * @brief One input or output stream of a configured model
+ */
+struct TensorInfo {
+    std::string name;
+    TensorDataType type{TensorDataType::kUint8};
+    int height{0};
+    int width{0};
+    int features{0};
+    size_t frame_size{0};           // Bytes per frame in the user buffer format
+    QuantInfo quant;
+
+    // On-device NMS output (0 classes = plain tensor)
+    int nms_classes{0};
+    int nms_max_bboxes_per_class{0};
+};
+
+/**
+ * @brief Device side of one model: configure, then write inputs and read outputs
+ *
+ * Frames are processed in FIFO order: each Write() queues one input frame,
+ * and each frame's outputs are read with one Read() per output stream, in
+ * write order. Write() and Read() are called from two different threads
+ * (AsyncInferenceEngine's writer and reader) and must not block each other.
+ * Everything else is called before the first Write().
+ */
+class IInferenceBackend {
+public:
+    virtual ~IInferenceBackend() = default;
+
+    /**
+     * @brief Load the model and create its streams
+     * @param model_path HEF file (HailoRT) or recording (simulated)
+     */
+    [[nodiscard]] virtual VoidResult Configure(const std::string& model_path) = 0;
+
+    [[nodiscard]] virtual const std::vector<TensorInfo>& GetInputs() const = 0;
+    [[nodiscard]] virtual const std::vector<TensorInfo>& GetOutputs() const = 0;
+
+    /**
+     * @brief Frames the device processes per batch
+     */
+    [[nodiscard]] virtual int GetBatchSize() const = 0;
+
+    /**
+     * @brief Queue one frame on the first input (blocks while the device queue is full)
+     */
+    [[nodiscard]] virtual VoidResult Write(const uint8_t* data, size_t size) = 0;
+
+    /**
+     * @brief Read output stream `index` of the oldest frame not yet read
+     */
+    [[nodiscard]] virtual VoidResult Read(size_t index, uint8_t* data, size_t size) = 0;
+
+    /**
+     * @brief Backend name for logs ("hailort", "simulated")
+     */
+    [[nodiscard]] virtual std::string_view GetName() const noexcept = 0;
+};
+
+/**
+ * @brief Creates an unconfigured backend for a model path on a device
+ *        (device_id as in HailoConfig::device_id; empty = default device)
+ */
+using InferenceBackendFactory = std::function<std::unique_ptr<IInferenceBackend>(
+    const std::string& model_path, const std::string& device_id)>;
+
+}  // namespace stream_daemon
+
+#endif  // STREAM_DAEMON_INFERENCE_BACKEND_H_
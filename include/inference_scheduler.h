@@ -0,0 +1,165 @@
+#ifndef STREAM_DAEMON_INFERENCE_SCHEDULER_H_
+#define STREAM_DAEMON_INFERENCE_SCHEDULER_H_
+
+#include "common.h"
+
+#include <array>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+namespace stream_daemon {
+
+/**
+ * @brief Admits frames from all streams and models to one NPU in a fair order
+ *
+ * Without it the device is shared in whatever order callers reach their
+ * model's engine, so a busy 30 fps camera can starve a critical 5 fps one.
+ * Every frame first takes a Lease; at most max_in_flight leases exist at a
+ * time and a freed slot goes to, in order:
+ * - a stream behind its guaranteed minimum rate (most frames owed first)
+ * - otherwise the highest priority class with frames waiting, and within
+ *   it the frame with the smallest virtual start time (start-time fair
+ *   queueing: equal weights alternate, weight 2 gets twice the frames)
+ *
+ * A frame still waiting when its stream's deadline passes is dropped: a
+ * stale frame is worth less than the next one from the camera. A stream
+ * whose worker is stopping is cancelled, so its frame does not hold up the
+ * teardown for a whole deadline.
+ *
+ * Create with std::make_shared (leases keep the scheduler alive).
+ */
+class InferenceScheduler : public std::enable_shared_from_this<InferenceScheduler> {
+public:
+    using Clock = std::chrono::steady_clock;
+    using NowFn = std::function<Clock::time_point()>;
+
+    // Held while the frame is on the device; releasing it admits the next
+    using Lease = std::shared_ptr<const void>;
+
+    struct StreamPolicy {
+        InferencePriority priority{InferencePriority::kNormal};
+        double weight{1.0};                     // Share within the priority class
+        double min_fps{0.0};                    // Guaranteed rate (0 = none)
+        std::chrono::milliseconds deadline{kDefaultInferenceDeadlineMs};  // 0 = wait forever
+    };
+
+    struct StreamStats {
+        StreamPolicy policy;
+        uint64_t granted{0};
+        uint64_t dropped{0};           // Deadline passed while waiting
+        uint64_t guaranteed{0};        // Admitted ahead of its class to meet min_fps
+        double achieved_fps{0.0};      // Grants per second over kSchedulerRateWindowMs
+        double mean_wait_ms{0.0};
+        size_t waiting{0};
+    };
+
+    /**
+     * @param max_in_flight Leases outstanding at once (min 1); at least the
+     *        largest model batch size so batches can fill
+     * @param now Time source for deadlines, minimum rates and statistics
+     *        (tests step it by hand)
+     */
+    explicit InferenceScheduler(int max_in_flight = kDefaultSchedulerMaxInFlight,
+                                NowFn now = Clock::now);
+
+    // Non-copyable
+    InferenceScheduler(const InferenceScheduler&) = delete;
+    InferenceScheduler& operator=(const InferenceScheduler&) = delete;
+
+    /**
+     * @brief Set or change a stream's policy (frames already waiting keep their deadline)
+     */
+    void SetStreamPolicy(const std::string& stream_id, const StreamPolicy& policy);
+
+    /**
+     * @brief Forget a stream and its statistics (no-op while it has frames waiting)
+     */
+    void RemoveStream(const std::string& stream_id);
+
+    /**
+     * @brief Fail the stream's waiting frames and every Acquire until Resume()
+     */
+    void Cancel(const std::string& stream_id);
+
+    /**
+     * @brief Admit the stream's frames again after Cancel()
+     */
+    void Resume(const std::string& stream_id);
+
+    /**
+     * @brief Wait for device slots for one frame of the stream
+     *
+     * Unknown streams get the default policy. A frame that occupies the
+     * device several times (e.g. tiled inference) asks for that many slots;
+     * it is granted all of them at once and charged as many turns of the
+     * stream's fair share.
+     *
+     * @param slots Device slots the frame needs (clamped to [1, max_in_flight])
+     * @return Lease to hold until the frame's outputs are read, or an error
+     *         when the deadline passed first or the stream was cancelled
+     *         (the frame should be dropped)
+     */
+    [[nodiscard]] Result<Lease> Acquire(const std::string& stream_id, int slots = 1);
+
+    [[nodiscard]] StreamStats GetStreamStats(const std::string& stream_id) const;
+    [[nodiscard]] std::unordered_map<std::string, StreamStats> GetStats() const;
+
+    [[nodiscard]] int GetMaxInFlight() const noexcept { return max_in_flight_; }
+    [[nodiscard]] int GetInFlight() const;
+
+private:
+    enum class WaiterState { kWaiting, kGranted, kDropped, kCancelled };
+
+    struct Waiter {
+        Clock::time_point enqueued;
+        Clock::time_point deadline;   // max() = none
+        double start_tag{0.0};        // Virtual time its class reaches when it is served
+        int slots{1};                 // Device slots the frame occupies
+        WaiterState state{WaiterState::kWaiting};
+    };
+
+    struct Stream {
+        StreamPolicy policy;
+        std::deque<Waiter*> waiting;          // Oldest first
+        double virtual_finish{0.0};           // Finish tag of its newest frame
+        double owed{0.0};                     // Min-rate frames not yet granted
+        Clock::time_point owed_updated;
+        std::deque<Clock::time_point> recent_grants;  // Within kSchedulerRateWindowMs
+        Clock::time_point first_seen;
+        uint64_t granted{0};
+        uint64_t dropped{0};
+        uint64_t guaranteed{0};
+        double total_wait_ms{0.0};
+        bool cancelled{false};
+    };
+
+    Stream& StreamFor(const std::string& stream_id, Clock::time_point now);
+
+    // Drop expired waiters and hand free slots out; caller holds mutex_
+    void Dispatch(Clock::time_point now);
+    Stream* SelectNext(bool& guaranteed);
+    void Grant(Stream& stream, bool guaranteed, Clock::time_point now);
+
+    void Release(int slots);
+
+    StreamStats MakeStats(const Stream& stream, Clock::time_point now) const;
+
+    const int max_in_flight_;
+    const NowFn now_;
+
+    mutable std::mutex mutex_;
+    std::condition_variable cv_;
+    std::unordered_map<std::string, Stream> streams_;
+    std::array<double, 3> class_virtual_time_{};  // Start tag served last, per InferencePriority
+    int in_flight_{0};
+};
+
+}  // namespace stream_daemon
+
+#endif  // STREAM_DAEMON_INFERENCE_SCHEDULER_H_
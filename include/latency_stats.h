@@ -0,0 +1,70 @@
+#ifndef STREAM_DAEMON_LATENCY_STATS_H_
+#define STREAM_DAEMON_LATENCY_STATS_H_
+
+#include "common.h"
+
+#include <chrono>
+#include <cstdint>
+#include <mutex>
+#include <vector>
+
+namespace stream_daemon {
+
+/**
+ * @brief Sliding-window latency aggregation (thread-safe)
+ *
+ * Keeps the last window_size samples in a ring; Summary() sorts a copy for
+ * percentiles, so recording stays O(1) on the frame path.
+ */
+class LatencyTracker {
+public:
+    explicit LatencyTracker(size_t window_size = kLatencyWindowSize);
+
+    /**
+     * @brief Record one sample (negative values, e.g. camera clock skew, are ignored)
+     */
+    void Record(int64_t latency_ms);
+
+    /**
+     * @brief Aggregate over the current window (count is the lifetime total)
+     */
+    [[nodiscard]] LatencySummary Summary() const;
+
+    void Reset();
+
+private:
+    std::vector<int64_t> window_;
+    size_t next_{0};
+    size_t filled_{0};
+    uint64_t count_{0};
+    int64_t last_{0};
+    mutable std::mutex mutex_;
+};
+
+/**
+ * @brief Per-stage CPU/device time in microseconds (thread-safe)
+ */
+class StageTimer {
+public:
+    explicit StageTimer(size_t window_size = kLatencyWindowSize) : samples_(window_size) {}
+
+    void Record(std::chrono::steady_clock::duration elapsed);
+
+    /**
+     * @brief Record the time since start
+     */
+    void RecordSince(std::chrono::steady_clock::time_point start) {
+        Record(std::chrono::steady_clock::now() - start);
+    }
+
+    [[nodiscard]] StageTiming Summary() const;
+
+    void Reset() { samples_.Reset(); }
+
+private:
+    LatencyTracker samples_;  // Same windowing, samples in microseconds
+};
+
+}  // namespace stream_daemon
+
+#endif  // STREAM_DAEMON_LATENCY_STATS_H_
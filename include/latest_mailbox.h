@@ -0,0 +1,120 @@
+#ifndef STREAM_DAEMON_LATEST_MAILBOX_H_
+#define STREAM_DAEMON_LATEST_MAILBOX_H_
+
+#include <atomic>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+
+namespace stream_daemon {
+
+/**
+ * @brief Single-slot "latest wins" hand-off between one producer and one consumer
+ *
+ * Put() atomically swaps the new item into the slot and destroys the item it
+ * replaced, so the producer never blocks on the consumer. The mutex/condvar
+ * are only used to park an idle consumer; the producer touches them only
+ * when the consumer is actually sleeping.
+ *
+ * @tparam T Item type (owned through std::unique_ptr<T, Deleter>)
+ * @tparam Deleter Deleter for replaced/unconsumed items
+ */
+template <typename T, typename Deleter = std::default_delete<T>>
+class LatestMailbox {
+public:
+    using Ptr = std::unique_ptr<T, Deleter>;
+
+    LatestMailbox() = default;
+    ~LatestMailbox() { Clear(); }
+
+    // Non-copyable, non-movable (atomic slot)
+    LatestMailbox(const LatestMailbox&) = delete;
+    LatestMailbox& operator=(const LatestMailbox&) = delete;
+
+    /**
+     * @brief Publish an item, replacing any item not yet taken
+     * @return true if an unconsumed item was dropped
+     */
+    bool Put(Ptr item) {
+        T* old = slot_.exchange(item.release(), std::memory_order_seq_cst);
+        const bool dropped = (old != nullptr);
+        if (dropped) {
+            Deleter{}(old);
+        }
+
+        if (waiting_.load(std::memory_order_seq_cst)) {
+            std::lock_guard<std::mutex> lock(wait_mutex_);
+            wait_cv_.notify_one();
+        }
+        return dropped;
+    }
+
+    /**
+     * @brief Take the current item without waiting (nullptr if empty)
+     */
+    [[nodiscard]] Ptr TryTake() {
+        return Ptr(slot_.exchange(nullptr, std::memory_order_seq_cst));
+    }
+
+    /**
+     * @brief Block until an item is available or the mailbox is closed
+     * @return Latest item, or nullptr once closed and empty
+     */
+    [[nodiscard]] Ptr WaitTake() {
+        while (true) {
+            if (Ptr item = TryTake()) {
+                return item;
+            }
+
+            std::unique_lock<std::mutex> lock(wait_mutex_);
+            if (closed_) {
+                return TryTake();
+            }
+
+            // Announce before re-checking the slot so a concurrent Put either
+            // is seen here or sees waiting_ and notifies under the mutex
+            waiting_.store(true, std::memory_order_seq_cst);
+            if (slot_.load(std::memory_order_seq_cst) == nullptr) {
+                wait_cv_.wait(lock);
+            }
+            waiting_.store(false, std::memory_order_seq_cst);
+        }
+    }
+
+    /**
+     * @brief Wake the consumer and make WaitTake() return once empty
+     */
+    void Close() {
+        std::lock_guard<std::mutex> lock(wait_mutex_);
+        closed_ = true;
+        wait_cv_.notify_all();
+    }
+
+    /**
+     * @brief Re-open after Close() (e.g. pipeline restart)
+     */
+    void Open() {
+        std::lock_guard<std::mutex> lock(wait_mutex_);
+        closed_ = false;
+    }
+
+    /**
+     * @brief Drop any pending item
+     */
+    void Clear() {
+        if (T* old = slot_.exchange(nullptr, std::memory_order_seq_cst)) {
+            Deleter{}(old);
+        }
+    }
+
+private:
+    std::atomic<T*> slot_{nullptr};
+    std::atomic<bool> waiting_{false};
+    std::mutex wait_mutex_;
+    std::condition_variable wait_cv_;
+    bool closed_{false};
+};
+
+}  // namespace stream_daemon
+
+#endif  // STREAM_DAEMON_LATEST_MAILBOX_H_
@@ -0,0 +1,76 @@
+#ifndef STREAM_DAEMON_MODEL_CONTEXT_H_
+#define STREAM_DAEMON_MODEL_CONTEXT_H_
+
+#include "common.h"
+
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace stream_daemon {
+
+/**
+ * @brief How a model's output tensors become detections
+ */
+enum class OutputDecoder {
+    kNone,     // Unknown layout: no detections
+    kNms,      // One on-device NMS output (boxes per class)
+    kRawYolo   // Multi-scale DFL/class/keypoint feature maps, NMS on the host
+};
+
+[[nodiscard]] std::string_view OutputDecoderToString(OutputDecoder decoder) noexcept;
+
+/**
+ * @brief What a stream declares about a model when it loads it
+ */
+struct ModelSpec {
+    std::string task{"det"};           // "det" or "pose"
+    int num_keypoints{0};              // Number of keypoints for pose model
+    std::vector<std::string> labels;   // Class labels (empty = COCO)
+    float confidence_threshold{kDefaultConfidenceThreshold};  // Requests without their own
+    float iou_threshold{kDefaultIouThreshold};                // Raw YOLO host NMS
+
+    bool operator==(const ModelSpec& other) const {
+        return task == other.task && num_keypoints == other.num_keypoints &&
+               labels == other.labels && confidence_threshold == other.confidence_threshold &&
+               iou_threshold == other.iou_threshold;
+    }
+    bool operator!=(const ModelSpec& other) const { return !(*this == other); }
+};
+
+/**
+ * @brief Immutable description of how to read one loaded model's outputs
+ *
+ * Fixed when a stream loads the model (HailoInference::GetContext): the
+ * stream's ModelSpec plus the output layout found on the device. Contexts
+ * are never modified, so any number of streams and workers parse with
+ * them concurrently; a stream whose task or labels change gets another
+ * context for the same configured network group.
+ */
+struct ModelContext {
+    std::string model_path;
+    ModelSpec spec;
+    OutputDecoder decoder{OutputDecoder::kNone};
+    int input_width{0};
+    int input_height{0};
+    int num_classes{0};               // kNms: classes in the output
+    int max_bboxes_per_class{0};      // kNms: box slots per class
+
+    /**
+     * @brief Label for a class id: spec labels, then COCO, then "object"
+     */
+    [[nodiscard]] std::string ClassName(int class_id) const;
+};
+
+/**
+ * @brief Parameters of one inference call
+ */
+struct InferenceRequest {
+    std::shared_ptr<const ModelContext> context;  // null = the model's default context
+    float confidence_threshold{-1.0f};            // < 0 = context->spec.confidence_threshold
+};
+
+}  // namespace stream_daemon
+
+#endif  // STREAM_DAEMON_MODEL_CONTEXT_H_
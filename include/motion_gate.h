@@ -0,0 +1,88 @@
+#ifndef STREAM_DAEMON_MOTION_GATE_H_
+#define STREAM_DAEMON_MOTION_GATE_H_
+
+#include "common.h"
+#include "frame_view.h"
+#include "image_ops.h"
+
+#include <chrono>
+#include <cstdint>
+#include <vector>
+
+namespace stream_daemon {
+
+/**
+ * @brief Skips inference on frames where nothing changed
+ *
+ * Each frame is reduced to a grid_width x grid_height thumbnail of mean
+ * luma (every row_step-th row, summed in 8-pixel groups with SAD; the Y
+ * plane for NV12/I420, green for RGB) and compared against a running
+ * background. The frame counts as motion when enough cells moved by more
+ * than cell_threshold. The background follows every frame at
+ * 1/2^background_shift, so lighting drifts and objects that stop are
+ * absorbed within a few seconds.
+ *
+ * Inference still runs at least every max_skip so static objects are
+ * re-confirmed. Not thread-safe (owned by one stream's frame worker).
+ */
+class MotionGate {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    struct Params {
+        int grid_width{64};
+        int grid_height{36};
+        int row_step{4};                  // Sample every Nth row inside a cell
+        int cell_threshold{10};           // Mean luma change marking a cell as changed
+        float changed_fraction{0.002f};   // Changed cells (of all) that count as motion
+        int background_shift{4};          // Background weight 1/16 per frame
+        std::chrono::milliseconds max_skip{kDefaultMotionMaxSkipMs};
+    };
+
+    MotionGate() : MotionGate(Params{}) {}
+    explicit MotionGate(Params params, SimdLevel level = DetectSimdLevel());
+
+    /**
+     * @brief Decide whether the frame needs inference
+     * @param frame Frame or inference region (RGB, NV12, I420)
+     * @param now Frame time
+     * @return true on motion, the first frame, a geometry change, or when
+     *         max_skip elapsed since the last inference
+     */
+    [[nodiscard]] bool ShouldInfer(const FrameView& frame, Clock::time_point now);
+
+    /**
+     * @brief Fraction of grid cells that changed in the last frame
+     */
+    [[nodiscard]] float GetChangedFraction() const noexcept { return changed_fraction_; }
+
+    /**
+     * @brief Forget the background (next frame always runs inference)
+     */
+    void Reset();
+
+    [[nodiscard]] SimdLevel GetSimdLevel() const noexcept { return level_; }
+
+private:
+    // Mean luma per grid cell into thumbnail_
+    void Downscale(const FrameView& frame);
+
+    Params params_;
+    SimdLevel level_;
+
+    std::vector<int32_t> column_edges_;   // grid_width + 1 cell boundaries in 8-pixel groups
+    std::vector<uint8_t> thumbnail_;
+    std::vector<int32_t> background_;     // Q4 mean luma per cell
+    std::vector<uint32_t> group_sums_;    // Per 8-pixel group, summed over a cell's rows
+    PixelFormat format_{PixelFormat::kUnknown};
+    int width_{0};
+    int height_{0};
+
+    bool has_background_{false};
+    Clock::time_point last_infer_;
+    float changed_fraction_{0.0f};
+};
+
+}  // namespace stream_daemon
+
+#endif  // STREAM_DAEMON_MOTION_GATE_H_
@@ -0,0 +1,106 @@
+#ifndef STREAM_DAEMON_PTS_FRAME_RING_H_
+#define STREAM_DAEMON_PTS_FRAME_RING_H_
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+namespace stream_daemon {
+
+/**
+ * @brief The last few frames of one pipeline branch, keyed by PTS
+ *
+ * Pairs frames across tee branches without waiting: the branch's appsink
+ * callback pushes every frame, and the consumer looks up the PTS of the
+ * frame it is processing, falling back to the newest entry when that PTS
+ * has not arrived (or was already evicted). The mutex only covers the slot
+ * bookkeeping; replaced frames are released outside it.
+ *
+ * @tparam T Nullable frame handle (e.g. FrameRef)
+ */
+template <typename T>
+class PtsFrameRing {
+public:
+    explicit PtsFrameRing(size_t capacity) : slots_(std::max<size_t>(1, capacity)) {}
+
+    // Non-copyable
+    PtsFrameRing(const PtsFrameRing&) = delete;
+    PtsFrameRing& operator=(const PtsFrameRing&) = delete;
+
+    /**
+     * @brief Add a frame, evicting the oldest once full
+     */
+    void Push(uint64_t pts, T frame) {
+        T evicted;  // Released after unlocking
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            Slot& slot = slots_[next_];
+            evicted = std::move(slot.frame);
+            slot.pts = pts;
+            slot.frame = std::move(frame);
+            next_ = (next_ + 1) % slots_.size();
+            size_ = std::min(size_ + 1, slots_.size());
+        }
+    }
+
+    /**
+     * @brief Frame with exactly this PTS, or an empty handle
+     */
+    [[nodiscard]] T Find(uint64_t pts) const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        for (size_t i = 1; i <= size_; ++i) {
+            const Slot& slot = slots_[(next_ + slots_.size() - i) % slots_.size()];
+            if (slot.pts == pts) {
+                return slot.frame;
+            }
+        }
+        return T{};
+    }
+
+    /**
+     * @brief Most recently pushed frame, or an empty handle
+     */
+    [[nodiscard]] T Latest() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (size_ == 0) {
+            return T{};
+        }
+        return slots_[(next_ + slots_.size() - 1) % slots_.size()].frame;
+    }
+
+    /**
+     * @brief Release every frame (e.g. pipeline teardown)
+     */
+    void Clear() {
+        std::vector<Slot> released(slots_.size());
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            released.swap(slots_);
+            next_ = 0;
+            size_ = 0;
+        }
+    }
+
+    [[nodiscard]] size_t Size() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return size_;
+    }
+
+private:
+    struct Slot {
+        uint64_t pts{0};
+        T frame{};
+    };
+
+    mutable std::mutex mutex_;
+    std::vector<Slot> slots_;
+    size_t next_{0};   // Slot the next Push() writes
+    size_t size_{0};
+};
+
+}  // namespace stream_daemon
+
+#endif  // STREAM_DAEMON_PTS_FRAME_RING_H_
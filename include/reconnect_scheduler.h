@@ -0,0 +1,194 @@
+#ifndef STREAM_DAEMON_RECONNECT_SCHEDULER_H_
+#define STREAM_DAEMON_RECONNECT_SCHEDULER_H_
+
+#include "common.h"
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <random>
+#include <string>
+#include <thread>
+
+namespace stream_daemon {
+
+/**
+ * @brief Backoff and concurrency limits for stream reconnects
+ */
+struct ReconnectPolicy {
+    std::chrono::milliseconds base_delay{kReconnectDelaySeconds * 1000};
+    std::chrono::milliseconds max_delay{kMaxReconnectDelaySeconds * 1000};
+    double jitter{kReconnectJitter};                     // +/- fraction of the delay
+    int max_concurrent_builds{kMaxConcurrentPipelineBuilds};
+    std::chrono::milliseconds build_timeout{kPipelineBuildTimeoutMs};
+};
+
+/**
+ * @brief Reconnect scheduler metrics
+ */
+struct ReconnectStats {
+    size_t scheduled{0};           // Waiting for their due time or a build slot
+    size_t building{0};            // Pipelines started, not yet PLAYING
+    uint64_t dispatched{0};
+    uint64_t build_timeouts{0};    // Slots released by timeout rather than completion
+};
+
+/**
+ * @brief Recovery escalation for one stream since its last good frame
+ *
+ * The first failure (error or EOS) may swap the source in place; every later
+ * one rebuilds the pipeline with backoff, until max_attempts are used up.
+ * Only a decoded frame resets it: a camera that accepts the connection and
+ * drops it again before sending a frame keeps escalating.
+ */
+class ReconnectEscalation {
+public:
+    enum class Step {
+        kSoftRestart,  // Replace only the source
+        kRebuild,      // Destroy the pipeline and rebuild after BackoffDelay(GetAttempts())
+        kGiveUp        // max_attempts reached
+    };
+
+    explicit ReconnectEscalation(int max_attempts) : max_attempts_(max_attempts) {}
+
+    /**
+     * @brief Count a failure and choose how to recover from it
+     * @param soft_restart_possible The source can be replaced in place
+     */
+    [[nodiscard]] Step OnFailure(bool soft_restart_possible);
+
+    /**
+     * @brief The stream delivered a frame: the next failure starts over
+     */
+    void Reset() noexcept { attempts_.store(0); }
+
+    /**
+     * @brief Attempts since the last good frame (1-based number of the last step)
+     */
+    [[nodiscard]] int GetAttempts() const noexcept { return attempts_.load(); }
+
+    [[nodiscard]] int GetMaxAttempts() const noexcept { return max_attempts_; }
+
+private:
+    const int max_attempts_;
+    std::atomic<int> attempts_{0};
+};
+
+/**
+ * @brief Coordinates pipeline rebuilds across all streams
+ *
+ * Each stream schedules its reconnect here instead of arming its own timer.
+ * Delays are jittered so streams dropped by the same network event do not
+ * rebuild in the same second, and at most max_concurrent_builds pipelines
+ * are negotiating RTSP at once. When several reconnects are due, streams
+ * that delivered frames most recently go first.
+ *
+ * A build holds its slot from dispatch until NotifyBuildComplete() (pipeline
+ * reached PLAYING), a new Schedule()/Cancel() for the stream, or build_timeout.
+ */
+class ReconnectScheduler {
+public:
+    /**
+     * @brief Hand a granted build off to the thread that performs it
+     *
+     * Runs on the dispatcher thread and must only hand off (e.g. post the
+     * rebuild to the stream's main loop) and return: Cancel() waits for it,
+     * and building here would race the stream's own callbacks.
+     *
+     * @return true if handed off (slot stays held), false to release the slot
+     */
+    using BuildFn = std::function<bool()>;
+
+    explicit ReconnectScheduler(ReconnectPolicy policy = {});
+    ~ReconnectScheduler();
+
+    // Non-copyable
+    ReconnectScheduler(const ReconnectScheduler&) = delete;
+    ReconnectScheduler& operator=(const ReconnectScheduler&) = delete;
+
+    /**
+     * @brief Start the dispatcher thread
+     */
+    void Start();
+
+    /**
+     * @brief Stop the dispatcher and drop pending reconnects
+     */
+    void Stop();
+
+    /**
+     * @brief Exponential backoff for the given attempt (1-based, before jitter)
+     */
+    [[nodiscard]] static std::chrono::milliseconds BackoffDelay(
+        const ReconnectPolicy& policy, int attempt);
+
+    [[nodiscard]] const ReconnectPolicy& GetPolicy() const noexcept { return policy_; }
+
+    /**
+     * @brief Schedule (or reschedule) a reconnect for a stream
+     * @param delay Delay before the build becomes due (jitter is added here)
+     * @param last_healthy_ms Last time the stream delivered frames (steady clock ms)
+     * @param build Called from the dispatcher thread once a slot is free (see BuildFn)
+     */
+    void Schedule(const std::string& stream_id,
+                  std::chrono::milliseconds delay,
+                  int64_t last_healthy_ms,
+                  BuildFn build);
+
+    /**
+     * @brief Drop a pending reconnect and release its build slot
+     *
+     * Waits for an in-progress build of this stream to return, so the
+     * caller may destroy the stream afterwards.
+     */
+    void Cancel(const std::string& stream_id);
+
+    /**
+     * @brief Release the build slot once the pipeline is up
+     */
+    void NotifyBuildComplete(const std::string& stream_id);
+
+    /**
+     * @brief Get current metrics
+     */
+    [[nodiscard]] ReconnectStats GetStats() const;
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    struct PendingReconnect {
+        Clock::time_point due;
+        int64_t last_healthy_ms{0};
+        BuildFn build;
+    };
+
+    void DispatchLoop();
+
+    // Release build slots past build_timeout; returns the earliest remaining expiry
+    Clock::time_point ExpireBuildsLocked(Clock::time_point now);
+
+    std::chrono::milliseconds ApplyJitterLocked(std::chrono::milliseconds delay);
+
+    ReconnectPolicy policy_;
+
+    std::map<std::string, PendingReconnect> pending_;
+    std::map<std::string, Clock::time_point> building_;  // stream_id -> build start
+    std::string dispatching_;                              // Build currently running
+    mutable std::mutex mutex_;
+    std::condition_variable cv_;
+
+    std::mt19937 rng_;
+    ReconnectStats stats_;
+
+    std::thread dispatcher_;
+    std::thread::id dispatcher_id_;  // Guarded by mutex_ (dispatcher_ is joined unlocked)
+    bool running_{false};  // Guarded by mutex_
+};
+
+}  // namespace stream_daemon
+
+#endif  // STREAM_DAEMON_RECONNECT_SCHEDULER_H_
@@ -0,0 +1,142 @@
+#ifndef STREAM_DAEMON_SHARED_SOURCE_H_
+#define STREAM_DAEMON_SHARED_SOURCE_H_
+
+#include <algorithm>
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "common.h"
+
+namespace stream_daemon {
+
+/**
+ * @brief Subscribers of one shared decode pipeline, held weakly
+ *
+ * The source never keeps a subscriber alive. ForEach() runs under the
+ * mutex, so once Remove() returns the subscriber gets no further calls;
+ * subscribers already destroyed are skipped and pruned on the next change.
+ *
+ * @tparam T Subscriber type
+ */
+template <typename T>
+class SubscriberSet {
+public:
+    SubscriberSet() = default;
+
+    // Non-copyable
+    SubscriberSet(const SubscriberSet&) = delete;
+    SubscriberSet& operator=(const SubscriberSet&) = delete;
+
+    void Add(const std::shared_ptr<T>& subscriber) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        RemoveLocked(subscriber.get());
+        subscribers_.push_back(subscriber);
+        has_subscribers_.store(true, std::memory_order_release);
+    }
+
+    /**
+     * @brief Stop delivering to a subscriber (waits for a running ForEach)
+     */
+    void Remove(const T* subscriber) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        RemoveLocked(subscriber);
+        has_subscribers_.store(!subscribers_.empty(), std::memory_order_release);
+    }
+
+    /**
+     * @brief Call fn(subscriber) for every live subscriber
+     *
+     * The references taken for the calls are released after unlocking, so a
+     * subscriber whose owner let go meanwhile is not destroyed under the mutex.
+     */
+    template <typename Fn>
+    void ForEach(Fn&& fn) {
+        std::vector<std::shared_ptr<T>> alive;  // Destroyed after the lock is released
+        std::lock_guard<std::mutex> lock(mutex_);
+        alive.reserve(subscribers_.size());
+        for (const auto& weak : subscribers_) {
+            if (auto subscriber = weak.lock()) {
+                fn(*subscriber);
+                alive.push_back(std::move(subscriber));
+            }
+        }
+    }
+
+    /**
+     * @brief Cheap check for the streaming thread (no lock)
+     */
+    [[nodiscard]] bool HasSubscribers() const noexcept {
+        return has_subscribers_.load(std::memory_order_acquire);
+    }
+
+    [[nodiscard]] size_t Size() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return static_cast<size_t>(std::count_if(
+            subscribers_.begin(), subscribers_.end(),
+            [](const std::weak_ptr<T>& weak) { return !weak.expired(); }));
+    }
+
+private:
+    void RemoveLocked(const T* subscriber) {
+        subscribers_.erase(
+            std::remove_if(subscribers_.begin(), subscribers_.end(),
+                           [subscriber](const std::weak_ptr<T>& weak) {
+                               const auto locked = weak.lock();
+                               return !locked || locked.get() == subscriber;
+                           }),
+            subscribers_.end());
+    }
+
+    mutable std::mutex mutex_;
+    std::vector<std::weak_ptr<T>> subscribers_;
+    std::atomic<bool> has_subscribers_{false};
+};
+
+/**
+ * @brief Move the subscribers of a departing source to one elected among them
+ *
+ * The first subscriber (in `streams` order) opens the camera itself, the
+ * rest follow it. All are stopped before any is re-pointed, then restarted,
+ * so none is ever attached to a stream that is going away.
+ *
+ * @tparam Streams Map of id -> std::shared_ptr<T>
+ * @return The elected source, nullptr if `source` had no subscribers
+ */
+template <typename Streams, typename T>
+std::shared_ptr<T> HandOverSubscribers(const Streams& streams, const T* source) {
+    std::vector<std::shared_ptr<T>> subscribers;
+    if (!source) {
+        return nullptr;
+    }
+    for (const auto& entry : streams) {
+        if (entry.second->GetSharedSource().get() == source) {
+            subscribers.push_back(entry.second);
+        }
+    }
+    if (subscribers.empty()) {
+        return nullptr;
+    }
+
+    const std::shared_ptr<T> new_source = subscribers.front();
+    for (const auto& subscriber : subscribers) {
+        subscriber->Stop();
+        subscriber->SetSharedSource(subscriber == new_source ? nullptr : new_source);
+    }
+    for (const auto& subscriber : subscribers) {
+        if (auto result = subscriber->Start(); IsError(result)) {
+            LogWarning("Failed to restart stream " + std::string(subscriber->GetStreamId()) +
+                       " after source handover: " + GetError(result));
+        }
+    }
+
+    LogInfo("Shared decode of " + std::string(source->GetStreamId()) +
+            " handed over to " + std::string(new_source->GetStreamId()));
+    return new_source;
+}
+
+}  // namespace stream_daemon
+
+#endif  // STREAM_DAEMON_SHARED_SOURCE_H_
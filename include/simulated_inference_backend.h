@@ -0,0 +1,181 @@
+#ifndef STREAM_DAEMON_SIMULATED_INFERENCE_BACKEND_H_
+#define STREAM_DAEMON_SIMULATED_INFERENCE_BACKEND_H_
+
+#include "inference_backend.h"
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace stream_daemon {
+
+/**
+ * @brief Stream layout of a model plus output tensors captured from it
+ *
+ * Stored as a small binary file (host byte order): the tensor infos, then
+ * every frame's outputs back to back.
+ */
+struct InferenceRecording {
+    std::vector<TensorInfo> inputs;
+    std::vector<TensorInfo> outputs;
+    int batch_size{1};
+    std::vector<std::vector<std::vector<uint8_t>>> frames;  // [frame][output] bytes
+
+    [[nodiscard]] static Result<InferenceRecording> Load(const std::string& path);
+    [[nodiscard]] VoidResult Save(const std::string& path) const;
+
+    /**
+     * @brief Every frame has one buffer of frame_size bytes per output
+     */
+    [[nodiscard]] VoidResult Validate() const;
+};
+
+/**
+ * @brief Timing of the simulated device
+ *
+ * Frames are run in batches of the model batch size; a batch starts once
+ * it is full or its first frame has waited batch_timeout. The device
+ * spends batch_overhead plus 1/frames_per_second per frame on a batch,
+ * one batch at a time, and a batch's outputs are ready no sooner than
+ * `latency` after it started. Write() blocks while queue_depth frames
+ * (at least one batch) are on the device.
+ */
+struct SimulatedDeviceModel {
+    std::chrono::microseconds latency{std::chrono::milliseconds(kDefaultSimulatedLatencyMs)};
+    double frames_per_second{kDefaultSimulatedFps};  // 0 = latency only
+    int queue_depth{kDefaultSimulatedQueueDepth};
+    int batch_size{0};                               // 0 = the recording's
+    std::chrono::microseconds batch_overhead{0};     // Fixed device time per batch
+    std::chrono::microseconds batch_timeout{std::chrono::milliseconds(kInferenceBatchFlushMs)};
+};
+
+/**
+ * @brief IInferenceBackend without hardware: replays recorded outputs
+ *
+ * Output frames are returned in recording order (cycling) with the timing
+ * of a SimulatedDeviceModel, so inference, batching, parsing and scheduling
+ * can be exercised and benchmarked on any Linux machine.
+ */
+class SimulatedInferenceBackend : public IInferenceBackend {
+public:
+    /**
+     * @param model Device timing
+     * @param recording_path Recording to load in Configure() (empty = the model path)
+     */
+    explicit SimulatedInferenceBackend(SimulatedDeviceModel model = {},
+                                       std::string recording_path = "");
+
+    /**
+     * @brief Replay an in-memory recording (Configure() ignores the model path)
+     */
+    SimulatedInferenceBackend(InferenceRecording recording, SimulatedDeviceModel model);
+
+    ~SimulatedInferenceBackend() override = default;
+
+    // Non-copyable
+    SimulatedInferenceBackend(const SimulatedInferenceBackend&) = delete;
+    SimulatedInferenceBackend& operator=(const SimulatedInferenceBackend&) = delete;
+
+    [[nodiscard]] VoidResult Configure(const std::string& model_path) override;
+
+    [[nodiscard]] const std::vector<TensorInfo>& GetInputs() const override {
+        return recording_.inputs;
+    }
+    [[nodiscard]] const std::vector<TensorInfo>& GetOutputs() const override {
+        return recording_.outputs;
+    }
+    [[nodiscard]] int GetBatchSize() const override {
+        return model_.batch_size > 0 ? model_.batch_size : recording_.batch_size;
+    }
+
+    [[nodiscard]] VoidResult Write(const uint8_t* data, size_t size) override;
+    [[nodiscard]] VoidResult Read(size_t index, uint8_t* data, size_t size) override;
+
+    [[nodiscard]] std::string_view GetName() const noexcept override { return "simulated"; }
+
+    /**
+     * @brief Batches the device has run (full or timed out)
+     */
+    [[nodiscard]] uint64_t GetBatchesRun() const;
+
+    /**
+     * @brief Frames written so far
+     */
+    [[nodiscard]] uint64_t GetFramesWritten() const;
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    struct QueuedFrame {
+        size_t recording_index;
+        Clock::time_point written;
+        std::optional<Clock::time_point> ready;  // Set when its batch starts
+    };
+
+    // Start the open batch (the last open_frames_ frames) at `now` (mutex_ held)
+    void StartBatch(Clock::time_point now);
+
+    SimulatedDeviceModel model_;
+    std::string recording_path_;
+    InferenceRecording recording_;
+    bool preloaded_{false};
+
+    mutable std::mutex mutex_;
+    std::condition_variable cv_;
+    std::deque<QueuedFrame> queue_;       // Written, not fully read
+    size_t open_frames_{0};               // Trailing frames waiting for their batch
+    std::optional<Clock::time_point> device_free_;  // End of the last batch's device time
+    size_t next_recording_index_{0};
+    uint64_t frames_written_{0};
+    uint64_t batches_run_{0};
+};
+
+/**
+ * @brief Passes through to another backend and saves the first outputs it reads
+ *
+ * The recording (stream layout plus max_frames frames) is written to path
+ * once complete, for later replay by SimulatedInferenceBackend.
+ */
+class RecordingInferenceBackend : public IInferenceBackend {
+public:
+    RecordingInferenceBackend(std::unique_ptr<IInferenceBackend> inner,
+                              std::string path,
+                              int max_frames = kDefaultRecordingFrames);
+
+    [[nodiscard]] VoidResult Configure(const std::string& model_path) override;
+
+    [[nodiscard]] const std::vector<TensorInfo>& GetInputs() const override {
+        return inner_->GetInputs();
+    }
+    [[nodiscard]] const std::vector<TensorInfo>& GetOutputs() const override {
+        return inner_->GetOutputs();
+    }
+    [[nodiscard]] int GetBatchSize() const override { return inner_->GetBatchSize(); }
+
+    [[nodiscard]] VoidResult Write(const uint8_t* data, size_t size) override {
+        return inner_->Write(data, size);
+    }
+    [[nodiscard]] VoidResult Read(size_t index, uint8_t* data, size_t size) override;
+
+    [[nodiscard]] std::string_view GetName() const noexcept override { return inner_->GetName(); }
+
+private:
+    std::unique_ptr<IInferenceBackend> inner_;
+    std::string path_;
+    size_t max_frames_;
+
+    // Reader thread only
+    InferenceRecording recording_;
+    std::vector<std::vector<uint8_t>> current_;  // Outputs of the frame being read
+    bool done_{false};
+};
+
+}  // namespace stream_daemon
+
+#endif  // STREAM_DAEMON_SIMULATED_INFERENCE_BACKEND_H_
@@ -0,0 +1,116 @@
+#ifndef STREAM_DAEMON_SNAPSHOT_STREAM_H_
+#define STREAM_DAEMON_SNAPSHOT_STREAM_H_
+
+#include "common.h"
+#include "frame_buffer.h"
+#include "teardown_executor.h"
+
+#include <gst/gst.h>
+
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+
+namespace stream_daemon {
+
+/**
+ * @brief On-demand decode of a camera's main stream for snapshots and event images
+ *
+ * Inference runs on a low-resolution substream; this pipeline is only
+ * opened when a full-resolution image is wanted (Touch()) and closed again
+ * after an idle period, so the main stream is not decoded continuously.
+ * Until the first frame arrives callers fall back to the inference frame.
+ *
+ * Opening (parse, state change to PLAYING) runs on the teardown executor
+ * like closing does; the frame worker picks the pipeline up on a later
+ * call and never blocks on the camera.
+ *
+ * Not thread-safe: owned and driven by the stream's frame worker.
+ */
+class SnapshotStream {
+public:
+    /**
+     * @param pipeline_description gst_parse_launch string ending in "appsink name=sink"
+     * @param teardown_executor Runs the blocking open and NULL state change (may be null)
+     */
+    SnapshotStream(std::string pipeline_description,
+                   std::shared_ptr<TeardownExecutor> teardown_executor);
+    ~SnapshotStream();
+
+    // Non-copyable
+    SnapshotStream(const SnapshotStream&) = delete;
+    SnapshotStream& operator=(const SnapshotStream&) = delete;
+
+    /**
+     * @brief Mark the stream as needed now; starts opening it if closed (after retry backoff)
+     */
+    void Touch();
+
+    /**
+     * @brief Latest decoded frame, or nullptr if none newer than max_age
+     */
+    [[nodiscard]] FrameRef Latest(std::chrono::milliseconds max_age);
+
+    /**
+     * @brief Close if not touched for the given period
+     */
+    void CloseIfIdle(std::chrono::milliseconds idle);
+
+    /**
+     * @brief Close now (teardown runs on the executor; an open in progress is discarded)
+     */
+    void Close();
+
+    [[nodiscard]] bool IsOpen() const noexcept { return pipeline_ != nullptr; }
+
+private:
+    // Hand-off from the open job to the frame worker
+    struct PendingOpen {
+        std::mutex mutex;
+        bool done{false};
+        bool cancelled{false};
+        GstElement* pipeline{nullptr};
+        GstElement* sink{nullptr};
+        std::string error;
+    };
+
+    void StartOpen();
+
+    // Adopt a finished open (pipeline or error); no-op while still opening
+    void CollectOpen();
+
+    // Build and start the pipeline (blocking; runs on the executor)
+    [[nodiscard]] static VoidResult Launch(const std::string& description,
+                                           GstElement*& pipeline, GstElement*& sink);
+
+    // Set NULL and release (blocking)
+    static void Teardown(GstElement* pipeline, GstElement* sink, GstBus* bus,
+                         std::chrono::milliseconds timeout);
+
+    // Run on the executor (TeardownExecutor::SubmitOrSpawn)
+    void Dispatch(std::string label, TeardownExecutor::Job job);
+
+    // Stop on ERROR/EOS (no bus watch: polled from Latest())
+    void CheckBus();
+
+    std::string pipeline_description_;
+    std::shared_ptr<TeardownExecutor> teardown_executor_;
+
+    GstElement* pipeline_{nullptr};
+    GstElement* sink_{nullptr};
+    GstBus* bus_{nullptr};
+    std::shared_ptr<PendingOpen> opening_;
+
+    FrameGeometryCache geometry_;
+    FrameRef latest_;
+    int64_t latest_ms_{0};
+    int64_t last_used_ms_{0};
+    int64_t retry_after_ms_{0};
+    int64_t open_started_ms_{0};
+};
+
+}  // namespace stream_daemon
+
+#endif  // STREAM_DAEMON_SNAPSHOT_STREAM_H_
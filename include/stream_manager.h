@@ -2,8 +2,12 @@
 #define STREAM_DAEMON_STREAM_MANAGER_H_
 
 #include "common.h"
+#include "device_pool.h"
 #include "nats_publisher.h"
+#include "inference_scheduler.h"
+#include "reconnect_scheduler.h"
 #include "stream_processor.h"
+#include "teardown_executor.h"
 
 #include <glib.h>
 
@@ -15,6 +19,7 @@
 #include <set>
 #include <string>
 #include <thread>
+#include <unordered_map>
 #include <vector>
 
 namespace stream_daemon {
@@ -29,9 +34,16 @@ class StreamManager {
 public:
     /**
      * @brief Factory method with error handling
+     * @param inference_max_in_flight Frames all streams may have on the NPU at
+     *        once (0 = no InferenceScheduler, streams reach the device unordered)
+     * @param device_ids Accelerators streams are placed on (empty = default device)
+     * @param max_model_replicas Devices one model may be configured on (0 = all)
      */
     [[nodiscard]] static Result<std::unique_ptr<StreamManager>> Create(
-        std::string_view nats_url = kDefaultNatsUrl);
+        std::string_view nats_url = kDefaultNatsUrl,
+        int inference_max_in_flight = kDefaultSchedulerMaxInFlight,
+        std::vector<std::string> device_ids = {},
+        int max_model_replicas = 0);
 
     // Non-copyable, non-movable
     StreamManager(const StreamManager&) = delete;
@@ -114,6 +126,27 @@ public:
      */
     [[nodiscard]] std::optional<std::vector<uint8_t>> GetSnapshot(std::string_view stream_id) const;
 
+    /**
+     * @brief Get pipeline teardown executor metrics
+     */
+    [[nodiscard]] TeardownStats GetTeardownStats() const;
+
+    /**
+     * @brief Get reconnect scheduler metrics
+     */
+    [[nodiscard]] ReconnectStats GetReconnectStats() const;
+
+    /**
+     * @brief Get per-stream inference scheduler metrics (empty without a scheduler)
+     */
+    [[nodiscard]] std::unordered_map<std::string, InferenceScheduler::StreamStats>
+    GetInferenceSchedulerStats() const;
+
+    /**
+     * @brief Get per-device utilisation and placement metrics
+     */
+    [[nodiscard]] std::vector<DevicePool::DeviceStats> GetDeviceStats() const;
+
     /**
      * @brief Get NATS publisher (for direct access if needed)
      */
@@ -169,7 +202,8 @@ public:
     void SetGlobalErrorCallback(ErrorCallback callback);
 
 private:
-    explicit StreamManager(std::shared_ptr<NatsPublisher> nats_publisher);
+    StreamManager(std::shared_ptr<NatsPublisher> nats_publisher, int inference_max_in_flight,
+                  std::shared_ptr<DevicePool> device_pool);
 
     /**
      * @brief Main loop thread function
@@ -181,8 +215,29 @@ private:
      */
     void ApplyCallbacks(StreamProcessor* processor);
 
+    /**
+     * @brief Stream whose pipeline can feed the given stream (same URL), or nullptr
+     */
+    [[nodiscard]] std::shared_ptr<StreamProcessor> FindSharedSourceLocked(
+        const StreamInfo& info, std::string_view exclude_id) const;
+
+    /**
+     * @brief Move the subscribers of a source to a new source (see HandOverSubscribers)
+     */
+    void RehomeSubscribersLocked(const StreamProcessor* source);
+
+    /**
+     * @brief Stop subscribers before sources, then destroy all processors
+     */
+    void StopAllStreamsLocked();
+
+    /**
+     * @brief Move streams between devices after the stream set changed
+     */
+    void RebalanceDevices();
+
     // Stream storage
-    std::map<std::string, std::unique_ptr<StreamProcessor>, std::less<>> streams_;
+    std::map<std::string, std::shared_ptr<StreamProcessor>, std::less<>> streams_;
     mutable std::mutex streams_mutex_;
 
     // Streams being removed (防御 code for rapid remove/add)
@@ -191,6 +246,18 @@ private:
     // NATS publisher (shared among all streams)
     std::shared_ptr<NatsPublisher> nats_publisher_;
 
+    // Bounded pool for blocking pipeline teardown (shared among all streams)
+    std::shared_ptr<TeardownExecutor> teardown_executor_;
+
+    // Staggered reconnects with a global cap on concurrent pipeline builds
+    std::shared_ptr<ReconnectScheduler> reconnect_scheduler_;
+
+    // Fair-share admission of all streams' frames to the NPU (null = off)
+    std::shared_ptr<InferenceScheduler> inference_scheduler_;
+
+    // Places streams' models on the accelerators by measured utilisation
+    std::shared_ptr<DevicePool> device_pool_;
+
     // GLib main loop
     GMainLoop* main_loop_{nullptr};
     GMainContext* main_context_{nullptr};
@@ -1,21 +1,38 @@
 #ifndef STREAM_DAEMON_STREAM_PROCESSOR_H_
 #define STREAM_DAEMON_STREAM_PROCESSOR_H_
 
+#include "callback_guard.h"
 #include "common.h"
+#include "decode_skip_controller.h"
+#include "device_pool.h"
+#include "frame_buffer.h"
+#include "frame_decimator.h"
+#include "latency_stats.h"
+#include "latest_mailbox.h"
+#include "motion_gate.h"
 #include "nats_publisher.h"
+#include "pts_frame_ring.h"
 #include "hailo_inference.h"
 #include "batch_inference_manager.h"
 #include "event_compositor.h"
+#include "inference_scheduler.h"
+#include "reconnect_scheduler.h"
+#include "shared_source.h"
+#include "snapshot_stream.h"
+#include "teardown_executor.h"
 
 #include <gst/gst.h>
 
 #include <atomic>
 #include <chrono>
+#include <functional>
+#include <future>
 #include <memory>
 #include <mutex>
 #include <optional>
 #include <string>
 #include <thread>
+#include <vector>
 
 namespace stream_daemon {
 
@@ -24,15 +41,24 @@ namespace stream_daemon {
  *
  * Manages a single GStreamer pipeline for RTSP stream processing
  * with Hailo NPU inference. Thread-safe and supports automatic reconnection.
+ * Always owned by a shared_ptr: subscribers of a shared decode hold their
+ * source weakly and register themselves with weak_from_this().
  */
-class StreamProcessor {
+class StreamProcessor : public std::enable_shared_from_this<StreamProcessor> {
 public:
     /**
      * @brief Factory method with error handling
+     * @param main_context Context whose loop runs bus messages, reconnects and
+     *        health-check recovery (nullptr = global default context)
      */
-    [[nodiscard]] static Result<std::unique_ptr<StreamProcessor>> Create(
+    [[nodiscard]] static Result<std::shared_ptr<StreamProcessor>> Create(
         const StreamInfo& info,
-        std::shared_ptr<NatsPublisher> nats_publisher);
+        std::shared_ptr<NatsPublisher> nats_publisher,
+        std::shared_ptr<TeardownExecutor> teardown_executor = nullptr,
+        std::shared_ptr<ReconnectScheduler> reconnect_scheduler = nullptr,
+        std::shared_ptr<InferenceScheduler> inference_scheduler = nullptr,
+        std::shared_ptr<DevicePool> device_pool = nullptr,
+        GMainContext* main_context = nullptr);
 
     // Non-copyable, non-movable (due to GStreamer callbacks)
     StreamProcessor(const StreamProcessor&) = delete;
@@ -106,6 +132,43 @@ public:
      */
     [[nodiscard]] std::string_view GetModelId() const noexcept { return model_id_; }
 
+    /**
+     * @brief Get RTSP URL
+     */
+    [[nodiscard]] const std::string& GetRtspUrl() const noexcept { return rtsp_url_; }
+
+    /**
+     * @brief Get inference substream URL (empty = rtsp_url)
+     */
+    [[nodiscard]] const std::string& GetInferenceUrl() const noexcept { return inference_url_; }
+
+    /**
+     * @brief Receive decoded frames from another stream instead of opening the RTSP URL
+     *
+     * Takes effect on the next Start(); nullptr restores a private pipeline.
+     * Held weakly: StreamManager moves subscribers to a new source before
+     * dropping the old one, and a subscriber whose source is gone just
+     * stops receiving frames.
+     */
+    void SetSharedSource(const std::shared_ptr<StreamProcessor>& source);
+    [[nodiscard]] std::shared_ptr<StreamProcessor> GetSharedSource() const;
+
+    /**
+     * @brief True if this stream's decode pipeline can feed the given stream
+     *
+     * Same URL and both single-branch: the shared frames are full decoded
+     * RGB, which any model letterboxes itself.
+     */
+    [[nodiscard]] bool CanShareSourceWith(const StreamInfo& info) const;
+
+    /**
+     * @brief Run this stream's model on another device's instance (DevicePool move)
+     *
+     * Taken over by the frame worker before its next frame; a frame already
+     * on the old device finishes there.
+     */
+    void SetInferencePlacement(std::shared_ptr<HailoInference> inference);
+
     // Callback setters
     void SetDetectionCallback(DetectionCallback callback);
     void SetStateChangeCallback(StateChangeCallback callback);
@@ -114,7 +177,76 @@ public:
 private:
     explicit StreamProcessor(
         const StreamInfo& info,
-        std::shared_ptr<NatsPublisher> nats_publisher);
+        std::shared_ptr<NatsPublisher> nats_publisher,
+        std::shared_ptr<TeardownExecutor> teardown_executor,
+        std::shared_ptr<ReconnectScheduler> reconnect_scheduler,
+        std::shared_ptr<InferenceScheduler> inference_scheduler,
+        std::shared_ptr<DevicePool> device_pool,
+        GMainContext* main_context);
+
+    /**
+     * @brief Start()/Stop() bodies; caller holds loop_guard_ (or runs in a loop callback)
+     */
+    [[nodiscard]] VoidResult StartLocked();
+    void StopLocked();
+
+    /**
+     * @brief Run fn on the main loop after delay, unless the stream is stopped first
+     * @return Source ID in main_context_
+     */
+    guint PostToMainLoop(std::function<void(StreamProcessor&)> fn,
+                         std::chrono::milliseconds delay = std::chrono::milliseconds(0));
+
+    /**
+     * @brief Destroy a source attached to main_context_
+     */
+    void RemoveLoopSource(guint& source_id);
+
+    /**
+     * @brief Acquire the shared HailoInference instance (and batch manager) for hef_path_
+     */
+    [[nodiscard]] VoidResult InitInference();
+
+    /**
+     * @brief Use an instance: this stream's context on it and its batch manager
+     */
+    void AttachInference(std::shared_ptr<HailoInference> inference);
+
+    /**
+     * @brief Switch to the instance SetInferencePlacement left (frame worker only)
+     */
+    void ApplyPendingPlacement();
+
+    /**
+     * @brief Wait for this stream's turn on the NPU
+     * @param slots Inferences the frame runs (one per crop when tiled)
+     * @return false when the frame waited past inference_deadline_ms or the
+     *         worker is being stopped (drop it)
+     */
+    [[nodiscard]] bool AcquireInferenceSlot(InferenceScheduler::Lease& lease, int slots = 1);
+
+    /**
+     * @brief Start as a subscriber of shared_source_ (no pipeline of our own)
+     */
+    [[nodiscard]] VoidResult StartShared();
+
+    /**
+     * @brief Subscriber registration on the source stream
+     */
+    void AddSubscriber(const std::shared_ptr<StreamProcessor>& subscriber) {
+        subscribers_.Add(subscriber);
+    }
+    void RemoveSubscriber(const StreamProcessor* subscriber) { subscribers_.Remove(subscriber); }
+
+    /**
+     * @brief Hand a decoded sample to every subscriber (source streaming thread)
+     */
+    void FanOut(GstSample* sample, int64_t capture_ms);
+
+    /**
+     * @brief Subscriber side of FanOut: count, decimate, queue for the frame worker
+     */
+    void DeliverSample(GstSample* sample, int64_t capture_ms);
 
     /**
      * @brief Create GStreamer pipeline
@@ -132,24 +264,161 @@ private:
     [[nodiscard]] std::string BuildPipelineString() const;
 
     /**
-     * @brief Schedule reconnection attempt
+     * @brief URL decoded by the pipeline (inference substream if configured)
+     */
+    [[nodiscard]] const std::string& PipelineUrl() const noexcept {
+        return inference_url_.empty() ? rtsp_url_ : inference_url_;
+    }
+
+    /**
+     * @brief Main stream decoded on demand for snapshots ("" = use inference frames)
+     */
+    [[nodiscard]] std::string SnapshotUrl() const;
+
+    /**
+     * @brief Launch string for the on-demand snapshot pipeline
+     */
+    [[nodiscard]] std::string BuildSnapshotPipelineString() const;
+
+    /**
+     * @brief True when the pipeline uses separate inference and preview branches
+     */
+    [[nodiscard]] bool UseDualBranch() const;
+
+    /**
+     * @brief Part of the frame inference runs on (roi_crop: event regions plus margin)
+     */
+    [[nodiscard]] BoundingBox InferenceRegion(int width, int height) const;
+
+    /**
+     * @brief Tiled-mode regions for a frame size: the full frame, then the tiles
+     *
+     * Recomputed only when the frame size changes (frame worker only).
+     */
+    const std::vector<BoundingBox>& InferenceTiles(int width, int height);
+
+    /**
+     * @brief Keep the latest inference result for frames the motion gate skips
+     *
+     * Called from the frame worker and the batch worker (full-frame pixels).
+     */
+    void RememberDetections(const std::vector<Detection>& detections);
+
+    /**
+     * @brief Preview frame paired with an inference frame (never waits)
+     * @return Preview frame with the same PTS, else the newest one (may be null)
+     */
+    [[nodiscard]] FrameRef PreviewFrameFor(GstSample* sample) const;
+
+    /**
+     * @brief Recover from a failure (error, EOS, stalled stream, failed rebuild)
+     *
+     * Follows escalation_: a source failure that is the first since the last
+     * good frame swaps rtspsrc in place; otherwise the pipeline is destroyed
+     * and rebuilt with backoff, and the stream goes to kError once
+     * kMaxReconnectAttempts are used up.
+     *
+     * @param source_failure The failure came from rtspsrc (soft restart may help)
+     * @param first_delay Caps the delay of the first rebuild since the last
+     *        good frame (0 = backoff only)
+     */
+    void RecoverFromFailure(std::string_view reason, bool source_failure,
+                            std::chrono::milliseconds first_delay = std::chrono::milliseconds(0));
+
+    /**
+     * @brief Schedule the pipeline rebuild after a delay
      */
-    void ScheduleReconnect();
+    void ScheduleReconnectAfter(std::chrono::milliseconds delay);
 
     /**
      * @brief Cancel scheduled reconnection
      */
     void CancelReconnect();
 
+    /**
+     * @brief Reconnect attempt (main loop, after the scheduler granted a slot or the timer fired)
+     */
+    void RunReconnect();
+
+    /**
+     * @brief Create an rtspsrc configured like the launch string
+     */
+    [[nodiscard]] GstElement* CreateSourceElement(const std::string& url) const;
+
+    /**
+     * @brief Replace only rtspsrc; depay/parse/decoder/appsink stay PLAYING
+     */
+    [[nodiscard]] VoidResult SoftRestartSource(const std::string& url);
+
+    /**
+     * @brief True if the message was posted by rtspsrc or one of its children
+     */
+    [[nodiscard]] bool IsSourceMessage(GstMessage* msg) const;
+
+    /**
+     * @brief Start the time-to-first-frame clock (no-op if already running)
+     */
+    void MarkReconnectStart();
+
     /**
      * @brief Process detections from Hailo inference
      */
-    void ProcessDetections(GstBuffer* buffer);
+    void ProcessDetections(const CapturedSample& captured);
+
+    /**
+     * @brief Start the per-stream frame worker (drains frame_mailbox_)
+     */
+    void StartFrameWorker();
+
+    /**
+     * @brief Ask the worker to exit after its current frame, without waiting
+     *
+     * A frame still waiting for its NPU turn is dropped rather than holding
+     * up the join for a whole scheduler deadline.
+     *
+     * @return The worker thread, for the caller to join off the main loop
+     */
+    [[nodiscard]] std::thread StopFrameWorker();
+
+    /**
+     * @brief Block until the last worker has left FrameWorkerLoop
+     *
+     * The worker owns the per-pipeline frame state (geometry, preview sink,
+     * batch registration, snapshot stream) and resets it on exit, so nothing
+     * it reads may be rebuilt or reconfigured before this returns.
+     */
+    void WaitFrameWorkerExit();
+    void FrameWorkerLoop();
 
     /**
      * @brief Update FPS calculation
+     * @return true when a new one-second window was closed
+     */
+    bool UpdateFps();
+
+    /**
+     * @brief Capture time of a frame (Unix ms)
+     *
+     * RTCP sender-report NTP time from the reference timestamp meta when the
+     * source provides it, otherwise now minus the buffer's age in the pipeline.
+     * Streaming thread only: `sink` is the appsink the sample was pulled from.
+     */
+    static int64_t CaptureTimeMs(GstSample* sample, GstElement* sink);
+
+    /**
+     * @brief Stamp publish time and record capture -> publish latency
+     */
+    void MarkPublished(DetectionEvent& event);
+
+    /**
+     * @brief Re-evaluate decode skipping once per FPS window
+     */
+    void UpdateDecodeSkip();
+
+    /**
+     * @brief Ask the decoder to skip frames until the next one inference needs
      */
-    void UpdateFps();
+    void SendDecodeSkipQos(GstSample* sample, double target_fps);
 
     /**
      * @brief Set state and notify callbacks
@@ -163,13 +432,21 @@ private:
 
     // GStreamer callbacks (static to be compatible with C callbacks)
     static GstFlowReturn OnNewSample(GstElement* sink, gpointer user_data);
+    static GstFlowReturn OnPreviewSample(GstElement* sink, gpointer user_data);
     static gboolean OnBusMessage(GstBus* bus, GstMessage* msg, gpointer user_data);
+    static void HandleBusMessage(StreamProcessor* self, GstMessage* msg);
+#ifdef HAVE_HAILORT
     static GstPadProbeReturn OnHailoProbe(GstPad* pad, GstPadProbeInfo* info, gpointer user_data);
-    static gboolean OnReconnectTimeout(gpointer user_data);
+#endif
+    static GstPadProbeReturn OnSourceCapsProbe(GstPad* pad, GstPadProbeInfo* info, gpointer user_data);
+    static GstPadProbeReturn OnDecoderInputProbe(GstPad* pad, GstPadProbeInfo* info, gpointer user_data);
+    static void OnSourcePadAdded(GstElement* src, GstPad* pad, gpointer user_data);
 
     // Stream info
     std::string stream_id_;
     std::string rtsp_url_;
+    std::string inference_url_;
+    std::string snapshot_url_;
     std::string hef_path_;
     std::string model_id_;
     StreamConfig config_;
@@ -179,14 +456,36 @@ private:
     int num_keypoints_{0};                // Number of keypoints for pose model
     std::vector<std::string> labels_;     // Class labels
 
-    // GStreamer elements
+    // GStreamer elements. Set and cleared only by the thread that builds and
+    // destroys the pipeline (Start/Stop callers, the main loop). The frame
+    // worker reads none of them but preview_sink_, which it clears when it
+    // exits; DestroyPipeline() frees that one only after joining the worker.
+    // Streaming-thread callbacks use their own element argument, plus
+    // appsink_pad_ until DestroyPipeline() has drained active_callbacks_.
     GstElement* pipeline_{nullptr};
     GstElement* appsink_{nullptr};
+    GstElement* preview_sink_{nullptr};      // Dual-branch only (JPEG/snapshot branch)
+    GstPad* source_caps_pad_{nullptr};       // Dual-branch only (tee sink pad)
+    gulong source_caps_probe_id_{0};
+    GstPad* decoder_pad_{nullptr};           // avdec_h264 sink pad (encoded frame rate)
+    gulong decoder_probe_id_{0};
+    GstPad* appsink_pad_{nullptr};           // Upstream QoS events are pushed from here
     GstBus* bus_{nullptr};
-    guint bus_watch_id_{0};
+    guint bus_watch_id_{0};                  // Sources in main_context_
     guint reconnect_source_id_{0};
     gulong hailo_probe_id_{0};
 
+    // Shared decode: streams on the same URL subscribe to one source pipeline
+    mutable std::mutex source_mutex_;                 // Guards the two links below
+    std::weak_ptr<StreamProcessor> shared_source_;    // Configured source (next Start)
+    std::weak_ptr<StreamProcessor> attached_source_;  // Source we are subscribed to
+    SubscriberSet<StreamProcessor> subscribers_;      // Source side
+
+    // Frame worker: streaming thread hands off samples, worker processes the latest
+    LatestMailbox<CapturedSample, CapturedSampleDeleter> frame_mailbox_;
+    std::thread frame_worker_;
+    std::shared_future<void> frame_worker_exited_;  // Ready once FrameWorkerLoop returned
+
     // Health check thread
     std::thread health_check_thread_;
     std::atomic<bool> health_check_running_{false};
@@ -194,13 +493,33 @@ private:
     // NATS publisher (shared)
     std::shared_ptr<NatsPublisher> nats_publisher_;
 
+    // Pipeline teardown pool (shared, owned by StreamManager; may be null)
+    std::shared_ptr<TeardownExecutor> teardown_executor_;
+
+    // Cross-stream reconnect coordination (shared, owned by StreamManager; may be null)
+    std::shared_ptr<ReconnectScheduler> reconnect_scheduler_;
+
+    // Fair-share NPU admission across streams and models (shared, owned by StreamManager; may be null)
+    std::shared_ptr<InferenceScheduler> inference_scheduler_;
+
+    // Accelerator placement of this stream's model (shared, owned by StreamManager; may be null)
+    std::shared_ptr<DevicePool> device_pool_;
+
     // State
     std::atomic<StreamState> state_{StreamState::kStopped};
     std::atomic<bool> stopping_{false};  // Set true during cleanup to block callbacks
     std::atomic<int> active_callbacks_{0};  // Count of callbacks currently running
-    std::atomic<bool> processing_frame_{false};  // Skip frames while processing
+    std::atomic<uint64_t> dropped_frames_{0};     // Mailbox replacements (latest frame wins)
+    std::atomic<uint64_t> motion_skipped_{0};     // Frames the motion gate did not infer
+    FrameDecimator inference_decimator_;          // Streaming thread only
+    DecodeSkipController decode_skip_;            // Decoder input thread only
+    std::atomic<double> decode_skip_fps_{0.0};    // 0 = decoder runs at camera rate
+    std::atomic<double> process_ms_{0.0};         // Frame worker time per frame (EWMA)
+    LatencyTracker queue_latency_;                // Capture -> frame worker
+    LatencyTracker publish_latency_;              // Capture -> publish
     std::atomic<uint64_t> frame_count_{0};
     std::atomic<int64_t> last_frame_time_{0};      // 마지막 프레임 수신 시간 (ms)
+    std::atomic<int64_t> last_healthy_time_{0};    // 마지막 실제 프레임 시간 (reconnect priority)
     std::atomic<int64_t> last_detection_time_{0};
     std::string last_error_;
     mutable std::mutex error_mutex_;
@@ -211,8 +530,16 @@ private:
     uint64_t frames_since_last_update_{0};
     std::atomic<double> current_fps_{0.0};
 
+    // Main loop: bus watch, reconnect and recovery jobs run here, serialized
+    // with Start/Stop/Update by loop_guard_ and dropped once the stream stops
+    GMainContext* main_context_{nullptr};
+    CallbackGuard<StreamProcessor> loop_guard_{this};
+
     // Reconnection
-    int reconnect_attempts_{0};
+    ReconnectEscalation escalation_{kMaxReconnectAttempts};  // Reset by the first good frame
+    std::atomic<int64_t> reconnect_started_ms_{0};     // 0 = no reconnect in progress
+    std::atomic<int64_t> last_reconnect_ttff_ms_{-1};
+    std::atomic<uint64_t> soft_restarts_{0};
     static constexpr int kMaxReconnectAttempts = 10;
 
     // Callbacks
@@ -221,28 +548,70 @@ private:
     ErrorCallback error_callback_;
     mutable std::mutex callback_mutex_;
 
-    // Snapshot storage (latest JPEG frame)
-    std::vector<uint8_t> last_snapshot_;
+    // Snapshot storage (latest JPEG frame, shared with published events)
+    JpegBlob last_snapshot_;
     mutable std::mutex snapshot_mutex_;
+    int64_t last_snapshot_ms_{0};         // When last_snapshot_ was encoded (frame worker only)
+
+    // Main-stream decode for snapshots/event images (frame worker only)
+    std::unique_ptr<SnapshotStream> snapshot_stream_;
+    mutable std::atomic<int64_t> snapshot_requested_ms_{0};
     int frame_width_{0};
     int frame_height_{0};
 
+    // Tiled mode regions and the frame size they were computed for (frame worker only)
+    std::vector<BoundingBox> inference_tiles_;
+    int tiles_width_{0};
+    int tiles_height_{0};
+
+    // Motion gating (gate: frame worker only; detections shared with the batch worker)
+    std::unique_ptr<MotionGate> motion_gate_;
+    std::vector<Detection> last_inferred_detections_;
+    std::mutex motion_mutex_;
+
+    // Appsink frame layouts (re-parsed only on caps change)
+    FrameGeometryCache frame_geometry_;      // Frame worker
+    FrameGeometryCache preview_geometry_;    // Preview appsink streaming thread
+
+    // Dual-branch: decoded source geometry (from caps event) and recent preview frames
+    std::atomic<int> source_width_{0};
+    std::atomic<int> source_height_{0};
+    PtsFrameRing<FrameRef> preview_ring_{kPreviewRingSize};
+
     // Hailo detection storage (from probe)
     std::vector<Detection> pending_detections_;
     mutable std::mutex detection_mutex_;
 
     // HailoRT direct inference (when HEF is specified)
-    // Shared instance for efficient multi-stream processing
+    // Shared instance for efficient multi-stream processing; replaced only
+    // while the frame worker is stopped or by the worker itself, under
+    // placement_mutex_ (GetStatus reads it from other threads)
     std::shared_ptr<HailoInference> hailo_inference_;
 
+    // Instance on the device DevicePool moved this stream to (until applied)
+    std::shared_ptr<HailoInference> pending_inference_;
+    mutable std::mutex placement_mutex_;
+
+    // This stream's task/keypoints/labels, sent with every inference request
+    std::shared_ptr<const ModelContext> model_context_;
+
     // Batch inference manager (for batch > 1 models)
     std::shared_ptr<BatchInferenceManager> batch_manager_;
 
+    // Per-frame context carried to event publishing (sync path or batch callback)
+    struct EventFrame {
+        JpegBlob jpeg;
+        int width{0};            // Geometry detections come back in
+        int height{0};
+        int report_width{0};     // Geometry events are reported in (attached image)
+        int report_height{0};
+        int64_t capture_ms{0};
+    };
+
     // Helper for batch inference callback
     void OnBatchResult(const std::string& stream_id,
                        std::vector<Detection> detections,
-                       const std::vector<uint8_t>& jpeg_data,
-                       int width, int height);
+                       const EventFrame& frame);
 
     // Event compositor (이벤트 설정 및 감지)
     std::unique_ptr<EventCompositor> event_compositor_;
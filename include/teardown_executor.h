@@ -0,0 +1,141 @@
+#ifndef STREAM_DAEMON_TEARDOWN_EXECUTOR_H_
+#define STREAM_DAEMON_TEARDOWN_EXECUTOR_H_
+
+#include "common.h"
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+
+namespace stream_daemon {
+
+/**
+ * @brief Teardown executor metrics
+ */
+struct TeardownStats {
+    size_t pending{0};             // Queued, not yet started
+    size_t active{0};              // Currently running (on a worker not yet retired)
+    size_t peak_pending{0};        // High-water mark of pending
+    uint64_t completed{0};
+    uint64_t timed_out{0};         // Jobs that ran longer than the job timeout
+    uint64_t abandoned{0};         // Jobs given up on (worker retired and replaced)
+    size_t wedged{0};              // Retired workers whose job is still running
+    uint64_t rejected{0};          // Submit() refused because the queue was full
+    int64_t last_duration_ms{0};
+    int64_t max_duration_ms{0};
+};
+
+/**
+ * @brief Fixed-size worker pool for blocking pipeline teardown
+ *
+ * gst_element_set_state(GST_STATE_NULL) on an unresponsive RTSP source can
+ * block for seconds. Teardowns are queued here instead of spawning one
+ * detached thread each, so a burst of reconnects (e.g. NVR reboot) costs at
+ * most num_workers threads. Jobs run on the workers themselves and get the
+ * timeout to bound their own blocking waits (gst_element_get_state); jobs
+ * exceeding it are counted in TeardownStats::timed_out.
+ *
+ * set_state(NULL) itself cannot be interrupted. A supervisor thread retires
+ * a worker whose job has run for twice the timeout: that worker exits once
+ * its job returns, and a replacement takes over the queue. At most
+ * max_wedged workers are retired at a time; past that, jobs wait in the
+ * queue. The queue is capped at max_pending, beyond which Submit() refuses
+ * (counted and logged; the caller must not spawn a thread instead). The
+ * executor never runs more than num_workers + max_wedged + 1 threads.
+ */
+class TeardownExecutor {
+public:
+    using Job = std::function<void(std::chrono::milliseconds timeout)>;
+
+    /**
+     * @param num_workers Number of worker threads (min 1)
+     * @param job_timeout Per-job budget passed to each job (worker retired at twice this)
+     * @param max_pending Queued jobs before Submit() refuses (min 1)
+     * @param max_wedged Retired workers at once before jobs just wait
+     */
+    explicit TeardownExecutor(
+        int num_workers = kDefaultTeardownWorkers,
+        std::chrono::milliseconds job_timeout = std::chrono::milliseconds(kDefaultTeardownTimeoutMs),
+        size_t max_pending = kDefaultTeardownMaxPending,
+        size_t max_wedged = kDefaultTeardownMaxWedged);
+
+    ~TeardownExecutor();
+
+    // Non-copyable
+    TeardownExecutor(const TeardownExecutor&) = delete;
+    TeardownExecutor& operator=(const TeardownExecutor&) = delete;
+
+    /**
+     * @brief Start worker threads
+     */
+    void Start();
+
+    /**
+     * @brief Run all queued jobs, then join workers
+     *
+     * Workers still wedged are let go regardless of max_wedged, so shutdown
+     * cannot hang on a stuck teardown.
+     */
+    void Stop();
+
+    [[nodiscard]] bool IsRunning() const;
+
+    /**
+     * @brief Queue a teardown job
+     * @param label Identifies the job in logs (e.g. stream ID)
+     * @return false if the executor is not running, or the queue is full
+     *         (refusal counted in TeardownStats::rejected)
+     */
+    [[nodiscard]] bool Submit(std::string label, Job job);
+
+    /**
+     * @brief Submit, or run on a one-off thread when there is no running executor
+     *
+     * Only a missing or stopped executor (standalone use, shutdown) gets a
+     * thread. A full queue does not: the job is dropped (counted in
+     * TeardownStats::rejected, its resources leak) instead of adding a
+     * thread per teardown in exactly the overload the cap is for.
+     *
+     * @return false if the job was dropped
+     */
+    static bool SubmitOrSpawn(const std::shared_ptr<TeardownExecutor>& executor,
+                              std::string label, Job job);
+
+    /**
+     * @brief Get current metrics
+     */
+    [[nodiscard]] TeardownStats GetStats() const;
+
+    [[nodiscard]] std::chrono::milliseconds GetJobTimeout() const noexcept { return job_timeout_; }
+
+private:
+    // Queue, worker slots and stats; shared with the worker threads because
+    // a retired worker may still be running when the executor is destroyed
+    struct State;
+
+    static void WorkerLoop(std::shared_ptr<State> state, uint64_t id);
+    void SuperviseLoop();
+
+    // Caller holds the state mutex
+    void SpawnWorkerLocked();
+
+    int num_workers_;
+    std::chrono::milliseconds job_timeout_;
+    size_t max_pending_;
+    size_t max_wedged_;
+
+    std::shared_ptr<State> state_;
+    std::map<uint64_t, std::thread> workers_;  // Guarded by the state mutex
+    std::thread supervisor_;
+};
+
+}  // namespace stream_daemon
+
+#endif  // STREAM_DAEMON_TEARDOWN_EXECUTOR_H_
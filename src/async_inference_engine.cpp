@@ -0,0 +1,234 @@
+#include "async_inference_engine.h"
+
+#include <algorithm>
+#include <chrono>
+
+namespace stream_daemon {
+
+AsyncInferenceEngine::AsyncInferenceEngine(DeviceIo io,
+                                           size_t input_size,
+                                           std::vector<size_t> output_sizes,
+                                           int max_in_flight)
+    : io_(std::move(io)),
+      input_size_(input_size),
+      output_sizes_(std::move(output_sizes)),
+      max_in_flight_(std::max(1, max_in_flight)),
+      output_pool_(std::make_shared<OutputPool>()) {
+    writer_thread_ = std::thread(&AsyncInferenceEngine::WriterLoop, this);
+    reader_thread_ = std::thread(&AsyncInferenceEngine::ReaderLoop, this);
+}
+
+AsyncInferenceEngine::~AsyncInferenceEngine() {
+    Stop();
+}
+
+void AsyncInferenceEngine::Submit(const uint8_t* input,
+                                  std::shared_ptr<const void> input_owner,
+                                  Completion completion) {
+    Request request;
+    request.input = input;
+    request.input_owner = std::move(input_owner);
+    request.completion = std::move(completion);
+
+    bool queued = false;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (running_) {
+            queued_.push_back(std::move(request));
+            queued = true;
+        }
+    }
+
+    if (!queued) {
+        request.completion(MakeErrorT<Outputs>("Inference engine stopped"));
+        return;
+    }
+    write_cv_.notify_one();
+}
+
+std::future<Result<AsyncInferenceEngine::Outputs>> AsyncInferenceEngine::Submit(
+    const uint8_t* input,
+    std::shared_ptr<const void> input_owner) {
+
+    auto promise = std::make_shared<std::promise<Result<Outputs>>>();
+    auto future = promise->get_future();
+    Submit(input, std::move(input_owner), [promise](Result<Outputs> result) {
+        promise->set_value(std::move(result));
+    });
+    return future;
+}
+
+void AsyncInferenceEngine::Stop() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (!running_) {
+            return;
+        }
+        running_ = false;
+    }
+    write_cv_.notify_all();
+
+    if (writer_thread_.joinable()) {
+        writer_thread_.join();
+    }
+
+    // Frames already written must still be read, or the next reader of the
+    // device streams would get their outputs
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        writer_stopped_ = true;
+    }
+    read_cv_.notify_all();
+
+    if (reader_thread_.joinable()) {
+        reader_thread_.join();
+    }
+
+    std::deque<Request> unsent;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        unsent.swap(queued_);
+    }
+    for (auto& request : unsent) {
+        request.completion(MakeErrorT<Outputs>("Inference engine stopped"));
+    }
+}
+
+int AsyncInferenceEngine::GetInFlight() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return in_flight_;
+}
+
+size_t AsyncInferenceEngine::GetQueued() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return queued_.size();
+}
+
+std::chrono::steady_clock::duration AsyncInferenceEngine::GetBusyTime() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (in_flight_ > 0) {
+        return busy_time_ + (std::chrono::steady_clock::now() - busy_since_);
+    }
+    return busy_time_;
+}
+
+void AsyncInferenceEngine::AddInFlight(int delta) {
+    const bool was_busy = in_flight_ > 0;
+    in_flight_ += delta;
+    if (!was_busy && in_flight_ > 0) {
+        busy_since_ = std::chrono::steady_clock::now();
+    } else if (was_busy && in_flight_ == 0) {
+        busy_time_ += std::chrono::steady_clock::now() - busy_since_;
+    }
+}
+
+void AsyncInferenceEngine::WriterLoop() {
+    while (true) {
+        Request request;
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            write_cv_.wait(lock, [this] {
+                return !running_ || (!queued_.empty() && in_flight_ < max_in_flight_);
+            });
+            if (!running_) {
+                return;
+            }
+            request = std::move(queued_.front());
+            queued_.pop_front();
+            AddInFlight(1);
+        }
+
+        auto status = io_.write(request.input, input_size_);
+        request.input = nullptr;
+        request.input_owner.reset();
+
+        if (IsError(status)) {
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                AddInFlight(-1);
+            }
+            LogWarning("AsyncInferenceEngine: write failed: " + GetError(status));
+            request.completion(MakeErrorT<Outputs>("Device write failed: " + GetError(status)));
+            // On error, wait a bit before next attempt
+            std::this_thread::sleep_for(std::chrono::milliseconds(kInferenceErrorBackoffMs));
+            continue;
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            written_.push_back(std::move(request));
+        }
+        read_cv_.notify_one();
+    }
+}
+
+void AsyncInferenceEngine::ReaderLoop() {
+    while (true) {
+        Request request;
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            read_cv_.wait(lock, [this] { return !written_.empty() || writer_stopped_; });
+            if (written_.empty()) {
+                return;  // Writer stopped and every written frame was read
+            }
+            request = std::move(written_.front());
+            written_.pop_front();
+        }
+
+        auto buffers = AcquireOutputs();
+        VoidResult status = MakeOk();
+        for (size_t i = 0; i < output_sizes_.size() && IsOk(status); ++i) {
+            status = io_.read(i, (*buffers)[i].data(), (*buffers)[i].size());
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            AddInFlight(-1);
+        }
+        write_cv_.notify_one();
+
+        if (IsError(status)) {
+            LogWarning("AsyncInferenceEngine: read failed: " + GetError(status));
+            RecycleOutputs(std::move(buffers));
+            request.completion(MakeErrorT<Outputs>("Device read failed: " + GetError(status)));
+            // On error, wait a bit before next attempt
+            std::this_thread::sleep_for(std::chrono::milliseconds(kInferenceErrorBackoffMs));
+            continue;
+        }
+
+        request.completion(Publish(std::move(buffers)));
+    }
+}
+
+std::unique_ptr<AsyncInferenceEngine::OutputBuffers> AsyncInferenceEngine::AcquireOutputs() {
+    {
+        std::lock_guard<std::mutex> lock(output_pool_->mutex);
+        if (!output_pool_->free.empty()) {
+            auto buffers = std::move(output_pool_->free.back());
+            output_pool_->free.pop_back();
+            return buffers;
+        }
+    }
+
+    auto buffers = std::make_unique<OutputBuffers>(output_sizes_.size());
+    for (size_t i = 0; i < output_sizes_.size(); ++i) {
+        (*buffers)[i].resize(output_sizes_[i]);
+    }
+    return buffers;
+}
+
+void AsyncInferenceEngine::RecycleOutputs(std::unique_ptr<OutputBuffers> buffers) {
+    std::lock_guard<std::mutex> lock(output_pool_->mutex);
+    output_pool_->free.push_back(std::move(buffers));
+}
+
+AsyncInferenceEngine::Outputs AsyncInferenceEngine::Publish(
+    std::unique_ptr<OutputBuffers> buffers) const {
+
+    return Outputs(buffers.release(), [pool = output_pool_](const OutputBuffers* released) {
+        std::lock_guard<std::mutex> lock(pool->mutex);
+        pool->free.emplace_back(const_cast<OutputBuffers*>(released));
+    });
+}
+
+}  // namespace stream_daemon
@@ -1,7 +1,6 @@
 #include "batch_inference_manager.h"
 #include "common.h"
 #include <algorithm>
-#include <cstring>
 
 namespace stream_daemon {
 
@@ -67,29 +66,34 @@ int BatchInferenceManager::GetBatchSize() const {
 
 void BatchInferenceManager::SubmitFrame(
     const std::string& stream_id,
-    const uint8_t* rgb_data,
-    int width,
-    int height,
-    ResultCallback callback) {
+    FrameRef frame_ref,
+    int source_width,
+    int source_height,
+    InferenceRequest request,
+    ResultCallback callback,
+    const BoundingBox& region) {
 
     if (!running_) {
         LogWarning("BatchInferenceManager: not running, dropping frame from " + stream_id);
         return;
     }
 
-    // Create pending frame with copy of data
+    if (!frame_ref) {
+        LogWarning("BatchInferenceManager: null frame from " + stream_id);
+        return;
+    }
+
+    // Pending frame holds a reference only - pixel data stays in the GstBuffer
     PendingFrame frame;
     frame.stream_id = stream_id;
-    frame.width = width;
-    frame.height = height;
+    frame.frame = std::move(frame_ref);
+    frame.source_width = source_width;
+    frame.source_height = source_height;
+    frame.region = region;
+    frame.request = std::move(request);
     frame.callback = std::move(callback);
     frame.submit_time = std::chrono::steady_clock::now();
 
-    // Copy RGB data
-    size_t data_size = static_cast<size_t>(width * height * 3);
-    frame.rgb_data.resize(data_size);
-    std::memcpy(frame.rgb_data.data(), rgb_data, data_size);
-
     // Add to queue
     {
         std::lock_guard<std::mutex> lock(queue_mutex_);
@@ -190,15 +194,20 @@ void BatchInferenceManager::ProcessBatch(std::vector<PendingFrame>& frames) {
 
     for (const auto& frame : frames) {
         HailoInference::FrameInput input;
-        input.rgb_data = frame.rgb_data.data();
-        input.width = frame.width;
-        input.height = frame.height;
+        input.frame = frame.frame->View();
+        if (frame.region.width > 0 && frame.region.height > 0) {
+            input.frame = input.frame.Crop(frame.region.x, frame.region.y,
+                                           frame.region.width, frame.region.height);
+        }
+        input.source_width = frame.source_width;
+        input.source_height = frame.source_height;
         input.stream_id = frame.stream_id;
+        input.request = frame.request;
         inputs.push_back(input);
     }
 
-    // Run batch inference
-    auto results = inference_->RunBatchInference(inputs, confidence_threshold_);
+    // Run batch inference (a short batch is not padded)
+    auto results = inference_->RunBatchInference(inputs);
 
     // Deliver results via callbacks
     for (auto& frame : frames) {
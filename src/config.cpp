@@ -69,6 +69,13 @@ void ParseHailoConfig(const YAML::Node& node, HailoConfig& config) {
     config.batch_size = GetOr<int>(node, "batch_size", config.batch_size);
     config.post_process_so = GetOr<std::string>(node, "post_process_so", config.post_process_so);
     config.function_name = GetOr<std::string>(node, "function_name", config.function_name);
+    config.backend = GetOr<std::string>(node, "backend", config.backend);
+    config.recording_dir = GetOr<std::string>(node, "recording_dir", config.recording_dir);
+    config.simulated_latency_ms = GetOr<int>(node, "simulated_latency_ms", config.simulated_latency_ms);
+    config.simulated_fps = GetOr<double>(node, "simulated_fps", config.simulated_fps);
+    config.max_in_flight = GetOr<int>(node, "max_in_flight", config.max_in_flight);
+    config.max_model_replicas = GetOr<int>(node, "max_model_replicas", config.max_model_replicas);
+    config.quantized_outputs = GetOr<bool>(node, "quantized_outputs", config.quantized_outputs);
 }
 
 void ParseGStreamerConfig(const YAML::Node& node, GStreamerConfig& config) {
@@ -215,6 +222,13 @@ std::string DaemonConfig::ToYamlString() const {
     out << YAML::Key << "batch_size" << YAML::Value << hailo.batch_size;
     out << YAML::Key << "post_process_so" << YAML::Value << hailo.post_process_so;
     out << YAML::Key << "function_name" << YAML::Value << hailo.function_name;
+    out << YAML::Key << "backend" << YAML::Value << hailo.backend;
+    out << YAML::Key << "recording_dir" << YAML::Value << hailo.recording_dir;
+    out << YAML::Key << "simulated_latency_ms" << YAML::Value << hailo.simulated_latency_ms;
+    out << YAML::Key << "simulated_fps" << YAML::Value << hailo.simulated_fps;
+    out << YAML::Key << "max_in_flight" << YAML::Value << hailo.max_in_flight;
+    out << YAML::Key << "max_model_replicas" << YAML::Value << hailo.max_model_replicas;
+    out << YAML::Key << "quantized_outputs" << YAML::Value << hailo.quantized_outputs;
     out << YAML::EndMap;
 
     // GStreamer
@@ -287,6 +301,18 @@ VoidResult DaemonConfig::Validate() const {
     if (hailo.batch_size < 1) {
         return MakeError("Hailo batch size must be at least 1");
     }
+    if (hailo.backend != "hailort" && hailo.backend != "simulated") {
+        return MakeError("Hailo backend must be 'hailort' or 'simulated'");
+    }
+    if (hailo.simulated_latency_ms < 0 || hailo.simulated_fps < 0.0) {
+        return MakeError("Simulated latency and FPS must not be negative");
+    }
+    if (hailo.max_in_flight < 0) {
+        return MakeError("Hailo max_in_flight must not be negative");
+    }
+    if (hailo.max_model_replicas < 0) {
+        return MakeError("Hailo max_model_replicas must not be negative");
+    }
 
     // Validate GStreamer
     if (gstreamer.debug_level < 0 || gstreamer.debug_level > 9) {
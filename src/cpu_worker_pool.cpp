@@ -0,0 +1,121 @@
+#include "cpu_worker_pool.h"
+
+#include <algorithm>
+#include <atomic>
+#include <memory>
+
+namespace stream_daemon {
+
+// Shared between the caller and the helpers it queued; helpers that start
+// after every index was claimed only touch the counters
+struct CpuWorkerPool::Batch {
+    const std::function<void(int)>* fn{nullptr};
+    int count{0};
+    std::atomic<int> next{0};
+    std::atomic<int> remaining{0};
+    std::mutex done_mutex;
+    std::condition_variable done_cv;
+};
+
+CpuWorkerPool::CpuWorkerPool(int num_workers) {
+    const int count = std::max(0, num_workers);
+    workers_.reserve(count);
+    for (int i = 0; i < count; ++i) {
+        workers_.emplace_back(&CpuWorkerPool::WorkerLoop, this);
+    }
+}
+
+CpuWorkerPool::~CpuWorkerPool() {
+    {
+        std::lock_guard<std::mutex> lock(queue_mutex_);
+        running_ = false;
+    }
+    queue_cv_.notify_all();
+
+    for (auto& worker : workers_) {
+        if (worker.joinable()) {
+            worker.join();
+        }
+    }
+}
+
+CpuWorkerPool& CpuWorkerPool::Shared() {
+    static CpuWorkerPool pool([] {
+        const int cores = static_cast<int>(std::thread::hardware_concurrency());
+        const int workers = std::max(0, cores - 1);
+        LogInfo("CpuWorkerPool started with " + std::to_string(workers) + " workers");
+        return workers;
+    }());
+    return pool;
+}
+
+void CpuWorkerPool::ParallelFor(int count, const std::function<void(int)>& fn) {
+    if (count <= 0) {
+        return;
+    }
+    if (count == 1 || workers_.empty()) {
+        for (int i = 0; i < count; ++i) {
+            fn(i);
+        }
+        return;
+    }
+
+    auto batch = std::make_shared<Batch>();
+    batch->fn = &fn;
+    batch->count = count;
+    batch->remaining = count;
+
+    const int helpers = std::min(count - 1, static_cast<int>(workers_.size()));
+    {
+        std::lock_guard<std::mutex> lock(queue_mutex_);
+        for (int i = 0; i < helpers; ++i) {
+            queue_.emplace_back([batch] { RunIndices(*batch); });
+        }
+    }
+    if (helpers == 1) {
+        queue_cv_.notify_one();
+    } else {
+        queue_cv_.notify_all();
+    }
+
+    RunIndices(*batch);
+
+    std::unique_lock<std::mutex> lock(batch->done_mutex);
+    batch->done_cv.wait(lock, [&] { return batch->remaining.load() == 0; });
+}
+
+void CpuWorkerPool::RunIndices(Batch& batch) {
+    while (true) {
+        const int index = batch.next.fetch_add(1);
+        if (index >= batch.count) {
+            return;
+        }
+
+        (*batch.fn)(index);
+
+        if (batch.remaining.fetch_sub(1) == 1) {
+            std::lock_guard<std::mutex> lock(batch.done_mutex);
+            batch.done_cv.notify_all();
+        }
+    }
+}
+
+void CpuWorkerPool::WorkerLoop() {
+    while (true) {
+        std::function<void()> task;
+        {
+            std::unique_lock<std::mutex> lock(queue_mutex_);
+            queue_cv_.wait(lock, [this] { return !running_ || !queue_.empty(); });
+
+            if (queue_.empty()) {
+                return;  // Stopped and drained
+            }
+
+            task = std::move(queue_.front());
+            queue_.pop_front();
+        }
+        task();
+    }
+}
+
+}  // namespace stream_daemon
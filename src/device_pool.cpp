@@ -0,0 +1,345 @@
+#include "device_pool.h"
+
+#include <algorithm>
+#include <sstream>
+
+namespace stream_daemon {
+
+namespace {
+
+constexpr double kLoadEpsilon = 1e-9;
+
+[[nodiscard]] std::string Trim(const std::string& value) {
+    const auto begin = value.find_first_not_of(" \t");
+    if (begin == std::string::npos) {
+        return {};
+    }
+    const auto end = value.find_last_not_of(" \t");
+    return value.substr(begin, end - begin + 1);
+}
+
+[[nodiscard]] std::string DeviceName(const std::string& device_id) {
+    return device_id.empty() ? std::string("default") : device_id;
+}
+
+}  // namespace
+
+std::vector<std::string> DevicePool::ParseDeviceIds(const std::string& list) {
+    std::vector<std::string> ids;
+    std::stringstream stream(list);
+    std::string item;
+    while (std::getline(stream, item, ',')) {
+        item = Trim(item);
+        if (!item.empty() && std::find(ids.begin(), ids.end(), item) == ids.end()) {
+            ids.push_back(item);
+        }
+    }
+    if (ids.empty()) {
+        ids.emplace_back();
+    }
+    return ids;
+}
+
+DevicePool::DevicePool(std::vector<std::string> device_ids, int max_replicas, NowFn now)
+    : device_ids_(device_ids.empty() ? std::vector<std::string>{""} : std::move(device_ids))
+    , max_replicas_(static_cast<size_t>(std::max(0, max_replicas)))
+    , now_(std::move(now))
+    , last_sample_(now_()) {}
+
+Result<DevicePool::StreamPlacement> DevicePool::AssignStream(const std::string& stream_id,
+                                                             const std::string& hef_path) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    SampleLocked(now_(), false);
+
+    if (auto it = assignments_.find(stream_id); it != assignments_.end()) {
+        if (it->second.hef_path == hef_path) {
+            const auto& replica = replicas_.at({hef_path, it->second.device_id});
+            return StreamPlacement{it->second.device_id, replica.inference};
+        }
+        DetachLocked(it->second.hef_path, it->second.device_id);
+        assignments_.erase(it);
+    }
+
+    // Least-loaded device the model may use; ties go to fewer streams, then
+    // a device that already has the model (no new network group)
+    const auto loads = DeviceLoadsLocked();
+    std::map<std::string, size_t> streams;
+    for (const auto& [key, replica] : replicas_) {
+        streams[key.second] += replica.streams;
+    }
+    const std::string* best = nullptr;
+    for (const auto& device_id : device_ids_) {
+        if (!CanPlaceLocked(hef_path, device_id)) {
+            continue;
+        }
+        if (!best) {
+            best = &device_id;
+            continue;
+        }
+        const double load = loads.at(device_id);
+        const double best_load = loads.at(*best);
+        if (load < best_load - kLoadEpsilon) {
+            best = &device_id;
+        } else if (load <= best_load + kLoadEpsilon) {
+            if (streams[device_id] != streams[*best]) {
+                if (streams[device_id] < streams[*best]) {
+                    best = &device_id;
+                }
+            } else if (replicas_.count({hef_path, device_id}) > 0 &&
+                       replicas_.count({hef_path, *best}) == 0) {
+                best = &device_id;
+            }
+        }
+    }
+
+    auto replica = ReplicaForLocked(hef_path, *best);
+    if (IsError(replica)) {
+        return GetError(replica);
+    }
+    AttachLocked(*GetValue(replica));
+    assignments_[stream_id] = Assignment{hef_path, *best};
+
+    LogInfo("DevicePool: " + stream_id + " placed on device " + DeviceName(*best) +
+            " (load " + std::to_string(loads.at(*best)) + ")");
+    return StreamPlacement{*best, GetValue(replica)->inference};
+}
+
+void DevicePool::ReleaseStream(const std::string& stream_id) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = assignments_.find(stream_id);
+    if (it == assignments_.end()) {
+        return;
+    }
+    DetachLocked(it->second.hef_path, it->second.device_id);
+    assignments_.erase(it);
+}
+
+std::vector<DevicePool::StreamMove> DevicePool::Rebalance() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    SampleLocked(now_(), false);
+
+    std::vector<StreamMove> moves;
+    if (device_ids_.size() < 2) {
+        return moves;
+    }
+
+    // Each move narrows the busiest-idlest gap by at least the margin; the
+    // round limit guards against estimates shifting under the moves
+    for (size_t round = 0; round < assignments_.size(); ++round) {
+        const auto loads = DeviceLoadsLocked();
+        const double average = AverageCostLocked();
+        const auto busiest = std::max_element(
+            loads.begin(), loads.end(),
+            [](const auto& a, const auto& b) { return a.second < b.second; });
+
+        // Costliest stream on the busiest device whose move still helps
+        const std::string* move_stream = nullptr;
+        const std::string* move_target = nullptr;
+        double move_cost = 0.0;
+        for (const auto& [stream_id, assignment] : assignments_) {
+            if (assignment.device_id != busiest->first) {
+                continue;
+            }
+            const double cost =
+                StreamCostLocked(replicas_.at({assignment.hef_path, assignment.device_id}), average);
+
+            const std::string* target = nullptr;
+            for (const auto& device_id : device_ids_) {
+                if (device_id == busiest->first || !CanPlaceLocked(assignment.hef_path, device_id)) {
+                    continue;
+                }
+                if (!target || loads.at(device_id) < loads.at(*target) - kLoadEpsilon) {
+                    target = &device_id;
+                }
+            }
+            if (!target ||
+                cost >= busiest->second - loads.at(*target) - kDevicePoolRebalanceMargin) {
+                continue;
+            }
+            if (!move_stream || cost > move_cost) {
+                move_stream = &stream_id;
+                move_target = target;
+                move_cost = cost;
+            }
+        }
+        if (!move_stream) {
+            break;
+        }
+
+        Assignment& assignment = assignments_.at(*move_stream);
+        auto replica = ReplicaForLocked(assignment.hef_path, *move_target);
+        if (IsError(replica)) {
+            LogWarning("DevicePool: cannot move " + *move_stream + " to device " +
+                       DeviceName(*move_target) + ": " + GetError(replica));
+            break;
+        }
+        AttachLocked(*GetValue(replica));
+        const std::string from = assignment.device_id;
+        DetachLocked(assignment.hef_path, from);
+        assignment.device_id = *move_target;
+
+        LogInfo("DevicePool: moving " + *move_stream + " from device " + DeviceName(from) +
+                " to " + DeviceName(*move_target) + " (cost " + std::to_string(move_cost) + ")");
+        moves.push_back(StreamMove{*move_stream, from, *move_target, GetValue(replica)->inference});
+    }
+    return moves;
+}
+
+void DevicePool::SampleUtilisation() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    SampleLocked(now_(), true);
+}
+
+std::optional<DevicePool::StreamPlacement> DevicePool::GetPlacement(const std::string& stream_id) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = assignments_.find(stream_id);
+    if (it == assignments_.end()) {
+        return std::nullopt;
+    }
+    const auto& replica = replicas_.at({it->second.hef_path, it->second.device_id});
+    return StreamPlacement{it->second.device_id, replica.inference};
+}
+
+std::vector<DevicePool::DeviceStats> DevicePool::GetStats() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    const auto loads = DeviceLoadsLocked();
+
+    std::vector<DeviceStats> stats;
+    for (const auto& device_id : device_ids_) {
+        DeviceStats device;
+        device.device_id = device_id;
+        device.load = loads.at(device_id);
+        for (const auto& [key, replica] : replicas_) {
+            if (key.second != device_id) {
+                continue;
+            }
+            device.utilisation += replica.utilisation;
+            device.streams += replica.streams;
+            ++device.models;
+        }
+        stats.push_back(std::move(device));
+    }
+    return stats;
+}
+
+void DevicePool::SampleLocked(Clock::time_point now, bool force) {
+    const auto interval = std::chrono::milliseconds(kDevicePoolSampleMs);
+    if (!force && now - last_sample_ < interval) {
+        return;
+    }
+    last_sample_ = now;
+
+    for (auto& [key, replica] : replicas_) {
+        const auto elapsed = now - replica.last_sample;
+        if (elapsed <= Clock::duration::zero() || (!force && elapsed < interval)) {
+            continue;
+        }
+        const auto busy = replica.inference->GetBusyTime();
+        const double fraction = std::chrono::duration<double>(busy - replica.last_busy).count() /
+                                std::chrono::duration<double>(elapsed).count();
+        replica.utilisation = replica.measured
+            ? kDevicePoolSmoothing * fraction + (1.0 - kDevicePoolSmoothing) * replica.utilisation
+            : fraction;
+        replica.measured = true;
+        replica.last_busy = busy;
+        replica.last_sample = now;
+    }
+}
+
+double DevicePool::AverageCostLocked() const {
+    double utilisation = 0.0;
+    size_t streams = 0;
+    for (const auto& [key, replica] : replicas_) {
+        if (replica.measured && replica.streams > 0) {
+            utilisation += replica.utilisation;
+            streams += replica.streams;
+        }
+    }
+    return streams > 0 ? utilisation / static_cast<double>(streams) : 1.0;
+}
+
+double DevicePool::StreamCostLocked(const Replica& replica, double average) const {
+    if (!replica.measured || replica.streams == 0) {
+        return average;
+    }
+    return replica.utilisation / static_cast<double>(replica.streams);
+}
+
+std::map<std::string, double> DevicePool::DeviceLoadsLocked() const {
+    const double average = AverageCostLocked();
+    std::map<std::string, double> loads;
+    for (const auto& device_id : device_ids_) {
+        loads[device_id] = 0.0;
+    }
+    for (const auto& [key, replica] : replicas_) {
+        loads[key.second] += static_cast<double>(replica.streams) * StreamCostLocked(replica, average);
+    }
+    return loads;
+}
+
+size_t DevicePool::ReplicaCountLocked(const std::string& hef_path) const {
+    return static_cast<size_t>(std::count_if(
+        replicas_.begin(), replicas_.end(),
+        [&](const auto& entry) { return entry.first.first == hef_path; }));
+}
+
+bool DevicePool::CanPlaceLocked(const std::string& hef_path, const std::string& device_id) const {
+    return replicas_.count({hef_path, device_id}) > 0 || max_replicas_ == 0 ||
+           ReplicaCountLocked(hef_path) < max_replicas_;
+}
+
+Result<DevicePool::Replica*> DevicePool::ReplicaForLocked(const std::string& hef_path,
+                                                          const std::string& device_id) {
+    auto it = replicas_.find({hef_path, device_id});
+    if (it != replicas_.end()) {
+        return &it->second;
+    }
+
+    auto inference = HailoInference::GetInstance(hef_path, device_id);
+    if (IsError(inference)) {
+        return MakeErrorT<Replica*>("Failed to load " + hef_path + " on device " +
+                                    DeviceName(device_id) + ": " + GetError(inference));
+    }
+
+    Replica replica;
+    replica.inference = GetValue(inference);
+    replica.last_busy = replica.inference->GetBusyTime();
+    replica.last_sample = now_();
+    return &replicas_.emplace(ReplicaKey{hef_path, device_id}, std::move(replica)).first->second;
+}
+
+void DevicePool::AttachLocked(Replica& replica) {
+    // Keep the per-stream cost until the next sample sees the new stream;
+    // an idle replica has no cost to keep and is measured afresh
+    if (replica.streams == 0) {
+        replica.measured = false;
+        replica.last_busy = replica.inference->GetBusyTime();
+        replica.last_sample = now_();
+    } else if (replica.measured) {
+        replica.utilisation *= static_cast<double>(replica.streams + 1) /
+                               static_cast<double>(replica.streams);
+    }
+    ++replica.streams;
+}
+
+void DevicePool::DetachLocked(const std::string& hef_path, const std::string& device_id) {
+    auto it = replicas_.find({hef_path, device_id});
+    if (it == replicas_.end() || it->second.streams == 0) {
+        return;
+    }
+    Replica& replica = it->second;
+    if (replica.measured) {
+        replica.utilisation *= static_cast<double>(replica.streams - 1) /
+                               static_cast<double>(replica.streams);
+    }
+    --replica.streams;
+
+    // The model stays configured where it last ran; spare replicas go
+    if (replica.streams == 0 && ReplicaCountLocked(hef_path) > 1) {
+        replicas_.erase(it);
+        HailoInference::ReleaseInstance(hef_path, device_id);
+        LogInfo("DevicePool: released " + hef_path + " on device " + DeviceName(device_id));
+    }
+}
+
+}  // namespace stream_daemon
@@ -424,6 +424,36 @@ std::optional<EventSetting> EventCompositor::GetSetting(
     return std::nullopt;
 }
 
+std::optional<RegionBounds> EventCompositor::GetRegionBounds() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    std::optional<RegionBounds> bounds;
+    for (const auto& [id, setting] : settings_) {
+        // 논리/알람 이벤트는 자식 이벤트의 영역을 따름
+        const bool composite = setting.event_type == EventType::kAnd ||
+                               setting.event_type == EventType::kOr ||
+                               setting.event_type == EventType::kAlarm;
+        if (setting.points.empty()) {
+            if (composite) {
+                continue;
+            }
+            return std::nullopt;
+        }
+
+        for (const auto& p : setting.points) {
+            if (!bounds) {
+                bounds = RegionBounds{p, p};
+                continue;
+            }
+            bounds->min.x = std::min(bounds->min.x, p.x);
+            bounds->min.y = std::min(bounds->min.y, p.y);
+            bounds->max.x = std::max(bounds->max.x, p.x);
+            bounds->max.y = std::max(bounds->max.y, p.y);
+        }
+    }
+    return bounds;
+}
+
 // ============================================================================
 // Line Event Detection
 // ============================================================================
@@ -0,0 +1,117 @@
+#include "frame_buffer.h"
+
+#include <gst/video/video.h>
+
+#include <algorithm>
+
+namespace stream_daemon {
+
+namespace {
+
+PixelFormat ToPixelFormat(GstVideoFormat format) {
+    switch (format) {
+        case GST_VIDEO_FORMAT_RGB:  return PixelFormat::kRGB;
+        case GST_VIDEO_FORMAT_NV12: return PixelFormat::kNV12;
+        case GST_VIDEO_FORMAT_I420: return PixelFormat::kI420;
+        default:                    return PixelFormat::kUnknown;
+    }
+}
+
+}  // namespace
+
+Result<std::shared_ptr<const FrameBuffer>> FrameBuffer::FromSample(
+    GstSample* sample, const FrameGeometry& geometry) {
+
+    if (!sample) {
+        return std::string("Sample is null");
+    }
+
+    GstBuffer* buffer = gst_sample_get_buffer(sample);
+    if (!buffer) {
+        return std::string("Sample has no buffer");
+    }
+
+    gst_sample_ref(sample);
+    auto frame = std::shared_ptr<FrameBuffer>(new FrameBuffer(sample, buffer));
+
+    if (!gst_buffer_map(buffer, &frame->map_, GST_MAP_READ)) {
+        // Destructor only unmaps a mapped buffer; still drops the sample ref
+        frame->buffer_ = nullptr;
+        return std::string("Failed to map buffer");
+    }
+
+    frame->view_ = geometry.Bind(frame->map_.data);
+
+    // Decoders with padded pools describe the real layout in GstVideoMeta
+    if (GstVideoMeta* meta = gst_buffer_get_video_meta(buffer)) {
+        const int planes = std::min<int>(static_cast<int>(meta->n_planes), kMaxFramePlanes);
+        for (int i = 0; i < planes; ++i) {
+            frame->view_.planes[i] = frame->map_.data + meta->offset[i];
+            frame->view_.strides[i] = meta->stride[i];
+        }
+    } else if (frame->map_.size < geometry.size) {
+        return std::string("Buffer smaller than negotiated frame size");
+    }
+
+    return std::shared_ptr<const FrameBuffer>(std::move(frame));
+}
+
+FrameBuffer::FrameBuffer(GstSample* sample, GstBuffer* buffer)
+    : sample_(sample)
+    , buffer_(buffer) {}
+
+FrameBuffer::~FrameBuffer() {
+    if (buffer_) {
+        gst_buffer_unmap(buffer_, &map_);
+    }
+    if (sample_) {
+        gst_sample_unref(sample_);
+    }
+}
+
+const FrameGeometry* FrameGeometryCache::Get(GstCaps* caps) {
+    if (!caps) {
+        return nullptr;
+    }
+    if (caps == caps_) {
+        return valid_ ? &geometry_ : nullptr;
+    }
+
+    Reset();
+    caps_ = gst_caps_ref(caps);
+
+    GstVideoInfo info;
+    gst_video_info_init(&info);
+    if (!gst_video_info_from_caps(&info, caps)) {
+        return nullptr;
+    }
+
+    geometry_ = FrameGeometry{};
+    geometry_.format = ToPixelFormat(GST_VIDEO_INFO_FORMAT(&info));
+    geometry_.width = GST_VIDEO_INFO_WIDTH(&info);
+    geometry_.height = GST_VIDEO_INFO_HEIGHT(&info);
+    geometry_.num_planes = std::min<int>(
+        static_cast<int>(GST_VIDEO_INFO_N_PLANES(&info)), kMaxFramePlanes);
+    for (int i = 0; i < geometry_.num_planes; ++i) {
+        geometry_.offsets[i] = GST_VIDEO_INFO_PLANE_OFFSET(&info, i);
+        geometry_.strides[i] = GST_VIDEO_INFO_PLANE_STRIDE(&info, i);
+    }
+    geometry_.size = GST_VIDEO_INFO_SIZE(&info);
+    geometry_.yuv_matrix = info.colorimetry.matrix == GST_VIDEO_COLOR_MATRIX_BT709
+                               ? YuvMatrix::kBt709 : YuvMatrix::kBt601;
+    geometry_.yuv_full_range = info.colorimetry.range == GST_VIDEO_COLOR_RANGE_0_255;
+
+    valid_ = geometry_.format != PixelFormat::kUnknown &&
+             geometry_.width > 0 && geometry_.height > 0;
+    return valid_ ? &geometry_ : nullptr;
+}
+
+void FrameGeometryCache::Reset() {
+    if (caps_) {
+        gst_caps_unref(caps_);
+        caps_ = nullptr;
+    }
+    valid_ = false;
+}
+
+}  // namespace stream_daemon
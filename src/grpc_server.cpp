@@ -50,6 +50,43 @@ constexpr int kStatusReconnecting = 4;
         if (j.contains("confidence_threshold")) {
             config.confidence_threshold = j["confidence_threshold"].get<float>();
         }
+        if (j.contains("dual_branch")) config.dual_branch = j["dual_branch"].get<bool>();
+        if (j.contains("preview_width")) config.preview_width = j["preview_width"].get<int>();
+        if (j.contains("inference_fps")) config.inference_fps = j["inference_fps"].get<double>();
+        if (j.contains("inference_every_n")) {
+            config.inference_every_n = j["inference_every_n"].get<int>();
+        }
+        if (j.contains("soft_restart")) config.soft_restart = j["soft_restart"].get<bool>();
+        if (j.contains("decode_skip")) config.decode_skip = j["decode_skip"].get<bool>();
+        if (j.contains("share_source")) config.share_source = j["share_source"].get<bool>();
+        if (j.contains("native_yuv")) config.native_yuv = j["native_yuv"].get<bool>();
+        if (j.contains("tiled")) config.tiled = j["tiled"].get<bool>();
+        if (j.contains("tile_size")) config.tile_size = j["tile_size"].get<int>();
+        if (j.contains("tile_overlap")) config.tile_overlap = j["tile_overlap"].get<float>();
+        if (j.contains("roi_crop")) config.roi_crop = j["roi_crop"].get<bool>();
+        if (j.contains("roi_crop_margin")) {
+            config.roi_crop_margin = j["roi_crop_margin"].get<float>();
+        }
+        if (j.contains("motion_gate")) config.motion_gate = j["motion_gate"].get<bool>();
+        if (j.contains("motion_max_skip_ms")) {
+            config.motion_max_skip_ms = j["motion_max_skip_ms"].get<int>();
+        }
+        if (j.contains("motion_republish")) {
+            config.motion_republish = j["motion_republish"].get<bool>();
+        }
+        if (j.contains("inference_priority")) {
+            config.inference_priority =
+                StringToInferencePriority(j["inference_priority"].get<std::string>());
+        }
+        if (j.contains("inference_weight")) {
+            config.inference_weight = j["inference_weight"].get<double>();
+        }
+        if (j.contains("inference_min_fps")) {
+            config.inference_min_fps = j["inference_min_fps"].get<double>();
+        }
+        if (j.contains("inference_deadline_ms")) {
+            config.inference_deadline_ms = j["inference_deadline_ms"].get<int>();
+        }
     } catch (...) {
         // 파싱 실패 시 기본값 사용
     }
@@ -439,6 +476,8 @@ public:
             StreamInfo info;
             info.stream_id = request->stream_id();
             info.rtsp_url = existing->rtsp_url;  // 기존 URI 유지
+            info.inference_url = request->inference_uri();  // 비어있으면 기존 유지
+            info.snapshot_url = request->snapshot_uri();
             info.hef_path = model->hef_path;
             info.model_id = request->app_id();
             info.task = model->task;
@@ -483,6 +522,8 @@ public:
         StreamInfo info;
         info.stream_id = request->stream_id();
         info.rtsp_url = request->uri();
+        info.inference_url = request->inference_uri();
+        info.snapshot_url = request->snapshot_uri();
 
         // 모델 조회 (app_id가 있으면)
         if (!request->app_id().empty()) {
@@ -624,6 +665,8 @@ public:
         if (!request->uri().empty()) {
             info.rtsp_url = request->uri();
         }
+        info.inference_url = request->inference_uri();
+        info.snapshot_url = request->snapshot_uri();
 
         // 모델 변경/추가
         if (!request->app_id().empty()) {
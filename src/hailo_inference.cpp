@@ -1,98 +1,153 @@
 #include "hailo_inference.h"
 #include "batch_inference_manager.h"
+#include "cpu_worker_pool.h"
+#include "detection_geometry.h"
 #include <algorithm>
 #include <array>
+#include <atomic>
 #include <chrono>
+#include <cmath>
 #include <cstring>
-#include <map>
+#include <iterator>
 #include <numeric>
 #include <sstream>
-#include <thread>
 
 namespace stream_daemon {
 
-// Static member definitions
-std::shared_ptr<hailort::VDevice> HailoInference::shared_vdevice_;
-std::unordered_map<std::string, std::shared_ptr<HailoInference>> HailoInference::instances_;
-std::mutex HailoInference::static_mutex_;
-
 namespace {
 
-// COCO 80 class labels
-static const char* COCO_LABELS[] = {
-    "person", "bicycle", "car", "motorcycle", "airplane", "bus", "train", "truck", "boat",
-    "traffic light", "fire hydrant", "stop sign", "parking meter", "bench", "bird", "cat",
-    "dog", "horse", "sheep", "cow", "elephant", "bear", "zebra", "giraffe", "backpack",
-    "umbrella", "handbag", "tie", "suitcase", "frisbee", "skis", "snowboard", "sports ball",
-    "kite", "baseball bat", "baseball glove", "skateboard", "surfboard", "tennis racket",
-    "bottle", "wine glass", "cup", "fork", "knife", "spoon", "bowl", "banana", "apple",
-    "sandwich", "orange", "broccoli", "carrot", "hot dog", "pizza", "donut", "cake", "chair",
-    "couch", "potted plant", "bed", "dining table", "toilet", "tv", "laptop", "mouse",
-    "remote", "keyboard", "cell phone", "microwave", "oven", "toaster", "sink", "refrigerator",
-    "book", "clock", "vase", "scissors", "teddy bear", "hair drier", "toothbrush"
-};
-static const int NUM_COCO_LABELS = 80;
-
-}  // namespace
-
-// Static member function for letterbox resize
-HailoInference::LetterboxInfo HailoInference::LetterboxResize(
-    const uint8_t* src, int src_w, int src_h,
-    uint8_t* dst, int dst_w, int dst_h,
-    uint8_t pad_value) {
+// One output frame of a tensor: FLOAT32 read as is, UINT8/UINT16 codes
+// dequantised on access
+struct OutputTensor {
+    const uint8_t* data{nullptr};
+    TensorDataType type{TensorDataType::kFloat32};
+    QuantInfo quant;
 
-    LetterboxInfo info;
+    bool IsQuantized() const { return type != TensorDataType::kFloat32; }
+    const float* Floats() const { return reinterpret_cast<const float*>(data); }
 
-    // Calculate scale to fit while maintaining aspect ratio
-    float scale_w = static_cast<float>(dst_w) / src_w;
-    float scale_h = static_cast<float>(dst_h) / src_h;
-    info.scale = std::min(scale_w, scale_h);
+    uint32_t Code(size_t index) const {
+        return type == TensorDataType::kUint16 ? reinterpret_cast<const uint16_t*>(data)[index]
+                                               : data[index];
+    }
 
-    // New dimensions after scaling
-    info.new_w = static_cast<int>(src_w * info.scale);
-    info.new_h = static_cast<int>(src_h * info.scale);
+    float Value(size_t index) const {
+        return IsQuantized() ? quant.Dequantize(Code(index)) : Floats()[index];
+    }
 
-    // Padding to center the image
-    info.pad_x = (dst_w - info.new_w) / 2;
-    info.pad_y = (dst_h - info.new_h) / 2;
+    // Values [begin, begin + count) as floats: in place for FLOAT32, else in `scratch`
+    const float* Values(size_t begin, size_t count, float* scratch) const {
+        if (!IsQuantized()) {
+            return Floats() + begin;
+        }
+        for (size_t i = 0; i < count; ++i) {
+            scratch[i] = quant.Dequantize(Code(begin + i));
+        }
+        return scratch;
+    }
+};
 
-    // Fill destination with padding color (gray 114 is common for YOLO)
-    std::memset(dst, pad_value, dst_w * dst_h * 3);
+// Class scores of a quantized tensor. One rule for the whole tensor: codes
+// are probabilities when every code dequantises into [0, 1], logits
+// otherwise. Both are monotonic in the code, so the confidence threshold
+// becomes the smallest code that reaches it and cells are rejected on
+// integer compares before anything is dequantised.
+struct QuantizedScores {
+    QuantInfo quant;
+    bool logits{false};
+    uint32_t max_code{0};
+    uint32_t threshold_code{0};  // max_code + 1 = nothing passes
+
+    float Score(uint32_t code) const {
+        const float value = quant.Dequantize(code);
+        return logits ? 1.0f / (1.0f + std::exp(-value)) : value;
+    }
 
-    // Resize and copy to center of destination
-    const float x_ratio = static_cast<float>(src_w) / info.new_w;
-    const float y_ratio = static_cast<float>(src_h) / info.new_h;
+    static QuantizedScores For(const OutputTensor& tensor, float confidence_threshold) {
+        QuantizedScores scores;
+        scores.quant = tensor.quant;
+        scores.max_code = tensor.type == TensorDataType::kUint16 ? 0xFFFFu : 0xFFu;
+        if (tensor.quant.scale <= 0.0f) {
+            return scores;  // Not monotonic: every cell is scored (threshold_code 0)
+        }
+        const float lowest = tensor.quant.Dequantize(0);
+        const float highest = tensor.quant.Dequantize(scores.max_code);
+        const float slack = 0.5f * tensor.quant.scale;  // 255 * (1/255) may round past 1
+        scores.logits = lowest < -slack || highest > 1.0f + slack;
+
+        // Inverse sigmoid (logits) and inverse quantisation give the estimate;
+        // stepping settles float rounding against Score() itself
+        const float t = std::clamp(confidence_threshold, 1e-6f, 1.0f - 1e-6f);
+        const float value = scores.logits ? std::log(t / (1.0f - t)) : confidence_threshold;
+        const double estimate = std::ceil(value / tensor.quant.scale + tensor.quant.zero_point);
+        int64_t code = static_cast<int64_t>(
+            std::clamp(estimate, 0.0, static_cast<double>(scores.max_code) + 1.0));
+        while (code > 0 && scores.Score(static_cast<uint32_t>(code - 1)) >= confidence_threshold) {
+            --code;
+        }
+        while (code <= scores.max_code &&
+               scores.Score(static_cast<uint32_t>(code)) < confidence_threshold) {
+            ++code;
+        }
+        scores.threshold_code = static_cast<uint32_t>(code);
+        return scores;
+    }
+};
 
-    for (int y = 0; y < info.new_h; ++y) {
-        for (int x = 0; x < info.new_w; ++x) {
-            int src_x = static_cast<int>(x * x_ratio);
-            int src_y = static_cast<int>(y * y_ratio);
+// Highest class code of one cell; false when it is below the threshold code
+template <typename CodeT>
+bool BestQuantizedClass(const CodeT* codes, int num_classes, uint32_t threshold_code,
+                        int& best_class, uint32_t& best_code) {
+    CodeT best = codes[0];
+    int best_index = 0;
+    for (int c = 1; c < num_classes; ++c) {
+        if (codes[c] > best) {
+            best = codes[c];
+            best_index = c;
+        }
+    }
+    if (best < threshold_code) {
+        return false;
+    }
+    best_class = best_index;
+    best_code = best;
+    return true;
+}
 
-            src_x = std::min(src_x, src_w - 1);
-            src_y = std::min(src_y, src_h - 1);
+}  // namespace
 
-            int dst_x = x + info.pad_x;
-            int dst_y = y + info.pad_y;
+// Static member definitions
+std::unordered_map<std::string, std::shared_ptr<HailoInference>> HailoInference::instances_;
+std::mutex HailoInference::static_mutex_;
+InferenceBackendFactory HailoInference::backend_factory_;
+std::function<void()> HailoInference::backend_shutdown_;
 
-            int dst_idx = (dst_y * dst_w + dst_x) * 3;
-            int src_idx = (src_y * src_w + src_x) * 3;
+// Static member function for letterbox geometry
+HailoInference::LetterboxInfo HailoInference::ComputeLetterbox(
+    int src_w, int src_h, int dst_w, int dst_h) {
+    return ComputeLetterboxGeometry(src_w, src_h, dst_w, dst_h);
+}
 
-            dst[dst_idx + 0] = src[src_idx + 0];
-            dst[dst_idx + 1] = src[src_idx + 1];
-            dst[dst_idx + 2] = src[src_idx + 2];
-        }
+void HailoInference::CopyPacked(const FrameView& src, uint8_t* dst) {
+    const size_t row_bytes = static_cast<size_t>(src.width) * 3;
+    if (src.IsPackedRgb()) {
+        std::memcpy(dst, src.planes[0], row_bytes * src.height);
+        return;
+    }
+    for (int y = 0; y < src.height; ++y) {
+        std::memcpy(dst + row_bytes * y, src.Row(0, y), row_bytes);
     }
-
-    return info;
 }
 
 Result<std::shared_ptr<HailoInference>> HailoInference::GetInstance(
-    const std::string& hef_path) {
+    const std::string& hef_path,
+    const std::string& device_id) {
 
     std::lock_guard<std::mutex> lock(static_mutex_);
 
     // Check if instance already exists
-    auto it = instances_.find(hef_path);
+    const std::string key = InstanceKey(hef_path, device_id);
+    auto it = instances_.find(key);
     if (it != instances_.end()) {
         return it->second;
     }
@@ -100,278 +155,350 @@ Result<std::shared_ptr<HailoInference>> HailoInference::GetInstance(
     // Create new instance
     auto inference = std::shared_ptr<HailoInference>(new HailoInference());
 
-    if (auto result = inference->Initialize(hef_path); IsError(result)) {
+    if (auto result = inference->Initialize(hef_path, device_id); IsError(result)) {
         return GetError(result);
     }
 
-    instances_[hef_path] = inference;
+    instances_[key] = inference;
     return inference;
 }
 
-void HailoInference::ReleaseInstance(const std::string& hef_path) {
+void HailoInference::ReleaseInstance(const std::string& hef_path, const std::string& device_id) {
+    std::lock_guard<std::mutex> lock(static_mutex_);
+    instances_.erase(InstanceKey(hef_path, device_id));
+}
+
+std::string HailoInference::InstanceKey(const std::string& hef_path, const std::string& device_id) {
+    return device_id.empty() ? hef_path : hef_path + "@" + device_id;
+}
+
+void HailoInference::SetBackendFactory(InferenceBackendFactory factory,
+                                       std::function<void()> on_shutdown) {
     std::lock_guard<std::mutex> lock(static_mutex_);
-    instances_.erase(hef_path);
+    backend_factory_ = std::move(factory);
+    backend_shutdown_ = std::move(on_shutdown);
 }
 
 void HailoInference::Shutdown() {
     std::lock_guard<std::mutex> lock(static_mutex_);
     instances_.clear();
-    shared_vdevice_.reset();
-    LogInfo("HailoRT shutdown complete");
+    if (backend_shutdown_) {
+        backend_shutdown_();
+    }
+    LogInfo("Inference shutdown complete");
 }
 
 HailoInference::~HailoInference() {
     is_ready_ = false;
+    if (engine_) {
+        engine_->Stop();  // Read frames still on the device before the backend goes
+    }
 }
 
-VoidResult HailoInference::Initialize(const std::string& hef_path) {
-    using namespace hailort;
-
+VoidResult HailoInference::Initialize(const std::string& hef_path, const std::string& device_id) {
     hef_path_ = hef_path;
-    LogInfo("Initializing HailoRT inference with HEF: " + hef_path);
-
-    // Create shared VDevice if not exists
-    if (!shared_vdevice_) {
-        auto vdevice_exp = VDevice::create();
-        if (!vdevice_exp) {
-            return MakeError("Failed to create VDevice: " +
-                            std::to_string(static_cast<int>(vdevice_exp.status())));
-        }
-        shared_vdevice_ = std::shared_ptr<VDevice>(vdevice_exp.release());
-        LogInfo("Shared VDevice created for multi-stream inference");
-    }
+    device_id_ = device_id;
 
-    // Load HEF
-    auto hef_exp = Hef::create(hef_path);
-    if (!hef_exp) {
-        return MakeError("Failed to load HEF: " +
-                        std::to_string(static_cast<int>(hef_exp.status())));
+    // Called from GetInstance with static_mutex_ held
+    if (!backend_factory_) {
+        return MakeError("No inference backend configured for " + hef_path);
     }
-    auto hef = hef_exp.release();
-
-    // Configure network group on shared VDevice
-    auto network_groups_exp = shared_vdevice_->configure(hef);
-    if (!network_groups_exp) {
-        return MakeError("Failed to configure network: " +
-                        std::to_string(static_cast<int>(network_groups_exp.status())));
+    backend_ = backend_factory_(hef_path, device_id);
+    if (!backend_) {
+        return MakeError("Inference backend factory returned no backend for " + hef_path);
     }
-    auto network_groups = network_groups_exp.release();
+    LogInfo("Initializing " + std::string(backend_->GetName()) +
+            " inference with model: " + hef_path +
+            (device_id.empty() ? std::string() : " on device " + device_id));
 
-    if (network_groups.empty()) {
-        return MakeError("No network groups found in HEF");
+    if (auto result = backend_->Configure(hef_path); IsError(result)) {
+        return result;
     }
-    network_group_ = network_groups[0];
 
-    // Get input/output info
-    auto input_vstream_infos = network_group_->get_input_vstream_infos();
-    if (!input_vstream_infos) {
-        return MakeError("Failed to get input vstream infos");
+    const auto& inputs = backend_->GetInputs();
+    const auto& outputs = backend_->GetOutputs();
+    if (inputs.empty()) {
+        return MakeError("Model has no input streams: " + hef_path);
     }
-
-    auto output_vstream_infos = network_group_->get_output_vstream_infos();
-    if (!output_vstream_infos) {
-        return MakeError("Failed to get output vstream infos");
+    if (outputs.empty()) {
+        return MakeError("Model has no output streams: " + hef_path);
     }
 
     // Get input dimensions from first input
-    if (!input_vstream_infos->empty()) {
-        const auto& input_info = (*input_vstream_infos)[0];
-        input_height_ = input_info.shape.height;
-        input_width_ = input_info.shape.width;
-
-        // Use batch=1 for stable operation
-        batch_size_ = 1;
-
-        LogInfo("Model input: " + std::to_string(input_width_) + "x" +
-                std::to_string(input_height_) + ", batch=" + std::to_string(batch_size_));
-    }
+    input_height_ = inputs[0].height;
+    input_width_ = inputs[0].width;
+    batch_size_ = std::max(1, backend_->GetBatchSize());
+    LogInfo("Model input: " + std::to_string(input_width_) + "x" +
+            std::to_string(input_height_) + ", batch=" + std::to_string(batch_size_));
+
+    // Output layout decides the decoder for every context of this model
+    auto context = std::make_shared<ModelContext>();
+    context->model_path = hef_path;
+    context->input_width = input_width_;
+    context->input_height = input_height_;
 
     // Check output for NMS format
-    if (!output_vstream_infos->empty()) {
-        const auto& output_info = (*output_vstream_infos)[0];
-        if (output_info.nms_shape.number_of_classes > 0) {
-            is_nms_output_ = true;
-            num_classes_ = output_info.nms_shape.number_of_classes;
-            max_bboxes_per_class_ = output_info.nms_shape.max_bboxes_per_class;
-            LogInfo("NMS output: " + std::to_string(num_classes_) + " classes, " +
-                    std::to_string(max_bboxes_per_class_) + " max bboxes/class");
+    if (outputs[0].nms_classes > 0) {
+        if (outputs[0].type != TensorDataType::kFloat32) {
+            return MakeError("NMS output must be FLOAT32, got " +
+                             std::string(TensorDataTypeToString(outputs[0].type)) + ": " + hef_path);
         }
+        context->decoder = OutputDecoder::kNms;
+        context->num_classes = outputs[0].nms_classes;
+        context->max_bboxes_per_class = outputs[0].nms_max_bboxes_per_class;
+        LogInfo("NMS output: " + std::to_string(context->num_classes) + " classes, " +
+                std::to_string(context->max_bboxes_per_class) + " max bboxes/class");
     }
 
-    // Create VStreams with separate params for input (UINT8) and output (FLOAT32)
-    hailo_vstream_params_t input_params = HailoRTDefaults::get_vstreams_params();
-    input_params.user_buffer_format.type = HAILO_FORMAT_TYPE_UINT8;
-    input_params.timeout_ms = 30000;  // 30 second timeout for heavy models
-
-    hailo_vstream_params_t output_params = HailoRTDefaults::get_vstreams_params();
-    output_params.user_buffer_format.type = HAILO_FORMAT_TYPE_FLOAT32;
-    output_params.timeout_ms = 30000;  // 30 second timeout for heavy models
-
-    // Build input params map
-    std::map<std::string, hailo_vstream_params_t> input_params_map;
-    for (const auto& info : *input_vstream_infos) {
-        input_params_map[info.name] = input_params;
-    }
-
-    // Build output params map
-    std::map<std::string, hailo_vstream_params_t> output_params_map;
-    for (const auto& info : *output_vstream_infos) {
-        output_params_map[info.name] = output_params;
-    }
-
-    // Create input vstreams
-    auto input_vstreams_exp = VStreamsBuilder::create_input_vstreams(*network_group_, input_params_map);
-    if (!input_vstreams_exp) {
-        return MakeError("Failed to create input vstreams");
-    }
-    input_vstreams_ = input_vstreams_exp.release();
-
-    // Create output vstreams
-    auto output_vstreams_exp = VStreamsBuilder::create_output_vstreams(*network_group_, output_params_map);
-    if (!output_vstreams_exp) {
-        return MakeError("Failed to create output vstreams");
-    }
-    output_vstreams_ = output_vstreams_exp.release();
-
     // Get frame sizes
-    if (!input_vstreams_.empty()) {
-        input_frame_size_ = input_vstreams_[0].get_frame_size();
-        input_buffer_.resize(input_frame_size_);
-        LogInfo("Input frame size: " + std::to_string(input_frame_size_) + " bytes");
+    input_frame_size_ = inputs[0].frame_size;
+    {
+        std::lock_guard<std::mutex> lock(input_slot_mutex_);
+        free_input_slots_.clear();
     }
-
-    // Create buffers for ALL output vstreams (critical for multi-output models like best12.hef)
-    // Each read() returns one frame's output, so buffer size = single frame size
-    output_buffers_.resize(output_vstreams_.size());
-    output_frame_sizes_.resize(output_vstreams_.size());
-
-    for (size_t i = 0; i < output_vstreams_.size(); ++i) {
-        output_frame_sizes_[i] = output_vstreams_[i].get_frame_size();
-        output_buffers_[i].resize(output_frame_sizes_[i]);
-        LogInfo("Output[" + std::to_string(i) + "] '" + output_vstreams_[i].name() +
-                "': " + std::to_string(output_frame_sizes_[i]) + " bytes");
+    LogInfo("Input frame size: " + std::to_string(input_frame_size_) + " bytes");
+
+    // Sizes of ALL output streams (critical for multi-output models like best12.hef)
+    // Each read returns one frame's output, so buffer size = single frame size
+    output_frame_sizes_.resize(outputs.size());
+    for (size_t i = 0; i < outputs.size(); ++i) {
+        output_frame_sizes_[i] = outputs[i].frame_size;
+        LogInfo("Output[" + std::to_string(i) + "] '" + outputs[i].name +
+                "': " + std::to_string(output_frame_sizes_[i]) + " bytes " +
+                std::string(TensorDataTypeToString(outputs[i].type)));
     }
 
-    if (output_vstreams_.size() > 1) {
-        LogInfo("Multi-output model detected: " + std::to_string(output_vstreams_.size()) + " output vstreams");
+    if (outputs.size() > 1) {
+        LogInfo("Multi-output model detected: " + std::to_string(outputs.size()) + " output streams");
         // Multi-output models (like best12.hef) are raw YOLO outputs, not NMS
-        is_raw_yolo_output_ = true;
-        is_nms_output_ = false;
+        context->decoder = OutputDecoder::kRawYolo;
         LogInfo("Using raw YOLO output parsing (multi-scale feature maps)");
     }
+    default_context_ = context;
+    contexts_.clear();
 
-    // Note: Don't manually activate - the scheduler handles activation automatically
-    // when using VStreams with shared VDevice
+    // Writer and reader threads keep up to kInferenceMaxInFlight frames on the device
+    AsyncInferenceEngine::DeviceIo io;
+    io.write = [this](const uint8_t* data, size_t size) {
+        return backend_->Write(data, size);
+    };
+    io.read = [this](size_t index, uint8_t* data, size_t size) {
+        // Read from ALL output streams (critical to prevent buffer overflow/timeout)
+        return backend_->Read(index, data, size);
+    };
+    engine_ = std::make_unique<AsyncInferenceEngine>(
+        std::move(io), input_frame_size_, output_frame_sizes_,
+        std::max(kInferenceMaxInFlight, batch_size_));
 
     is_ready_ = true;
-    LogInfo("HailoRT inference initialized successfully");
+    LogInfo("Inference initialized successfully (" + std::string(backend_->GetName()) + ")");
 
     return MakeOk();
 }
 
 std::vector<Detection> HailoInference::RunInference(
-    const uint8_t* rgb_data,
-    int width,
-    int height,
-    float confidence_threshold) {
+    const FrameView& frame,
+    const InferenceRequest& request) {
 
-    static int inference_count = 0;
+    static std::atomic<int> inference_counter{0};
 
-    if (!is_ready_ || input_vstreams_.empty() || output_vstreams_.empty()) {
+    if (!is_ready_) {
         LogWarning("RunInference: not ready");
         return {};
     }
 
-    std::lock_guard<std::mutex> lock(inference_mutex_);
+    if ((frame.format != PixelFormat::kRGB && !frame.IsYuv()) || !frame.IsValid()) {
+        LogWarning("RunInference: unsupported frame format");
+        return {};
+    }
+
+    const int width = frame.width;
+    const int height = frame.height;
+
+    // Letterbox resize input (maintains aspect ratio with padding);
+    // YUV frames are converted in the same pass
+    auto slot = AcquireInputSlot();
+    const auto preprocess_start = std::chrono::steady_clock::now();
+    const LetterboxInfo letterbox_info = Preprocess(frame, *slot);
+    preprocess_timer_.RecordSince(preprocess_start);
 
-    ++inference_count;
+    const int inference_count = ++inference_counter;
     if (inference_count == 1 || inference_count % 100 == 0) {
         LogInfo("RunInference: frame #" + std::to_string(inference_count) +
                 " (" + std::to_string(width) + "x" + std::to_string(height) + ")");
     }
+    if (inference_count == 1 && letterbox_info.scale != 1.0f) {
+        LogInfo("RunInference: letterbox resize " + std::to_string(width) + "x" +
+                std::to_string(height) + " -> " + std::to_string(input_width_) + "x" +
+                std::to_string(input_height_) + " (scale=" +
+                std::to_string(letterbox_info.scale) + ", pad=" +
+                std::to_string(letterbox_info.pad_x) + "," +
+                std::to_string(letterbox_info.pad_y) + ", kernel=" +
+                std::string(SimdLevelToString(slot->resizer.GetSimdLevel())) + ", bands=" +
+                std::to_string(slot->resizer.GetLastBandCount()) + ")");
+    }
 
-    // Letterbox resize input (maintains aspect ratio with padding)
-    LetterboxInfo letterbox_info;
-    if (width != input_width_ || height != input_height_) {
-        letterbox_info = LetterboxResize(rgb_data, width, height,
-                                          input_buffer_.data(), input_width_, input_height_);
-        if (inference_count == 1) {
-            LogInfo("RunInference: letterbox resize " + std::to_string(width) + "x" +
-                    std::to_string(height) + " -> " + std::to_string(input_width_) + "x" +
-                    std::to_string(input_height_) + " (scale=" +
-                    std::to_string(letterbox_info.scale) + ", pad=" +
-                    std::to_string(letterbox_info.pad_x) + "," +
-                    std::to_string(letterbox_info.pad_y) + ")");
-        }
-    } else {
-        std::memcpy(input_buffer_.data(), rgb_data, input_frame_size_);
-        letterbox_info.scale = 1.0f;
-        letterbox_info.pad_x = 0;
-        letterbox_info.pad_y = 0;
-        letterbox_info.new_w = width;
-        letterbox_info.new_h = height;
-    }
-
-    // Write to input vstream
-    if (inference_count == 1) {
-        LogInfo("RunInference: writing to input vstream...");
-    }
-    auto status = input_vstreams_[0].write(
-        hailort::MemoryView(input_buffer_.data(), input_buffer_.size()));
-    if (status != HAILO_SUCCESS) {
-        LogWarning("Failed to write to input vstream: " + std::to_string(static_cast<int>(status)));
-        // On error, wait a bit before next attempt
-        std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    // The slot goes back to the free list once written; other callers'
+    // frames are written and read while this one waits
+    const auto inference_start = std::chrono::steady_clock::now();
+    const uint8_t* input = slot->buffer.data();
+    auto outputs = engine_->Submit(input, std::move(slot)).get();
+    if (IsError(outputs)) {
+        LogWarning("RunInference: " + GetError(outputs));
         return {};
     }
+    auto detections = ParseOutputs(*GetValue(outputs), request, letterbox_info, width, height);
+    inference_timer_.RecordSince(inference_start);
 
-    // Read from ALL output vstreams (critical to prevent buffer overflow/timeout)
-    if (inference_count == 1) {
-        LogInfo("RunInference: reading from " + std::to_string(output_vstreams_.size()) + " output vstream(s)...");
+    if (inference_count == 1 || (inference_count % 100 == 0 && !detections.empty())) {
+        LogInfo("RunInference: found " + std::to_string(detections.size()) + " detections");
+    }
+    if (inference_count % 100 == 0) {
+        const StageTiming preprocess = preprocess_timer_.Summary();
+        const StageTiming inference = inference_timer_.Summary();
+        LogInfo("RunInference: preprocess mean=" + std::to_string(preprocess.mean_us) +
+                "us p95=" + std::to_string(preprocess.p95_us) + "us, inference mean=" +
+                std::to_string(inference.mean_us) + "us p95=" +
+                std::to_string(inference.p95_us) + "us");
     }
 
-    for (size_t i = 0; i < output_vstreams_.size(); ++i) {
-        status = output_vstreams_[i].read(
-            hailort::MemoryView(output_buffers_[i].data(), output_buffers_[i].size()));
-        if (status != HAILO_SUCCESS) {
-            LogWarning("Failed to read from output vstream[" + std::to_string(i) + "]: " +
-                      std::to_string(static_cast<int>(status)));
-            // On error, wait a bit before next attempt
-            std::this_thread::sleep_for(std::chrono::milliseconds(100));
-            return {};
-        }
+    return detections;
+}
+
+std::vector<Detection> HailoInference::RunInferenceLetterboxed(
+    const FrameView& model_frame,
+    int source_width,
+    int source_height,
+    const InferenceRequest& request) {
+
+    if (!is_ready_) {
+        LogWarning("RunInferenceLetterboxed: not ready");
+        return {};
     }
 
-    // Parse output - use appropriate parser based on model type
-    std::vector<Detection> detections;
-    if (is_raw_yolo_output_ && !output_buffers_.empty()) {
-        // Multi-output model (like best12.hef) - use raw YOLO parsing
-        if (inference_count == 1) {
-            LogInfo("Using raw YOLO output parsing for " + std::to_string(output_vstreams_.size()) + " outputs");
-        }
-        detections = ParseRawYoloOutput(output_buffers_, confidence_threshold, 0.45f,
-                                         width, height, letterbox_info);
-    } else if (is_nms_output_ && !output_buffers_.empty()) {
-        // Single NMS output - parse first vstream
-        detections = ParseNmsOutput(output_buffers_[0], confidence_threshold,
-                                     width, height, letterbox_info);
+    if (model_frame.format != PixelFormat::kRGB ||
+        model_frame.width != input_width_ || model_frame.height != input_height_) {
+        LogWarning("RunInferenceLetterboxed: frame does not match model input");
+        return {};
     }
 
-    if (inference_count == 1 || (inference_count % 100 == 0 && !detections.empty())) {
-        LogInfo("RunInference: found " + std::to_string(detections.size()) + " detections");
+    // Pipeline scaled with borders; only the geometry is needed to map back
+    const LetterboxInfo letterbox_info = ComputeLetterbox(
+        source_width, source_height, input_width_, input_height_);
+
+    // Packed rows go to the device as-is, padded rows are packed first
+    const uint8_t* input = model_frame.planes[0];
+    std::shared_ptr<InputSlot> slot;
+    if (!model_frame.IsPackedRgb()) {
+        slot = AcquireInputSlot();
+        const auto preprocess_start = std::chrono::steady_clock::now();
+        CopyPacked(model_frame, slot->buffer.data());
+        slot->resizer.Invalidate(slot->buffer.data());
+        preprocess_timer_.RecordSince(preprocess_start);
+        input = slot->buffer.data();
     }
 
+    // model_frame stays mapped by the caller until the outputs are back
+    const auto inference_start = std::chrono::steady_clock::now();
+    auto outputs = engine_->Submit(input, std::move(slot)).get();
+    if (IsError(outputs)) {
+        LogWarning("RunInferenceLetterboxed: " + GetError(outputs));
+        return {};
+    }
+    auto detections = ParseOutputs(*GetValue(outputs), request, letterbox_info,
+                                   source_width, source_height);
+    inference_timer_.RecordSince(inference_start);
     return detections;
 }
 
+std::shared_ptr<HailoInference::InputSlot> HailoInference::AcquireInputSlot() {
+    std::unique_ptr<InputSlot> slot;
+    {
+        std::lock_guard<std::mutex> lock(input_slot_mutex_);
+        if (!free_input_slots_.empty()) {
+            slot = std::move(free_input_slots_.back());
+            free_input_slots_.pop_back();
+        }
+    }
+
+    if (!slot) {
+        slot = std::make_unique<InputSlot>();
+        slot->buffer.assign(input_frame_size_, kLetterboxPadValue);
+        slot->resizer.SetWorkerPool(&CpuWorkerPool::Shared());
+    }
+
+    // Callers hold the slot only for the duration of one inference call
+    return std::shared_ptr<InputSlot>(slot.release(), [this](InputSlot* released) {
+        std::lock_guard<std::mutex> lock(input_slot_mutex_);
+        free_input_slots_.emplace_back(released);
+    });
+}
+
+HailoInference::LetterboxInfo HailoInference::Preprocess(const FrameView& frame,
+                                                         InputSlot& slot) const {
+    uint8_t* dst = slot.buffer.data();
+    if (frame.width != input_width_ || frame.height != input_height_ || frame.IsYuv()) {
+        return slot.resizer.Resize(frame, dst, input_width_, input_height_);
+    }
+
+    CopyPacked(frame, dst);
+    slot.resizer.Invalidate(dst);
+
+    LetterboxInfo letterbox_info;
+    letterbox_info.scale = 1.0f;
+    letterbox_info.pad_x = 0;
+    letterbox_info.pad_y = 0;
+    letterbox_info.new_w = frame.width;
+    letterbox_info.new_h = frame.height;
+    return letterbox_info;
+}
+
+const ModelContext& HailoInference::ContextFor(const InferenceRequest& request) const {
+    return request.context ? *request.context : *default_context_;
+}
+
+float HailoInference::ThresholdFor(const InferenceRequest& request, const ModelContext& context) {
+    return request.confidence_threshold >= 0.0f ? request.confidence_threshold
+                                                : context.spec.confidence_threshold;
+}
+
+std::vector<Detection> HailoInference::ParseOutputs(
+    const AsyncInferenceEngine::OutputBuffers& outputs,
+    const InferenceRequest& request,
+    const LetterboxInfo& letterbox,
+    int frame_width,
+    int frame_height) {
+
+    // The context is immutable: no lock, whichever stream it belongs to
+    const ModelContext& context = ContextFor(request);
+    const float confidence_threshold = ThresholdFor(request, context);
+    if (outputs.empty()) {
+        return {};
+    }
+
+    // Parse output - use appropriate parser based on model type
+    switch (context.decoder) {
+        case OutputDecoder::kRawYolo:
+            // Multi-output model (like best12.hef) - use raw YOLO parsing
+            return ParseRawYoloOutput(outputs, context, confidence_threshold,
+                                      frame_width, frame_height, letterbox);
+        case OutputDecoder::kNms:
+            // Single NMS output - parse first output stream
+            return ParseNmsOutput(outputs[0], context, confidence_threshold,
+                                  frame_width, frame_height, letterbox);
+        case OutputDecoder::kNone:
+            break;
+    }
+    return {};
+}
+
 std::unordered_map<std::string, std::vector<Detection>> HailoInference::RunBatchInference(
-    const std::vector<FrameInput>& frames,
-    float confidence_threshold) {
+    const std::vector<FrameInput>& frames) {
 
-    static int batch_inference_count = 0;
+    static std::atomic<int> batch_inference_counter{0};
     std::unordered_map<std::string, std::vector<Detection>> results;
 
-    if (!is_ready_ || input_vstreams_.empty() || output_vstreams_.empty()) {
+    if (!is_ready_) {
         LogWarning("RunBatchInference: not ready");
         return results;
     }
@@ -380,85 +507,87 @@ std::unordered_map<std::string, std::vector<Detection>> HailoInference::RunBatch
         return results;
     }
 
-    std::lock_guard<std::mutex> lock(inference_mutex_);
-    ++batch_inference_count;
-
     const int num_frames = static_cast<int>(frames.size());
-    const int actual_batch = std::min(num_frames, batch_size_);
+
+    // Prepare per-frame buffers before submitting (Hailo batch = multiple
+    // write() calls, not a concatenated buffer). Slots keep their letterbox borders,
+    // which are only repainted on geometry changes.
+    const size_t single_frame_size = input_frame_size_;
+    std::vector<std::shared_ptr<InputSlot>> slots(num_frames);
+    std::vector<LetterboxInfo> letterbox_infos(num_frames);
+
+    for (int i = 0; i < num_frames; ++i) {
+        slots[i] = AcquireInputSlot();
+
+        InputSlot& slot = *slots[i];
+        uint8_t* dst = slot.buffer.data();
+        const auto& view = frames[i].frame;
+        const auto preprocess_start = std::chrono::steady_clock::now();
+
+        if ((view.format != PixelFormat::kRGB && !view.IsYuv()) || !view.IsValid()) {
+            LogWarning("RunBatchInference: unsupported frame format for " +
+                       frames[i].stream_id);
+            std::memset(dst, kLetterboxPadValue, single_frame_size);
+            slot.resizer.Invalidate(dst);
+            continue;
+        }
+
+        if (frames[i].source_width > 0 && frames[i].source_height > 0) {
+            // Already letterboxed by the pipeline - keep source geometry for mapping
+            if (view.width != input_width_ || view.height != input_height_) {
+                LogWarning("RunBatchInference: pre-letterboxed frame does not match model input");
+                std::memset(dst, kLetterboxPadValue, single_frame_size);
+                slot.resizer.Invalidate(dst);
+                continue;
+            }
+            CopyPacked(view, dst);
+            slot.resizer.Invalidate(dst);
+            letterbox_infos[i] = ComputeLetterbox(frames[i].source_width,
+                                                  frames[i].source_height,
+                                                  input_width_, input_height_);
+        } else {
+            letterbox_infos[i] = Preprocess(view, slot);
+        }
+        preprocess_timer_.RecordSince(preprocess_start);
+    }
+
+    const int batch_inference_count = ++batch_inference_counter;
 
     if (batch_inference_count == 1 || batch_inference_count % 100 == 0) {
         LogInfo("RunBatchInference: batch #" + std::to_string(batch_inference_count) +
                 ", frames=" + std::to_string(num_frames) + "/" + std::to_string(batch_size_));
     }
 
-    // Prepare per-frame buffers (Hailo batch = multiple write() calls, not concatenated buffer)
-    const size_t single_frame_size = input_width_ * input_height_ * 3;
-    std::vector<std::vector<uint8_t>> frame_buffers(batch_size_, std::vector<uint8_t>(single_frame_size, 114));
-    std::vector<LetterboxInfo> letterbox_infos(batch_size_);
-
-    // Process each frame in the batch
-    for (int i = 0; i < batch_size_; ++i) {
-        uint8_t* dst = frame_buffers[i].data();
-
-        if (i < num_frames) {
-            const auto& frame = frames[i];
-            if (frame.width != input_width_ || frame.height != input_height_) {
-                letterbox_infos[i] = LetterboxResize(frame.rgb_data, frame.width, frame.height,
-                                                      dst, input_width_, input_height_);
-            } else {
-                std::memcpy(dst, frame.rgb_data, single_frame_size);
-                letterbox_infos[i].scale = 1.0f;
-                letterbox_infos[i].pad_x = 0;
-                letterbox_infos[i].pad_y = 0;
-                letterbox_infos[i].new_w = frame.width;
-                letterbox_infos[i].new_h = frame.height;
-            }
-        }
-        // Else: already padded with gray (114)
-    }
-
-    // Write each frame separately (Hailo batch_size=N means N sequential writes before read)
-    hailo_status status;
-    for (int i = 0; i < batch_size_; ++i) {
-        status = input_vstreams_[0].write(
-            hailort::MemoryView(frame_buffers[i].data(), frame_buffers[i].size()));
-        if (status != HAILO_SUCCESS) {
-            LogWarning("RunBatchInference: failed to write frame " + std::to_string(i) +
-                      ": " + std::to_string(static_cast<int>(status)));
-            return results;
-        }
+    const auto inference_start = std::chrono::steady_clock::now();
+
+    // Hailo batch_size=N means N writes; the engine queues them back to back
+    // and each frame's outputs come back separately. A short batch is written
+    // as-is: the device scheduler runs it after kInferenceBatchFlushMs.
+    std::vector<std::future<Result<AsyncInferenceEngine::Outputs>>> pending;
+    pending.reserve(num_frames);
+    for (int i = 0; i < num_frames; ++i) {
+        const uint8_t* input = slots[i]->buffer.data();
+        pending.push_back(engine_->Submit(input, std::move(slots[i])));
     }
 
-    // For batch mode: read and parse each frame's outputs separately
-    // Hailo batch = multiple write() calls followed by multiple read() calls
-    // Each read() returns one frame's output
-    for (int frame_idx = 0; frame_idx < actual_batch && frame_idx < num_frames; ++frame_idx) {
-        // Read from all output vstreams for this frame
-        for (size_t i = 0; i < output_vstreams_.size(); ++i) {
-            status = output_vstreams_[i].read(
-                hailort::MemoryView(output_buffers_[i].data(), output_buffers_[i].size()));
-            if (status != HAILO_SUCCESS) {
-                LogWarning("RunBatchInference: failed to read output[" + std::to_string(i) +
-                          "] for frame " + std::to_string(frame_idx));
-                return results;
-            }
+    for (int frame_idx = 0; frame_idx < num_frames; ++frame_idx) {
+        auto outputs = pending[frame_idx].get();
+        if (IsError(outputs)) {
+            LogWarning("RunBatchInference: frame " + std::to_string(frame_idx) + ": " +
+                       GetError(outputs));
+            continue;
         }
 
-        // Parse outputs for this frame
+        // Parse outputs for this frame (in source geometry when pre-letterboxed)
+        // with the frame's own context and threshold
         const auto& frame = frames[frame_idx];
-        std::vector<Detection> detections;
-
-        if (is_raw_yolo_output_ && !output_buffers_.empty()) {
-            // output_buffers_ now contains single frame outputs (already read)
-            detections = ParseRawYoloOutput(output_buffers_, confidence_threshold, 0.45f,
-                                             frame.width, frame.height, letterbox_infos[frame_idx]);
-        } else if (is_nms_output_ && !output_buffers_.empty()) {
-            detections = ParseNmsOutput(output_buffers_[0], confidence_threshold,
-                                         frame.width, frame.height, letterbox_infos[frame_idx]);
-        }
-
-        results[frame.stream_id] = std::move(detections);
+        const int frame_width = frame.source_width > 0 ? frame.source_width : frame.frame.width;
+        const int frame_height = frame.source_height > 0 ? frame.source_height : frame.frame.height;
+        results[frame.stream_id] = ParseOutputs(*GetValue(outputs), frame.request,
+                                                letterbox_infos[frame_idx],
+                                                frame_width, frame_height);
     }
+    inference_timer_.RecordSince(inference_start);
 
     if (batch_inference_count == 1 || batch_inference_count % 100 == 0) {
         size_t total_detections = 0;
@@ -471,8 +600,51 @@ std::unordered_map<std::string, std::vector<Detection>> HailoInference::RunBatch
     return results;
 }
 
+std::vector<Detection> HailoInference::RunTiledInference(
+    const FrameView& frame,
+    const std::vector<BoundingBox>& tiles,
+    const InferenceRequest& request) {
+
+    std::vector<Detection> merged;
+    if (!frame.IsValid() || tiles.empty()) {
+        return merged;
+    }
+
+    const size_t group_size = static_cast<size_t>(std::max(1, batch_size_));
+    std::vector<FrameInput> inputs;
+    inputs.reserve(group_size);
+
+    for (size_t first = 0; first < tiles.size(); first += group_size) {
+        const size_t last = std::min(tiles.size(), first + group_size);
+
+        // Batch results are keyed by stream_id: use the tile index
+        inputs.clear();
+        for (size_t i = first; i < last; ++i) {
+            FrameInput input;
+            input.frame = frame.Crop(tiles[i].x, tiles[i].y, tiles[i].width, tiles[i].height);
+            input.stream_id = std::to_string(i);
+            input.request = request;
+            inputs.push_back(std::move(input));
+        }
+
+        auto results = RunBatchInference(inputs);
+        for (size_t i = first; i < last; ++i) {
+            auto it = results.find(std::to_string(i));
+            if (it == results.end()) {
+                continue;
+            }
+            OffsetDetections(it->second, tiles[i], frame.width, frame.height);
+            std::move(it->second.begin(), it->second.end(), std::back_inserter(merged));
+        }
+    }
+
+    SuppressOverlappingDetections(merged, kTileMergeOverlap);
+    return merged;
+}
+
 std::vector<Detection> HailoInference::ParseNmsOutput(
     const std::vector<uint8_t>& output_data,
+    const ModelContext& context,
     float confidence_threshold,
     int frame_width,
     int frame_height,
@@ -480,7 +652,7 @@ std::vector<Detection> HailoInference::ParseNmsOutput(
 
     std::vector<Detection> detections;
 
-    if (!is_nms_output_) {
+    if (context.decoder != OutputDecoder::kNms) {
         LogWarning("Model doesn't have NMS output");
         return detections;
     }
@@ -490,11 +662,11 @@ std::vector<Detection> HailoInference::ParseNmsOutput(
 
     // Calculate actual params per detection slot from output size
     // num_floats = num_classes * max_bboxes_per_class * params_per_det
-    const int total_slots = num_classes_ * max_bboxes_per_class_;
+    const int total_slots = context.num_classes * context.max_bboxes_per_class;
     const int actual_det_params = (total_slots > 0) ? (num_floats / total_slots) : 0;
 
     // Expected params for pose model: 5 (bbox+score) + num_keypoints*3
-    const int keypoint_params = (task_ == "pose") ? num_keypoints_ * 3 : 0;
+    const int keypoint_params = (context.spec.task == "pose") ? context.spec.num_keypoints * 3 : 0;
     const int expected_det_params = 5 + keypoint_params;
 
     // Debug: print structure info
@@ -525,9 +697,9 @@ std::vector<Detection> HailoInference::ParseNmsOutput(
 
     // For Hailo NMS output: iterate through all detection slots
     // Format: [class0_det0, class0_det1, ..., class1_det0, ...]
-    for (int cls = 0; cls < num_classes_; ++cls) {
-        for (int i = 0; i < max_bboxes_per_class_; ++i) {
-            size_t det_offset = (cls * max_bboxes_per_class_ + i) * det_params;
+    for (int cls = 0; cls < context.num_classes; ++cls) {
+        for (int i = 0; i < context.max_bboxes_per_class; ++i) {
+            size_t det_offset = (cls * context.max_bboxes_per_class + i) * det_params;
             if (det_offset + 5 > num_floats) break;
 
             // Try standard format: [y_min, x_min, y_max, x_max, score, ...]
@@ -555,14 +727,8 @@ std::vector<Detection> HailoInference::ParseNmsOutput(
             Detection det;
             det.class_id = cls;
 
-            // Use labels_ if available, otherwise fallback to COCO labels
-            if (!labels_.empty() && cls < static_cast<int>(labels_.size())) {
-                det.class_name = labels_[cls];
-            } else if (cls < NUM_COCO_LABELS) {
-                det.class_name = COCO_LABELS[cls];
-            } else {
-                det.class_name = "object";
-            }
+            // Use labels if available, otherwise fallback to COCO labels
+            det.class_name = context.ClassName(cls);
             det.confidence = score;
 
             det.bbox.x = static_cast<int>(x1_orig);
@@ -577,8 +743,8 @@ std::vector<Detection> HailoInference::ParseNmsOutput(
             det.bbox.height = std::min(det.bbox.height, frame_height - det.bbox.y);
 
             // Parse keypoints for pose model
-            if (task_ == "pose" && num_keypoints_ > 0) {
-                for (int k = 0; k < num_keypoints_; ++k) {
+            if (context.spec.task == "pose" && context.spec.num_keypoints > 0) {
+                for (int k = 0; k < context.spec.num_keypoints; ++k) {
                     size_t kp_offset = det_offset + 5 + k * 3;
                     if (kp_offset + 3 > num_floats) break;
 
@@ -611,7 +777,7 @@ std::vector<Detection> HailoInference::ParseNmsOutput(
                         << " bbox=(" << det.bbox.x << "," << det.bbox.y
                         << "," << det.bbox.width << "," << det.bbox.height << ")"
                         << " frame=" << frame_width << "x" << frame_height
-                        << " (labels_size=" << labels_.size() << ")";
+                        << " (labels_size=" << context.spec.labels.size() << ")";
                     LogInfo(oss.str());
                     ++det_log_count;
                 }
@@ -680,8 +846,8 @@ std::vector<int> HailoInference::ApplyNMS(
 
 std::vector<Detection> HailoInference::ParseRawYoloOutput(
     const std::vector<std::vector<uint8_t>>& output_buffers,
+    const ModelContext& context,
     float confidence_threshold,
-    float iou_threshold,
     int frame_width,
     int frame_height,
     const LetterboxInfo& letterbox) {
@@ -692,8 +858,8 @@ std::vector<Detection> HailoInference::ParseRawYoloOutput(
         return detections;
     }
 
-    // Model parameters - use SetModelConfig values or defaults
-    const int model_num_keypoints = (num_keypoints_ > 0) ? num_keypoints_ : 4;
+    // Model parameters - from the request's context
+    const int model_num_keypoints = (context.spec.num_keypoints > 0) ? context.spec.num_keypoints : 4;
     const int reg_max = 16;  // DFL bins
 
     // Debug output structure
@@ -705,9 +871,10 @@ std::vector<Detection> HailoInference::ParseRawYoloOutput(
         LogInfo(oss.str());
 
         for (size_t i = 0; i < output_buffers.size(); ++i) {
-            size_t num_floats = output_buffers[i].size() / sizeof(float);
-            LogInfo("  Output[" + std::to_string(i) + "]: " + std::to_string(num_floats) + " floats (" +
-                    output_vstreams_[i].name() + ")");
+            const auto& info = backend_->GetOutputs()[i];
+            size_t num_values = output_buffers[i].size() / TensorDataTypeSize(info.type);
+            LogInfo("  Output[" + std::to_string(i) + "]: " + std::to_string(num_values) + " " +
+                    std::string(TensorDataTypeToString(info.type)) + " (" + info.name + ")");
         }
         ++debug_count;
     }
@@ -745,15 +912,15 @@ std::vector<Detection> HailoInference::ParseRawYoloOutput(
     int p5_dfl = -1, p5_class = -1, p5_kp = -1;
 
     // Dynamic num_classes from labels (fallback to 13 for backward compatibility)
-    const int num_classes = labels_.empty() ? 13 : static_cast<int>(labels_.size());
-    const int num_kp_channels = (num_keypoints_ > 0) ? num_keypoints_ * 3 : 12;
+    const int num_classes = context.spec.labels.empty() ? 13 : static_cast<int>(context.spec.labels.size());
+    const int num_kp_channels = (context.spec.num_keypoints > 0) ? context.spec.num_keypoints * 3 : 12;
 
     // Map outputs by tensor NAME (not size - size can collide when num_classes=16)
     // conv43/44/45 = P3 (DFL/Class/KP)
     // conv57/58/59 = P4 (DFL/Class/KP)
     // conv70/71/72 = P5 (DFL/Class/KP)
     for (size_t i = 0; i < output_buffers.size(); ++i) {
-        std::string name = output_vstreams_[i].name();
+        const std::string& name = backend_->GetOutputs()[i].name;
 
         // P3 outputs
         if (name.find("conv43") != std::string::npos) p3_dfl = i;
@@ -821,12 +988,27 @@ std::vector<Detection> HailoInference::ParseRawYoloOutput(
     std::vector<int> all_class_ids;
     std::vector<std::vector<std::array<float, 3>>> all_keypoints;
 
+    // Outputs may be FLOAT32 or quantized (HailoConfig::quantized_outputs)
+    const auto& output_infos = backend_->GetOutputs();
+    auto tensor = [&](int index) {
+        OutputTensor out;
+        out.data = output_buffers[index].data();
+        out.type = output_infos[index].type;
+        out.quant = output_infos[index].quant;
+        return out;
+    };
+    std::array<float, 4 * reg_max> dfl_scratch{};
+
     // Process each scale
     for (const auto& scale : scales) {
-        const float* dfl_data = reinterpret_cast<const float*>(output_buffers[scale.dfl_idx].data());
-        const float* class_data = reinterpret_cast<const float*>(output_buffers[scale.class_idx].data());
-        const float* kp_data = (scale.kp_idx >= 0) ?
-            reinterpret_cast<const float*>(output_buffers[scale.kp_idx].data()) : nullptr;
+        const OutputTensor dfl_data = tensor(scale.dfl_idx);
+        const OutputTensor class_data = tensor(scale.class_idx);
+        const OutputTensor kp_data = (scale.kp_idx >= 0) ? tensor(scale.kp_idx) : OutputTensor{};
+
+        // Quantized scores: the threshold as a code, once per scale
+        const QuantizedScores quantized_scores = class_data.IsQuantized()
+            ? QuantizedScores::For(class_data, confidence_threshold)
+            : QuantizedScores{};
 
         for (int gy = 0; gy < scale.grid_h; ++gy) {
             for (int gx = 0; gx < scale.grid_w; ++gx) {
@@ -838,19 +1020,35 @@ std::vector<Detection> HailoInference::ParseRawYoloOutput(
                 float max_class_score = 0.0f;
                 int best_class_id = 0;
 
-                for (int c = 0; c < scale.num_classes; ++c) {
-                    float raw_score = class_data[class_base + c];
-                    float class_score = raw_score;
-
-                    // Apply sigmoid if values look like logits
-                    if (raw_score < -10.0f || raw_score > 10.0f ||
-                        raw_score < 0.0f || raw_score > 1.0f) {
-                        class_score = 1.0f / (1.0f + std::exp(-raw_score));
-                    }
+                if (class_data.IsQuantized()) {
+                    // Integer compares only; the survivor's score is dequantised
+                    uint32_t best_code = 0;
+                    const bool passed = class_data.type == TensorDataType::kUint16
+                        ? BestQuantizedClass(
+                              reinterpret_cast<const uint16_t*>(class_data.data) + class_base,
+                              scale.num_classes, quantized_scores.threshold_code,
+                              best_class_id, best_code)
+                        : BestQuantizedClass(class_data.data + class_base, scale.num_classes,
+                                             quantized_scores.threshold_code,
+                                             best_class_id, best_code);
+                    if (!passed) continue;
+                    max_class_score = quantized_scores.Score(best_code);
+                } else {
+                    const float* class_scores = class_data.Floats();
+                    for (int c = 0; c < scale.num_classes; ++c) {
+                        float raw_score = class_scores[class_base + c];
+                        float class_score = raw_score;
+
+                        // Apply sigmoid if values look like logits
+                        if (raw_score < -10.0f || raw_score > 10.0f ||
+                            raw_score < 0.0f || raw_score > 1.0f) {
+                            class_score = 1.0f / (1.0f + std::exp(-raw_score));
+                        }
 
-                    if (class_score > max_class_score) {
-                        max_class_score = class_score;
-                        best_class_id = c;
+                        if (class_score > max_class_score) {
+                            max_class_score = class_score;
+                            best_class_id = c;
+                        }
                     }
                 }
 
@@ -858,10 +1056,12 @@ std::vector<Detection> HailoInference::ParseRawYoloOutput(
                 if (max_class_score < confidence_threshold) continue;
 
                 // Decode bbox using DFL
-                float dist_left = decode_dfl(&dfl_data[dfl_base], 0);
-                float dist_top = decode_dfl(&dfl_data[dfl_base], 1);
-                float dist_right = decode_dfl(&dfl_data[dfl_base], 2);
-                float dist_bottom = decode_dfl(&dfl_data[dfl_base], 3);
+                const float* dfl_values = dfl_data.Values(dfl_base, dfl_scratch.size(),
+                                                          dfl_scratch.data());
+                float dist_left = decode_dfl(dfl_values, 0);
+                float dist_top = decode_dfl(dfl_values, 1);
+                float dist_right = decode_dfl(dfl_values, 2);
+                float dist_bottom = decode_dfl(dfl_values, 3);
 
                 // Convert to pixel coordinates
                 float anchor_x = (gx + 0.5f) * scale.stride;
@@ -882,14 +1082,14 @@ std::vector<Detection> HailoInference::ParseRawYoloOutput(
 
                 // Parse keypoints
                 std::vector<std::array<float, 3>> kpts;
-                if (kp_data != nullptr) {
+                if (kp_data.data != nullptr) {
                     int kp_base = pixel_idx * 12;
 
                     for (int k = 0; k < model_num_keypoints; ++k) {
                         // Sequential layout: [x0,y0,c0, x1,y1,c1, x2,y2,c2, x3,y3,c3]
-                        float kp_x_raw = kp_data[kp_base + k * 3 + 0];
-                        float kp_y_raw = kp_data[kp_base + k * 3 + 1];
-                        float kp_vis = kp_data[kp_base + k * 3 + 2];
+                        float kp_x_raw = kp_data.Value(kp_base + k * 3 + 0);
+                        float kp_y_raw = kp_data.Value(kp_base + k * 3 + 1);
+                        float kp_vis = kp_data.Value(kp_base + k * 3 + 2);
 
                         // Apply sigmoid to visibility (raw is logit)
                         if (kp_vis < 0.0f || kp_vis > 1.0f) {
@@ -914,7 +1114,8 @@ std::vector<Detection> HailoInference::ParseRawYoloOutput(
     }
 
     // Apply NMS
-    std::vector<int> keep_indices = ApplyNMS(all_boxes, all_scores, iou_threshold);
+    std::vector<int> keep_indices = ApplyNMS(all_boxes, all_scores,
+                                                context.spec.iou_threshold);
 
     // Convert to Detection objects and transform coordinates
     for (int idx : keep_indices) {
@@ -936,13 +1137,7 @@ std::vector<Detection> HailoInference::ParseRawYoloOutput(
         det.class_id = all_class_ids[idx];
 
         // Set class name
-        if (!labels_.empty() && det.class_id < static_cast<int>(labels_.size())) {
-            det.class_name = labels_[det.class_id];
-        } else if (det.class_id < NUM_COCO_LABELS) {
-            det.class_name = COCO_LABELS[det.class_id];
-        } else {
-            det.class_name = "object";
-        }
+        det.class_name = context.ClassName(det.class_id);
 
         det.confidence = all_scores[idx];
         det.bbox.x = static_cast<int>(x1_clamped);
@@ -995,20 +1190,53 @@ std::vector<Detection> HailoInference::ParseRawYoloOutput(
     return detections;
 }
 
-void HailoInference::SetModelConfig(const std::string& task, int num_keypoints,
-                                     const std::vector<std::string>& labels) {
-    std::lock_guard<std::mutex> lock(inference_mutex_);
-    task_ = task;
-    num_keypoints_ = num_keypoints;
-    labels_ = labels;
+std::shared_ptr<const ModelContext> HailoInference::GetContext(const ModelSpec& spec) {
+    std::lock_guard<std::mutex> lock(contexts_mutex_);
+    if (default_context_->spec == spec) {
+        return default_context_;
+    }
+    std::shared_ptr<const ModelContext> found;
+    contexts_.erase(std::remove_if(contexts_.begin(), contexts_.end(),
+                                   [&](const std::weak_ptr<const ModelContext>& entry) {
+                                       auto context = entry.lock();
+                                       if (context && !found && context->spec == spec) {
+                                           found = context;
+                                       }
+                                       return !context;
+                                   }),
+                    contexts_.end());
+    if (found) {
+        return found;
+    }
+
+    // Same network group and decoder, the stream's own interpretation
+    auto context = std::make_shared<ModelContext>(*default_context_);
+    context->spec = spec;
+    if (context->spec.task.empty()) {
+        context->spec.task = "det";
+    }
 
-    // Note: num_classes_ is set from HEF NMS output info during Initialize()
-    // labels_ is only used for class name mapping, not for limiting detection classes
+    // Note: num_classes comes from the HEF NMS output info found in Initialize()
+    // labels are only used for class name mapping, not for limiting detection classes
+    LogInfo("HailoInference: context for " + hef_path_ + ": task=" + context->spec.task +
+            ", keypoints=" + std::to_string(context->spec.num_keypoints) +
+            ", labels=" + std::to_string(context->spec.labels.size()) +
+            ", decoder=" + std::string(OutputDecoderToString(context->decoder)) +
+            ", nms_classes=" + std::to_string(context->num_classes));
+
+    contexts_.push_back(context);
+    return context;
+}
+
+size_t HailoInference::GetContextCount() {
+    std::lock_guard<std::mutex> lock(contexts_mutex_);
+    return static_cast<size_t>(std::count_if(
+        contexts_.begin(), contexts_.end(),
+        [](const std::weak_ptr<const ModelContext>& entry) { return !entry.expired(); }));
+}
 
-    LogInfo("HailoInference: task=" + task_ + ", keypoints=" +
-            std::to_string(num_keypoints_) + ", labels=" +
-            std::to_string(labels_.size()) + ", nms_classes=" +
-            std::to_string(num_classes_));
+std::chrono::steady_clock::duration HailoInference::GetBusyTime() const {
+    return engine_ ? engine_->GetBusyTime() : std::chrono::steady_clock::duration::zero();
 }
 
 std::shared_ptr<BatchInferenceManager> HailoInference::GetBatchManager(int batch_timeout_ms) {
@@ -1023,7 +1251,7 @@ std::shared_ptr<BatchInferenceManager> HailoInference::GetBatchManager(int batch
     if (!batch_manager_) {
         // We need a shared_ptr to this, but we're not managed by shared_ptr ourselves
         // Get the existing shared instance from the static cache
-        auto self = instances_.find(hef_path_);
+        auto self = instances_.find(InstanceKey(hef_path_, device_id_));
         if (self != instances_.end()) {
             batch_manager_ = std::make_shared<BatchInferenceManager>(
                 self->second, batch_timeout_ms);
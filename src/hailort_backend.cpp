@@ -0,0 +1,255 @@
+#include "hailort_backend.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <map>
+
+namespace stream_daemon {
+
+// Static member definitions
+std::map<std::string, std::shared_ptr<hailort::VDevice>> HailoRtBackend::shared_vdevices_;
+std::mutex HailoRtBackend::vdevice_mutex_;
+
+Result<std::shared_ptr<hailort::VDevice>> HailoRtBackend::AcquireSharedDevice(
+    const std::string& device_id) {
+    std::lock_guard<std::mutex> lock(vdevice_mutex_);
+
+    // Create shared VDevice if not exists
+    auto& vdevice = shared_vdevices_[device_id];
+    if (!vdevice) {
+        auto vdevice_exp = [&device_id]() {
+            if (device_id.empty()) {
+                return hailort::VDevice::create();
+            }
+
+            // "a+b": one VDevice over both modules
+            std::vector<hailo_device_id_t> ids;
+            size_t begin = 0;
+            while (begin <= device_id.size()) {
+                const size_t end = std::min(device_id.find('+', begin), device_id.size());
+                hailo_device_id_t id{};
+                std::snprintf(id.id, sizeof(id.id), "%s",
+                              device_id.substr(begin, end - begin).c_str());
+                ids.push_back(id);
+                begin = end + 1;
+            }
+
+            hailo_vdevice_params_t params{};
+            hailo_init_vdevice_params(&params);
+            params.device_ids = ids.data();
+            params.device_count = static_cast<uint32_t>(ids.size());
+            return hailort::VDevice::create(params);
+        }();
+        if (!vdevice_exp) {
+            shared_vdevices_.erase(device_id);
+            return MakeErrorT<std::shared_ptr<hailort::VDevice>>(
+                "Failed to create VDevice '" + device_id + "': " +
+                std::to_string(static_cast<int>(vdevice_exp.status())));
+        }
+        vdevice = std::shared_ptr<hailort::VDevice>(vdevice_exp.release());
+        LogInfo("Shared VDevice created for multi-stream inference" +
+                (device_id.empty() ? std::string() : " on " + device_id));
+    }
+    return vdevice;
+}
+
+void HailoRtBackend::ReleaseSharedDevice() {
+    std::lock_guard<std::mutex> lock(vdevice_mutex_);
+    shared_vdevices_.clear();
+}
+
+TensorInfo HailoRtBackend::ToTensorInfo(const hailo_vstream_info_t& info, size_t frame_size,
+                                        TensorDataType type) {
+    TensorInfo tensor;
+    tensor.name = info.name;
+    tensor.type = type;
+    tensor.height = static_cast<int>(info.shape.height);
+    tensor.width = static_cast<int>(info.shape.width);
+    tensor.features = static_cast<int>(info.shape.features);
+    tensor.frame_size = frame_size;
+    tensor.quant.scale = info.quant_info.qp_scale;
+    tensor.quant.zero_point = info.quant_info.qp_zp;
+    tensor.nms_classes = static_cast<int>(info.nms_shape.number_of_classes);
+    tensor.nms_max_bboxes_per_class = static_cast<int>(info.nms_shape.max_bboxes_per_class);
+    return tensor;
+}
+
+std::optional<TensorDataType> HailoRtBackend::ToTensorDataType(hailo_format_type_t type) {
+    switch (type) {
+        case HAILO_FORMAT_TYPE_UINT8:
+            return TensorDataType::kUint8;
+        case HAILO_FORMAT_TYPE_UINT16:
+            return TensorDataType::kUint16;
+        case HAILO_FORMAT_TYPE_FLOAT32:
+            return TensorDataType::kFloat32;
+        default:
+            return std::nullopt;
+    }
+}
+
+VoidResult HailoRtBackend::Configure(const std::string& hef_path) {
+    using namespace hailort;
+
+    auto vdevice_result = AcquireSharedDevice(device_id_);
+    if (IsError(vdevice_result)) {
+        return MakeError(GetError(vdevice_result));
+    }
+    vdevice_ = GetValue(std::move(vdevice_result));
+
+    // Load HEF
+    auto hef_exp = Hef::create(hef_path);
+    if (!hef_exp) {
+        return MakeError("Failed to load HEF: " +
+                        std::to_string(static_cast<int>(hef_exp.status())));
+    }
+    auto hef = hef_exp.release();
+
+    // Batch size: the one asked for, else what the HEF's network group params declare
+    auto params_exp = hef.create_configure_params(HAILO_STREAM_INTERFACE_PCIE);
+    if (!params_exp) {
+        return MakeError("Failed to get configure params: " +
+                        std::to_string(static_cast<int>(params_exp.status())));
+    }
+    auto configure_params = params_exp.release();
+    if (configure_params.empty()) {
+        return MakeError("No network groups found in HEF");
+    }
+
+    int hef_batch_size = configure_params.begin()->second.batch_size;
+    for (const auto& [network_name, network_params] :
+         configure_params.begin()->second.network_params_by_name) {
+        hef_batch_size = std::max<int>(hef_batch_size, network_params.batch_size);
+    }
+    batch_size_ = requested_batch_size_ > 1 ? requested_batch_size_
+                                            : std::max(1, hef_batch_size);  // 0 = HailoRT default
+    for (auto& [group_name, group_params] : configure_params) {
+        group_params.batch_size = static_cast<uint16_t>(batch_size_);
+        for (auto& [network_name, network_params] : group_params.network_params_by_name) {
+            network_params.batch_size = static_cast<uint16_t>(batch_size_);
+        }
+    }
+
+    // Configure network group on shared VDevice
+    auto network_groups_exp = vdevice_->configure(hef, configure_params);
+    if (!network_groups_exp) {
+        return MakeError("Failed to configure network: " +
+                        std::to_string(static_cast<int>(network_groups_exp.status())));
+    }
+    auto network_groups = network_groups_exp.release();
+
+    if (network_groups.empty()) {
+        return MakeError("No network groups found in HEF");
+    }
+    network_group_ = network_groups[0];
+
+    // Get input/output info
+    auto input_vstream_infos = network_group_->get_input_vstream_infos();
+    if (!input_vstream_infos) {
+        return MakeError("Failed to get input vstream infos");
+    }
+
+    auto output_vstream_infos = network_group_->get_output_vstream_infos();
+    if (!output_vstream_infos) {
+        return MakeError("Failed to get output vstream infos");
+    }
+
+    // Partial batches run once the oldest frame waited this long
+    if (batch_size_ > 1) {
+        const auto status = network_group_->set_scheduler_timeout(
+            std::chrono::milliseconds(kInferenceBatchFlushMs));
+        if (status != HAILO_SUCCESS) {
+            LogWarning("Failed to set scheduler timeout: " +
+                       std::to_string(static_cast<int>(status)));
+        }
+    }
+
+    // Create VStreams with separate params for input (UINT8) and output
+    // (FLOAT32, or the device's own type for quantized non-NMS outputs)
+    hailo_vstream_params_t input_params = HailoRTDefaults::get_vstreams_params();
+    input_params.user_buffer_format.type = HAILO_FORMAT_TYPE_UINT8;
+    input_params.timeout_ms = 30000;  // 30 second timeout for heavy models
+
+    hailo_vstream_params_t output_params = HailoRTDefaults::get_vstreams_params();
+    output_params.user_buffer_format.type = HAILO_FORMAT_TYPE_FLOAT32;
+    output_params.timeout_ms = 30000;  // 30 second timeout for heavy models
+
+    // Build input params map
+    std::map<std::string, hailo_vstream_params_t> input_params_map;
+    for (const auto& info : *input_vstream_infos) {
+        input_params_map[info.name] = input_params;
+    }
+
+    // Build output params map
+    std::map<std::string, hailo_vstream_params_t> output_params_map;
+    for (const auto& info : *output_vstream_infos) {
+        output_params_map[info.name] = output_params;
+        if (quantized_outputs_ && !HailoRTCommon::is_nms(info)) {
+            // Read as the device produces it; the decoders only know unsigned
+            // integer and float layouts
+            if (!ToTensorDataType(info.format.type)) {
+                return MakeError("Output " + std::string(info.name) +
+                                 " has unsupported quantized format " +
+                                 std::to_string(static_cast<int>(info.format.type)) +
+                                 " (disable quantized outputs for this model)");
+            }
+            output_params_map[info.name].user_buffer_format.type = info.format.type;
+        }
+    }
+
+    // Create input vstreams
+    auto input_vstreams_exp = VStreamsBuilder::create_input_vstreams(*network_group_, input_params_map);
+    if (!input_vstreams_exp) {
+        return MakeError("Failed to create input vstreams");
+    }
+    input_vstreams_ = input_vstreams_exp.release();
+
+    // Create output vstreams
+    auto output_vstreams_exp = VStreamsBuilder::create_output_vstreams(*network_group_, output_params_map);
+    if (!output_vstreams_exp) {
+        return MakeError("Failed to create output vstreams");
+    }
+    output_vstreams_ = output_vstreams_exp.release();
+
+    // Describe the streams in vstream order (sizes in the user buffer format)
+    inputs_.clear();
+    for (const auto& vstream : input_vstreams_) {
+        inputs_.push_back(ToTensorInfo(vstream.get_info(), vstream.get_frame_size(),
+                                       TensorDataType::kUint8));
+    }
+    outputs_.clear();
+    for (const auto& vstream : output_vstreams_) {
+        const auto type = ToTensorDataType(vstream.get_user_buffer_format().type);
+        if (!type) {
+            return MakeError("Output " + std::string(vstream.get_info().name) +
+                             " has unsupported user buffer format " +
+                             std::to_string(static_cast<int>(vstream.get_user_buffer_format().type)));
+        }
+        outputs_.push_back(ToTensorInfo(vstream.get_info(), vstream.get_frame_size(), *type));
+    }
+
+    // Note: Don't manually activate - the scheduler handles activation automatically
+    // when using VStreams with shared VDevice
+    return MakeOk();
+}
+
+VoidResult HailoRtBackend::Write(const uint8_t* data, size_t size) {
+    // HailoRT does not modify the buffer
+    const auto status = input_vstreams_[0].write(
+        hailort::MemoryView(const_cast<uint8_t*>(data), size));
+    if (status != HAILO_SUCCESS) {
+        return MakeError("input vstream write: " + std::to_string(static_cast<int>(status)));
+    }
+    return MakeOk();
+}
+
+VoidResult HailoRtBackend::Read(size_t index, uint8_t* data, size_t size) {
+    const auto status = output_vstreams_[index].read(hailort::MemoryView(data, size));
+    if (status != HAILO_SUCCESS) {
+        return MakeError("output vstream[" + std::to_string(index) + "] read: " +
+                         std::to_string(static_cast<int>(status)));
+    }
+    return MakeOk();
+}
+
+}  // namespace stream_daemon
@@ -0,0 +1,940 @@
+#include "image_ops.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+#if defined(__x86_64__) || defined(__i386__)
+#define STREAM_DAEMON_X86_KERNELS 1
+#include <immintrin.h>
+#endif
+
+#if defined(__ARM_NEON)
+#define STREAM_DAEMON_NEON_KERNELS 1
+#include <arm_neon.h>
+#endif
+
+namespace stream_daemon {
+
+namespace {
+
+// Fixed-point interpolation: Q7 weights per axis, Q14 after both passes
+constexpr int kWeightBits = 7;
+constexpr int kWeightOne = 1 << kWeightBits;
+constexpr int kBlendShift = 2 * kWeightBits;
+constexpr int kBlendRound = 1 << (kBlendShift - 1);
+
+// SIMD stores run a few elements past the row; the scalar tail rewrites them
+constexpr size_t kRowSlack = 8;
+
+using HorizontalFn = void (*)(const uint8_t* row, const int32_t* offset0, const int32_t* offset1,
+                              const int16_t* weight, int gather_columns, int columns,
+                              int16_t* out);
+using VerticalFn = void (*)(const int16_t* top, const int16_t* bottom, int weight, int count,
+                            uint8_t* out);
+
+struct YuvCoefficients;
+using YuvRowFn = void (*)(const uint8_t* y, const uint8_t* u, const uint8_t* v, int chroma_step,
+                          int width, const YuvCoefficients& k, uint8_t* out);
+
+struct Kernels {
+    HorizontalFn horizontal;
+    VerticalFn vertical;
+    YuvRowFn yuv_to_rgb;
+};
+
+// kChannels interleaved samples per pixel (RGB 3, NV12 UV 2, planar 1)
+template <int kChannels>
+void HorizontalScalarRange(const uint8_t* row, const int32_t* offset0, const int32_t* offset1,
+                           const int16_t* weight, int begin, int end, int16_t* out) {
+    for (int x = begin; x < end; ++x) {
+        const uint8_t* p0 = row + offset0[x];
+        const uint8_t* p1 = row + offset1[x];
+        const int w1 = weight[x];
+        const int w0 = kWeightOne - w1;
+        int16_t* o = out + x * kChannels;
+        for (int c = 0; c < kChannels; ++c) {
+            o[c] = static_cast<int16_t>(p0[c] * w0 + p1[c] * w1);
+        }
+    }
+}
+
+void HorizontalScalar(const uint8_t* row, const int32_t* offset0, const int32_t* offset1,
+                      const int16_t* weight, int /*gather_columns*/, int columns, int16_t* out) {
+    HorizontalScalarRange<3>(row, offset0, offset1, weight, 0, columns, out);
+}
+
+void VerticalScalarRange(const int16_t* top, const int16_t* bottom, int weight,
+                         int begin, int end, uint8_t* out) {
+    const int w0 = kWeightOne - weight;
+    for (int i = begin; i < end; ++i) {
+        out[i] = static_cast<uint8_t>((top[i] * w0 + bottom[i] * weight + kBlendRound) >> kBlendShift);
+    }
+}
+
+void VerticalScalar(const int16_t* top, const int16_t* bottom, int weight, int count,
+                    uint8_t* out) {
+    VerticalScalarRange(top, bottom, weight, 0, count, out);
+}
+
+// YUV -> RGB in Q13 (every coefficient fits int16 for madd):
+// rgb = ((y - y_offset) * y_scale + chroma terms + round) >> kYuvBits
+constexpr int kYuvBits = 13;
+constexpr int kYuvRound = 1 << (kYuvBits - 1);
+
+struct YuvCoefficients {
+    int y_offset;
+    int y_scale;
+    int r_v;
+    int g_u;
+    int g_v;
+    int b_u;
+};
+
+YuvCoefficients MakeYuvCoefficients(YuvMatrix matrix, bool full_range) {
+    const double kr = matrix == YuvMatrix::kBt709 ? 0.2126 : 0.299;
+    const double kb = matrix == YuvMatrix::kBt709 ? 0.0722 : 0.114;
+    const double kg = 1.0 - kr - kb;
+    const double y_scale = full_range ? 1.0 : 255.0 / 219.0;
+    const double c_scale = full_range ? 1.0 : 255.0 / 224.0;
+
+    const auto fixed = [](double value) {
+        return static_cast<int>(std::lround(value * (1 << kYuvBits)));
+    };
+    return {full_range ? 0 : 16,
+            fixed(y_scale),
+            fixed(2.0 * (1.0 - kr) * c_scale),
+            fixed(-2.0 * kb * (1.0 - kb) / kg * c_scale),
+            fixed(-2.0 * kr * (1.0 - kr) / kg * c_scale),
+            fixed(2.0 * (1.0 - kb) * c_scale)};
+}
+
+inline uint8_t ClampToByte(int value) {
+    return static_cast<uint8_t>(std::clamp(value, 0, 255));
+}
+
+// One output row: u/v advance by chroma_step per pixel (2 for interleaved NV12)
+void YuvRowToRgbRange(const uint8_t* y, const uint8_t* u, const uint8_t* v, int chroma_step,
+                      int begin, int end, const YuvCoefficients& k, uint8_t* out) {
+    for (int x = begin; x < end; ++x) {
+        const int luma = (y[x] - k.y_offset) * k.y_scale + kYuvRound;
+        const int cb = u[x * chroma_step] - 128;
+        const int cr = v[x * chroma_step] - 128;
+        out[x * 3 + 0] = ClampToByte((luma + k.r_v * cr) >> kYuvBits);
+        out[x * 3 + 1] = ClampToByte((luma + k.g_u * cb + k.g_v * cr) >> kYuvBits);
+        out[x * 3 + 2] = ClampToByte((luma + k.b_u * cb) >> kYuvBits);
+    }
+}
+
+void YuvRowToRgbScalar(const uint8_t* y, const uint8_t* u, const uint8_t* v, int chroma_step,
+                       int width, const YuvCoefficients& k, uint8_t* out) {
+    YuvRowToRgbRange(y, u, v, chroma_step, 0, width, k, out);
+}
+
+#if defined(STREAM_DAEMON_X86_KERNELS)
+
+inline int Load32(const uint8_t* p) {
+    int value;
+    std::memcpy(&value, p, sizeof(value));
+    return value;
+}
+
+// RGBX RGBX (u16) -> RGB RGB in the low 12 bytes
+#define STREAM_DAEMON_COMPACT_RGBX 0, 1, 2, 3, 4, 5, 8, 9, 10, 11, 12, 13, -1, -1, -1, -1
+
+__attribute__((target("sse4.1")))
+inline __m128i BlendSse41(__m128i p0, __m128i p1, __m128i w1) {
+    const __m128i w0 = _mm_sub_epi16(_mm_set1_epi16(kWeightOne), w1);
+    return _mm_add_epi16(_mm_mullo_epi16(p0, w0), _mm_mullo_epi16(p1, w1));
+}
+
+__attribute__((target("sse4.1")))
+void HorizontalSse41(const uint8_t* row, const int32_t* offset0, const int32_t* offset1,
+                     const int16_t* weight, int gather_columns, int columns, int16_t* out) {
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i compact = _mm_setr_epi8(STREAM_DAEMON_COMPACT_RGBX);
+
+    int x = 0;
+    for (; x + 4 <= gather_columns; x += 4) {
+        const __m128i p0 = _mm_setr_epi32(Load32(row + offset0[x]), Load32(row + offset0[x + 1]),
+                                          Load32(row + offset0[x + 2]), Load32(row + offset0[x + 3]));
+        const __m128i p1 = _mm_setr_epi32(Load32(row + offset1[x]), Load32(row + offset1[x + 1]),
+                                          Load32(row + offset1[x + 2]), Load32(row + offset1[x + 3]));
+
+        // One weight per pixel, repeated over its four channels
+        __m128i w = _mm_cvtepi16_epi32(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(weight + x)));
+        w = _mm_or_si128(w, _mm_slli_epi32(w, 16));
+
+        const __m128i lo = BlendSse41(_mm_unpacklo_epi8(p0, zero), _mm_unpacklo_epi8(p1, zero),
+                                      _mm_unpacklo_epi32(w, w));
+        const __m128i hi = BlendSse41(_mm_unpackhi_epi8(p0, zero), _mm_unpackhi_epi8(p1, zero),
+                                      _mm_unpackhi_epi32(w, w));
+
+        int16_t* o = out + x * 3;
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(o), _mm_shuffle_epi8(lo, compact));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(o + 6), _mm_shuffle_epi8(hi, compact));
+    }
+    HorizontalScalarRange<3>(row, offset0, offset1, weight, x, columns, out);
+}
+
+__attribute__((target("sse4.1")))
+inline __m128i MixSse41(__m128i pairs, __m128i weights) {
+    const __m128i sum = _mm_add_epi32(_mm_madd_epi16(pairs, weights), _mm_set1_epi32(kBlendRound));
+    return _mm_srai_epi32(sum, kBlendShift);
+}
+
+__attribute__((target("sse4.1")))
+void VerticalSse41(const int16_t* top, const int16_t* bottom, int weight, int count,
+                   uint8_t* out) {
+    // (top, bottom) pairs x (w0, w1) pairs via madd
+    const __m128i weights = _mm_set1_epi32((weight << 16) | (kWeightOne - weight));
+
+    int i = 0;
+    for (; i + 16 <= count; i += 16) {
+        const __m128i t0 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(top + i));
+        const __m128i b0 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(bottom + i));
+        const __m128i t1 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(top + i + 8));
+        const __m128i b1 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(bottom + i + 8));
+
+        const __m128i r0 = _mm_packs_epi32(MixSse41(_mm_unpacklo_epi16(t0, b0), weights),
+                                           MixSse41(_mm_unpackhi_epi16(t0, b0), weights));
+        const __m128i r1 = _mm_packs_epi32(MixSse41(_mm_unpacklo_epi16(t1, b1), weights),
+                                           MixSse41(_mm_unpackhi_epi16(t1, b1), weights));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out + i), _mm_packus_epi16(r0, r1));
+    }
+    VerticalScalarRange(top, bottom, weight, i, count, out);
+}
+
+// pshufb masks scattering 16 R, G, B bytes into 48 interleaved RGB bytes
+struct InterleaveMasks {
+    alignas(16) int8_t mask[3][3][16];  // [output block][channel][byte]
+};
+
+constexpr InterleaveMasks MakeInterleaveMasks() {
+    InterleaveMasks masks{};
+    for (int block = 0; block < 3; ++block) {
+        for (int channel = 0; channel < 3; ++channel) {
+            for (int byte = 0; byte < 16; ++byte) {
+                const int i = block * 16 + byte;
+                masks.mask[block][channel][byte] =
+                    static_cast<int8_t>(i % 3 == channel ? i / 3 : -128);
+            }
+        }
+    }
+    return masks;
+}
+
+constexpr InterleaveMasks kRgbInterleave = MakeInterleaveMasks();
+
+__attribute__((target("sse4.1")))
+inline __m128i CoefficientPair(int first, int second) {
+    return _mm_unpacklo_epi16(_mm_set1_epi16(static_cast<int16_t>(first)),
+                              _mm_set1_epi16(static_cast<int16_t>(second)));
+}
+
+// (a * coef.first + b * coef.second + add) >> kYuvBits for 8 int16 lanes, saturated to int16
+__attribute__((target("sse4.1")))
+inline __m128i YuvChannelSse41(__m128i a, __m128i b, __m128i coef, __m128i add_lo, __m128i add_hi) {
+    const __m128i lo = _mm_add_epi32(_mm_madd_epi16(_mm_unpacklo_epi16(a, b), coef), add_lo);
+    const __m128i hi = _mm_add_epi32(_mm_madd_epi16(_mm_unpackhi_epi16(a, b), coef), add_hi);
+    return _mm_packs_epi32(_mm_srai_epi32(lo, kYuvBits), _mm_srai_epi32(hi, kYuvBits));
+}
+
+__attribute__((target("sse4.1")))
+void YuvRowToRgbSse41(const uint8_t* y, const uint8_t* u, const uint8_t* v, int chroma_step,
+                      int width, const YuvCoefficients& k, uint8_t* out) {
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i y_offset = _mm_set1_epi16(static_cast<int16_t>(k.y_offset));
+    const __m128i c_offset = _mm_set1_epi16(128);
+    const __m128i round = _mm_set1_epi32(kYuvRound);
+    const __m128i r_coef = CoefficientPair(k.y_scale, k.r_v);
+    const __m128i g_coef = CoefficientPair(k.y_scale, k.g_u);
+    const __m128i g_v_coef = CoefficientPair(k.g_v, kYuvRound);   // (cr, 1) pairs
+    const __m128i b_coef = CoefficientPair(k.y_scale, k.b_u);
+    const __m128i ones = _mm_set1_epi16(1);
+    const __m128i even = _mm_setr_epi8(0, 2, 4, 6, 8, 10, 12, 14, -1, -1, -1, -1, -1, -1, -1, -1);
+    const __m128i odd = _mm_setr_epi8(1, 3, 5, 7, 9, 11, 13, 15, -1, -1, -1, -1, -1, -1, -1, -1);
+
+    int x = 0;
+    for (; x + 16 <= width; x += 16) {
+        const __m128i yy = _mm_loadu_si128(reinterpret_cast<const __m128i*>(y + x));
+        __m128i uu;
+        __m128i vv;
+        if (chroma_step == 2) {
+            // NV12: u points at the interleaved UV row
+            const __m128i uv0 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(u + x * 2));
+            const __m128i uv1 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(u + x * 2 + 16));
+            uu = _mm_unpacklo_epi64(_mm_shuffle_epi8(uv0, even), _mm_shuffle_epi8(uv1, even));
+            vv = _mm_unpacklo_epi64(_mm_shuffle_epi8(uv0, odd), _mm_shuffle_epi8(uv1, odd));
+        } else {
+            uu = _mm_loadu_si128(reinterpret_cast<const __m128i*>(u + x));
+            vv = _mm_loadu_si128(reinterpret_cast<const __m128i*>(v + x));
+        }
+
+        // 8 pixels -> R, G, B as int16
+        const auto convert = [&](int half, __m128i* channels) {
+            const auto widen = [&](__m128i bytes, __m128i offset) {
+                return _mm_sub_epi16(half == 0 ? _mm_unpacklo_epi8(bytes, zero)
+                                               : _mm_unpackhi_epi8(bytes, zero), offset);
+            };
+            const __m128i luma = widen(yy, y_offset);
+            const __m128i cb = widen(uu, c_offset);
+            const __m128i cr = widen(vv, c_offset);
+
+            // G has three terms: the (cr, 1) pair carries the rounding constant
+            const __m128i g_lo = _mm_madd_epi16(_mm_unpacklo_epi16(cr, ones), g_v_coef);
+            const __m128i g_hi = _mm_madd_epi16(_mm_unpackhi_epi16(cr, ones), g_v_coef);
+
+            channels[0] = YuvChannelSse41(luma, cr, r_coef, round, round);
+            channels[1] = YuvChannelSse41(luma, cb, g_coef, g_lo, g_hi);
+            channels[2] = YuvChannelSse41(luma, cb, b_coef, round, round);
+        };
+
+        __m128i lo[3];
+        __m128i hi[3];
+        convert(0, lo);
+        convert(1, hi);
+        const __m128i rgb[3] = {_mm_packus_epi16(lo[0], hi[0]),
+                                _mm_packus_epi16(lo[1], hi[1]),
+                                _mm_packus_epi16(lo[2], hi[2])};
+
+        uint8_t* o = out + x * 3;
+        for (int block = 0; block < 3; ++block) {
+            const auto& masks = kRgbInterleave.mask[block];
+            __m128i packed = _mm_shuffle_epi8(
+                rgb[0], _mm_load_si128(reinterpret_cast<const __m128i*>(masks[0])));
+            packed = _mm_or_si128(packed, _mm_shuffle_epi8(
+                rgb[1], _mm_load_si128(reinterpret_cast<const __m128i*>(masks[1]))));
+            packed = _mm_or_si128(packed, _mm_shuffle_epi8(
+                rgb[2], _mm_load_si128(reinterpret_cast<const __m128i*>(masks[2]))));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(o + block * 16), packed);
+        }
+    }
+    YuvRowToRgbRange(y, u, v, chroma_step, x, width, k, out);
+}
+
+__attribute__((target("avx2")))
+inline __m256i BlendAvx2(__m256i p0, __m256i p1, __m256i w1) {
+    const __m256i w0 = _mm256_sub_epi16(_mm256_set1_epi16(kWeightOne), w1);
+    return _mm256_add_epi16(_mm256_mullo_epi16(p0, w0), _mm256_mullo_epi16(p1, w1));
+}
+
+__attribute__((target("avx2")))
+void HorizontalAvx2(const uint8_t* row, const int32_t* offset0, const int32_t* offset1,
+                    const int16_t* weight, int gather_columns, int columns, int16_t* out) {
+    const __m256i zero = _mm256_setzero_si256();
+    const __m256i compact = _mm256_setr_epi8(STREAM_DAEMON_COMPACT_RGBX, STREAM_DAEMON_COMPACT_RGBX);
+    const int* base = reinterpret_cast<const int*>(row);
+
+    int x = 0;
+    for (; x + 8 <= gather_columns; x += 8) {
+        const __m256i i0 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(offset0 + x));
+        const __m256i i1 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(offset1 + x));
+        const __m256i p0 = _mm256_i32gather_epi32(base, i0, 1);
+        const __m256i p1 = _mm256_i32gather_epi32(base, i1, 1);
+
+        __m256i w = _mm256_cvtepi16_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i*>(weight + x)));
+        w = _mm256_or_si256(w, _mm256_slli_epi32(w, 16));
+
+        // Per 128-bit lane: lo = pixels (0,1) / (4,5), hi = pixels (2,3) / (6,7)
+        const __m256i lo = _mm256_shuffle_epi8(
+            BlendAvx2(_mm256_unpacklo_epi8(p0, zero), _mm256_unpacklo_epi8(p1, zero),
+                      _mm256_unpacklo_epi32(w, w)),
+            compact);
+        const __m256i hi = _mm256_shuffle_epi8(
+            BlendAvx2(_mm256_unpackhi_epi8(p0, zero), _mm256_unpackhi_epi8(p1, zero),
+                      _mm256_unpackhi_epi32(w, w)),
+            compact);
+
+        // Ascending addresses so each store overwrites the previous one's tail
+        int16_t* o = out + x * 3;
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(o), _mm256_castsi256_si128(lo));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(o + 6), _mm256_castsi256_si128(hi));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(o + 12), _mm256_extracti128_si256(lo, 1));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(o + 18), _mm256_extracti128_si256(hi, 1));
+    }
+    HorizontalScalarRange<3>(row, offset0, offset1, weight, x, columns, out);
+}
+
+__attribute__((target("avx2")))
+inline __m256i MixAvx2(__m256i pairs, __m256i weights) {
+    const __m256i sum = _mm256_add_epi32(_mm256_madd_epi16(pairs, weights),
+                                         _mm256_set1_epi32(kBlendRound));
+    return _mm256_srai_epi32(sum, kBlendShift);
+}
+
+__attribute__((target("avx2")))
+void VerticalAvx2(const int16_t* top, const int16_t* bottom, int weight, int count,
+                  uint8_t* out) {
+    const __m256i weights = _mm256_set1_epi32((weight << 16) | (kWeightOne - weight));
+
+    int i = 0;
+    for (; i + 32 <= count; i += 32) {
+        const __m256i t0 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(top + i));
+        const __m256i b0 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(bottom + i));
+        const __m256i t1 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(top + i + 16));
+        const __m256i b1 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(bottom + i + 16));
+
+        // unpack/pack are per-lane, so r0/r1 come back in element order
+        const __m256i r0 = _mm256_packs_epi32(MixAvx2(_mm256_unpacklo_epi16(t0, b0), weights),
+                                              MixAvx2(_mm256_unpackhi_epi16(t0, b0), weights));
+        const __m256i r1 = _mm256_packs_epi32(MixAvx2(_mm256_unpacklo_epi16(t1, b1), weights),
+                                              MixAvx2(_mm256_unpackhi_epi16(t1, b1), weights));
+        const __m256i packed = _mm256_permute4x64_epi64(_mm256_packus_epi16(r0, r1), 0xD8);
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + i), packed);
+    }
+    VerticalScalarRange(top, bottom, weight, i, count, out);
+}
+
+#undef STREAM_DAEMON_COMPACT_RGBX
+
+#endif  // STREAM_DAEMON_X86_KERNELS
+
+#if defined(STREAM_DAEMON_NEON_KERNELS)
+
+// No gather on NEON: the horizontal pass stays scalar, vertical pass and colour conversion
+// are vectorised
+void VerticalNeon(const int16_t* top, const int16_t* bottom, int weight, int count,
+                  uint8_t* out) {
+    const uint16x4_t w0 = vdup_n_u16(static_cast<uint16_t>(kWeightOne - weight));
+    const uint16x4_t w1 = vdup_n_u16(static_cast<uint16_t>(weight));
+
+    int i = 0;
+    for (; i + 8 <= count; i += 8) {
+        const uint16x8_t t = vld1q_u16(reinterpret_cast<const uint16_t*>(top + i));
+        const uint16x8_t b = vld1q_u16(reinterpret_cast<const uint16_t*>(bottom + i));
+
+        const uint32x4_t lo = vmlal_u16(vmull_u16(vget_low_u16(t), w0), vget_low_u16(b), w1);
+        const uint32x4_t hi = vmlal_u16(vmull_u16(vget_high_u16(t), w0), vget_high_u16(b), w1);
+
+        // Rounding narrow shift == (sum + kBlendRound) >> kBlendShift
+        const uint16x8_t mixed = vcombine_u16(vrshrn_n_u32(lo, kBlendShift),
+                                              vrshrn_n_u32(hi, kBlendShift));
+        vst1_u8(out + i, vqmovn_u16(mixed));
+    }
+    VerticalScalarRange(top, bottom, weight, i, count, out);
+}
+
+void YuvRowToRgbNeon(const uint8_t* y, const uint8_t* u, const uint8_t* v, int chroma_step,
+                     int width, const YuvCoefficients& k, uint8_t* out) {
+    const uint8x8_t y_offset = vdup_n_u8(static_cast<uint8_t>(k.y_offset));
+    const uint8x8_t c_offset = vdup_n_u8(128);
+    const int32x4_t round = vdupq_n_s32(kYuvRound);
+    const auto y_scale = static_cast<int16_t>(k.y_scale);
+
+    // (sum >> kYuvBits) saturated to int16, then to 0..255
+    const auto narrow = [](int32x4_t lo, int32x4_t hi) {
+        return vqmovun_s16(vcombine_s16(vqshrn_n_s32(lo, kYuvBits), vqshrn_n_s32(hi, kYuvBits)));
+    };
+
+    int x = 0;
+    for (; x + 8 <= width; x += 8) {
+        uint8x8_t uu;
+        uint8x8_t vv;
+        if (chroma_step == 2) {
+            const uint8x8x2_t uv = vld2_u8(u + x * 2);
+            uu = uv.val[0];
+            vv = uv.val[1];
+        } else {
+            uu = vld1_u8(u + x);
+            vv = vld1_u8(v + x);
+        }
+
+        const int16x8_t luma = vreinterpretq_s16_u16(vsubl_u8(vld1_u8(y + x), y_offset));
+        const int16x8_t cb = vreinterpretq_s16_u16(vsubl_u8(uu, c_offset));
+        const int16x8_t cr = vreinterpretq_s16_u16(vsubl_u8(vv, c_offset));
+
+        const int32x4_t luma_lo = vmlaq_n_s32(round, vmovl_s16(vget_low_s16(luma)), y_scale);
+        const int32x4_t luma_hi = vmlaq_n_s32(round, vmovl_s16(vget_high_s16(luma)), y_scale);
+
+        uint8x8x3_t rgb;
+        rgb.val[0] = narrow(vmlal_n_s16(luma_lo, vget_low_s16(cr), static_cast<int16_t>(k.r_v)),
+                            vmlal_n_s16(luma_hi, vget_high_s16(cr), static_cast<int16_t>(k.r_v)));
+        rgb.val[1] = narrow(
+            vmlal_n_s16(vmlal_n_s16(luma_lo, vget_low_s16(cb), static_cast<int16_t>(k.g_u)),
+                        vget_low_s16(cr), static_cast<int16_t>(k.g_v)),
+            vmlal_n_s16(vmlal_n_s16(luma_hi, vget_high_s16(cb), static_cast<int16_t>(k.g_u)),
+                        vget_high_s16(cr), static_cast<int16_t>(k.g_v)));
+        rgb.val[2] = narrow(vmlal_n_s16(luma_lo, vget_low_s16(cb), static_cast<int16_t>(k.b_u)),
+                            vmlal_n_s16(luma_hi, vget_high_s16(cb), static_cast<int16_t>(k.b_u)));
+        vst3_u8(out + x * 3, rgb);
+    }
+    YuvRowToRgbRange(y, u, v, chroma_step, x, width, k, out);
+}
+
+#endif  // STREAM_DAEMON_NEON_KERNELS
+
+Kernels SelectKernels(SimdLevel level) {
+    switch (level) {
+#if defined(STREAM_DAEMON_X86_KERNELS)
+        case SimdLevel::kAvx2:
+            return {HorizontalAvx2, VerticalAvx2, YuvRowToRgbSse41};
+        case SimdLevel::kSse41:
+            return {HorizontalSse41, VerticalSse41, YuvRowToRgbSse41};
+#endif
+#if defined(STREAM_DAEMON_NEON_KERNELS)
+        case SimdLevel::kNeon:
+            return {HorizontalScalar, VerticalNeon, YuvRowToRgbNeon};
+#endif
+        default:
+            return {HorizontalScalar, VerticalScalar, YuvRowToRgbScalar};
+    }
+}
+
+// Bilinear source coordinate (pixel centers aligned) -> index pair + Q7 weight
+void BilinearTap(int dst_index, double scale, int src_size,
+                 int32_t& index0, int32_t& index1, int16_t& weight) {
+    const double pos = std::max(0.0, (dst_index + 0.5) * scale - 0.5);
+    int i0 = static_cast<int>(pos);
+    int w = static_cast<int>(std::lround((pos - i0) * kWeightOne));
+    if (w == kWeightOne) {
+        ++i0;
+        w = 0;
+    }
+    if (i0 >= src_size - 1) {
+        i0 = src_size - 1;
+        w = 0;
+    }
+    index0 = i0;
+    index1 = std::min(i0 + 1, src_size - 1);
+    weight = static_cast<int16_t>(w);
+}
+
+}  // namespace
+
+LetterboxGeometry ComputeLetterboxGeometry(int src_w, int src_h, int dst_w, int dst_h) noexcept {
+    LetterboxGeometry geometry;
+
+    // Calculate scale to fit while maintaining aspect ratio
+    float scale_w = static_cast<float>(dst_w) / src_w;
+    float scale_h = static_cast<float>(dst_h) / src_h;
+    geometry.scale = std::min(scale_w, scale_h);
+
+    // New dimensions after scaling
+    geometry.new_w = static_cast<int>(src_w * geometry.scale);
+    geometry.new_h = static_cast<int>(src_h * geometry.scale);
+
+    // Padding to center the image
+    geometry.pad_x = (dst_w - geometry.new_w) / 2;
+    geometry.pad_y = (dst_h - geometry.new_h) / 2;
+
+    return geometry;
+}
+
+std::string_view SimdLevelToString(SimdLevel level) noexcept {
+    switch (level) {
+        case SimdLevel::kScalar: return "scalar";
+        case SimdLevel::kSse41: return "sse4.1";
+        case SimdLevel::kAvx2: return "avx2";
+        case SimdLevel::kNeon: return "neon";
+    }
+    return "unknown";
+}
+
+bool IsSimdLevelSupported(SimdLevel level) noexcept {
+    switch (level) {
+        case SimdLevel::kScalar:
+            return true;
+#if defined(STREAM_DAEMON_X86_KERNELS)
+        case SimdLevel::kSse41:
+            __builtin_cpu_init();
+            return __builtin_cpu_supports("sse4.1");
+        case SimdLevel::kAvx2:
+            __builtin_cpu_init();
+            return __builtin_cpu_supports("avx2");
+#endif
+#if defined(STREAM_DAEMON_NEON_KERNELS)
+        case SimdLevel::kNeon:
+            return true;
+#endif
+        default:
+            return false;
+    }
+}
+
+SimdLevel DetectSimdLevel() noexcept {
+    for (SimdLevel level : {SimdLevel::kAvx2, SimdLevel::kSse41, SimdLevel::kNeon}) {
+        if (IsSimdLevelSupported(level)) {
+            return level;
+        }
+    }
+    return SimdLevel::kScalar;
+}
+
+LetterboxResizer::LetterboxResizer(ResizeInterpolation interpolation, SimdLevel level)
+    : interpolation_(interpolation),
+      level_(IsSimdLevelSupported(level) ? level : DetectSimdLevel()) {}
+
+LetterboxGeometry LetterboxResizer::Resize(const FrameView& src, uint8_t* dst,
+                                           int dst_w, int dst_h, uint8_t pad_value) {
+    const Plan& plan = GetPlan(src.format, src.width, src.height, dst_w, dst_h);
+    const auto& geometry = plan.geometry;
+
+    if (geometry.new_w <= 0 || geometry.new_h <= 0 || !src.IsValid()) {
+        std::memset(dst, pad_value, static_cast<size_t>(dst_w) * dst_h * 3);
+        Invalidate(dst);
+        return geometry;
+    }
+
+    PaintBorders(plan, dst, pad_value);
+
+    const int bands = BandCount(plan);
+    if (scratch_.size() < static_cast<size_t>(bands)) {
+        scratch_.resize(bands);
+    }
+    last_bands_ = bands;
+
+    if (bands == 1) {
+        ResizeRows(plan, src, dst, 0, geometry.new_h, scratch_[0]);
+        return geometry;
+    }
+
+    pool_->ParallelFor(bands, [&](int band) {
+        const int y_begin = static_cast<int>(static_cast<int64_t>(geometry.new_h) * band / bands);
+        const int y_end = static_cast<int>(static_cast<int64_t>(geometry.new_h) * (band + 1) / bands);
+        ResizeRows(plan, src, dst, y_begin, y_end, scratch_[band]);
+    });
+    return geometry;
+}
+
+void LetterboxResizer::SetWorkerPool(CpuWorkerPool* pool, int64_t min_parallel_pixels) {
+    pool_ = pool;
+    min_parallel_pixels_ = min_parallel_pixels;
+}
+
+void LetterboxResizer::Invalidate(const uint8_t* dst) {
+    painted_.erase(std::remove_if(painted_.begin(), painted_.end(),
+                                  [dst](const PaintedBuffer& p) { return p.dst == dst; }),
+                   painted_.end());
+}
+
+void LetterboxResizer::InvalidateAll() {
+    painted_.clear();
+}
+
+const LetterboxResizer::Plan& LetterboxResizer::GetPlan(PixelFormat format, int src_w, int src_h,
+                                                        int dst_w, int dst_h) {
+    auto it = std::find_if(plans_.begin(), plans_.end(), [&](const Plan& plan) {
+        return plan.format == format && plan.src_w == src_w && plan.src_h == src_h &&
+               plan.dst_w == dst_w && plan.dst_h == dst_h;
+    });
+    if (it != plans_.end()) {
+        std::rotate(it, it + 1, plans_.end());
+        return plans_.back();
+    }
+
+    if (plans_.size() >= kLetterboxPlanCacheSize) {
+        plans_.erase(plans_.begin());
+    }
+
+    Plan plan;
+    plan.format = format;
+    plan.src_w = src_w;
+    plan.src_h = src_h;
+    plan.dst_w = dst_w;
+    plan.dst_h = dst_h;
+    BuildPlan(plan);
+    plans_.push_back(std::move(plan));
+    return plans_.back();
+}
+
+void LetterboxResizer::BuildPlan(Plan& plan) const {
+    plan.geometry = ComputeLetterboxGeometry(plan.src_w, plan.src_h, plan.dst_w, plan.dst_h);
+    const int new_w = plan.geometry.new_w;
+    const int new_h = plan.geometry.new_h;
+    if (new_w <= 0 || new_h <= 0) {
+        return;
+    }
+
+    plan.x_offset0.resize(new_w);
+    plan.x_offset1.resize(new_w);
+    plan.x_weight.assign(new_w, 0);
+    plan.y_index0.resize(new_h);
+    plan.y_index1.resize(new_h);
+    plan.y_weight.assign(new_h, 0);
+
+    // Luma of YUV formats is a 1-byte plane
+    const int bytes_per_pixel = plan.format == PixelFormat::kRGB ? 3 : 1;
+
+    if (interpolation_ == ResizeInterpolation::kNearest) {
+        // Same float math as the original per-pixel loop (bit-exact output)
+        const float x_ratio = static_cast<float>(plan.src_w) / new_w;
+        const float y_ratio = static_cast<float>(plan.src_h) / new_h;
+        for (int x = 0; x < new_w; ++x) {
+            const int src_x = std::min(static_cast<int>(x * x_ratio), plan.src_w - 1);
+            plan.x_offset0[x] = plan.x_offset1[x] = src_x * bytes_per_pixel;
+        }
+        for (int y = 0; y < new_h; ++y) {
+            const int src_y = std::min(static_cast<int>(y * y_ratio), plan.src_h - 1);
+            plan.y_index0[y] = plan.y_index1[y] = src_y;
+        }
+        BuildChromaTables(plan);
+        return;
+    }
+
+    const double x_scale = static_cast<double>(plan.src_w) / new_w;
+    const double y_scale = static_cast<double>(plan.src_h) / new_h;
+    for (int x = 0; x < new_w; ++x) {
+        int32_t x0 = 0;
+        int32_t x1 = 0;
+        BilinearTap(x, x_scale, plan.src_w, x0, x1, plan.x_weight[x]);
+        plan.x_offset0[x] = x0 * bytes_per_pixel;
+        plan.x_offset1[x] = x1 * bytes_per_pixel;
+    }
+    for (int y = 0; y < new_h; ++y) {
+        BilinearTap(y, y_scale, plan.src_h, plan.y_index0[y], plan.y_index1[y], plan.y_weight[y]);
+    }
+
+    BuildChromaTables(plan);
+    if (plan.format != PixelFormat::kRGB) {
+        return;
+    }
+
+    // 4-byte loads of the last pixel would read one byte past the row
+    const int32_t row_bytes = plan.src_w * 3;
+    plan.gather_columns = 0;
+    while (plan.gather_columns < new_w && plan.x_offset1[plan.gather_columns] + 4 <= row_bytes) {
+        ++plan.gather_columns;
+    }
+}
+
+void LetterboxResizer::BuildChromaTables(Plan& plan) const {
+    if (plan.format != PixelFormat::kNV12 && plan.format != PixelFormat::kI420) {
+        return;
+    }
+
+    const int new_w = plan.geometry.new_w;
+    const int new_h = plan.geometry.new_h;
+    const int chroma_w = (plan.src_w + 1) / 2;
+    const int chroma_h = (plan.src_h + 1) / 2;
+    const int bytes_per_pixel = plan.format == PixelFormat::kNV12 ? 2 : 1;  // UV interleaved
+
+    plan.cx_offset0.resize(new_w);
+    plan.cx_offset1.resize(new_w);
+    plan.cx_weight.assign(new_w, 0);
+    plan.cy_index0.resize(new_h);
+    plan.cy_index1.resize(new_h);
+    plan.cy_weight.assign(new_h, 0);
+
+    if (interpolation_ == ResizeInterpolation::kNearest) {
+        // Chroma of the luma sample that was picked
+        for (int x = 0; x < new_w; ++x) {
+            plan.cx_offset0[x] = plan.cx_offset1[x] = (plan.x_offset0[x] / 2) * bytes_per_pixel;
+        }
+        for (int y = 0; y < new_h; ++y) {
+            plan.cy_index0[y] = plan.cy_index1[y] = plan.y_index0[y] / 2;
+        }
+        return;
+    }
+
+    // Chroma samples treated as centered between their luma pairs
+    const double x_scale = static_cast<double>(chroma_w) / new_w;
+    const double y_scale = static_cast<double>(chroma_h) / new_h;
+    for (int x = 0; x < new_w; ++x) {
+        int32_t x0 = 0;
+        int32_t x1 = 0;
+        BilinearTap(x, x_scale, chroma_w, x0, x1, plan.cx_weight[x]);
+        plan.cx_offset0[x] = x0 * bytes_per_pixel;
+        plan.cx_offset1[x] = x1 * bytes_per_pixel;
+    }
+    for (int y = 0; y < new_h; ++y) {
+        BilinearTap(y, y_scale, chroma_h, plan.cy_index0[y], plan.cy_index1[y], plan.cy_weight[y]);
+    }
+}
+
+void LetterboxResizer::PaintBorders(const Plan& plan, uint8_t* dst, uint8_t pad_value) {
+    const auto& g = plan.geometry;
+    auto it = std::find_if(painted_.begin(), painted_.end(),
+                           [dst](const PaintedBuffer& p) { return p.dst == dst; });
+    if (it != painted_.end() && it->dst_w == plan.dst_w && it->dst_h == plan.dst_h &&
+        it->pad_x == g.pad_x && it->pad_y == g.pad_y && it->new_w == g.new_w &&
+        it->new_h == g.new_h && it->pad_value == pad_value) {
+        return;
+    }
+
+    const size_t row_bytes = static_cast<size_t>(plan.dst_w) * 3;
+    const int bottom_rows = plan.dst_h - g.pad_y - g.new_h;
+    const size_t left_bytes = static_cast<size_t>(g.pad_x) * 3;
+    const size_t right_bytes = static_cast<size_t>(plan.dst_w - g.pad_x - g.new_w) * 3;
+
+    std::memset(dst, pad_value, row_bytes * g.pad_y);
+    std::memset(dst + row_bytes * (g.pad_y + g.new_h), pad_value, row_bytes * bottom_rows);
+    if (left_bytes > 0 || right_bytes > 0) {
+        for (int y = g.pad_y; y < g.pad_y + g.new_h; ++y) {
+            uint8_t* row = dst + row_bytes * y;
+            std::memset(row, pad_value, left_bytes);
+            std::memset(row + row_bytes - right_bytes, pad_value, right_bytes);
+        }
+    }
+
+    PaintedBuffer painted{dst, plan.dst_w, plan.dst_h, g.pad_x, g.pad_y, g.new_w, g.new_h, pad_value};
+    if (it != painted_.end()) {
+        *it = painted;
+    } else {
+        painted_.push_back(painted);
+    }
+}
+
+int LetterboxResizer::BandCount(const Plan& plan) const {
+    if (!pool_ || static_cast<int64_t>(plan.src_w) * plan.src_h < min_parallel_pixels_) {
+        return 1;
+    }
+    const int max_bands = std::max(1, plan.geometry.new_h / kMinPreprocessBandRows);
+    return std::min(pool_->GetConcurrency(), max_bands);
+}
+
+void LetterboxResizer::ResizeRows(const Plan& plan, const FrameView& src, uint8_t* dst,
+                                  int y_begin, int y_end, Scratch& scratch) const {
+    if (src.IsYuv()) {
+        ResizeYuv(plan, src, dst, y_begin, y_end, scratch);
+    } else if (interpolation_ == ResizeInterpolation::kNearest) {
+        ResizeNearest(plan, src, dst, y_begin, y_end);
+    } else {
+        ResizeBilinear(plan, src, dst, y_begin, y_end, scratch);
+    }
+}
+
+void LetterboxResizer::ResizeNearest(const Plan& plan, const FrameView& src, uint8_t* dst,
+                                     int y_begin, int y_end) const {
+    const auto& g = plan.geometry;
+    const size_t row_bytes = static_cast<size_t>(plan.dst_w) * 3;
+    const size_t copy_bytes = static_cast<size_t>(g.new_w) * 3;
+
+    for (int y = y_begin; y < y_end; ++y) {
+        uint8_t* dst_row = dst + row_bytes * (y + g.pad_y) + static_cast<size_t>(g.pad_x) * 3;
+
+        // Upscaled rows repeat: copy the previous output row
+        if (y > y_begin && plan.y_index0[y] == plan.y_index0[y - 1]) {
+            std::memcpy(dst_row, dst_row - row_bytes, copy_bytes);
+            continue;
+        }
+
+        const uint8_t* src_row = src.Row(0, plan.y_index0[y]);
+        for (int x = 0; x < g.new_w; ++x) {
+            const uint8_t* p = src_row + plan.x_offset0[x];
+            uint8_t* o = dst_row + x * 3;
+            o[0] = p[0];
+            o[1] = p[1];
+            o[2] = p[2];
+        }
+    }
+}
+
+void LetterboxResizer::ResizeBilinear(const Plan& plan, const FrameView& src, uint8_t* dst,
+                                      int y_begin, int y_end, Scratch& scratch) const {
+    const auto& g = plan.geometry;
+    const size_t row_bytes = static_cast<size_t>(plan.dst_w) * 3;
+    const int count = g.new_w * 3;
+    const Kernels kernels = SelectKernels(level_);
+
+    // Rows cached from the previous frame are stale
+    scratch.rows.Reset(static_cast<size_t>(count) + kRowSlack);
+
+    const auto horizontal = [&](int src_y, int16_t* out) {
+        kernels.horizontal(src.Row(0, src_y), plan.x_offset0.data(), plan.x_offset1.data(),
+                           plan.x_weight.data(), plan.gather_columns, g.new_w, out);
+    };
+
+    for (int y = y_begin; y < y_end; ++y) {
+        const int16_t* top = CachedRow(scratch.rows, plan.y_index0[y], horizontal);
+        const int16_t* bottom = CachedRow(scratch.rows, plan.y_index1[y], horizontal);
+        uint8_t* dst_row = dst + row_bytes * (y + g.pad_y) + static_cast<size_t>(g.pad_x) * 3;
+        kernels.vertical(top, bottom, plan.y_weight[y], count, dst_row);
+    }
+}
+
+void LetterboxResizer::ResizeYuv(const Plan& plan, const FrameView& src, uint8_t* dst,
+                                 int y_begin, int y_end, Scratch& scratch) const {
+    const auto& g = plan.geometry;
+    const size_t row_bytes = static_cast<size_t>(plan.dst_w) * 3;
+    const bool nv12 = src.format == PixelFormat::kNV12;
+    const int chroma_planes = nv12 ? 1 : 2;
+    const int chroma_count = nv12 ? g.new_w * 2 : g.new_w;
+    const bool bilinear = interpolation_ == ResizeInterpolation::kBilinear;
+    const YuvCoefficients coeffs = MakeYuvCoefficients(src.yuv_matrix, src.yuv_full_range);
+    const Kernels kernels = SelectKernels(level_);
+
+    std::vector<uint8_t>& luma_row = scratch.luma_row;
+    luma_row.resize(static_cast<size_t>(g.new_w) + kRowSlack);
+    scratch.rows.Reset(static_cast<size_t>(g.new_w) + kRowSlack);
+    for (int p = 0; p < chroma_planes; ++p) {
+        scratch.chroma_row[p].resize(static_cast<size_t>(chroma_count) + kRowSlack);
+        scratch.chroma[p].Reset(static_cast<size_t>(chroma_count) + kRowSlack);
+    }
+
+    const auto luma = [&](int src_y, int16_t* out) {
+        HorizontalScalarRange<1>(src.Row(0, src_y), plan.x_offset0.data(), plan.x_offset1.data(),
+                                 plan.x_weight.data(), 0, g.new_w, out);
+    };
+
+    for (int y = y_begin; y < y_end; ++y) {
+        if (bilinear) {
+            kernels.vertical(CachedRow(scratch.rows, plan.y_index0[y], luma),
+                             CachedRow(scratch.rows, plan.y_index1[y], luma),
+                             plan.y_weight[y], g.new_w, luma_row.data());
+
+            for (int p = 0; p < chroma_planes; ++p) {
+                const auto chroma = [&](int src_y, int16_t* out) {
+                    const uint8_t* row = src.Row(1 + p, src_y);
+                    if (nv12) {
+                        HorizontalScalarRange<2>(row, plan.cx_offset0.data(), plan.cx_offset1.data(),
+                                                 plan.cx_weight.data(), 0, g.new_w, out);
+                    } else {
+                        HorizontalScalarRange<1>(row, plan.cx_offset0.data(), plan.cx_offset1.data(),
+                                                 plan.cx_weight.data(), 0, g.new_w, out);
+                    }
+                };
+                kernels.vertical(CachedRow(scratch.chroma[p], plan.cy_index0[y], chroma),
+                                 CachedRow(scratch.chroma[p], plan.cy_index1[y], chroma),
+                                 plan.cy_weight[y], chroma_count, scratch.chroma_row[p].data());
+            }
+        } else {
+            const uint8_t* luma_src = src.Row(0, plan.y_index0[y]);
+            for (int x = 0; x < g.new_w; ++x) {
+                luma_row[x] = luma_src[plan.x_offset0[x]];
+            }
+            for (int p = 0; p < chroma_planes; ++p) {
+                const uint8_t* chroma_src = src.Row(1 + p, plan.cy_index0[y]);
+                uint8_t* out = scratch.chroma_row[p].data();
+                for (int x = 0; x < g.new_w; ++x) {
+                    const uint8_t* c = chroma_src + plan.cx_offset0[x];
+                    if (nv12) {
+                        out[x * 2] = c[0];
+                        out[x * 2 + 1] = c[1];
+                    } else {
+                        out[x] = c[0];
+                    }
+                }
+            }
+        }
+
+        const uint8_t* u = scratch.chroma_row[0].data();
+        const uint8_t* v = nv12 ? u + 1 : scratch.chroma_row[1].data();
+        uint8_t* dst_row = dst + row_bytes * (y + g.pad_y) + static_cast<size_t>(g.pad_x) * 3;
+        kernels.yuv_to_rgb(luma_row.data(), u, v, nv12 ? 2 : 1, g.new_w, coeffs, dst_row);
+    }
+}
+
+void LetterboxResizer::RowCache::Reset(size_t size) {
+    for (int i = 0; i < 2; ++i) {
+        rows[i].resize(size);
+        y[i] = -1;
+    }
+}
+
+template <typename Fill>
+const int16_t* LetterboxResizer::CachedRow(RowCache& cache, int src_y, Fill&& fill) {
+    for (int i = 0; i < 2; ++i) {
+        if (cache.y[i] == src_y) {
+            return cache.rows[i].data();
+        }
+    }
+
+    // Source rows only move down: evict the upper one
+    const int slot = cache.y[0] <= cache.y[1] ? 0 : 1;
+    fill(src_y, cache.rows[slot].data());
+    cache.y[slot] = src_y;
+    return cache.rows[slot].data();
+}
+
+}  // namespace stream_daemon
@@ -0,0 +1,23 @@
+#include "inference_backend.h"
+
+namespace stream_daemon {
+
+std::string_view TensorDataTypeToString(TensorDataType type) noexcept {
+    switch (type) {
+        case TensorDataType::kUint8: return "uint8";
+        case TensorDataType::kUint16: return "uint16";
+        case TensorDataType::kFloat32: return "float32";
+    }
+    return "unknown";
+}
+
+size_t TensorDataTypeSize(TensorDataType type) noexcept {
+    switch (type) {
+        case TensorDataType::kUint8: return 1;
+        case TensorDataType::kUint16: return 2;
+        case TensorDataType::kFloat32: return 4;
+    }
+    return 1;
+}
+
+}  // namespace stream_daemon
@@ -0,0 +1,281 @@
+#include "inference_scheduler.h"
+
+#include <algorithm>
+
+namespace stream_daemon {
+
+namespace {
+
+constexpr double kMinWeight = 1e-3;
+
+[[nodiscard]] double ElapsedMs(InferenceScheduler::Clock::time_point from,
+                               InferenceScheduler::Clock::time_point to) {
+    return std::chrono::duration<double, std::milli>(to - from).count();
+}
+
+}  // namespace
+
+InferenceScheduler::InferenceScheduler(int max_in_flight, NowFn now)
+    : max_in_flight_(std::max(1, max_in_flight)), now_(std::move(now)) {}
+
+void InferenceScheduler::SetStreamPolicy(const std::string& stream_id, const StreamPolicy& policy) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    const auto now = now_();
+    Stream& stream = StreamFor(stream_id, now);
+    stream.policy = policy;
+    stream.policy.weight = std::max(policy.weight, kMinWeight);
+    stream.policy.min_fps = std::max(policy.min_fps, 0.0);
+    stream.owed = std::min(stream.owed, kSchedulerMinRateBurst);
+    Dispatch(now);
+}
+
+void InferenceScheduler::RemoveStream(const std::string& stream_id) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = streams_.find(stream_id);
+    if (it != streams_.end() && it->second.waiting.empty()) {
+        streams_.erase(it);
+    }
+}
+
+void InferenceScheduler::Cancel(const std::string& stream_id) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    Stream& stream = StreamFor(stream_id, now_());
+    stream.cancelled = true;
+    for (Waiter* waiter : stream.waiting) {
+        waiter->state = WaiterState::kCancelled;
+    }
+    stream.waiting.clear();
+    cv_.notify_all();
+}
+
+void InferenceScheduler::Resume(const std::string& stream_id) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = streams_.find(stream_id);
+    if (it != streams_.end()) {
+        it->second.cancelled = false;
+    }
+}
+
+Result<InferenceScheduler::Lease> InferenceScheduler::Acquire(const std::string& stream_id,
+                                                              int slots) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    const auto now = now_();
+    Stream& stream = StreamFor(stream_id, now);
+    if (stream.cancelled) {
+        return MakeErrorT<Lease>("Inference for " + stream_id + " cancelled");
+    }
+
+    const auto deadline = stream.policy.deadline;
+    Waiter waiter;
+    waiter.enqueued = now;
+    waiter.deadline = deadline.count() > 0 ? now + deadline : Clock::time_point::max();
+    waiter.slots = std::clamp(slots, 1, max_in_flight_);
+
+    // Tagged on arrival: an idle stream restarts at its class's virtual time
+    // (no credit for the time it was idle), a backlogged one after its last frame
+    const auto cls = static_cast<size_t>(stream.policy.priority);
+    waiter.start_tag = std::max(stream.virtual_finish, class_virtual_time_[cls]);
+    stream.virtual_finish = waiter.start_tag + waiter.slots / stream.policy.weight;
+    stream.waiting.push_back(&waiter);
+    Dispatch(now);
+
+    while (waiter.state == WaiterState::kWaiting) {
+        if (waiter.deadline == Clock::time_point::max()) {
+            cv_.wait(lock);
+            continue;
+        }
+        // Waits out the remaining time by now_(), so an injected clock works too
+        const auto remaining = waiter.deadline - now_();
+        if (remaining <= Clock::duration::zero() ||
+            cv_.wait_for(lock, remaining) == std::cv_status::timeout) {
+            // Dispatch drops expired waiters; do it here in case no slot frees up
+            Dispatch(now_());
+        }
+    }
+
+    if (waiter.state == WaiterState::kCancelled) {
+        return MakeErrorT<Lease>("Inference for " + stream_id + " cancelled");
+    }
+    if (waiter.state == WaiterState::kDropped) {
+        return MakeErrorT<Lease>("Inference deadline (" +
+                                 std::to_string(deadline.count()) +
+                                 "ms) passed waiting for the NPU");
+    }
+
+    // Releasing the lease frees the slot (the scheduler lives as long as any lease)
+    auto self = shared_from_this();
+    const int granted = waiter.slots;
+    return Lease(nullptr, [self, granted](const void*) { self->Release(granted); });
+}
+
+InferenceScheduler::StreamStats InferenceScheduler::GetStreamStats(const std::string& stream_id) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = streams_.find(stream_id);
+    if (it == streams_.end()) {
+        return StreamStats{};
+    }
+    return MakeStats(it->second, now_());
+}
+
+std::unordered_map<std::string, InferenceScheduler::StreamStats> InferenceScheduler::GetStats() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    const auto now = now_();
+    std::unordered_map<std::string, StreamStats> stats;
+    for (const auto& [stream_id, stream] : streams_) {
+        stats.emplace(stream_id, MakeStats(stream, now));
+    }
+    return stats;
+}
+
+int InferenceScheduler::GetInFlight() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return in_flight_;
+}
+
+InferenceScheduler::Stream& InferenceScheduler::StreamFor(const std::string& stream_id,
+                                                          Clock::time_point now) {
+    auto [it, inserted] = streams_.try_emplace(stream_id);
+    if (inserted) {
+        it->second.first_seen = now;
+        it->second.owed_updated = now;
+    }
+    return it->second;
+}
+
+void InferenceScheduler::Dispatch(Clock::time_point now) {
+    bool changed = false;
+
+    for (auto& [stream_id, stream] : streams_) {
+        // Stale frames leave the queue whether or not a slot is free
+        auto& waiting = stream.waiting;
+        const auto expired = std::stable_partition(
+            waiting.begin(), waiting.end(),
+            [now](const Waiter* waiter) { return waiter->deadline > now; });
+        for (auto it = expired; it != waiting.end(); ++it) {
+            (*it)->state = WaiterState::kDropped;
+            ++stream.dropped;
+            changed = true;
+        }
+        waiting.erase(expired, waiting.end());
+
+        // Min-rate streams are owed min_fps frames per second (bounded burst)
+        if (stream.policy.min_fps > 0.0) {
+            const double seconds = std::chrono::duration<double>(now - stream.owed_updated).count();
+            stream.owed = std::min(kSchedulerMinRateBurst,
+                                   stream.owed + stream.policy.min_fps * std::max(0.0, seconds));
+        }
+        stream.owed_updated = now;
+    }
+
+    while (in_flight_ < max_in_flight_) {
+        bool guaranteed = false;
+        Stream* next = SelectNext(guaranteed);
+        // A multi-slot frame waits for enough free slots rather than being
+        // overtaken, so large frames are not starved by single-slot ones
+        if (!next || in_flight_ + next->waiting.front()->slots > max_in_flight_) {
+            break;
+        }
+        Grant(*next, guaranteed, now);
+        changed = true;
+    }
+
+    if (changed) {
+        cv_.notify_all();
+    }
+}
+
+InferenceScheduler::Stream* InferenceScheduler::SelectNext(bool& guaranteed) {
+    // A stream behind its minimum rate goes first, whatever its class
+    Stream* owed = nullptr;
+    for (auto& [stream_id, stream] : streams_) {
+        if (stream.waiting.empty() || stream.policy.min_fps <= 0.0 || stream.owed < 1.0) {
+            continue;
+        }
+        if (!owed || stream.owed > owed->owed) {
+            owed = &stream;
+        }
+    }
+    if (owed) {
+        guaranteed = true;
+        return owed;
+    }
+
+    // Highest class with frames waiting; smallest start tag within it
+    Stream* best = nullptr;
+    for (auto& [stream_id, stream] : streams_) {
+        if (stream.waiting.empty()) {
+            continue;
+        }
+        if (!best || stream.policy.priority < best->policy.priority) {
+            best = &stream;
+            continue;
+        }
+        if (stream.policy.priority > best->policy.priority) {
+            continue;
+        }
+        const Waiter* head = stream.waiting.front();
+        const Waiter* best_head = best->waiting.front();
+        if (head->start_tag < best_head->start_tag ||
+            (head->start_tag == best_head->start_tag && head->enqueued < best_head->enqueued)) {
+            best = &stream;
+        }
+    }
+    guaranteed = false;
+    return best;
+}
+
+void InferenceScheduler::Grant(Stream& stream, bool guaranteed, Clock::time_point now) {
+    Waiter* waiter = stream.waiting.front();
+    stream.waiting.pop_front();
+    waiter->state = WaiterState::kGranted;
+    in_flight_ += waiter->slots;
+
+    // Every grant counts as service: towards the min rate and the fair share
+    stream.owed = std::max(0.0, stream.owed - 1.0);
+    const auto cls = static_cast<size_t>(stream.policy.priority);
+    class_virtual_time_[cls] = std::max(class_virtual_time_[cls], waiter->start_tag);
+
+    ++stream.granted;
+    if (guaranteed) {
+        ++stream.guaranteed;
+    }
+    stream.total_wait_ms += ElapsedMs(waiter->enqueued, now);
+    stream.recent_grants.push_back(now);
+    const auto window = std::chrono::milliseconds(kSchedulerRateWindowMs);
+    while (!stream.recent_grants.empty() && now - stream.recent_grants.front() > window) {
+        stream.recent_grants.pop_front();
+    }
+}
+
+void InferenceScheduler::Release(int slots) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    in_flight_ -= slots;
+    Dispatch(now_());
+}
+
+InferenceScheduler::StreamStats InferenceScheduler::MakeStats(const Stream& stream,
+                                                              Clock::time_point now) const {
+    StreamStats stats;
+    stats.policy = stream.policy;
+    stats.granted = stream.granted;
+    stats.dropped = stream.dropped;
+    stats.guaranteed = stream.guaranteed;
+    stats.waiting = stream.waiting.size();
+    if (stream.granted > 0) {
+        stats.mean_wait_ms = stream.total_wait_ms / static_cast<double>(stream.granted);
+    }
+
+    // Rate over the window, or since the stream appeared when that is shorter
+    const auto window = std::chrono::milliseconds(kSchedulerRateWindowMs);
+    const auto span = std::min<Clock::duration>(window, now - stream.first_seen);
+    const auto recent = std::count_if(
+        stream.recent_grants.begin(), stream.recent_grants.end(),
+        [&](Clock::time_point granted) { return now - granted <= window; });
+    const double seconds = std::chrono::duration<double>(span).count();
+    if (seconds > 0.0) {
+        stats.achieved_fps = static_cast<double>(recent) / seconds;
+    }
+    return stats;
+}
+
+}  // namespace stream_daemon
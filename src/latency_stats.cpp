@@ -0,0 +1,76 @@
+#include "latency_stats.h"
+
+#include <algorithm>
+#include <numeric>
+
+namespace stream_daemon {
+
+LatencyTracker::LatencyTracker(size_t window_size)
+    : window_(std::max<size_t>(1, window_size), 0) {}
+
+void LatencyTracker::Record(int64_t latency_ms) {
+    if (latency_ms < 0) {
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    window_[next_] = latency_ms;
+    next_ = (next_ + 1) % window_.size();
+    filled_ = std::min(filled_ + 1, window_.size());
+    ++count_;
+    last_ = latency_ms;
+}
+
+LatencySummary LatencyTracker::Summary() const {
+    std::vector<int64_t> samples;
+    LatencySummary summary;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        summary.count = count_;
+        summary.last_ms = last_;
+        samples.assign(window_.begin(), window_.begin() + static_cast<std::ptrdiff_t>(filled_));
+    }
+
+    if (samples.empty()) {
+        return summary;
+    }
+
+    std::sort(samples.begin(), samples.end());
+    const auto percentile = [&samples](double p) {
+        const auto index = static_cast<size_t>(p * static_cast<double>(samples.size() - 1) + 0.5);
+        return samples[index];
+    };
+
+    summary.mean_ms = static_cast<double>(std::accumulate(samples.begin(), samples.end(), int64_t{0})) /
+                      static_cast<double>(samples.size());
+    summary.p50_ms = percentile(0.50);
+    summary.p95_ms = percentile(0.95);
+    summary.p99_ms = percentile(0.99);
+    summary.max_ms = samples.back();
+    return summary;
+}
+
+void LatencyTracker::Reset() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    next_ = 0;
+    filled_ = 0;
+    count_ = 0;
+    last_ = 0;
+}
+
+void StageTimer::Record(std::chrono::steady_clock::duration elapsed) {
+    samples_.Record(std::chrono::duration_cast<std::chrono::microseconds>(elapsed).count());
+}
+
+StageTiming StageTimer::Summary() const {
+    const LatencySummary summary = samples_.Summary();
+    StageTiming timing;
+    timing.count = summary.count;
+    timing.last_us = summary.last_ms;
+    timing.mean_us = summary.mean_ms;
+    timing.p95_us = summary.p95_ms;
+    timing.max_us = summary.max_ms;
+    return timing;
+}
+
+}  // namespace stream_daemon
@@ -1,13 +1,20 @@
 #include "common.h"
 #include "config.h"
 #include "debug_utils.h"
+#include "device_pool.h"
 #include "grpc_server.h"
+#include "hailo_inference.h"
+#ifdef HAVE_HAILORT
+#include "hailort_backend.h"
+#endif
 #include "model_registry.h"
+#include "simulated_inference_backend.h"
 #include "stream_manager.h"
 
 #include <gst/gst.h>
 
 #include <atomic>
+#include <chrono>
 #include <csignal>
 #include <cstdlib>
 #include <cstring>
@@ -242,6 +249,57 @@ std::string FindConfigFile(const std::string& specified_path) {
     return specified_path;
 }
 
+/**
+ * @brief Backend factory for HailoInference from the hailo config section
+ *
+ * Recordings are <recording_dir>/<model stem>.rec: written by the hailort
+ * backend (on the first pool device only, one file per model), replayed by
+ * the simulated one on every device (which falls back to the model path
+ * itself when no directory is set).
+ *
+ * Empty when the hailort backend is asked for in a build without HailoRT
+ * (ENABLE_HAILORT=OFF).
+ */
+stream_daemon::InferenceBackendFactory MakeBackendFactory(
+    const stream_daemon::HailoConfig& hailo) {
+    using namespace stream_daemon;
+
+    auto recording_path = [dir = hailo.recording_dir](const std::string& model_path) {
+        if (dir.empty()) {
+            return std::string();
+        }
+        const auto stem = std::filesystem::path(model_path).stem().string();
+        return (std::filesystem::path(dir) / (stem + ".rec")).string();
+    };
+
+    if (hailo.backend == "simulated") {
+        SimulatedDeviceModel model;
+        model.latency = std::chrono::milliseconds(hailo.simulated_latency_ms);
+        model.frames_per_second = hailo.simulated_fps;
+        return [model, recording_path](const std::string& model_path, const std::string&)
+                   -> std::unique_ptr<IInferenceBackend> {
+            return std::make_unique<SimulatedInferenceBackend>(model, recording_path(model_path));
+        };
+    }
+
+#ifdef HAVE_HAILORT
+    const std::string recorded_device = DevicePool::ParseDeviceIds(hailo.device_id).front();
+    return [recording_path, recorded_device, batch_size = hailo.batch_size,
+            quantized = hailo.quantized_outputs](
+               const std::string& model_path, const std::string& device_id)
+               -> std::unique_ptr<IInferenceBackend> {
+        auto backend = std::make_unique<HailoRtBackend>(batch_size, device_id, quantized);
+        const std::string path = recording_path(model_path);
+        if (path.empty() || device_id != recorded_device) {
+            return backend;
+        }
+        return std::make_unique<RecordingInferenceBackend>(std::move(backend), path);
+    };
+#else
+    return {};
+#endif
+}
+
 }  // namespace
 
 int main(int argc, char* argv[]) {
@@ -328,6 +386,31 @@ int main(int argc, char* argv[]) {
     LogInfo("Starting Stream Processing Daemon...");
     LogInfo("NATS URL: " + config.nats.url);
     LogInfo("gRPC port: " + std::to_string(config.grpc.port));
+    LogInfo("Inference backend: " + config.hailo.backend +
+            (config.hailo.quantized_outputs ? " (quantized outputs)" : ""));
+    LogInfo("Inference scheduler: " + (config.hailo.max_in_flight > 0
+                                           ? "max_in_flight=" + std::to_string(config.hailo.max_in_flight)
+                                           : std::string("off")));
+    const auto device_ids = DevicePool::ParseDeviceIds(config.hailo.device_id);
+    if (device_ids.size() > 1) {
+        LogInfo("Device pool: " + std::to_string(device_ids.size()) + " devices (" +
+                config.hailo.device_id + "), max_model_replicas=" +
+                std::to_string(config.hailo.max_model_replicas));
+    }
+
+    auto backend_factory = MakeBackendFactory(config.hailo);
+    if (!backend_factory) {
+        LogError("Inference backend '" + config.hailo.backend +
+                 "' is not available: built without HailoRT (ENABLE_HAILORT=OFF)");
+        gst_deinit();
+        return 1;
+    }
+#ifdef HAVE_HAILORT
+    HailoInference::SetBackendFactory(std::move(backend_factory),
+                                      &HailoRtBackend::ReleaseSharedDevice);
+#else
+    HailoInference::SetBackendFactory(std::move(backend_factory));
+#endif
 
     // Setup signal handlers
     SetupSignalHandlers();
@@ -343,7 +426,8 @@ int main(int argc, char* argv[]) {
     LogInfo("Registered models: " + std::to_string(model_registry->GetModelCount()));
 
     // Create StreamManager
-    auto manager_result = StreamManager::Create(config.nats.url);
+    auto manager_result = StreamManager::Create(config.nats.url, config.hailo.max_in_flight,
+                                                device_ids, config.hailo.max_model_replicas);
     if (IsError(manager_result)) {
         LogError("Failed to create StreamManager: " + GetError(manager_result));
         gst_deinit();
@@ -0,0 +1,43 @@
+#include "model_context.h"
+
+namespace stream_daemon {
+
+namespace {
+
+// COCO 80 class labels
+static const char* COCO_LABELS[] = {
+    "person", "bicycle", "car", "motorcycle", "airplane", "bus", "train", "truck", "boat",
+    "traffic light", "fire hydrant", "stop sign", "parking meter", "bench", "bird", "cat",
+    "dog", "horse", "sheep", "cow", "elephant", "bear", "zebra", "giraffe", "backpack",
+    "umbrella", "handbag", "tie", "suitcase", "frisbee", "skis", "snowboard", "sports ball",
+    "kite", "baseball bat", "baseball glove", "skateboard", "surfboard", "tennis racket",
+    "bottle", "wine glass", "cup", "fork", "knife", "spoon", "bowl", "banana", "apple",
+    "sandwich", "orange", "broccoli", "carrot", "hot dog", "pizza", "donut", "cake", "chair",
+    "couch", "potted plant", "bed", "dining table", "toilet", "tv", "laptop", "mouse",
+    "remote", "keyboard", "cell phone", "microwave", "oven", "toaster", "sink", "refrigerator",
+    "book", "clock", "vase", "scissors", "teddy bear", "hair drier", "toothbrush"
+};
+static const int NUM_COCO_LABELS = 80;
+
+}  // namespace
+
+std::string_view OutputDecoderToString(OutputDecoder decoder) noexcept {
+    switch (decoder) {
+        case OutputDecoder::kNone: return "none";
+        case OutputDecoder::kNms: return "nms";
+        case OutputDecoder::kRawYolo: return "raw_yolo";
+    }
+    return "unknown";
+}
+
+std::string ModelContext::ClassName(int class_id) const {
+    if (class_id >= 0 && class_id < static_cast<int>(spec.labels.size())) {
+        return spec.labels[class_id];
+    }
+    if (class_id >= 0 && class_id < NUM_COCO_LABELS) {
+        return COCO_LABELS[class_id];
+    }
+    return "object";
+}
+
+}  // namespace stream_daemon
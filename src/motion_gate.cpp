@@ -0,0 +1,220 @@
+#include "motion_gate.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+
+#if defined(__x86_64__) || defined(__i386__)
+#define STREAM_DAEMON_X86_KERNELS 1
+#include <immintrin.h>
+#endif
+
+#if defined(__ARM_NEON)
+#define STREAM_DAEMON_NEON_KERNELS 1
+#include <arm_neon.h>
+#endif
+
+namespace stream_daemon {
+
+namespace {
+
+// Background kept in Q4 so the 1/16 update does not stall on rounding
+constexpr int kBackgroundBits = 4;
+
+// Pixels per group sum; cell edges are multiples of it so one SAD lane
+// never straddles two cells
+constexpr int kGroupPixels = 8;
+
+// sums[g] += row[8g] + ... + row[8g+7] for g in [0, groups)
+using GroupSumFn = void (*)(const uint8_t* row, int groups, uint32_t* sums);
+
+void GroupSumScalar(const uint8_t* row, int groups, uint32_t* sums) {
+    for (int g = 0; g < groups; ++g) {
+        const uint8_t* p = row + g * kGroupPixels;
+        sums[g] += static_cast<uint32_t>(p[0]) + p[1] + p[2] + p[3] + p[4] + p[5] + p[6] + p[7];
+    }
+}
+
+#if defined(STREAM_DAEMON_X86_KERNELS)
+
+__attribute__((target("sse4.1")))
+void GroupSumSse41(const uint8_t* row, int groups, uint32_t* sums) {
+    const __m128i zero = _mm_setzero_si128();
+    int g = 0;
+    for (; g + 2 <= groups; g += 2) {
+        const __m128i bytes = _mm_loadu_si128(reinterpret_cast<const __m128i*>(row + g * kGroupPixels));
+        // Two 64-bit lane sums -> two adjacent 32-bit values
+        const __m128i sad = _mm_shuffle_epi32(_mm_sad_epu8(bytes, zero), _MM_SHUFFLE(3, 3, 2, 0));
+        const __m128i acc = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(sums + g));
+        _mm_storel_epi64(reinterpret_cast<__m128i*>(sums + g), _mm_add_epi32(acc, sad));
+    }
+    GroupSumScalar(row + g * kGroupPixels, groups - g, sums + g);
+}
+
+__attribute__((target("avx2")))
+void GroupSumAvx2(const uint8_t* row, int groups, uint32_t* sums) {
+    const __m256i zero = _mm256_setzero_si256();
+    const __m256i pack = _mm256_setr_epi32(0, 2, 4, 6, 0, 2, 4, 6);
+    int g = 0;
+    for (; g + 4 <= groups; g += 4) {
+        const __m256i bytes = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(row + g * kGroupPixels));
+        const __m256i sad = _mm256_permutevar8x32_epi32(_mm256_sad_epu8(bytes, zero), pack);
+        const __m128i acc = _mm_loadu_si128(reinterpret_cast<const __m128i*>(sums + g));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(sums + g),
+                         _mm_add_epi32(acc, _mm256_castsi256_si128(sad)));
+    }
+    GroupSumScalar(row + g * kGroupPixels, groups - g, sums + g);
+}
+
+#endif  // STREAM_DAEMON_X86_KERNELS
+
+#if defined(STREAM_DAEMON_NEON_KERNELS)
+
+void GroupSumNeon(const uint8_t* row, int groups, uint32_t* sums) {
+    int g = 0;
+    for (; g + 2 <= groups; g += 2) {
+        const uint32x4_t quads = vpaddlq_u16(vpaddlq_u8(vld1q_u8(row + g * kGroupPixels)));
+        const uint32x2_t pair = vpadd_u32(vget_low_u32(quads), vget_high_u32(quads));
+        vst1_u32(sums + g, vadd_u32(vld1_u32(sums + g), pair));
+    }
+    GroupSumScalar(row + g * kGroupPixels, groups - g, sums + g);
+}
+
+#endif  // STREAM_DAEMON_NEON_KERNELS
+
+GroupSumFn SelectGroupSum(SimdLevel level) {
+    switch (level) {
+#if defined(STREAM_DAEMON_X86_KERNELS)
+        case SimdLevel::kAvx2:
+            return GroupSumAvx2;
+        case SimdLevel::kSse41:
+            return GroupSumSse41;
+#endif
+#if defined(STREAM_DAEMON_NEON_KERNELS)
+        case SimdLevel::kNeon:
+            return GroupSumNeon;
+#endif
+        default:
+            return GroupSumScalar;
+    }
+}
+
+}  // namespace
+
+MotionGate::MotionGate(Params params, SimdLevel level)
+    : params_(params),
+      level_(IsSimdLevelSupported(level) ? level : DetectSimdLevel()) {
+    params_.grid_width = std::max(1, params_.grid_width);
+    params_.grid_height = std::max(1, params_.grid_height);
+    params_.row_step = std::max(1, params_.row_step);
+}
+
+bool MotionGate::ShouldInfer(const FrameView& frame, Clock::time_point now) {
+    if (!frame.IsValid() || (frame.format != PixelFormat::kRGB && !frame.IsYuv())) {
+        return true;
+    }
+
+    // New geometry (caps change, ROI edit): start over
+    if (frame.format != format_ || frame.width != width_ || frame.height != height_) {
+        Reset();
+        format_ = frame.format;
+        width_ = frame.width;
+        height_ = frame.height;
+    }
+
+    Downscale(frame);
+
+    const size_t cells = thumbnail_.size();
+    if (!has_background_) {
+        background_.resize(cells);
+        for (size_t i = 0; i < cells; ++i) {
+            background_[i] = thumbnail_[i] << kBackgroundBits;
+        }
+        has_background_ = true;
+        changed_fraction_ = 1.0f;
+        last_infer_ = now;
+        return true;
+    }
+
+    const int32_t threshold = params_.cell_threshold << kBackgroundBits;
+    size_t changed = 0;
+    for (size_t i = 0; i < cells; ++i) {
+        const int32_t current = thumbnail_[i] << kBackgroundBits;
+        const int32_t delta = current - background_[i];
+        if (std::abs(delta) > threshold) {
+            ++changed;
+        }
+        background_[i] += delta >> params_.background_shift;
+    }
+    changed_fraction_ = static_cast<float>(changed) / static_cast<float>(cells);
+
+    const size_t min_changed = std::max<size_t>(
+        1, static_cast<size_t>(std::ceil(params_.changed_fraction * static_cast<float>(cells))));
+    if (changed >= min_changed || now - last_infer_ >= params_.max_skip) {
+        last_infer_ = now;
+        return true;
+    }
+    return false;
+}
+
+void MotionGate::Reset() {
+    has_background_ = false;
+    format_ = PixelFormat::kUnknown;
+    width_ = 0;
+    height_ = 0;
+    changed_fraction_ = 0.0f;
+}
+
+void MotionGate::Downscale(const FrameView& frame) {
+    const int full_groups = frame.width / kGroupPixels;
+    const int tail = frame.width % kGroupPixels;
+    const int groups = full_groups + (tail > 0 ? 1 : 0);
+    const int grid_w = std::min(params_.grid_width, groups);
+    const int grid_h = std::min(params_.grid_height, frame.height);
+    const bool rgb = frame.format == PixelFormat::kRGB;
+    const GroupSumFn group_sum = SelectGroupSum(level_);
+
+    // Cell boundaries in groups
+    column_edges_.resize(grid_w + 1);
+    for (int c = 0; c <= grid_w; ++c) {
+        column_edges_[c] = static_cast<int32_t>(static_cast<int64_t>(groups) * c / grid_w);
+    }
+    thumbnail_.resize(static_cast<size_t>(grid_w) * grid_h);
+    group_sums_.resize(groups);
+
+    for (int r = 0; r < grid_h; ++r) {
+        const int y0 = static_cast<int>(static_cast<int64_t>(frame.height) * r / grid_h);
+        const int y1 = static_cast<int>(static_cast<int64_t>(frame.height) * (r + 1) / grid_h);
+        std::fill(group_sums_.begin(), group_sums_.end(), 0u);
+
+        int rows = 0;
+        for (int y = y0; y < y1; y += params_.row_step, ++rows) {
+            const uint8_t* row = frame.Row(0, y);
+            if (rgb) {
+                // Green carries most of the luma
+                for (int x = 0; x < frame.width; ++x) {
+                    group_sums_[x / kGroupPixels] += row[x * 3 + 1];
+                }
+                continue;
+            }
+            group_sum(row, full_groups, group_sums_.data());
+            for (int x = full_groups * kGroupPixels; x < frame.width; ++x) {
+                group_sums_[full_groups] += row[x];
+            }
+        }
+
+        uint8_t* out = thumbnail_.data() + static_cast<size_t>(r) * grid_w;
+        for (int c = 0; c < grid_w; ++c) {
+            uint32_t sum = 0;
+            for (int g = column_edges_[c]; g < column_edges_[c + 1]; ++g) {
+                sum += group_sums_[g];
+            }
+            const int x0 = column_edges_[c] * kGroupPixels;
+            const int x1 = std::min(column_edges_[c + 1] * kGroupPixels, frame.width);
+            const uint32_t samples = static_cast<uint32_t>(rows) * static_cast<uint32_t>(x1 - x0);
+            out[c] = static_cast<uint8_t>(samples > 0 ? sum / samples : 0);
+        }
+    }
+}
+
+}  // namespace stream_daemon
@@ -464,6 +464,8 @@ std::string NatsPublisher::SerializeToJson(const DetectionEvent& event) const {
 
     j["stream_id"] = event.stream_id;
     j["timestamp"] = event.timestamp;
+    j["capture_timestamp"] = event.capture_timestamp;
+    j["publish_timestamp"] = event.publish_timestamp;
     j["frame_number"] = event.frame_number;
     j["fps"] = event.fps;
     j["width"] = event.width;
@@ -507,8 +509,8 @@ std::string NatsPublisher::SerializeToJson(const DetectionEvent& event) const {
     j["events"] = std::move(events_obj);
 
     // 이미지 데이터 (Base64 인코딩)
-    if (!event.image_data.empty()) {
-        j["image"] = Base64Encode(event.image_data);
+    if (event.image_data && !event.image_data->empty()) {
+        j["image"] = Base64Encode(*event.image_data);
     }
 
     return j.dump();
@@ -0,0 +1,207 @@
+#include "reconnect_scheduler.h"
+
+#include <algorithm>
+
+namespace stream_daemon {
+
+ReconnectScheduler::ReconnectScheduler(ReconnectPolicy policy)
+    : policy_(policy),
+      rng_(std::random_device{}()) {
+    policy_.max_concurrent_builds = std::max(1, policy_.max_concurrent_builds);
+}
+
+ReconnectScheduler::~ReconnectScheduler() {
+    Stop();
+}
+
+void ReconnectScheduler::Start() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (running_) {
+            return;
+        }
+        running_ = true;
+    }
+    dispatcher_ = std::thread(&ReconnectScheduler::DispatchLoop, this);
+    LogInfo("ReconnectScheduler started (max concurrent builds=" +
+            std::to_string(policy_.max_concurrent_builds) + ")");
+}
+
+void ReconnectScheduler::Stop() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (!running_) {
+            return;
+        }
+        running_ = false;
+    }
+    cv_.notify_all();
+
+    if (dispatcher_.joinable()) {
+        dispatcher_.join();
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    pending_.clear();
+    building_.clear();
+    LogInfo("ReconnectScheduler stopped");
+}
+
+ReconnectEscalation::Step ReconnectEscalation::OnFailure(bool soft_restart_possible) {
+    int attempts = attempts_.load();
+    do {
+        if (attempts >= max_attempts_) {
+            return Step::kGiveUp;
+        }
+    } while (!attempts_.compare_exchange_weak(attempts, attempts + 1));
+
+    return attempts == 0 && soft_restart_possible ? Step::kSoftRestart : Step::kRebuild;
+}
+
+std::chrono::milliseconds ReconnectScheduler::BackoffDelay(
+    const ReconnectPolicy& policy, int attempt) {
+
+    auto delay = policy.base_delay;
+    for (int i = 1; i < attempt && delay < policy.max_delay; ++i) {
+        delay *= 2;
+    }
+    return std::min(delay, policy.max_delay);
+}
+
+void ReconnectScheduler::Schedule(const std::string& stream_id,
+                                  std::chrono::milliseconds delay,
+                                  int64_t last_healthy_ms,
+                                  BuildFn build) {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+
+        // A new reconnect means the previous build (if any) has failed
+        building_.erase(stream_id);
+
+        PendingReconnect entry;
+        entry.due = Clock::now() + ApplyJitterLocked(delay);
+        entry.last_healthy_ms = last_healthy_ms;
+        entry.build = std::move(build);
+        pending_[stream_id] = std::move(entry);
+    }
+    cv_.notify_all();
+}
+
+void ReconnectScheduler::Cancel(const std::string& stream_id) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    pending_.erase(stream_id);
+    building_.erase(stream_id);
+
+    // Called from inside the build itself: nothing to wait for
+    if (std::this_thread::get_id() == dispatcher_id_) {
+        return;
+    }
+    cv_.wait(lock, [&] { return dispatching_ != stream_id; });
+    cv_.notify_all();
+}
+
+void ReconnectScheduler::NotifyBuildComplete(const std::string& stream_id) {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (building_.erase(stream_id) == 0) {
+            return;
+        }
+    }
+    cv_.notify_all();
+}
+
+ReconnectStats ReconnectScheduler::GetStats() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    ReconnectStats stats = stats_;
+    stats.scheduled = pending_.size();
+    stats.building = building_.size();
+    return stats;
+}
+
+std::chrono::milliseconds ReconnectScheduler::ApplyJitterLocked(std::chrono::milliseconds delay) {
+    if (policy_.jitter <= 0.0 || delay.count() <= 0) {
+        return delay;
+    }
+    std::uniform_real_distribution<double> dist(-policy_.jitter, policy_.jitter);
+    const double factor = 1.0 + dist(rng_);
+    return std::chrono::milliseconds(
+        static_cast<int64_t>(static_cast<double>(delay.count()) * factor));
+}
+
+ReconnectScheduler::Clock::time_point ReconnectScheduler::ExpireBuildsLocked(
+    Clock::time_point now) {
+
+    auto earliest = Clock::time_point::max();
+    for (auto it = building_.begin(); it != building_.end();) {
+        const auto expiry = it->second + policy_.build_timeout;
+        if (expiry <= now) {
+            LogWarning("Reconnect build for " + it->first + " did not complete within " +
+                       std::to_string(policy_.build_timeout.count()) + "ms, releasing slot");
+            ++stats_.build_timeouts;
+            it = building_.erase(it);
+        } else {
+            earliest = std::min(earliest, expiry);
+            ++it;
+        }
+    }
+    return earliest;
+}
+
+void ReconnectScheduler::DispatchLoop() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    dispatcher_id_ = std::this_thread::get_id();
+
+    while (running_) {
+        const auto now = Clock::now();
+        auto wake = ExpireBuildsLocked(now);
+
+        const bool slot_free =
+            building_.size() < static_cast<size_t>(policy_.max_concurrent_builds);
+
+        // Among due reconnects, the most recently healthy stream goes first
+        auto next = pending_.end();
+        for (auto it = pending_.begin(); it != pending_.end(); ++it) {
+            if (it->second.due > now) {
+                if (slot_free) {
+                    wake = std::min(wake, it->second.due);
+                }
+                continue;
+            }
+            if (next == pending_.end() ||
+                it->second.last_healthy_ms > next->second.last_healthy_ms ||
+                (it->second.last_healthy_ms == next->second.last_healthy_ms &&
+                 it->second.due < next->second.due)) {
+                next = it;
+            }
+        }
+
+        if (!slot_free || next == pending_.end()) {
+            if (wake == Clock::time_point::max()) {
+                cv_.wait(lock);
+            } else {
+                cv_.wait_until(lock, wake);
+            }
+            continue;
+        }
+
+        const std::string stream_id = next->first;
+        BuildFn build = std::move(next->second.build);
+        pending_.erase(next);
+        building_[stream_id] = now;
+        dispatching_ = stream_id;
+        ++stats_.dispatched;
+
+        lock.unlock();
+        const bool started = build ? build() : false;
+        lock.lock();
+
+        dispatching_.clear();
+        if (!started) {
+            // Failed immediately; the build may already have rescheduled itself
+            building_.erase(stream_id);
+        }
+        cv_.notify_all();
+    }
+}
+
+}  // namespace stream_daemon
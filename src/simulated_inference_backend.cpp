@@ -0,0 +1,368 @@
+#include "simulated_inference_backend.h"
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <thread>
+
+namespace stream_daemon {
+
+namespace {
+
+constexpr char kRecordingMagic[8] = {'S', 'D', 'R', 'E', 'C', '0', '0', '1'};
+
+// Read failures after this long mean no frame was ever written (HailoRT: 30s)
+constexpr auto kSimulatedReadTimeout = std::chrono::seconds(30);
+
+template <typename T>
+void WritePod(std::ofstream& out, const T& value) {
+    out.write(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+template <typename T>
+bool ReadPod(std::ifstream& in, T& value) {
+    return static_cast<bool>(in.read(reinterpret_cast<char*>(&value), sizeof(T)));
+}
+
+void WriteTensor(std::ofstream& out, const TensorInfo& tensor) {
+    WritePod(out, static_cast<uint32_t>(tensor.name.size()));
+    out.write(tensor.name.data(), static_cast<std::streamsize>(tensor.name.size()));
+    WritePod(out, static_cast<uint32_t>(tensor.type));
+    WritePod(out, static_cast<int32_t>(tensor.height));
+    WritePod(out, static_cast<int32_t>(tensor.width));
+    WritePod(out, static_cast<int32_t>(tensor.features));
+    WritePod(out, static_cast<uint64_t>(tensor.frame_size));
+    WritePod(out, tensor.quant.scale);
+    WritePod(out, tensor.quant.zero_point);
+    WritePod(out, static_cast<int32_t>(tensor.nms_classes));
+    WritePod(out, static_cast<int32_t>(tensor.nms_max_bboxes_per_class));
+}
+
+bool ReadTensor(std::ifstream& in, TensorInfo& tensor) {
+    uint32_t name_size = 0;
+    if (!ReadPod(in, name_size) || name_size > 4096) {
+        return false;
+    }
+    tensor.name.resize(name_size);
+    if (!in.read(tensor.name.data(), name_size)) {
+        return false;
+    }
+
+    uint32_t type = 0;
+    int32_t height = 0, width = 0, features = 0, nms_classes = 0, nms_max = 0;
+    uint64_t frame_size = 0;
+    if (!ReadPod(in, type) || !ReadPod(in, height) || !ReadPod(in, width) ||
+        !ReadPod(in, features) || !ReadPod(in, frame_size) ||
+        !ReadPod(in, tensor.quant.scale) || !ReadPod(in, tensor.quant.zero_point) ||
+        !ReadPod(in, nms_classes) || !ReadPod(in, nms_max)) {
+        return false;
+    }
+    if (type > static_cast<uint32_t>(TensorDataType::kFloat32)) {
+        return false;
+    }
+    tensor.type = static_cast<TensorDataType>(type);
+    tensor.height = height;
+    tensor.width = width;
+    tensor.features = features;
+    tensor.frame_size = static_cast<size_t>(frame_size);
+    tensor.nms_classes = nms_classes;
+    tensor.nms_max_bboxes_per_class = nms_max;
+    return true;
+}
+
+}  // namespace
+
+// ============================================================================
+// InferenceRecording
+// ============================================================================
+
+Result<InferenceRecording> InferenceRecording::Load(const std::string& path) {
+    std::ifstream in(path, std::ios::binary);
+    if (!in) {
+        return MakeErrorT<InferenceRecording>("Cannot open recording: " + path);
+    }
+
+    char magic[sizeof(kRecordingMagic)] = {};
+    if (!in.read(magic, sizeof(magic)) ||
+        std::memcmp(magic, kRecordingMagic, sizeof(magic)) != 0) {
+        return MakeErrorT<InferenceRecording>("Not an inference recording: " + path);
+    }
+
+    InferenceRecording recording;
+    uint32_t batch_size = 0, num_inputs = 0, num_outputs = 0, num_frames = 0;
+    if (!ReadPod(in, batch_size) || !ReadPod(in, num_inputs) || !ReadPod(in, num_outputs)) {
+        return MakeErrorT<InferenceRecording>("Truncated recording header: " + path);
+    }
+    recording.batch_size = static_cast<int>(batch_size);
+
+    recording.inputs.resize(num_inputs);
+    for (auto& tensor : recording.inputs) {
+        if (!ReadTensor(in, tensor)) {
+            return MakeErrorT<InferenceRecording>("Bad input tensor in recording: " + path);
+        }
+    }
+    recording.outputs.resize(num_outputs);
+    for (auto& tensor : recording.outputs) {
+        if (!ReadTensor(in, tensor)) {
+            return MakeErrorT<InferenceRecording>("Bad output tensor in recording: " + path);
+        }
+    }
+
+    if (!ReadPod(in, num_frames)) {
+        return MakeErrorT<InferenceRecording>("Truncated recording: " + path);
+    }
+    recording.frames.resize(num_frames);
+    for (auto& frame : recording.frames) {
+        frame.resize(num_outputs);
+        for (size_t i = 0; i < num_outputs; ++i) {
+            frame[i].resize(recording.outputs[i].frame_size);
+            if (!in.read(reinterpret_cast<char*>(frame[i].data()),
+                         static_cast<std::streamsize>(frame[i].size()))) {
+                return MakeErrorT<InferenceRecording>("Truncated recording frames: " + path);
+            }
+        }
+    }
+
+    if (auto result = recording.Validate(); IsError(result)) {
+        return MakeErrorT<InferenceRecording>(GetError(result) + ": " + path);
+    }
+    return recording;
+}
+
+VoidResult InferenceRecording::Save(const std::string& path) const {
+    if (auto result = Validate(); IsError(result)) {
+        return result;
+    }
+
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    if (!out) {
+        return MakeError("Cannot write recording: " + path);
+    }
+
+    out.write(kRecordingMagic, sizeof(kRecordingMagic));
+    WritePod(out, static_cast<uint32_t>(batch_size));
+    WritePod(out, static_cast<uint32_t>(inputs.size()));
+    WritePod(out, static_cast<uint32_t>(outputs.size()));
+    for (const auto& tensor : inputs) {
+        WriteTensor(out, tensor);
+    }
+    for (const auto& tensor : outputs) {
+        WriteTensor(out, tensor);
+    }
+    WritePod(out, static_cast<uint32_t>(frames.size()));
+    for (const auto& frame : frames) {
+        for (const auto& buffer : frame) {
+            out.write(reinterpret_cast<const char*>(buffer.data()),
+                      static_cast<std::streamsize>(buffer.size()));
+        }
+    }
+
+    if (!out) {
+        return MakeError("Failed writing recording: " + path);
+    }
+    return MakeOk();
+}
+
+VoidResult InferenceRecording::Validate() const {
+    if (inputs.empty() || outputs.empty()) {
+        return MakeError("Recording has no input or output tensors");
+    }
+    if (batch_size < 1) {
+        return MakeError("Recording batch size must be at least 1");
+    }
+    if (frames.empty()) {
+        return MakeError("Recording has no frames");
+    }
+    for (const auto& frame : frames) {
+        if (frame.size() != outputs.size()) {
+            return MakeError("Recording frame does not match the output count");
+        }
+        for (size_t i = 0; i < outputs.size(); ++i) {
+            if (frame[i].size() != outputs[i].frame_size) {
+                return MakeError("Recording output '" + outputs[i].name + "' has the wrong size");
+            }
+        }
+    }
+    return MakeOk();
+}
+
+// ============================================================================
+// SimulatedInferenceBackend
+// ============================================================================
+
+SimulatedInferenceBackend::SimulatedInferenceBackend(SimulatedDeviceModel model,
+                                                     std::string recording_path)
+    : model_(model),
+      recording_path_(std::move(recording_path)) {
+    model_.queue_depth = std::max(1, model_.queue_depth);
+}
+
+SimulatedInferenceBackend::SimulatedInferenceBackend(InferenceRecording recording,
+                                                     SimulatedDeviceModel model)
+    : model_(model),
+      recording_(std::move(recording)),
+      preloaded_(true) {
+    model_.queue_depth = std::max(1, model_.queue_depth);
+}
+
+VoidResult SimulatedInferenceBackend::Configure(const std::string& model_path) {
+    if (!preloaded_) {
+        const std::string& path = recording_path_.empty() ? model_path : recording_path_;
+        auto result = InferenceRecording::Load(path);
+        if (IsError(result)) {
+            return MakeError(GetError(result));
+        }
+        recording_ = GetValue(std::move(result));
+    } else if (auto result = recording_.Validate(); IsError(result)) {
+        return result;
+    }
+
+    // A full batch must fit on the device
+    model_.queue_depth = std::max(model_.queue_depth, GetBatchSize());
+
+    LogInfo("Simulated inference device: " + std::to_string(recording_.frames.size()) +
+            " recorded frames, latency=" + std::to_string(model_.latency.count()) +
+            "us, fps=" + std::to_string(model_.frames_per_second) +
+            ", batch=" + std::to_string(GetBatchSize()) +
+            ", queue=" + std::to_string(model_.queue_depth));
+    return MakeOk();
+}
+
+void SimulatedInferenceBackend::StartBatch(Clock::time_point now) {
+    if (open_frames_ == 0) {
+        return;
+    }
+
+    // One batch at a time: overhead plus per-frame time once the device is free
+    Clock::duration device_time = model_.batch_overhead;
+    if (model_.frames_per_second > 0.0) {
+        device_time += std::chrono::duration_cast<Clock::duration>(
+            std::chrono::duration<double>(open_frames_ / model_.frames_per_second));
+    }
+    const auto start = device_free_ ? std::max(now, *device_free_) : now;
+    device_free_ = start + device_time;
+    const auto ready = std::max(now + model_.latency, *device_free_);
+
+    for (auto it = queue_.end() - static_cast<std::ptrdiff_t>(open_frames_); it != queue_.end(); ++it) {
+        it->ready = ready;
+    }
+    open_frames_ = 0;
+    ++batches_run_;
+}
+
+VoidResult SimulatedInferenceBackend::Write(const uint8_t* data, size_t size) {
+    if (data == nullptr || size != recording_.inputs[0].frame_size) {
+        return MakeError("simulated write: expected " +
+                         std::to_string(recording_.inputs[0].frame_size) + " bytes, got " +
+                         std::to_string(size));
+    }
+
+    std::unique_lock<std::mutex> lock(mutex_);
+    cv_.wait(lock, [this] { return static_cast<int>(queue_.size()) < model_.queue_depth; });
+
+    const auto now = Clock::now();
+    queue_.push_back({next_recording_index_, now, std::nullopt});
+    next_recording_index_ = (next_recording_index_ + 1) % recording_.frames.size();
+    ++frames_written_;
+    if (static_cast<int>(++open_frames_) >= GetBatchSize()) {
+        StartBatch(now);
+    }
+    lock.unlock();
+    cv_.notify_all();
+    return MakeOk();
+}
+
+VoidResult SimulatedInferenceBackend::Read(size_t index, uint8_t* data, size_t size) {
+    if (index >= recording_.outputs.size() || size != recording_.outputs[index].frame_size) {
+        return MakeError("simulated read: bad output " + std::to_string(index) +
+                         " or size " + std::to_string(size));
+    }
+
+    std::unique_lock<std::mutex> lock(mutex_);
+    if (!cv_.wait_for(lock, kSimulatedReadTimeout, [this] { return !queue_.empty(); })) {
+        return MakeError("simulated read: timeout");
+    }
+
+    // A partial batch starts once its first frame (the front) has waited batch_timeout
+    if (!queue_.front().ready) {
+        const auto flush_at = queue_.front().written + model_.batch_timeout;
+        if (!cv_.wait_until(lock, flush_at, [this] { return queue_.front().ready.has_value(); })) {
+            StartBatch(Clock::now());
+        }
+    }
+    const QueuedFrame frame = queue_.front();
+
+    // Only the reader pops, so the front stays put while we sleep
+    lock.unlock();
+    std::this_thread::sleep_until(*frame.ready);
+
+    const auto& output = recording_.frames[frame.recording_index][index];
+    std::memcpy(data, output.data(), size);
+
+    if (index + 1 == recording_.outputs.size()) {
+        lock.lock();
+        queue_.pop_front();
+        lock.unlock();
+        cv_.notify_all();
+    }
+    return MakeOk();
+}
+
+uint64_t SimulatedInferenceBackend::GetFramesWritten() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return frames_written_;
+}
+
+uint64_t SimulatedInferenceBackend::GetBatchesRun() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return batches_run_;
+}
+
+// ============================================================================
+// RecordingInferenceBackend
+// ============================================================================
+
+RecordingInferenceBackend::RecordingInferenceBackend(std::unique_ptr<IInferenceBackend> inner,
+                                                     std::string path,
+                                                     int max_frames)
+    : inner_(std::move(inner)),
+      path_(std::move(path)),
+      max_frames_(static_cast<size_t>(std::max(1, max_frames))) {}
+
+VoidResult RecordingInferenceBackend::Configure(const std::string& model_path) {
+    if (auto result = inner_->Configure(model_path); IsError(result)) {
+        return result;
+    }
+    recording_.inputs = inner_->GetInputs();
+    recording_.outputs = inner_->GetOutputs();
+    recording_.batch_size = inner_->GetBatchSize();
+    recording_.frames.clear();
+    current_.assign(recording_.outputs.size(), {});
+    done_ = false;
+    return MakeOk();
+}
+
+VoidResult RecordingInferenceBackend::Read(size_t index, uint8_t* data, size_t size) {
+    auto result = inner_->Read(index, data, size);
+    if (done_ || IsError(result) || index >= current_.size()) {
+        return result;
+    }
+
+    current_[index].assign(data, data + size);
+    if (index + 1 == current_.size()) {
+        recording_.frames.push_back(current_);
+        if (recording_.frames.size() >= max_frames_) {
+            done_ = true;
+            if (auto saved = recording_.Save(path_); IsError(saved)) {
+                LogWarning("Inference recording not saved: " + GetError(saved));
+            } else {
+                LogInfo("Inference recording saved: " + path_ + " (" +
+                        std::to_string(recording_.frames.size()) + " frames)");
+            }
+            recording_.frames.clear();
+        }
+    }
+    return result;
+}
+
+}  // namespace stream_daemon
@@ -0,0 +1,250 @@
+#include "snapshot_stream.h"
+
+#include <gst/app/gstappsink.h>
+
+#include <thread>
+#include <utility>
+
+namespace stream_daemon {
+
+namespace {
+
+int64_t SteadyNowMs() {
+    return std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+}  // namespace
+
+SnapshotStream::SnapshotStream(std::string pipeline_description,
+                               std::shared_ptr<TeardownExecutor> teardown_executor)
+    : pipeline_description_(std::move(pipeline_description)),
+      teardown_executor_(std::move(teardown_executor)) {}
+
+SnapshotStream::~SnapshotStream() {
+    Close();
+}
+
+void SnapshotStream::Touch() {
+    const int64_t now = SteadyNowMs();
+    last_used_ms_ = now;
+
+    CollectOpen();
+    if (pipeline_ || opening_ || now < retry_after_ms_) {
+        return;
+    }
+
+    StartOpen();
+}
+
+FrameRef SnapshotStream::Latest(std::chrono::milliseconds max_age) {
+    CollectOpen();
+    if (!pipeline_) {
+        return nullptr;
+    }
+
+    CheckBus();
+    if (!sink_) {
+        return nullptr;
+    }
+
+    if (GstSample* sample = gst_app_sink_try_pull_sample(GST_APP_SINK(sink_), 0)) {
+        if (const FrameGeometry* geometry = geometry_.Get(gst_sample_get_caps(sample))) {
+            auto frame_result = FrameBuffer::FromSample(sample, *geometry);
+            if (IsOk(frame_result)) {
+                latest_ = GetValue(std::move(frame_result));
+                latest_ms_ = SteadyNowMs();
+            }
+        }
+        gst_sample_unref(sample);
+    }
+
+    if (!latest_ || SteadyNowMs() - latest_ms_ > max_age.count()) {
+        return nullptr;
+    }
+    return latest_;
+}
+
+void SnapshotStream::CloseIfIdle(std::chrono::milliseconds idle) {
+    if ((pipeline_ || opening_) && SteadyNowMs() - last_used_ms_ > idle.count()) {
+        LogInfo("Snapshot stream idle, closing");
+        Close();
+    }
+}
+
+void SnapshotStream::Close() {
+    latest_.reset();
+    geometry_.Reset();
+
+    // Open in progress: drop it; a job still running tears its pipeline down itself
+    if (opening_) {
+        GstElement* opened_pipeline = nullptr;
+        GstElement* opened_sink = nullptr;
+        {
+            std::lock_guard<std::mutex> lock(opening_->mutex);
+            opening_->cancelled = true;
+            std::swap(opened_pipeline, opening_->pipeline);
+            std::swap(opened_sink, opening_->sink);
+        }
+        opening_.reset();
+        if (opened_pipeline) {
+            Dispatch("snapshot", [opened_pipeline, opened_sink](std::chrono::milliseconds timeout) {
+                Teardown(opened_pipeline, opened_sink, nullptr, timeout);
+            });
+        }
+    }
+
+    if (!pipeline_) {
+        return;
+    }
+
+    GstElement* old_pipeline = pipeline_;
+    GstElement* old_sink = sink_;
+    GstBus* old_bus = bus_;
+    pipeline_ = nullptr;
+    sink_ = nullptr;
+    bus_ = nullptr;
+
+    Dispatch("snapshot", [old_pipeline, old_sink, old_bus](std::chrono::milliseconds timeout) {
+        Teardown(old_pipeline, old_sink, old_bus, timeout);
+    });
+}
+
+void SnapshotStream::StartOpen() {
+    auto pending = std::make_shared<PendingOpen>();
+    opening_ = pending;
+    open_started_ms_ = SteadyNowMs();
+
+    Dispatch("snapshot-open", [pending, description = pipeline_description_](
+                                  std::chrono::milliseconds timeout) {
+        GstElement* pipeline = nullptr;
+        GstElement* sink = nullptr;
+        auto result = Launch(description, pipeline, sink);
+        {
+            std::lock_guard<std::mutex> lock(pending->mutex);
+            if (!pending->cancelled) {
+                pending->done = true;
+                pending->pipeline = pipeline;
+                pending->sink = sink;
+                if (IsError(result)) {
+                    pending->error = GetError(result);
+                }
+                return;
+            }
+        }
+        // Closed while opening: nobody adopts it
+        if (pipeline) {
+            Teardown(pipeline, sink, nullptr, timeout);
+        }
+    });
+}
+
+void SnapshotStream::CollectOpen() {
+    if (!opening_) {
+        return;
+    }
+
+    GstElement* pipeline = nullptr;
+    GstElement* sink = nullptr;
+    std::string error;
+    {
+        std::lock_guard<std::mutex> lock(opening_->mutex);
+        if (opening_->done) {
+            pipeline = opening_->pipeline;
+            sink = opening_->sink;
+            error = opening_->error;
+        } else if (SteadyNowMs() - open_started_ms_ > kPipelineBuildTimeoutMs) {
+            // Job lost or wedged: give up on it, it cleans up if it ever finishes
+            opening_->cancelled = true;
+            error = "open timed out";
+        } else {
+            return;
+        }
+    }
+    opening_.reset();
+
+    if (!pipeline) {
+        LogWarning("Snapshot stream: " + error);
+        retry_after_ms_ = SteadyNowMs() + kSnapshotRetryDelayMs;
+        return;
+    }
+
+    pipeline_ = pipeline;
+    sink_ = sink;
+    bus_ = gst_element_get_bus(pipeline);
+    LogInfo("Snapshot stream opened");
+}
+
+VoidResult SnapshotStream::Launch(const std::string& description,
+                                  GstElement*& pipeline_out, GstElement*& sink_out) {
+    GError* error = nullptr;
+    GstElement* pipeline = gst_parse_launch(description.c_str(), &error);
+    if (error) {
+        std::string error_msg = "Failed to create pipeline: " + std::string(error->message);
+        g_error_free(error);
+        if (pipeline) gst_object_unref(pipeline);
+        return MakeError(error_msg);
+    }
+    if (!pipeline) {
+        return MakeError("Failed to create pipeline: unknown error");
+    }
+
+    GstElement* sink = gst_bin_get_by_name(GST_BIN(pipeline), "sink");
+    if (!sink) {
+        gst_object_unref(pipeline);
+        return MakeError("Failed to get appsink element");
+    }
+
+    if (gst_element_set_state(pipeline, GST_STATE_PLAYING) == GST_STATE_CHANGE_FAILURE) {
+        gst_element_set_state(pipeline, GST_STATE_NULL);
+        gst_object_unref(sink);
+        gst_object_unref(pipeline);
+        return MakeError("Failed to start pipeline");
+    }
+
+    pipeline_out = pipeline;
+    sink_out = sink;
+    return MakeOk();
+}
+
+void SnapshotStream::Teardown(GstElement* pipeline, GstElement* sink, GstBus* bus,
+                              std::chrono::milliseconds timeout) {
+    gst_element_set_state(pipeline, GST_STATE_NULL);
+    gst_element_get_state(pipeline, nullptr, nullptr,
+                          static_cast<GstClockTime>(timeout.count()) * GST_MSECOND);
+    if (sink) gst_object_unref(sink);
+    if (bus) gst_object_unref(bus);
+    gst_object_unref(pipeline);
+}
+
+void SnapshotStream::Dispatch(std::string label, TeardownExecutor::Job job) {
+    // A dropped open is noticed by CollectOpen() (open timeout)
+    (void)TeardownExecutor::SubmitOrSpawn(teardown_executor_, std::move(label), std::move(job));
+}
+
+void SnapshotStream::CheckBus() {
+    if (!bus_) {
+        return;
+    }
+
+    GstMessage* msg = gst_bus_pop_filtered(
+        bus_, static_cast<GstMessageType>(GST_MESSAGE_ERROR | GST_MESSAGE_EOS));
+    if (!msg) {
+        return;
+    }
+
+    std::string reason = "end of stream";
+    if (GST_MESSAGE_TYPE(msg) == GST_MESSAGE_ERROR) {
+        GError* err = nullptr;
+        gst_message_parse_error(msg, &err, nullptr);
+        reason = err ? err->message : "unknown error";
+        if (err) g_error_free(err);
+    }
+    gst_message_unref(msg);
+
+    LogWarning("Snapshot stream stopped: " + reason);
+    Close();
+    retry_after_ms_ = SteadyNowMs() + kSnapshotRetryDelayMs;
+}
+
+}  // namespace stream_daemon
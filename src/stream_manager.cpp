@@ -10,7 +10,10 @@ namespace stream_daemon {
 // Factory Method
 // ============================================================================
 
-Result<std::unique_ptr<StreamManager>> StreamManager::Create(std::string_view nats_url) {
+Result<std::unique_ptr<StreamManager>> StreamManager::Create(std::string_view nats_url,
+                                                             int inference_max_in_flight,
+                                                             std::vector<std::string> device_ids,
+                                                             int max_model_replicas) {
     // Initialize GStreamer if not already done
     static bool gst_initialized = false;
     if (!gst_initialized) {
@@ -22,8 +25,11 @@ Result<std::unique_ptr<StreamManager>> StreamManager::Create(std::string_view na
     // Create NATS publisher (does NOT connect immediately)
     auto nats_publisher = NatsPublisher::Create(nats_url);
 
+    auto device_pool = std::make_shared<DevicePool>(std::move(device_ids), max_model_replicas);
+
     auto manager = std::unique_ptr<StreamManager>(
-        new StreamManager(std::move(nats_publisher)));
+        new StreamManager(std::move(nats_publisher), inference_max_in_flight,
+                          std::move(device_pool)));
 
     return manager;
 }
@@ -32,17 +38,40 @@ Result<std::unique_ptr<StreamManager>> StreamManager::Create(std::string_view na
 // Constructor / Destructor
 // ============================================================================
 
-StreamManager::StreamManager(std::shared_ptr<NatsPublisher> nats_publisher)
-    : nats_publisher_(std::move(nats_publisher)) {
+StreamManager::StreamManager(std::shared_ptr<NatsPublisher> nats_publisher,
+                             int inference_max_in_flight,
+                             std::shared_ptr<DevicePool> device_pool)
+    : nats_publisher_(std::move(nats_publisher))
+    , teardown_executor_(std::make_shared<TeardownExecutor>())
+    , reconnect_scheduler_(std::make_shared<ReconnectScheduler>())
+    , inference_scheduler_(inference_max_in_flight > 0
+                               ? std::make_shared<InferenceScheduler>(inference_max_in_flight)
+                               : nullptr)
+    , device_pool_(std::move(device_pool)) {
 
     // Create main context and main loop
     main_context_ = g_main_context_new();
     main_loop_ = g_main_loop_new(main_context_, FALSE);
+
+    // Streams can be added before Start(); teardown/reconnect must always be available
+    teardown_executor_->Start();
+    reconnect_scheduler_->Start();
 }
 
 StreamManager::~StreamManager() {
     Stop();
 
+    // Streams added without Start() still hold source/subscriber links
+    {
+        std::lock_guard<std::mutex> lock(streams_mutex_);
+        StopAllStreamsLocked();
+    }
+
+    reconnect_scheduler_->Stop();
+
+    // Drain remaining teardowns (processors may have been destroyed without Stop())
+    teardown_executor_->Stop();
+
     if (main_loop_) {
         g_main_loop_unref(main_loop_);
         main_loop_ = nullptr;
@@ -66,6 +95,9 @@ void StreamManager::Start() {
     running_ = true;
     LogInfo("StreamManager starting...");
 
+    teardown_executor_->Start();
+    reconnect_scheduler_->Start();
+
     // Try to connect to NATS (non-blocking, will auto-reconnect)
     if (nats_publisher_) {
         auto result = nats_publisher_->Connect();
@@ -94,12 +126,13 @@ void StreamManager::Stop() {
     // Stop all streams first
     {
         std::lock_guard<std::mutex> lock(streams_mutex_);
-        for (auto& [id, processor] : streams_) {
-            processor->Stop();
-        }
-        streams_.clear();
+        StopAllStreamsLocked();
     }
 
+    // No stream is left to reconnect; release the stopped pipelines before returning
+    reconnect_scheduler_->Stop();
+    teardown_executor_->Stop();
+
     // Quit main loop
     if (main_loop_ && g_main_loop_is_running(main_loop_)) {
         g_main_loop_quit(main_loop_);
@@ -137,6 +170,35 @@ void StreamManager::MainLoopThread() {
 // Stream Management
 // ============================================================================
 
+std::shared_ptr<StreamProcessor> StreamManager::FindSharedSourceLocked(
+    const StreamInfo& info, std::string_view exclude_id) const {
+
+    for (const auto& [id, processor] : streams_) {
+        if (id != exclude_id && !processor->GetSharedSource() &&
+            processor->CanShareSourceWith(info)) {
+            return processor;
+        }
+    }
+    return nullptr;
+}
+
+void StreamManager::RehomeSubscribersLocked(const StreamProcessor* source) {
+    HandOverSubscribers(streams_, source);
+}
+
+void StreamManager::StopAllStreamsLocked() {
+    // Subscribers first: they are attached to their source's pipeline
+    for (auto& [id, processor] : streams_) {
+        if (processor->GetSharedSource()) {
+            processor->Stop();
+        }
+    }
+    for (auto& [id, processor] : streams_) {
+        processor->Stop();
+    }
+    streams_.clear();
+}
+
 VoidResult StreamManager::AddStream(const StreamInfo& info) {
     std::lock_guard<std::mutex> lock(streams_mutex_);
 
@@ -157,7 +219,9 @@ VoidResult StreamManager::AddStream(const StreamInfo& info) {
     }
 
     // Create stream processor
-    auto result = StreamProcessor::Create(info, nats_publisher_);
+    auto result = StreamProcessor::Create(
+        info, nats_publisher_, teardown_executor_, reconnect_scheduler_, inference_scheduler_,
+        device_pool_, main_context_);
     if (IsError(result)) {
         return MakeError("Failed to create stream: " + GetError(result));
     }
@@ -167,6 +231,13 @@ VoidResult StreamManager::AddStream(const StreamInfo& info) {
     // Apply global callbacks
     ApplyCallbacks(processor.get());
 
+    // Same camera already open: subscribe to its decoded frames
+    if (auto source = FindSharedSourceLocked(info, info.stream_id)) {
+        processor->SetSharedSource(source);
+        LogInfo("Stream " + info.stream_id + " shares decode with " +
+                std::string(source->GetStreamId()));
+    }
+
     // Start the stream
     if (auto start_result = processor->Start(); IsError(start_result)) {
         return start_result;
@@ -176,12 +247,13 @@ VoidResult StreamManager::AddStream(const StreamInfo& info) {
     streams_[info.stream_id] = std::move(processor);
 
     LogInfo("Stream added: " + info.stream_id);
+    RebalanceDevices();
     return MakeOk();
 }
 
 VoidResult StreamManager::RemoveStream(std::string_view stream_id) {
     std::string stream_id_str{stream_id};
-    std::unique_ptr<StreamProcessor> processor_to_stop;
+    std::shared_ptr<StreamProcessor> processor_to_stop;
 
     {
         std::lock_guard<std::mutex> lock(streams_mutex_);
@@ -194,6 +266,9 @@ VoidResult StreamManager::RemoveStream(std::string_view stream_id) {
         // Mark as removing (防御 code)
         removing_streams_.insert(stream_id_str);
 
+        // Subscribers must not outlive their source
+        RehomeSubscribersLocked(it->second.get());
+
         // Move processor out of map
         processor_to_stop = std::move(it->second);
         streams_.erase(it);
@@ -212,6 +287,7 @@ VoidResult StreamManager::RemoveStream(std::string_view stream_id) {
     {
         std::lock_guard<std::mutex> lock(streams_mutex_);
         removing_streams_.erase(stream_id_str);
+        RebalanceDevices();
     }
 
     return MakeOk();
@@ -225,12 +301,33 @@ VoidResult StreamManager::UpdateStream(const StreamInfo& info) {
         return MakeError("Stream " + info.stream_id + " not found");
     }
 
+    StreamProcessor* processor = it->second.get();
+    StreamInfo effective = info;
+    if (effective.rtsp_url.empty()) {
+        effective.rtsp_url = processor->GetRtspUrl();
+    }
+    effective.inference_url = ResolveUrlUpdate(processor->GetInferenceUrl(), info.inference_url);
+
+    // A source that can no longer feed its subscribers hands them over first;
+    // otherwise the stream (re)subscribes to any source for its new URL
+    if (!processor->GetSharedSource() && !processor->CanShareSourceWith(effective)) {
+        RehomeSubscribersLocked(processor);
+    }
+    bool has_subscribers = false;
+    for (const auto& [id, other] : streams_) {
+        has_subscribers = has_subscribers || other->GetSharedSource().get() == processor;
+    }
+    if (!has_subscribers) {
+        processor->SetSharedSource(FindSharedSourceLocked(effective, info.stream_id));
+    }
+
     // Update the stream
-    if (auto result = it->second->Update(info); IsError(result)) {
+    if (auto result = processor->Update(info); IsError(result)) {
         return result;
     }
 
     LogInfo("Stream updated: " + info.stream_id);
+    RebalanceDevices();
     return MakeOk();
 }
 
@@ -248,6 +345,7 @@ VoidResult StreamManager::ClearStreamInference(std::string_view stream_id) {
     }
 
     LogInfo("Inference cleared from stream: " + std::string(stream_id));
+    RebalanceDevices();
     return MakeOk();
 }
 
@@ -329,6 +427,36 @@ std::optional<std::vector<uint8_t>> StreamManager::GetSnapshot(std::string_view
     return it->second->GetSnapshot();
 }
 
+TeardownStats StreamManager::GetTeardownStats() const {
+    return teardown_executor_->GetStats();
+}
+
+ReconnectStats StreamManager::GetReconnectStats() const {
+    return reconnect_scheduler_->GetStats();
+}
+
+std::unordered_map<std::string, InferenceScheduler::StreamStats>
+StreamManager::GetInferenceSchedulerStats() const {
+    if (!inference_scheduler_) {
+        return {};
+    }
+    return inference_scheduler_->GetStats();
+}
+
+std::vector<DevicePool::DeviceStats> StreamManager::GetDeviceStats() const {
+    return device_pool_->GetStats();
+}
+
+void StreamManager::RebalanceDevices() {
+    // Caller holds streams_mutex_; streams switch at their next frame
+    for (auto& move : device_pool_->Rebalance()) {
+        auto it = streams_.find(move.stream_id);
+        if (it != streams_.end()) {
+            it->second->SetInferencePlacement(std::move(move.inference));
+        }
+    }
+}
+
 // ============================================================================
 // NATS Control
 // ============================================================================
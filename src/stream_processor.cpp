@@ -1,25 +1,156 @@
 #include "stream_processor.h"
+#include "detection_geometry.h"
 
 #include <gst/app/gstappsink.h>
 #include <gst/video/video.h>
+#ifdef HAVE_HAILORT
 #include <gst/hailo/tensor_meta.hpp>
+#endif
 
 // JPEG encoding
 #include <jpeglib.h>
 
 #include <algorithm>
+#include <array>
 #include <cmath>
 #include <cstring>
 #include <sstream>
+#include <utility>
 
 namespace stream_daemon {
 
 namespace {
 
-// JPEG 인코딩 (libjpeg 사용)
-std::vector<uint8_t> EncodeJpeg(const uint8_t* rgb_data, int width, int height, int quality) {
+// rtspsrc settings shared by the launch string and soft restart
+constexpr std::pair<const char*, const char*> kRtspSourceProperties[] = {
+    {"latency", "0"},
+    {"timeout", "2000000"},        // 2초 (마이크로초)
+    {"tcp-timeout", "2000000"},    // TCP 타임아웃 2초
+    {"retry", "1"},
+    {"protocols", "tcp"},
+    {"drop-on-latency", "true"},
+};
+
+// Decode skipping lets the decoder output the next frame at this fraction
+// of the inference period, leaving the decimator a frame to pick
+constexpr double kDecodeSkipHorizon = 0.8;
+
+// Reference timestamp meta caps rtspsrc uses for RTCP sender-report times
+constexpr const char* kNtpTimestampCaps = "timestamp/x-ntp";
+constexpr int64_t kNtpToUnixEpochSeconds = 2208988800LL;  // 1900-01-01 -> 1970-01-01
+
+// Ask rtspsrc (>= 1.22) to attach capture NTP times; older versions lack the property
+void EnableReferenceTimestamps(GstElement* src) {
+    if (src && g_object_class_find_property(G_OBJECT_GET_CLASS(src),
+                                            "add-reference-timestamp-meta")) {
+        g_object_set(src, "add-reference-timestamp-meta", TRUE, nullptr);
+    }
+}
+
+int64_t SteadyNowMs() {
+    return std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+// JFIF expects full-range YCbCr; limited-range decoder output is expanded
+struct JpegRangeLut {
+    std::array<uint8_t, 256> luma;
+    std::array<uint8_t, 256> chroma;
+};
+
+const JpegRangeLut& GetJpegRangeLut(bool full_range) {
+    static const auto build = [](bool full) {
+        JpegRangeLut lut;
+        for (int i = 0; i < 256; ++i) {
+            const double luma = full ? i : (i - 16) * 255.0 / 219.0;
+            const double chroma = full ? i : (i - 128) * 255.0 / 224.0 + 128.0;
+            lut.luma[i] = static_cast<uint8_t>(std::clamp(std::lround(luma), 0L, 255L));
+            lut.chroma[i] = static_cast<uint8_t>(std::clamp(std::lround(chroma), 0L, 255L));
+        }
+        return lut;
+    };
+    static const JpegRangeLut limited_lut = build(false);
+    static const JpegRangeLut full_lut = build(true);
+    return full_range ? full_lut : limited_lut;
+}
+
+// Feed NV12/I420 planes to libjpeg as 4:2:0 raw data (no colour conversion or
+// downsampling pass). BT.709 sources are written with JFIF's BT.601 matrix;
+// the slight hue shift is acceptable for snapshots.
+void WriteRawYuv(jpeg_compress_struct* cinfo, const FrameView& frame) {
+    constexpr int kLumaRows = 16;    // One iMCU row (v_samp_factor 2 * DCTSIZE)
+    constexpr int kChromaRows = 8;
+
+    // Rows are padded to whole MCUs by repeating the last column
+    const int luma_width = (frame.width + 15) & ~15;
+    const int chroma_width = luma_width / 2;
+    const int chroma_w = frame.ChromaWidth();
+    const int chroma_h = frame.ChromaHeight();
+    const bool nv12 = frame.format == PixelFormat::kNV12;
+    const JpegRangeLut& lut = GetJpegRangeLut(frame.yuv_full_range);
+
+    std::vector<uint8_t> luma(static_cast<size_t>(luma_width) * kLumaRows);
+    std::vector<uint8_t> cb(static_cast<size_t>(chroma_width) * kChromaRows);
+    std::vector<uint8_t> cr(static_cast<size_t>(chroma_width) * kChromaRows);
+    JSAMPROW luma_rows[kLumaRows];
+    JSAMPROW cb_rows[kChromaRows];
+    JSAMPROW cr_rows[kChromaRows];
+    for (int i = 0; i < kLumaRows; ++i) {
+        luma_rows[i] = luma.data() + static_cast<size_t>(i) * luma_width;
+    }
+    for (int i = 0; i < kChromaRows; ++i) {
+        cb_rows[i] = cb.data() + static_cast<size_t>(i) * chroma_width;
+        cr_rows[i] = cr.data() + static_cast<size_t>(i) * chroma_width;
+    }
+    JSAMPARRAY planes[3] = {luma_rows, cb_rows, cr_rows};
+
+    while (cinfo->next_scanline < cinfo->image_height) {
+        const int first_row = static_cast<int>(cinfo->next_scanline);
+
+        // Rows past the bottom edge repeat the last row
+        for (int i = 0; i < kLumaRows; ++i) {
+            const uint8_t* src = frame.Row(0, std::min(first_row + i, frame.height - 1));
+            uint8_t* dst = luma_rows[i];
+            for (int x = 0; x < frame.width; ++x) {
+                dst[x] = lut.luma[src[x]];
+            }
+            std::fill(dst + frame.width, dst + luma_width, dst[frame.width - 1]);
+        }
+
+        for (int i = 0; i < kChromaRows; ++i) {
+            const int y = std::min(first_row / 2 + i, chroma_h - 1);
+            uint8_t* u = cb_rows[i];
+            uint8_t* v = cr_rows[i];
+            if (nv12) {
+                const uint8_t* uv = frame.Row(1, y);
+                for (int x = 0; x < chroma_w; ++x) {
+                    u[x] = lut.chroma[uv[x * 2]];
+                    v[x] = lut.chroma[uv[x * 2 + 1]];
+                }
+            } else {
+                const uint8_t* src_u = frame.Row(1, y);
+                const uint8_t* src_v = frame.Row(2, y);
+                for (int x = 0; x < chroma_w; ++x) {
+                    u[x] = lut.chroma[src_u[x]];
+                    v[x] = lut.chroma[src_v[x]];
+                }
+            }
+            std::fill(u + chroma_w, u + chroma_width, u[chroma_w - 1]);
+            std::fill(v + chroma_w, v + chroma_width, v[chroma_w - 1]);
+        }
+
+        jpeg_write_raw_data(cinfo, planes, kLumaRows);
+    }
+}
+
+// JPEG 인코딩 (libjpeg 사용, RGB rows with any stride or NV12/I420 planes)
+std::vector<uint8_t> EncodeJpeg(const FrameView& frame, int quality) {
     std::vector<uint8_t> jpeg_data;
 
+    if ((frame.format != PixelFormat::kRGB && !frame.IsYuv()) || !frame.IsValid()) {
+        return jpeg_data;
+    }
+
     struct jpeg_compress_struct cinfo;
     struct jpeg_error_mgr jerr;
 
@@ -31,22 +162,35 @@ std::vector<uint8_t> EncodeJpeg(const uint8_t* rgb_data, int width, int height,
     unsigned long outsize = 0;
     jpeg_mem_dest(&cinfo, &outbuffer, &outsize);
 
-    cinfo.image_width = width;
-    cinfo.image_height = height;
+    cinfo.image_width = frame.width;
+    cinfo.image_height = frame.height;
     cinfo.input_components = 3;
-    cinfo.in_color_space = JCS_RGB;
+    cinfo.in_color_space = frame.IsYuv() ? JCS_YCbCr : JCS_RGB;
 
     jpeg_set_defaults(&cinfo);
     jpeg_set_quality(&cinfo, quality, TRUE);
 
-    jpeg_start_compress(&cinfo, TRUE);
+    if (frame.IsYuv()) {
+        // 4:2:0 sampling matching the source planes
+        cinfo.raw_data_in = TRUE;
+        cinfo.comp_info[0].h_samp_factor = 2;
+        cinfo.comp_info[0].v_samp_factor = 2;
+        for (int i = 1; i < 3; ++i) {
+            cinfo.comp_info[i].h_samp_factor = 1;
+            cinfo.comp_info[i].v_samp_factor = 1;
+        }
+
+        jpeg_start_compress(&cinfo, TRUE);
+        WriteRawYuv(&cinfo, frame);
+    } else {
+        jpeg_start_compress(&cinfo, TRUE);
 
-    // 라인 단위로 인코딩
-    int row_stride = width * 3;
-    while (cinfo.next_scanline < cinfo.image_height) {
-        JSAMPROW row_pointer = const_cast<JSAMPROW>(
-            rgb_data + cinfo.next_scanline * row_stride);
-        jpeg_write_scanlines(&cinfo, &row_pointer, 1);
+        // 라인 단위로 인코딩
+        while (cinfo.next_scanline < cinfo.image_height) {
+            JSAMPROW row_pointer = const_cast<JSAMPROW>(
+                frame.Row(0, static_cast<int>(cinfo.next_scanline)));
+            jpeg_write_scanlines(&cinfo, &row_pointer, 1);
+        }
     }
 
     jpeg_finish_compress(&cinfo);
@@ -61,6 +205,7 @@ std::vector<uint8_t> EncodeJpeg(const uint8_t* rgb_data, int width, int height,
     return jpeg_data;
 }
 
+#ifdef HAVE_HAILORT
 // COCO 80 클래스 이름
 static const char* COCO_LABELS[] = {
     "person", "bicycle", "car", "motorcycle", "airplane", "bus", "train", "truck", "boat",
@@ -267,6 +412,35 @@ std::vector<Detection> ExtractHailoDetections(
 
     return detections;
 }
+#endif  // HAVE_HAILORT
+
+using LoopTicket = CallbackGuard<StreamProcessor>::Ticket;
+
+struct LoopJob {
+    LoopTicket ticket;
+    std::function<void(StreamProcessor&)> fn;
+};
+
+// Attach a one-shot source to `context` that runs fn through the ticket
+guint PostLoopJob(GMainContext* context, LoopTicket ticket,
+                  std::function<void(StreamProcessor&)> fn,
+                  std::chrono::milliseconds delay = std::chrono::milliseconds(0)) {
+    GSource* source = delay.count() > 0
+        ? g_timeout_source_new(static_cast<guint>(delay.count()))
+        : g_idle_source_new();
+    g_source_set_callback(
+        source,
+        [](gpointer data) -> gboolean {
+            auto* job = static_cast<LoopJob*>(data);
+            job->ticket.Run(job->fn);
+            return G_SOURCE_REMOVE;
+        },
+        new LoopJob{std::move(ticket), std::move(fn)},
+        [](gpointer data) { delete static_cast<LoopJob*>(data); });
+    const guint id = g_source_attach(source, context);
+    g_source_unref(source);
+    return id;
+}
 
 }  // namespace
 
@@ -274,9 +448,14 @@ std::vector<Detection> ExtractHailoDetections(
 // Factory Method
 // ============================================================================
 
-Result<std::unique_ptr<StreamProcessor>> StreamProcessor::Create(
+Result<std::shared_ptr<StreamProcessor>> StreamProcessor::Create(
     const StreamInfo& info,
-    std::shared_ptr<NatsPublisher> nats_publisher) {
+    std::shared_ptr<NatsPublisher> nats_publisher,
+    std::shared_ptr<TeardownExecutor> teardown_executor,
+    std::shared_ptr<ReconnectScheduler> reconnect_scheduler,
+    std::shared_ptr<InferenceScheduler> inference_scheduler,
+    std::shared_ptr<DevicePool> device_pool,
+    GMainContext* main_context) {
 
     if (info.stream_id.empty()) {
         return std::string("Stream ID cannot be empty");
@@ -288,8 +467,11 @@ Result<std::unique_ptr<StreamProcessor>> StreamProcessor::Create(
 
     // hef_path는 선택: 비어있으면 영상만 스트림 (추론 없음)
 
-    auto processor = std::unique_ptr<StreamProcessor>(
-        new StreamProcessor(info, std::move(nats_publisher)));
+    auto processor = std::shared_ptr<StreamProcessor>(
+        new StreamProcessor(info, std::move(nats_publisher),
+                            std::move(teardown_executor), std::move(reconnect_scheduler),
+                            std::move(inference_scheduler), std::move(device_pool),
+                            main_context));
 
     return processor;
 }
@@ -300,9 +482,16 @@ Result<std::unique_ptr<StreamProcessor>> StreamProcessor::Create(
 
 StreamProcessor::StreamProcessor(
     const StreamInfo& info,
-    std::shared_ptr<NatsPublisher> nats_publisher)
+    std::shared_ptr<NatsPublisher> nats_publisher,
+    std::shared_ptr<TeardownExecutor> teardown_executor,
+    std::shared_ptr<ReconnectScheduler> reconnect_scheduler,
+    std::shared_ptr<InferenceScheduler> inference_scheduler,
+    std::shared_ptr<DevicePool> device_pool,
+    GMainContext* main_context)
     : stream_id_(info.stream_id)
     , rtsp_url_(info.rtsp_url)
+    , inference_url_(ResolveUrlUpdate(std::string(), info.inference_url))
+    , snapshot_url_(ResolveUrlUpdate(std::string(), info.snapshot_url))
     , hef_path_(info.hef_path)
     , model_id_(info.model_id)
     , config_(info.config)
@@ -310,6 +499,11 @@ StreamProcessor::StreamProcessor(
     , num_keypoints_(info.num_keypoints)
     , labels_(info.labels)
     , nats_publisher_(std::move(nats_publisher))
+    , teardown_executor_(std::move(teardown_executor))
+    , reconnect_scheduler_(std::move(reconnect_scheduler))
+    , inference_scheduler_(std::move(inference_scheduler))
+    , device_pool_(std::move(device_pool))
+    , main_context_(main_context ? g_main_context_ref(main_context) : nullptr)
     , frame_width_(0)   // Auto-detect from RTSP stream
     , frame_height_(0)  // Auto-detect from RTSP stream
     , event_compositor_(std::make_unique<EventCompositor>()) {
@@ -317,7 +511,26 @@ StreamProcessor::StreamProcessor(
 }
 
 StreamProcessor::~StreamProcessor() {
+    // Waits for a running loop job; none starts after this
+    loop_guard_.Detach();
     Stop();
+    CancelReconnect();
+    if (std::thread worker = StopFrameWorker(); worker.joinable()) {
+        worker.join();
+    }
+    WaitFrameWorkerExit();  // Handed to a teardown job that may not have run yet
+    if (batch_manager_) {
+        batch_manager_->UnregisterStream(stream_id_);
+    }
+    if (inference_scheduler_) {
+        inference_scheduler_->RemoveStream(stream_id_);
+    }
+    if (device_pool_) {
+        device_pool_->ReleaseStream(stream_id_);
+    }
+    if (main_context_) {
+        g_main_context_unref(main_context_);
+    }
 }
 
 // ============================================================================
@@ -325,16 +538,30 @@ StreamProcessor::~StreamProcessor() {
 // ============================================================================
 
 VoidResult StreamProcessor::Start() {
+    auto lock = loop_guard_.Lock();
+    return StartLocked();
+}
+
+VoidResult StreamProcessor::StartLocked() {
     if (state_ == StreamState::kRunning || state_ == StreamState::kStarting) {
         return MakeOk();
     }
 
+    // A worker stopped by DestroyPipeline on the main loop may still finish
+    // its frame; it reads what the new pipeline sets up. After a reconnect
+    // backoff it is long gone, so this only waits for Update-style restarts
+    WaitFrameWorkerExit();
+
     // Reset stopping flag (may be set from previous Stop)
     stopping_.store(false, std::memory_order_release);
 
     SetState(StreamState::kStarting);
     LogInfo("Starting stream: " + stream_id_);
 
+    if (GetSharedSource()) {
+        return StartShared();
+    }
+
     if (auto result = CreatePipeline(); IsError(result)) {
         SetError(GetError(result));
         SetState(StreamState::kError);
@@ -356,8 +583,9 @@ VoidResult StreamProcessor::Start() {
     start_time_ = std::chrono::steady_clock::now();
     last_fps_update_ = start_time_;
     frame_count_ = 0;
+    dropped_frames_ = 0;
+    motion_skipped_ = 0;
     frames_since_last_update_ = 0;
-    reconnect_attempts_ = 0;
     last_frame_time_ = std::chrono::duration_cast<std::chrono::milliseconds>(
         start_time_.time_since_epoch()).count();
 
@@ -387,13 +615,10 @@ VoidResult StreamProcessor::Start() {
                                    "s, triggering reconnect");
                         SetState(StreamState::kError);
                         SetError("No frames received (timeout)");
-                        // Schedule reconnect on main thread
-                        g_idle_add([](gpointer data) -> gboolean {
-                            auto* self = static_cast<StreamProcessor*>(data);
-                            self->DestroyPipeline();
-                            self->ScheduleReconnect();
-                            return G_SOURCE_REMOVE;
-                        }, this);
+                        // Recover on the main loop (dropped if Stop() gets there first)
+                        PostToMainLoop([](StreamProcessor& self) {
+                            self.RecoverFromFailure("no frames", false);
+                        });
                         break;  // Exit health check thread
                     }
                 }
@@ -410,6 +635,11 @@ VoidResult StreamProcessor::Start() {
 }
 
 void StreamProcessor::Stop() {
+    auto lock = loop_guard_.Lock();
+    StopLocked();
+}
+
+void StreamProcessor::StopLocked() {
     if (state_ == StreamState::kStopped) {
         return;
     }
@@ -422,10 +652,27 @@ void StreamProcessor::Stop() {
         health_check_thread_.join();
     }
 
+    // Drop queued loop jobs (bus messages, reconnects, health recovery);
+    // after the join so the health thread cannot post a fresh one
+    loop_guard_.Invalidate();
+
+    // Subscriber: no further samples after this returns
+    {
+        std::lock_guard<std::mutex> lock(source_mutex_);
+        if (auto source = attached_source_.lock()) {
+            source->RemoveSubscriber(this);
+        }
+        attached_source_.reset();
+    }
+
     LogInfo("Stop: CancelReconnect...");
     CancelReconnect();
+    escalation_.Reset();
+    reconnect_started_ms_ = 0;
     LogInfo("Stop: DestroyPipeline...");
     DestroyPipeline();
+    // Callers reconfigure what the worker reads (Update, ClearInference)
+    WaitFrameWorkerExit();
     LogInfo("Stop: SetState...");
 
     SetState(StreamState::kStopped);
@@ -433,17 +680,44 @@ void StreamProcessor::Stop() {
 }
 
 VoidResult StreamProcessor::Update(const StreamInfo& new_info) {
+    auto lock = loop_guard_.Lock();
     LogInfo("Updating stream: " + stream_id_ +
             ", old_url=" + rtsp_url_ +
             ", new_url=" + new_info.rtsp_url);
 
+    // URL-only change: swap the source, keep decoder and sinks running
+    const bool url_only =
+        pipeline_ && IsRunning() && config_.soft_restart &&
+        !new_info.rtsp_url.empty() && new_info.rtsp_url != rtsp_url_ &&
+        inference_url_.empty() && ResolveUrlUpdate(inference_url_, new_info.inference_url).empty() &&
+        ResolveUrlUpdate(snapshot_url_, new_info.snapshot_url) == snapshot_url_ &&
+        (new_info.hef_path.empty() || new_info.hef_path == hef_path_) &&
+        (new_info.model_id.empty() || new_info.model_id == model_id_) &&
+        (new_info.task.empty() || new_info.task == task_) &&
+        new_info.num_keypoints == num_keypoints_ &&
+        (new_info.labels.empty() || new_info.labels == labels_) &&
+        new_info.config == config_;
+
+    if (url_only) {
+        MarkReconnectStart();
+        if (auto result = SoftRestartSource(new_info.rtsp_url); IsOk(result)) {
+            rtsp_url_ = new_info.rtsp_url;
+            return MakeOk();
+        } else {
+            LogWarning("Soft URL swap failed for " + stream_id_ + ": " +
+                       GetError(result) + ", rebuilding pipeline");
+        }
+    }
+
     // Stop current pipeline
-    Stop();
+    StopLocked();
 
     // Update configuration - 빈 URL이면 기존 유지
     if (!new_info.rtsp_url.empty()) {
         rtsp_url_ = new_info.rtsp_url;
     }
+    inference_url_ = ResolveUrlUpdate(inference_url_, new_info.inference_url);
+    snapshot_url_ = ResolveUrlUpdate(snapshot_url_, new_info.snapshot_url);
     if (!new_info.hef_path.empty()) {
         hef_path_ = new_info.hef_path;
     }
@@ -451,6 +725,7 @@ VoidResult StreamProcessor::Update(const StreamInfo& new_info) {
         model_id_ = new_info.model_id;
     }
     config_ = new_info.config;
+    inference_tiles_.clear();  // Tile size/overlap or model may have changed
 
     // Update model info
     if (!new_info.task.empty()) {
@@ -462,22 +737,30 @@ VoidResult StreamProcessor::Update(const StreamInfo& new_info) {
     }
 
     // Restart with new configuration
-    return Start();
+    return StartLocked();
 }
 
 VoidResult StreamProcessor::ClearInference() {
+    auto lock = loop_guard_.Lock();
     LogInfo("Clearing inference from stream: " + stream_id_ + ", rtsp_url=" + rtsp_url_);
 
     // Stop current pipeline
-    Stop();
+    StopLocked();
 
     // Clear inference-related state
     hef_path_.clear();
     model_id_.clear();
-    hailo_inference_.reset();
+    {
+        std::lock_guard<std::mutex> lock(placement_mutex_);
+        hailo_inference_.reset();
+        pending_inference_.reset();
+    }
+    if (device_pool_) {
+        device_pool_->ReleaseStream(stream_id_);
+    }
 
     // Restart in video-only mode
-    return Start();
+    return StartLocked();
 }
 
 Result<std::vector<std::string>> StreamProcessor::UpdateEventSettings(
@@ -494,6 +777,97 @@ void StreamProcessor::ClearEventSettings() {
     }
 }
 
+// ============================================================================
+// Shared Decode
+// ============================================================================
+
+bool StreamProcessor::CanShareSourceWith(const StreamInfo& info) const {
+    const std::string inference_url = ResolveUrlUpdate(std::string(), info.inference_url);
+    const std::string& url = inference_url.empty() ? info.rtsp_url : inference_url;
+    return url == PipelineUrl() &&
+           config_.share_source && info.config.share_source &&
+           !config_.dual_branch && !info.config.dual_branch;
+}
+
+VoidResult StreamProcessor::StartShared() {
+    const std::shared_ptr<StreamProcessor> source = GetSharedSource();
+    if (!source) {
+        // Removed between the check in StartLocked and here
+        const std::string error = "Shared source is gone";
+        SetError(error);
+        SetState(StreamState::kError);
+        return MakeError(error);
+    }
+
+    if (auto result = InitInference(); IsError(result)) {
+        SetError(GetError(result));
+        SetState(StreamState::kError);
+        return result;
+    }
+
+    inference_decimator_.Configure(config_.inference_fps, config_.inference_every_n);
+
+    start_time_ = std::chrono::steady_clock::now();
+    last_fps_update_ = start_time_;
+    frame_count_ = 0;
+    dropped_frames_ = 0;
+    motion_skipped_ = 0;
+    frames_since_last_update_ = 0;
+    last_frame_time_ = std::chrono::duration_cast<std::chrono::milliseconds>(
+        start_time_.time_since_epoch()).count();
+
+    // Worker first: the source may deliver as soon as we are subscribed
+    StartFrameWorker();
+    {
+        std::lock_guard<std::mutex> lock(source_mutex_);
+        attached_source_ = source;
+    }
+    source->AddSubscriber(shared_from_this());
+
+    SetState(StreamState::kRunning);
+    LogInfo("Stream started (sharing decode of " +
+            std::string(source->GetStreamId()) + "): " + stream_id_);
+    return MakeOk();
+}
+
+void StreamProcessor::SetSharedSource(const std::shared_ptr<StreamProcessor>& source) {
+    std::lock_guard<std::mutex> lock(source_mutex_);
+    shared_source_ = source;
+}
+
+std::shared_ptr<StreamProcessor> StreamProcessor::GetSharedSource() const {
+    std::lock_guard<std::mutex> lock(source_mutex_);
+    return shared_source_.lock();
+}
+
+void StreamProcessor::FanOut(GstSample* sample, int64_t capture_ms) {
+    subscribers_.ForEach([sample, capture_ms](StreamProcessor& subscriber) {
+        subscriber.DeliverSample(sample, capture_ms);
+    });
+}
+
+void StreamProcessor::DeliverSample(GstSample* sample, int64_t capture_ms) {
+    const auto now = std::chrono::steady_clock::now();
+    ++frame_count_;
+    last_frame_time_ = std::chrono::duration_cast<std::chrono::milliseconds>(
+        now.time_since_epoch()).count();
+    last_healthy_time_.store(last_frame_time_.load(std::memory_order_relaxed),
+                             std::memory_order_relaxed);
+    UpdateFps();
+
+    if (!inference_decimator_.ShouldProcess(
+            std::chrono::duration_cast<std::chrono::microseconds>(
+                now.time_since_epoch()).count())) {
+        return;
+    }
+
+    // Same buffer, our own reference: no copy per logical stream
+    if (frame_mailbox_.Put(LatestMailbox<CapturedSample, CapturedSampleDeleter>::Ptr(
+            new CapturedSample{gst_sample_ref(sample), capture_ms}))) {
+        dropped_frames_.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
 // ============================================================================
 // Status & Snapshot
 // ============================================================================
@@ -505,6 +879,37 @@ StreamStatus StreamProcessor::GetStatus() const {
     status.model_id = model_id_;
     status.state = state_.load();
     status.frame_count = frame_count_.load();
+    status.dropped_frames = dropped_frames_.load();
+    status.motion_skipped = motion_skipped_.load();
+    status.soft_restarts = soft_restarts_.load();
+    status.reconnect_ttff_ms = last_reconnect_ttff_ms_.load();
+    status.decode_skip_fps = decode_skip_fps_.load();
+    std::shared_ptr<StreamProcessor> source;
+    {
+        std::lock_guard<std::mutex> lock(source_mutex_);
+        source = attached_source_.lock();
+    }
+    if (source) {
+        status.shared_source_id = std::string(source->GetStreamId());
+    }
+    status.queue_latency = queue_latency_.Summary();
+    status.publish_latency = publish_latency_.Summary();
+    std::shared_ptr<HailoInference> inference;
+    {
+        std::lock_guard<std::mutex> lock(placement_mutex_);
+        inference = hailo_inference_;
+    }
+    if (inference) {
+        status.preprocess_timing = inference->GetPreprocessTiming();
+        status.inference_timing = inference->GetInferenceTiming();
+        status.device_id = inference->GetDeviceId();
+        if (inference_scheduler_) {
+            const auto scheduling = inference_scheduler_->GetStreamStats(stream_id_);
+            status.inference_rate_fps = scheduling.achieved_fps;
+            status.scheduler_wait_ms = scheduling.mean_wait_ms;
+            status.scheduler_dropped = scheduling.dropped;
+        }
+    }
     status.current_fps = current_fps_.load();
     status.last_detection_time = last_detection_time_.load();
 
@@ -520,15 +925,29 @@ StreamStatus StreamProcessor::GetStatus() const {
         status.last_error = last_error_;
     }
 
+    // A subscriber has no pipeline of its own: while its source reconnects
+    // or has failed, it receives no frames either
+    if (source && status.state == StreamState::kRunning) {
+        const StreamState source_state = source->state_.load();
+        if (source_state == StreamState::kReconnecting || source_state == StreamState::kError) {
+            status.state = source_state;
+            std::lock_guard<std::mutex> lock(source->error_mutex_);
+            status.last_error = source->last_error_;
+        }
+    }
+
     return status;
 }
 
 std::optional<std::vector<uint8_t>> StreamProcessor::GetSnapshot() const {
+    // Keeps the main stream open; the first request still returns the inference frame
+    snapshot_requested_ms_.store(GetCurrentTimestampMs(), std::memory_order_relaxed);
+
     std::lock_guard<std::mutex> lock(snapshot_mutex_);
-    if (last_snapshot_.empty()) {
+    if (!last_snapshot_ || last_snapshot_->empty()) {
         return std::nullopt;
     }
-    return last_snapshot_;
+    return *last_snapshot_;
 }
 
 // ============================================================================
@@ -554,30 +973,131 @@ void StreamProcessor::SetErrorCallback(ErrorCallback callback) {
 // Pipeline Management
 // ============================================================================
 
-VoidResult StreamProcessor::CreatePipeline() {
+VoidResult StreamProcessor::InitInference() {
     // Initialize HailoRT inference if HEF path is specified
     if (!hef_path_.empty()) {
-        auto inference_result = HailoInference::GetInstance(hef_path_);
-        if (IsError(inference_result)) {
-            return MakeError("Failed to initialize Hailo inference: " + GetError(inference_result));
-        }
-        hailo_inference_ = GetValue(inference_result);
-
-        // Set model configuration for proper output parsing
-        hailo_inference_->SetModelConfig(task_, num_keypoints_, labels_);
-
-        // Get batch manager for batch > 1 models
-        int batch_size = hailo_inference_->GetBatchSize();
-        if (batch_size > 1) {
-            batch_manager_ = hailo_inference_->GetBatchManager();
-            if (batch_manager_) {
-                batch_manager_->RegisterStream(stream_id_);
-                LogInfo("Batch inference enabled (batch=" + std::to_string(batch_size) +
-                        ") for stream: " + stream_id_);
+        // Pooled: the device this stream was placed on (a move pending for
+        // the frame worker is already the pool's current placement)
+        std::shared_ptr<HailoInference> inference;
+        if (device_pool_) {
+            auto placement = device_pool_->AssignStream(stream_id_, hef_path_);
+            if (IsError(placement)) {
+                return MakeError("Failed to initialize Hailo inference: " + GetError(placement));
+            }
+            inference = GetValue(placement).inference;
+        } else {
+            auto inference_result = HailoInference::GetInstance(hef_path_);
+            if (IsError(inference_result)) {
+                return MakeError("Failed to initialize Hailo inference: " + GetError(inference_result));
             }
+            inference = GetValue(inference_result);
+        }
+        {
+            std::lock_guard<std::mutex> lock(placement_mutex_);
+            pending_inference_.reset();
+        }
+        AttachInference(std::move(inference));
+
+        LogInfo("HailoRT inference initialized (shared instance" +
+                (hailo_inference_->GetDeviceId().empty()
+                     ? std::string()
+                     : ", device " + hailo_inference_->GetDeviceId()) + ")");
+
+        // Policy follows config updates (InitInference runs on every pipeline build)
+        if (inference_scheduler_) {
+            InferenceScheduler::StreamPolicy policy;
+            policy.priority = config_.inference_priority;
+            policy.weight = config_.inference_weight;
+            policy.min_fps = config_.inference_min_fps;
+            policy.deadline = std::chrono::milliseconds(config_.inference_deadline_ms);
+            inference_scheduler_->SetStreamPolicy(stream_id_, policy);
+            LogInfo("Inference scheduling for " + stream_id_ + ": priority=" +
+                    std::string(InferencePriorityToString(policy.priority)) +
+                    ", weight=" + std::to_string(policy.weight) +
+                    ", min_fps=" + std::to_string(policy.min_fps) +
+                    ", deadline=" + std::to_string(config_.inference_deadline_ms) + "ms");
+        }
+    } else if (device_pool_) {
+        // Video-only now (model removed by Update): free its device share
+        device_pool_->ReleaseStream(stream_id_);
+    }
+
+    // Fresh background per start (frame worker not running yet)
+    motion_gate_.reset();
+    if (config_.motion_gate) {
+        MotionGate::Params params;
+        params.max_skip = std::chrono::milliseconds(config_.motion_max_skip_ms);
+        motion_gate_ = std::make_unique<MotionGate>(params);
+        LogInfo("Motion gate for " + stream_id_ + ": max_skip=" +
+                std::to_string(config_.motion_max_skip_ms) + "ms, simd=" +
+                std::string(SimdLevelToString(motion_gate_->GetSimdLevel())));
+    }
+    return MakeOk();
+}
+
+void StreamProcessor::AttachInference(std::shared_ptr<HailoInference> inference) {
+    if (batch_manager_) {
+        batch_manager_->UnregisterStream(stream_id_);
+        batch_manager_.reset();
+    }
+    {
+        std::lock_guard<std::mutex> lock(placement_mutex_);
+        hailo_inference_ = std::move(inference);
+    }
+
+    // This stream's output interpretation (shared with streams of equal spec)
+    ModelSpec spec;
+    spec.task = task_;
+    spec.num_keypoints = num_keypoints_;
+    spec.labels = labels_;
+    model_context_ = hailo_inference_->GetContext(spec);
+
+    // Get batch manager for batch > 1 models
+    int batch_size = hailo_inference_->GetBatchSize();
+    if (batch_size > 1) {
+        batch_manager_ = hailo_inference_->GetBatchManager();
+        if (batch_manager_) {
+            batch_manager_->RegisterStream(stream_id_);
+            LogInfo("Batch inference enabled (batch=" + std::to_string(batch_size) +
+                    ") for stream: " + stream_id_);
         }
+    }
+}
+
+void StreamProcessor::SetInferencePlacement(std::shared_ptr<HailoInference> inference) {
+    std::lock_guard<std::mutex> lock(placement_mutex_);
+    pending_inference_ = std::move(inference);
+}
+
+void StreamProcessor::ApplyPendingPlacement() {
+    std::shared_ptr<HailoInference> inference;
+    {
+        std::lock_guard<std::mutex> lock(placement_mutex_);
+        if (!pending_inference_ || !hailo_inference_) {
+            return;
+        }
+        inference = std::move(pending_inference_);
+    }
+    LogInfo("Stream " + stream_id_ + " inference moved to device " +
+            (inference->GetDeviceId().empty() ? std::string("default") : inference->GetDeviceId()));
+    AttachInference(std::move(inference));
+}
+
+bool StreamProcessor::AcquireInferenceSlot(InferenceScheduler::Lease& lease, int slots) {
+    if (!inference_scheduler_ || !hailo_inference_ || !hailo_inference_->IsReady()) {
+        return true;
+    }
+    auto result = inference_scheduler_->Acquire(stream_id_, slots);
+    if (IsError(result)) {
+        return false;
+    }
+    lease = GetValue(std::move(result));
+    return true;
+}
 
-        LogInfo("HailoRT inference initialized (shared instance)");
+VoidResult StreamProcessor::CreatePipeline() {
+    if (auto result = InitInference(); IsError(result)) {
+        return result;
     }
 
     const std::string pipeline_str = BuildPipelineString();
@@ -596,6 +1116,11 @@ VoidResult StreamProcessor::CreatePipeline() {
         return MakeError("Failed to create pipeline: unknown error");
     }
 
+    if (GstElement* src = gst_bin_get_by_name(GST_BIN(pipeline_), "src")) {
+        EnableReferenceTimestamps(src);
+        gst_object_unref(src);
+    }
+
     // Get appsink element
     appsink_ = gst_bin_get_by_name(GST_BIN(pipeline_), "sink");
     if (!appsink_) {
@@ -611,12 +1136,72 @@ VoidResult StreamProcessor::CreatePipeline() {
         "drop", TRUE,
         nullptr);
 
+    // Inference decimation (configured before the first new-sample callback)
+    inference_decimator_.Configure(config_.inference_fps, config_.inference_every_n);
+    if (!inference_decimator_.IsPassThrough()) {
+        LogInfo("Inference decimation for " + stream_id_ + ": fps=" +
+                std::to_string(config_.inference_fps) + ", every_n=" +
+                std::to_string(config_.inference_every_n));
+    }
+
     // Connect new-sample signal
     g_signal_connect(appsink_, "new-sample", G_CALLBACK(OnNewSample), this);
 
+    // Dual-branch: the preview appsink fills preview_ring_ for the frame
+    // worker to pair by PTS, and the tee input caps give the decoded source
+    // geometry for coordinate mapping
+    if (UseDualBranch()) {
+        preview_sink_ = gst_bin_get_by_name(GST_BIN(pipeline_), "preview_sink");
+        GstElement* tee = gst_bin_get_by_name(GST_BIN(pipeline_), "t");
+        if (!preview_sink_ || !tee) {
+            if (tee) gst_object_unref(tee);
+            if (preview_sink_) gst_object_unref(preview_sink_);
+            preview_sink_ = nullptr;
+            gst_object_unref(appsink_);
+            appsink_ = nullptr;
+            gst_object_unref(pipeline_);
+            pipeline_ = nullptr;
+            return MakeError("Failed to get dual-branch elements");
+        }
+
+        preview_geometry_.Reset();
+        preview_ring_.Clear();
+        g_signal_connect(preview_sink_, "new-sample", G_CALLBACK(OnPreviewSample), this);
+
+        source_caps_pad_ = gst_element_get_static_pad(tee, "sink");
+        gst_object_unref(tee);
+        source_caps_probe_id_ = gst_pad_add_probe(
+            source_caps_pad_, GST_PAD_PROBE_TYPE_EVENT_DOWNSTREAM,
+            OnSourceCapsProbe, this, nullptr);
+
+        LogInfo("Dual-branch pipeline enabled for " + stream_id_ +
+                " (preview width " + std::to_string(config_.preview_width) + ")");
+    }
+
+    // Decode skipping: encoded frames entering the decoder give the camera
+    // rate, QoS events go upstream from the appsink pad
+    decode_skip_.Reset();
+    decode_skip_fps_ = 0.0;
+    appsink_pad_ = gst_element_get_static_pad(appsink_, "sink");
+    GstElement* decoder = gst_bin_get_by_name(GST_BIN(pipeline_), "dec");
+    if (decoder) {
+        decoder_pad_ = gst_element_get_static_pad(decoder, "sink");
+        gst_object_unref(decoder);
+        decoder_probe_id_ = gst_pad_add_probe(
+            decoder_pad_, GST_PAD_PROBE_TYPE_BUFFER,
+            OnDecoderInputProbe, this, nullptr);
+    }
+
     // Setup bus watch for messages
     bus_ = gst_element_get_bus(pipeline_);
-    bus_watch_id_ = gst_bus_add_watch(bus_, OnBusMessage, this);
+    GSource* bus_source = gst_bus_create_watch(bus_);
+    g_source_set_callback(bus_source, reinterpret_cast<GSourceFunc>(G_CALLBACK(OnBusMessage)),
+                          new LoopTicket(loop_guard_.Issue()),
+                          [](gpointer data) { delete static_cast<LoopTicket*>(data); });
+    bus_watch_id_ = g_source_attach(bus_source, main_context_);
+    g_source_unref(bus_source);
+
+    StartFrameWorker();
 
     return MakeOk();
 }
@@ -624,22 +1209,26 @@ VoidResult StreamProcessor::CreatePipeline() {
 void StreamProcessor::DestroyPipeline() {
     LogInfo("DestroyPipeline: start");
 
-    // Unregister from batch manager if registered
-    if (batch_manager_) {
-        LogInfo("DestroyPipeline: UnregisterStream...");
-        batch_manager_->UnregisterStream(stream_id_);
-        batch_manager_.reset();
-    }
-
-    if (reconnect_source_id_ > 0) {
-        g_source_remove(reconnect_source_id_);
-        reconnect_source_id_ = 0;
-    }
+    // Read before the worker is told to stop: it clears preview_sink_ on exit
+    GstElement* old_preview_sink = pipeline_ ? preview_sink_ : nullptr;
+    GstElement* old_pipeline = nullptr;
+    GstElement* old_appsink = nullptr;
+    GstBus* old_bus = nullptr;
+
+    // Runs on the main loop too: only signal the worker. It finishes the frame
+    // in hand, resets its own state (batch registration, preview sink,
+    // geometry, snapshot stream) and is joined by the teardown job before
+    // the pipeline it reads is freed. A job that never runs detaches it
+    // instead (exit is tracked separately)
+    std::shared_ptr<std::thread> worker(new std::thread(StopFrameWorker()), [](std::thread* t) {
+        if (t->joinable()) {
+            t->detach();
+        }
+        delete t;
+    });
 
-    if (bus_watch_id_ > 0) {
-        g_source_remove(bus_watch_id_);
-        bus_watch_id_ = 0;
-    }
+    RemoveLoopSource(reconnect_source_id_);
+    RemoveLoopSource(bus_watch_id_);
 
     if (pipeline_) {
         LogInfo("DestroyPipeline: setting stopping flag...");
@@ -647,11 +1236,33 @@ void StreamProcessor::DestroyPipeline() {
         // STEP 1: Set stopping flag to prevent new callbacks from running
         stopping_.store(true, std::memory_order_release);
 
+        if (source_caps_pad_) {
+            if (source_caps_probe_id_ > 0) {
+                gst_pad_remove_probe(source_caps_pad_, source_caps_probe_id_);
+                source_caps_probe_id_ = 0;
+            }
+            gst_object_unref(source_caps_pad_);
+            source_caps_pad_ = nullptr;
+        }
+
+        if (decoder_pad_) {
+            if (decoder_probe_id_ > 0) {
+                gst_pad_remove_probe(decoder_pad_, decoder_probe_id_);
+                decoder_probe_id_ = 0;
+            }
+            gst_object_unref(decoder_pad_);
+            decoder_pad_ = nullptr;
+        }
+
         // STEP 2: Disconnect signal to prevent NEW callbacks
         if (appsink_) {
             g_signal_handlers_disconnect_by_func(
                 appsink_, reinterpret_cast<gpointer>(OnNewSample), this);
         }
+        if (old_preview_sink) {
+            g_signal_handlers_disconnect_by_func(
+                old_preview_sink, reinterpret_cast<gpointer>(OnPreviewSample), this);
+        }
 
         // STEP 3: Wait for any in-flight callbacks to complete (max 100ms)
         int wait_count = 0;
@@ -663,28 +1274,58 @@ void StreamProcessor::DestroyPipeline() {
             LogInfo("DestroyPipeline: waited " + std::to_string(wait_count) + "ms for callbacks");
         }
 
+        // Samples handed off after the worker stopped still ref old buffers
+        frame_mailbox_.Clear();
+        preview_ring_.Clear();
+
+        // No callback left that could push QoS upstream
+        if (appsink_pad_) {
+            gst_object_unref(appsink_pad_);
+            appsink_pad_ = nullptr;
+        }
+
         LogInfo("DestroyPipeline: async cleanup...");
 
         // Capture pointers for async cleanup
-        GstElement* old_pipeline = pipeline_;
-        GstElement* old_appsink = appsink_;
-        GstBus* old_bus = bus_;
+        old_pipeline = pipeline_;
+        old_appsink = appsink_;
+        old_bus = bus_;
 
-        // Clear our pointers immediately (prevents any further access)
+        // Clear our pointers immediately (prevents any further access); the
+        // worker reads none of them. preview_sink_ it does read: it clears
+        // that one on exit
         pipeline_ = nullptr;
         appsink_ = nullptr;
         bus_ = nullptr;
+        if (!worker->joinable()) {
+            preview_sink_ = nullptr;
+        }
+    }
+
+    if (old_pipeline || worker->joinable()) {
+        // Full cleanup off the caller thread to avoid blocking gRPC / the main loop
+        auto teardown = [worker, old_pipeline, old_appsink, old_preview_sink, old_bus](
+                            std::chrono::milliseconds timeout) {
+            if (worker->joinable()) {
+                worker->join();
+            }
+            if (!old_pipeline) {
+                return;  // Subscriber: no pipeline of its own
+            }
 
-        // Full cleanup in background thread to avoid blocking gRPC
-        std::thread([old_pipeline, old_appsink, old_bus]() {
             // Stop pipeline (can be slow with unresponsive RTSP)
             gst_element_set_state(old_pipeline, GST_STATE_NULL);
-            gst_element_get_state(old_pipeline, nullptr, nullptr, 3 * GST_SECOND);
+            gst_element_get_state(old_pipeline, nullptr, nullptr,
+                                  static_cast<GstClockTime>(timeout.count()) * GST_MSECOND);
 
             if (old_appsink) gst_object_unref(old_appsink);
+            if (old_preview_sink) gst_object_unref(old_preview_sink);
             if (old_bus) gst_object_unref(old_bus);
             gst_object_unref(old_pipeline);
-        }).detach();
+        };
+
+        // Dropped when the queue is full: the worker is then detached by its deleter
+        (void)TeardownExecutor::SubmitOrSpawn(teardown_executor_, stream_id_, std::move(teardown));
 
         LogInfo("DestroyPipeline: cleanup scheduled");
     }
@@ -697,17 +1338,14 @@ std::string StreamProcessor::BuildPipelineString() const {
     std::ostringstream oss;
 
     // RTSP source with reconnection settings
-    oss << "rtspsrc location=\"" << rtsp_url_ << "\" "
-        << "latency=0 "
-        << "timeout=2000000 "      // 2초 (마이크로초)
-        << "tcp-timeout=2000000 "  // TCP 타임아웃 2초
-        << "retry=1 "
-        << "protocols=tcp "
-        << "drop-on-latency=true "
-        << "name=src "
-        << "! rtph264depay "
+    oss << "rtspsrc location=\"" << PipelineUrl() << "\" ";
+    for (const auto& [name, value] : kRtspSourceProperties) {
+        oss << name << "=" << value << " ";
+    }
+    oss << "name=src "
+        << "! rtph264depay name=depay "
         << "! h264parse "
-        << "! avdec_h264 ";
+        << "! avdec_h264 name=dec ";
 
     // Auto-detect RTSP stream resolution (no forced scaling)
     // HailoInference handles resize internally for model input
@@ -722,156 +1360,532 @@ std::string StreamProcessor::BuildPipelineString() const {
         LogInfo("Running in video-only mode (no inference)");
     }
 
-    // Output to appsink (RGB format for JPEG encoding and inference)
+    if (UseDualBranch()) {
+        // Dual-branch: scale in YUV before colour conversion on both branches.
+        // Inference branch is letterboxed to model size (add-borders keeps DAR),
+        // preview branch is only used for JPEG/snapshots and encodes YUV directly.
+        oss << "! tee name=t "
+            << "t. ! queue max-size-buffers=3 leaky=downstream "
+            << "! videoscale add-borders=true "
+            << "! videoconvert "
+            << "! video/x-raw,format=RGB"
+            << ",width=" << hailo_inference_->GetInputWidth()
+            << ",height=" << hailo_inference_->GetInputHeight()
+            << ",pixel-aspect-ratio=1/1 "
+            << "! appsink name=sink emit-signals=true max-buffers=1 drop=true sync=false "
+            << "t. ! queue max-size-buffers=3 leaky=downstream "
+            << "! videoscale "
+            << "! videoconvert "
+            << "! video/x-raw,format=" << (config_.native_yuv ? "I420" : "RGB")
+            << ",width=" << config_.preview_width
+            << ",pixel-aspect-ratio=1/1 "
+            << "! appsink name=preview_sink emit-signals=true max-buffers=1 drop=true sync=false";
+        return oss.str();
+    }
+
+    // Output to appsink. With native_yuv the decoder's planes pass through
+    // (videoconvert is a no-op for I420/NV12) and inference converts only the
+    // letterboxed pixels; JPEG encoding takes the planes as raw 4:2:0 data.
     // Large queue with leaky=downstream allows RTSP to buffer ahead
     // and drop old frames, keeping the stream at real-time speed
     oss << "! queue max-size-buffers=3 leaky=downstream "
         << "! videoconvert "
-        << "! video/x-raw,format=RGB "
+        << "! video/x-raw,format=" << (config_.native_yuv ? "{ I420, NV12 }" : "RGB") << " "
         << "! appsink name=sink emit-signals=true max-buffers=1 drop=true sync=false";
 
     return oss.str();
 }
 
+std::string StreamProcessor::SnapshotUrl() const {
+    // Substream for inference implies rtsp_url is the main stream
+    std::string url = !snapshot_url_.empty() ? snapshot_url_
+                    : !inference_url_.empty() ? rtsp_url_
+                    : std::string();
+    return url == PipelineUrl() ? std::string() : url;
+}
+
+std::string StreamProcessor::BuildSnapshotPipelineString() const {
+    std::ostringstream oss;
+    oss << "rtspsrc location=\"" << SnapshotUrl() << "\" ";
+    for (const auto& [name, value] : kRtspSourceProperties) {
+        oss << name << "=" << value << " ";
+    }
+    oss << "! rtph264depay "
+        << "! h264parse "
+        << "! avdec_h264 "
+        << "! queue max-size-buffers=1 leaky=downstream "
+        << "! videoconvert "
+        << "! video/x-raw,format=" << (config_.native_yuv ? "{ I420, NV12 }" : "RGB") << " "
+        << "! appsink name=sink emit-signals=false max-buffers=1 drop=true sync=false";
+    return oss.str();
+}
+
+bool StreamProcessor::UseDualBranch() const {
+    return config_.dual_branch && config_.preview_width > 0 &&
+           hailo_inference_ && hailo_inference_->IsReady();
+}
+
+BoundingBox StreamProcessor::InferenceRegion(int width, int height) const {
+    const BoundingBox full{0, 0, width, height};
+    if (!config_.roi_crop || !event_compositor_) {
+        return full;
+    }
+
+    const auto bounds = event_compositor_->GetRegionBounds();
+    if (!bounds) {
+        return full;
+    }
+
+    const BoundingBox region = NormalizedRegionToPixels(
+        bounds->min.x, bounds->min.y, bounds->max.x, bounds->max.y,
+        config_.roi_crop_margin, width, height);
+    return region.width > 0 && region.height > 0 ? region : full;
+}
+
+const std::vector<BoundingBox>& StreamProcessor::InferenceTiles(int width, int height) {
+    if (width == tiles_width_ && height == tiles_height_ && !inference_tiles_.empty()) {
+        return inference_tiles_;
+    }
+
+    const int model_w = hailo_inference_->GetInputWidth();
+    const int model_h = hailo_inference_->GetInputHeight();
+    const int tile_w = config_.tile_size > 0 ? config_.tile_size : model_w;
+    const int tile_h = model_w > 0 ? tile_w * model_h / model_w : tile_w;
+
+    // The letterboxed full frame catches objects larger than a tile
+    inference_tiles_ = {BoundingBox{0, 0, width, height}};
+    const auto tiles = ComputeTiles(width, height, tile_w, tile_h, config_.tile_overlap);
+    if (tiles.size() > 1) {
+        inference_tiles_.insert(inference_tiles_.end(), tiles.begin(), tiles.end());
+    }
+    tiles_width_ = width;
+    tiles_height_ = height;
+
+    LogInfo("Stream " + stream_id_ + " tiled inference: " +
+            std::to_string(inference_tiles_.size() - 1) + " tiles of " +
+            std::to_string(tile_w) + "x" + std::to_string(tile_h) + " + full frame");
+    return inference_tiles_;
+}
+
+FrameRef StreamProcessor::PreviewFrameFor(GstSample* sample) const {
+    // Both branches leave the tee with the same buffer (same PTS); when the
+    // preview branch has not delivered it yet, its newest frame is close enough
+    GstBuffer* buffer = gst_sample_get_buffer(sample);
+    if (buffer && GST_BUFFER_PTS_IS_VALID(buffer)) {
+        if (FrameRef preview = preview_ring_.Find(GST_BUFFER_PTS(buffer))) {
+            return preview;
+        }
+    }
+    return preview_ring_.Latest();
+}
+
 // ============================================================================
 // Reconnection
 // ============================================================================
 
-void StreamProcessor::ScheduleReconnect() {
+void StreamProcessor::RecoverFromFailure(std::string_view reason, bool source_failure,
+                                         std::chrono::milliseconds first_delay) {
     if (state_ == StreamState::kStopped) {
         return;
     }
 
-    if (reconnect_attempts_ >= kMaxReconnectAttempts) {
+    // Source-only failure: swap rtspsrc, keep the decoder running
+    const bool soft_possible = source_failure && config_.soft_restart && pipeline_ != nullptr;
+    auto step = escalation_.OnFailure(soft_possible);
+    if (step == ReconnectEscalation::Step::kSoftRestart) {
+        MarkReconnectStart();
+        auto result = SoftRestartSource(PipelineUrl());
+        if (IsOk(result)) {
+            LogInfo("Soft restart for " + stream_id_ + " (" + std::string(reason) + ")");
+            return;
+        }
+        LogWarning("Soft restart failed for " + stream_id_ + ": " + GetError(result));
+        step = escalation_.OnFailure(false);
+    }
+
+    DestroyPipeline();
+    if (step == ReconnectEscalation::Step::kGiveUp) {
+        CancelReconnect();  // Frees the build slot if a rebuild failed
         SetError("Max reconnection attempts reached");
         SetState(StreamState::kError);
         return;
     }
 
-    SetState(StreamState::kReconnecting);
-    ++reconnect_attempts_;
+    const int attempt = escalation_.GetAttempts();
+    MarkReconnectStart();
 
-    int delay = kReconnectDelaySeconds * reconnect_attempts_;
-    LogWarning("Scheduling reconnect for " + stream_id_ +
-               " in " + std::to_string(delay) + " seconds (attempt " +
-               std::to_string(reconnect_attempts_) + "/" +
+    // Exponential backoff; jitter is added by the scheduler
+    const ReconnectPolicy policy = reconnect_scheduler_ ? reconnect_scheduler_->GetPolicy()
+                                                        : ReconnectPolicy{};
+    auto delay = ReconnectScheduler::BackoffDelay(policy, attempt);
+    if (attempt == 1 && first_delay.count() > 0) {
+        delay = std::min(delay, first_delay);
+    }
+    LogWarning("Scheduling reconnect for " + stream_id_ + " (" + std::string(reason) +
+               ") in " + std::to_string(delay.count()) + " ms (attempt " +
+               std::to_string(attempt) + "/" +
                std::to_string(kMaxReconnectAttempts) + ")");
 
-    reconnect_source_id_ = g_timeout_add_seconds(
-        static_cast<guint>(delay),
-        OnReconnectTimeout,
-        this);
+    ScheduleReconnectAfter(delay);
+}
+
+void StreamProcessor::ScheduleReconnectAfter(std::chrono::milliseconds delay) {
+    SetState(StreamState::kReconnecting);
+
+    if (reconnect_scheduler_) {
+        // The dispatcher only grants the build slot; the rebuild runs on the
+        // main loop, serialized with bus messages and Stop(). The slot is
+        // released by PLAYING (NotifyBuildComplete) or the next Schedule()
+        reconnect_scheduler_->Schedule(
+            stream_id_, delay, last_healthy_time_.load(),
+            [context = main_context_, ticket = loop_guard_.Issue()]() {
+                PostLoopJob(context, ticket, [](StreamProcessor& self) { self.RunReconnect(); });
+                return true;
+            });
+        return;
+    }
+
+    // Standalone processor: per-stream timer on the main loop
+    CancelReconnect();
+    reconnect_source_id_ = PostToMainLoop([](StreamProcessor& self) {
+        self.reconnect_source_id_ = 0;
+        self.RunReconnect();
+    }, delay);
 }
 
 void StreamProcessor::CancelReconnect() {
-    if (reconnect_source_id_ > 0) {
-        g_source_remove(reconnect_source_id_);
-        reconnect_source_id_ = 0;
+    RemoveLoopSource(reconnect_source_id_);
+    if (reconnect_scheduler_) {
+        reconnect_scheduler_->Cancel(stream_id_);
     }
 }
 
-// ============================================================================
-// Detection Processing (with JPEG encoding)
-// ============================================================================
+void StreamProcessor::RunReconnect() {
+    if (state_ == StreamState::kStopped) {
+        return;
+    }
 
-void StreamProcessor::ProcessDetections(GstBuffer* buffer) {
-    ++frame_count_;
-    last_frame_time_ = std::chrono::duration_cast<std::chrono::milliseconds>(
-        std::chrono::steady_clock::now().time_since_epoch()).count();
-    UpdateFps();
+    LogInfo("Attempting reconnect for stream: " + stream_id_);
 
-    // Get video frame info
-    GstMapInfo map;
-    if (!gst_buffer_map(buffer, &map, GST_MAP_READ)) {
-        LogWarning("Failed to map buffer");
+    if (auto result = StartLocked(); IsError(result)) {
+        LogError("Reconnect failed: " + GetError(result));
+        RecoverFromFailure("reconnect failed", false);
+    }
+}
+
+guint StreamProcessor::PostToMainLoop(std::function<void(StreamProcessor&)> fn,
+                                      std::chrono::milliseconds delay) {
+    return PostLoopJob(main_context_, loop_guard_.Issue(), std::move(fn), delay);
+}
+
+void StreamProcessor::RemoveLoopSource(guint& source_id) {
+    if (source_id == 0) {
         return;
     }
+    // IDs are per context: g_source_remove() would look in the default one
+    if (GSource* source = g_main_context_find_source_by_id(main_context_, source_id)) {
+        g_source_destroy(source);
+    }
+    source_id = 0;
+}
 
-    // Get frame dimensions from caps (auto-detect from RTSP stream)
-    GstCaps* caps = gst_pad_get_current_caps(
-        gst_element_get_static_pad(appsink_, "sink"));
+void StreamProcessor::MarkReconnectStart() {
+    int64_t expected = 0;
+    reconnect_started_ms_.compare_exchange_strong(expected, SteadyNowMs());
+}
 
-    int width = 0;
-    int height = 0;
+GstElement* StreamProcessor::CreateSourceElement(const std::string& url) const {
+    GstElement* src = gst_element_factory_make("rtspsrc", "src");
+    if (!src) {
+        return nullptr;
+    }
+    gst_util_set_object_arg(G_OBJECT(src), "location", url.c_str());
+    for (const auto& [name, value] : kRtspSourceProperties) {
+        gst_util_set_object_arg(G_OBJECT(src), name, value);
+    }
+    EnableReferenceTimestamps(src);
+    return src;
+}
 
-    if (caps) {
-        GstStructure* structure = gst_caps_get_structure(caps, 0);
-        gst_structure_get_int(structure, "width", &width);
-        gst_structure_get_int(structure, "height", &height);
-        gst_caps_unref(caps);
+bool StreamProcessor::IsSourceMessage(GstMessage* msg) const {
+    if (!pipeline_) {
+        return false;
+    }
+    GstElement* src = gst_bin_get_by_name(GST_BIN(pipeline_), "src");
+    if (!src) {
+        return false;
     }
 
-    // Log resolution detection on first frame or resolution change
-    if (width > 0 && height > 0 &&
-        (frame_width_ != width || frame_height_ != height)) {
-        LogInfo("Stream " + stream_id_ + " resolution: " +
-                std::to_string(width) + "x" + std::to_string(height));
+    bool from_source = false;
+    for (GstObject* obj = GST_MESSAGE_SRC(msg); obj; obj = GST_OBJECT_PARENT(obj)) {
+        if (obj == GST_OBJECT(src)) {
+            from_source = true;
+            break;
+        }
+    }
+    gst_object_unref(src);
+    return from_source;
+}
+
+VoidResult StreamProcessor::SoftRestartSource(const std::string& url) {
+    if (!pipeline_) {
+        return MakeError("Pipeline not created");
+    }
+
+    GstElement* depay = gst_bin_get_by_name(GST_BIN(pipeline_), "depay");
+    if (!depay) {
+        return MakeError("Depayloader not found");
+    }
+    GstPad* depay_sink = gst_element_get_static_pad(depay, "sink");
+    gst_object_unref(depay);
+    if (!depay_sink) {
+        return MakeError("Depayloader has no sink pad");
+    }
+
+    GstElement* new_src = CreateSourceElement(url);
+    if (!new_src) {
+        gst_object_unref(depay_sink);
+        return MakeError("Failed to create rtspsrc");
+    }
+
+    // Detach the old source (bin_get_by_name ref keeps it alive off the bin)
+    if (GstElement* old_src = gst_bin_get_by_name(GST_BIN(pipeline_), "src")) {
+        if (GstPad* peer = gst_pad_get_peer(depay_sink)) {
+            gst_pad_unlink(peer, depay_sink);
+            gst_object_unref(peer);
+        }
+        gst_bin_remove(GST_BIN(pipeline_), old_src);
+
+        // set_state(NULL) on a dead RTSP session can block; reuse the teardown pool
+        auto teardown = [old_src](std::chrono::milliseconds timeout) {
+            gst_element_set_state(old_src, GST_STATE_NULL);
+            gst_element_get_state(old_src, nullptr, nullptr,
+                                  static_cast<GstClockTime>(timeout.count()) * GST_MSECOND);
+            gst_object_unref(old_src);
+        };
+        (void)TeardownExecutor::SubmitOrSpawn(teardown_executor_, stream_id_ + "/src",
+                                              std::move(teardown));
+    }
+
+    // Drop partial access units and clear EOS downstream; elements stay PLAYING
+    gst_pad_send_event(depay_sink, gst_event_new_flush_start());
+    gst_pad_send_event(depay_sink, gst_event_new_flush_stop(TRUE));
+    gst_object_unref(depay_sink);
+
+    g_signal_connect(new_src, "pad-added", G_CALLBACK(OnSourcePadAdded), this);
+    if (!gst_bin_add(GST_BIN(pipeline_), new_src)) {
+        gst_object_unref(new_src);
+        return MakeError("Failed to add rtspsrc to pipeline");
     }
+    if (!gst_element_sync_state_with_parent(new_src)) {
+        return MakeError("Failed to start rtspsrc");
+    }
+
+    ++soft_restarts_;
+    return MakeOk();
+}
+
+// ============================================================================
+// Detection Processing (with JPEG encoding)
+// ============================================================================
+
+void StreamProcessor::ProcessDetections(const CapturedSample& captured) {
+    GstSample* const sample = captured.sample;
+    const int64_t capture_ms = captured.capture_ms;
+    queue_latency_.Record(GetCurrentTimestampMs() - capture_ms);
+
+    // Frame layout from the sample caps (auto-detect from RTSP stream);
+    // parsed only when the caps change
+    const FrameGeometry* geometry = frame_geometry_.Get(gst_sample_get_caps(sample));
 
     // Fallback to config if caps not available
-    if (width <= 0 || height <= 0) {
-        width = config_.width;
-        height = config_.height;
+    const FrameGeometry fallback = FrameGeometry::Rgb(config_.width, config_.height);
+    if (!geometry) {
+        geometry = &fallback;
+    }
+    const int frame_w = geometry->width;
+    const int frame_h = geometry->height;
+
+    // Map once and share the mapping with the batch worker (no pixel copy)
+    auto frame_result = FrameBuffer::FromSample(sample, *geometry);
+    if (IsError(frame_result)) {
+        LogWarning("Failed to map frame: " + GetError(frame_result));
+        return;
+    }
+    FrameRef frame = GetValue(std::move(frame_result));
+
+    // Single branch: the inference frame is the decoded frame and feeds the JPEG too.
+    // Dual branch: the inference frame is letterboxed to model size, JPEG comes from
+    // the preview branch and detections are reported in decoded source geometry.
+    FrameRef preview = frame;
+    int width = frame_w;
+    int height = frame_h;
+    const bool prescaled = (preview_sink_ != nullptr);
+
+    if (prescaled) {
+        preview = PreviewFrameFor(sample);
+        width = source_width_.load(std::memory_order_relaxed);
+        height = source_height_.load(std::memory_order_relaxed);
+        if (width <= 0 || height <= 0) {
+            width = config_.width;
+            height = config_.height;
+        }
+    }
+
+    // Log resolution detection on first frame or resolution change
+    if (frame_width_ != width || frame_height_ != height) {
+        LogInfo("Stream " + stream_id_ + " resolution: " +
+                std::to_string(width) + "x" + std::to_string(height));
     }
 
     frame_width_ = width;
     frame_height_ = height;
 
-    // JPEG 인코딩 (needed for both sync and async paths)
-    auto jpeg_data = EncodeJpeg(map.data, width, height, jpeg_quality_);
+    EventFrame event_frame;
+    event_frame.width = width;
+    event_frame.height = height;
+    event_frame.capture_ms = capture_ms;
+
+    // Main stream (substream inference): decoded only while snapshots or
+    // event images are wanted; detections are reported in the geometry of
+    // the image attached to this event
+    event_frame.report_width = width;
+    event_frame.report_height = height;
+    if (snapshot_stream_) {
+        const int64_t now_ms = GetCurrentTimestampMs();
+        if (now_ms - snapshot_requested_ms_.load(std::memory_order_relaxed) < kSnapshotIdleTimeoutMs ||
+            (publish_images_ && now_ms - last_detection_time_.load() < kSnapshotIdleTimeoutMs)) {
+            snapshot_stream_->Touch();
+        }
+        if (FrameRef main_frame = snapshot_stream_->Latest(
+                std::chrono::milliseconds(kSnapshotMaxAgeMs))) {
+            preview = std::move(main_frame);
+            event_frame.report_width = preview->Width();
+            event_frame.report_height = preview->Height();
+        }
+        snapshot_stream_->CloseIfIdle(std::chrono::milliseconds(kSnapshotIdleTimeoutMs));
+    }
 
     // Run inference via HailoRT API if available
     std::vector<Detection> detections;
+    InferenceScheduler::Lease lease;  // This frame's NPU slots (released once outputs are read)
+
+    // Tiled frames are batched by RunTiledInference itself (synchronous)
+    const bool tiled = config_.tiled && !prescaled;
+
+    // ROI crop: pixels outside every event region never reach the NPU;
+    // detections come back relative to the region
+    const BoundingBox region = prescaled ? BoundingBox{0, 0, width, height}
+                                         : InferenceRegion(width, height);
+    const bool cropped = region.width != width || region.height != height;
+    const FrameView view = cropped
+        ? frame->View().Crop(region.x, region.y, region.width, region.height)
+        : frame->View();
+
+    // A tiled frame runs once per crop and is charged that many NPU slots
+    const int slots = tiled && hailo_inference_ && hailo_inference_->IsReady()
+        ? static_cast<int>(InferenceTiles(view.width, view.height).size())
+        : 1;
+
+    // Motion gate: a static scene skips the NPU and republishes the last
+    // detections (or publishes nothing). Decided before the JPEG encode: a
+    // frame that is not published is encoded only to refresh the snapshot
+    bool infer = true;
+    bool publish = true;
+    if (motion_gate_ && !motion_gate_->ShouldInfer(view, std::chrono::steady_clock::now())) {
+        motion_skipped_.fetch_add(1, std::memory_order_relaxed);
+        infer = false;
+        publish = config_.motion_republish;
+    } else if (!AcquireInferenceSlot(lease, slots)) {
+        // Waited past the deadline behind other streams (a newer frame is
+        // coming), or the worker is stopping
+        infer = false;
+        publish = false;
+    }
+
+    // JPEG 인코딩 (shared by reference): for a published image, or to keep the
+    // snapshot fresh (requested since the last encode, or older than the refresh)
+    const int64_t encode_ms = GetCurrentTimestampMs();
+    const bool snapshot_stale =
+        snapshot_requested_ms_.load(std::memory_order_relaxed) >= last_snapshot_ms_ ||
+        encode_ms - last_snapshot_ms_ >= kSnapshotRefreshMs;
+    if (preview && ((publish && publish_images_) || snapshot_stale)) {
+        event_frame.jpeg = std::make_shared<const std::vector<uint8_t>>(
+            EncodeJpeg(preview->View(), jpeg_quality_));
+        last_snapshot_ms_ = encode_ms;
+
+        // 스냅샷 저장
+        std::lock_guard<std::mutex> lock(snapshot_mutex_);
+        last_snapshot_ = event_frame.jpeg;
+    }
+    preview.reset();
 
-    if (batch_manager_) {
+    if (!publish) {
+        return;
+    }
+    if (!infer) {
+        frame.reset();
+        std::lock_guard<std::mutex> lock(motion_mutex_);
+        detections = last_inferred_detections_;
+    } else if (batch_manager_ && !tiled) {
         // Batch inference path (async) - submit frame and return
         // Results will be handled via OnBatchResult callback
-        auto jpeg_copy = jpeg_data;  // Copy for callback
         batch_manager_->SubmitFrame(
             stream_id_,
-            map.data, width, height,
-            [this, jpeg_copy, width, height](const std::string& stream_id,
-                                              std::vector<Detection> dets) {
-                OnBatchResult(stream_id, std::move(dets), jpeg_copy, width, height);
-            });
-
-        // Save snapshot even in async mode
-        {
-            std::lock_guard<std::mutex> lock(snapshot_mutex_);
-            last_snapshot_ = std::move(jpeg_data);
-        }
-        gst_buffer_unmap(buffer, &map);
+            std::move(frame),
+            prescaled ? width : 0,
+            prescaled ? height : 0,
+            InferenceRequest{model_context_, config_.confidence_threshold},
+            [this, event_frame, region, cropped, lease](const std::string& stream_id,
+                                                        std::vector<Detection> dets) mutable {
+                // Outputs are read: free the NPU slot before publishing
+                lease.reset();
+                if (cropped) {
+                    OffsetDetections(dets, region, event_frame.width, event_frame.height);
+                }
+                RememberDetections(dets);
+                OnBatchResult(stream_id, std::move(dets), event_frame);
+            },
+            cropped ? region : BoundingBox{});
         return;  // Async path - callback will handle the rest
-    }
-
-    // Synchronous inference path (batch=1 models)
-    if (hailo_inference_ && hailo_inference_->IsReady()) {
-        detections = hailo_inference_->RunInference(
-            map.data, width, height, config_.confidence_threshold);
-    }
+    } else if (hailo_inference_ && hailo_inference_->IsReady()) {
+        // Synchronous inference path (batch=1 models)
+        const InferenceRequest request{model_context_, config_.confidence_threshold};
+        if (tiled) {
+            detections = hailo_inference_->RunTiledInference(
+                view, InferenceTiles(view.width, view.height), request);
+        } else if (prescaled) {
+            detections = hailo_inference_->RunInferenceLetterboxed(view, width, height, request);
+        } else {
+            detections = hailo_inference_->RunInference(view, request);
+        }
+        lease.reset();
 
-    // 스냅샷 저장
-    {
-        std::lock_guard<std::mutex> lock(snapshot_mutex_);
-        last_snapshot_ = jpeg_data;
+        if (cropped) {
+            OffsetDetections(detections, region, width, height);
+        }
+        RememberDetections(detections);
     }
 
-    gst_buffer_unmap(buffer, &map);
+    // Release the GstBuffer before event handling and NATS publish
+    frame.reset();
 
     // DetectionEvent 생성
     DetectionEvent event;
     event.stream_id = stream_id_;
     event.timestamp = GetCurrentTimestampMs();
+    event.capture_timestamp = event_frame.capture_ms;
     event.frame_number = frame_count_.load();
     event.fps = current_fps_.load();
-    event.width = width;
-    event.height = height;
+    event.width = event_frame.report_width;
+    event.height = event_frame.report_height;
     event.detections = std::move(detections);
+    ScaleDetections(event.detections, width, height, event.width, event.height);
 
     // 이벤트 체크
     if (!event.detections.empty() && event_compositor_) {
         // ROI 이벤트 (각 detection에 event_setting_id 태깅)
-        event_compositor_->CheckEvents(event.detections, width, height);
+        event_compositor_->CheckEvents(event.detections, event.width, event.height);
 
         // ROI events 맵 생성 (event_id -> {status, labels}) - 복수 ROI 지원
         for (const auto& det : event.detections) {
@@ -884,7 +1898,7 @@ void StreamProcessor::ProcessDetections(GstBuffer* buffer) {
 
         // Line 이벤트 (키포인트 기반, status 0/1/2)
         auto line_results = event_compositor_->CheckLineEvents(
-            event.detections, width, height);
+            event.detections, event.width, event.height);
         for (auto& [event_id, result] : line_results) {
             event.events[event_id].status = result.status;
             event.events[event_id].labels = std::move(result.labels);
@@ -892,7 +1906,7 @@ void StreamProcessor::ProcessDetections(GstBuffer* buffer) {
 
         // AngleViolation 이벤트 (키포인트 벡터 vs 라인 각도, status 0/2)
         auto angle_results = event_compositor_->CheckAngleViolationEvents(
-            event.detections, width, height);
+            event.detections, event.width, event.height);
         for (auto& [event_id, result] : angle_results) {
             event.events[event_id].status = result.status;
             event.events[event_id].labels = std::move(result.labels);
@@ -901,7 +1915,7 @@ void StreamProcessor::ProcessDetections(GstBuffer* buffer) {
 
     // 이미지 포함 여부
     if (publish_images_) {
-        event.image_data = std::move(jpeg_data);
+        event.image_data = std::move(event_frame.jpeg);
     }
 
     // Detection이 있으면 시간 업데이트
@@ -909,6 +1923,8 @@ void StreamProcessor::ProcessDetections(GstBuffer* buffer) {
         last_detection_time_ = event.timestamp;
     }
 
+    MarkPublished(event);
+
     // NATS 발행 (모든 프레임, detection 유무 상관없이)
     if (nats_publisher_ && nats_publisher_->IsConnected()) {
         if (auto result = nats_publisher_->Publish(event); IsError(result)) {
@@ -925,7 +1941,123 @@ void StreamProcessor::ProcessDetections(GstBuffer* buffer) {
     }
 }
 
-void StreamProcessor::UpdateFps() {
+int64_t StreamProcessor::CaptureTimeMs(GstSample* sample, GstElement* sink) {
+    const int64_t now_ms = GetCurrentTimestampMs();
+    GstBuffer* buffer = gst_sample_get_buffer(sample);
+    if (!buffer) {
+        return now_ms;
+    }
+
+    // Camera capture time from the RTCP sender report (copied through depay/decode)
+    static GstCaps* const ntp_caps = gst_caps_new_empty_simple(kNtpTimestampCaps);
+    if (GstReferenceTimestampMeta* meta = gst_buffer_get_reference_timestamp_meta(buffer, ntp_caps)) {
+        return static_cast<int64_t>(meta->timestamp / GST_MSECOND) - kNtpToUnixEpochSeconds * 1000;
+    }
+
+    // No sender report yet: subtract the buffer's age by the pipeline clock
+    const GstSegment* segment = gst_sample_get_segment(sample);
+    GstClock* clock = gst_element_get_clock(sink);
+    if (!clock) {
+        return now_ms;
+    }
+    const GstClockTime clock_now = gst_clock_get_time(clock);
+    gst_object_unref(clock);
+
+    const GstClockTime base_time = gst_element_get_base_time(sink);
+    if (!segment || !GST_BUFFER_PTS_IS_VALID(buffer) || clock_now < base_time) {
+        return now_ms;
+    }
+
+    const GstClockTime running_now = clock_now - base_time;
+    const GstClockTime running_time = gst_segment_to_running_time(
+        segment, GST_FORMAT_TIME, GST_BUFFER_PTS(buffer));
+    if (!GST_CLOCK_TIME_IS_VALID(running_time) || running_time > running_now) {
+        return now_ms;
+    }
+    return now_ms - static_cast<int64_t>((running_now - running_time) / GST_MSECOND);
+}
+
+void StreamProcessor::MarkPublished(DetectionEvent& event) {
+    event.publish_timestamp = GetCurrentTimestampMs();
+    if (event.capture_timestamp > 0) {
+        publish_latency_.Record(event.publish_timestamp - event.capture_timestamp);
+    }
+}
+
+void StreamProcessor::StartFrameWorker() {
+    if (frame_worker_.joinable()) {
+        return;
+    }
+    frame_mailbox_.Open();
+    if (inference_scheduler_) {
+        inference_scheduler_->Resume(stream_id_);
+    }
+
+    const std::string snapshot_url = SnapshotUrl();
+    if (!snapshot_url.empty()) {
+        snapshot_stream_ = std::make_unique<SnapshotStream>(
+            BuildSnapshotPipelineString(), teardown_executor_);
+        LogInfo("Snapshot stream for " + stream_id_ + ": " + snapshot_url + " (on demand)");
+    }
+
+    std::promise<void> exited;
+    frame_worker_exited_ = exited.get_future().share();
+    frame_worker_ = std::thread([this, exited = std::move(exited)]() mutable {
+        FrameWorkerLoop();
+        exited.set_value();  // Last touch of `this`
+    });
+}
+
+std::thread StreamProcessor::StopFrameWorker() {
+    frame_mailbox_.Close();
+    // A frame waiting for its NPU turn would hold up the join for a whole deadline
+    if (inference_scheduler_) {
+        inference_scheduler_->Cancel(stream_id_);
+    }
+    return std::move(frame_worker_);
+}
+
+void StreamProcessor::WaitFrameWorkerExit() {
+    if (frame_worker_exited_.valid()) {
+        frame_worker_exited_.wait();
+    }
+}
+
+void StreamProcessor::FrameWorkerLoop() {
+    LogInfo("Frame worker started for " + stream_id_);
+
+    // Always processes the freshest frame; older ones were dropped by Put()
+    while (auto frame = frame_mailbox_.WaitTake()) {
+        if (stopping_.load(std::memory_order_acquire)) {
+            continue;
+        }
+        ApplyPendingPlacement();
+        const auto start = std::chrono::steady_clock::now();
+        ProcessDetections(*frame);
+        const double elapsed_ms = std::chrono::duration<double, std::milli>(
+            std::chrono::steady_clock::now() - start).count();
+
+        // Smoothed worker cost bounds the rate decode skipping asks for
+        const double prev_ms = process_ms_.load(std::memory_order_relaxed);
+        process_ms_.store(prev_ms > 0.0 ? prev_ms * 0.9 + elapsed_ms * 0.1 : elapsed_ms,
+                          std::memory_order_relaxed);
+    }
+
+    // Per-pipeline state only this thread used; the next Start() waits for us
+    if (batch_manager_) {
+        batch_manager_->UnregisterStream(stream_id_);
+        batch_manager_.reset();
+    }
+    frame_mailbox_.Clear();
+    snapshot_stream_.reset();
+    frame_geometry_.Reset();
+    preview_sink_ = nullptr;  // Unref'd by the teardown job that joins us
+
+    LogInfo("Frame worker stopped for " + stream_id_ + " (dropped " +
+            std::to_string(dropped_frames_.load()) + " frames)");
+}
+
+bool StreamProcessor::UpdateFps() {
     ++frames_since_last_update_;
 
     auto now = std::chrono::steady_clock::now();
@@ -937,7 +2069,73 @@ void StreamProcessor::UpdateFps() {
                       static_cast<double>(elapsed);
         frames_since_last_update_ = 0;
         last_fps_update_ = now;
+        return true;
+    }
+    return false;
+}
+
+void StreamProcessor::UpdateDecodeSkip() {
+    // Subscribers decimate independently; skipping for our demand would starve them
+    if (!config_.decode_skip || subscribers_.HasSubscribers()) {
+        decode_skip_.Reset();
+        decode_skip_fps_.store(0.0, std::memory_order_relaxed);
+        return;
+    }
+
+    // Rate the processor can use: decimation target, bounded by worker throughput
+    const double source_fps = current_fps_.load();
+    double demand_fps = source_fps;
+    if (config_.inference_fps > 0.0) {
+        demand_fps = std::min(demand_fps, config_.inference_fps);
+    }
+    if (config_.inference_every_n > 1) {
+        demand_fps = std::min(demand_fps, source_fps / config_.inference_every_n);
+    }
+    const double process_ms = process_ms_.load(std::memory_order_relaxed);
+    if (process_ms > 0.0) {
+        demand_fps = std::min(demand_fps, 1000.0 / process_ms);
+    }
+
+    if (decode_skip_.Update(source_fps, demand_fps)) {
+        if (decode_skip_.IsThrottling()) {
+            LogInfo("Decode skipping enabled for " + stream_id_ + ": " +
+                    std::to_string(decode_skip_.TargetFps()) + " of " +
+                    std::to_string(source_fps) + " fps");
+        } else {
+            LogInfo("Decode skipping disabled for " + stream_id_);
+        }
+    }
+    decode_skip_fps_.store(decode_skip_.TargetFps(), std::memory_order_relaxed);
+}
+
+void StreamProcessor::SendDecodeSkipQos(GstSample* sample, double target_fps) {
+    GstBuffer* buffer = gst_sample_get_buffer(sample);
+    const GstSegment* segment = gst_sample_get_segment(sample);
+    const double source_fps = current_fps_.load();
+    if (!appsink_pad_ || !buffer || !segment || !GST_BUFFER_PTS_IS_VALID(buffer) ||
+        source_fps <= target_fps) {
+        return;
+    }
+
+    const GstClockTime running_time = gst_segment_to_running_time(
+        segment, GST_FORMAT_TIME, GST_BUFFER_PTS(buffer));
+    if (!GST_CLOCK_TIME_IS_VALID(running_time)) {
+        return;
+    }
+
+    // GstVideoDecoder treats frames before timestamp + 2*diff + frame duration
+    // as late: non-reference frames are not decoded and the rest are dropped
+    // before videoconvert. Aim short of the next needed frame so decimation
+    // still has one to pick.
+    const double horizon_ns = kDecodeSkipHorizon * static_cast<double>(GST_SECOND) / target_fps;
+    const double frame_ns = static_cast<double>(GST_SECOND) / source_fps;
+    const auto diff = static_cast<GstClockTimeDiff>((horizon_ns - frame_ns) / 2.0);
+    if (diff <= 0) {
+        return;
     }
+
+    gst_pad_push_event(appsink_pad_, gst_event_new_qos(
+        GST_QOS_TYPE_UNDERFLOW, source_fps / target_fps, diff, running_time));
 }
 
 // ============================================================================
@@ -985,10 +2183,32 @@ GstFlowReturn StreamProcessor::OnNewSample(GstElement* sink, gpointer user_data)
         return GST_FLOW_EOS;
     }
 
-    // Skip frame if still processing previous one (keeps RTSP flowing at full rate)
-    bool expected = false;
-    if (!self->processing_frame_.compare_exchange_strong(expected, true)) {
-        // Already processing - pull and discard to keep pipeline flowing
+    // Frame counting and FPS are done on the decoder input (camera rate,
+    // before decode skipping and decimation); this tracks decoded output
+    const auto now = std::chrono::steady_clock::now();
+    self->last_frame_time_ = std::chrono::duration_cast<std::chrono::milliseconds>(
+        now.time_since_epoch()).count();
+    self->last_healthy_time_.store(self->last_frame_time_.load(std::memory_order_relaxed),
+                                   std::memory_order_relaxed);
+
+    // First frame after a reconnect: record blind time, stream is healthy again
+    if (self->reconnect_started_ms_.load(std::memory_order_relaxed) != 0) {
+        const int64_t started = self->reconnect_started_ms_.exchange(0);
+        if (started != 0) {
+            const int64_t ttff = self->last_frame_time_.load() - started;
+            self->last_reconnect_ttff_ms_ = ttff;
+            self->escalation_.Reset();
+            LogInfo("Stream " + self->stream_id_ + " first frame " +
+                    std::to_string(ttff) + " ms after reconnect");
+        }
+    }
+
+    // Inference rate decimation (inference_fps / inference_every_n);
+    // with subscribers the sample is still pulled for them
+    const bool process = self->inference_decimator_.ShouldProcess(
+        std::chrono::duration_cast<std::chrono::microseconds>(now.time_since_epoch()).count());
+    const bool shared = self->subscribers_.HasSubscribers();
+    if (!process && !shared) {
         GstSample* sample = gst_app_sink_pull_sample(GST_APP_SINK(sink));
         if (sample) gst_sample_unref(sample);
         return GST_FLOW_OK;
@@ -1000,24 +2220,68 @@ GstFlowReturn StreamProcessor::OnNewSample(GstElement* sink, gpointer user_data)
     // Double-check after incrementing counter
     if (self->stopping_.load(std::memory_order_acquire)) {
         self->active_callbacks_.fetch_sub(1, std::memory_order_relaxed);
-        self->processing_frame_.store(false, std::memory_order_release);
         return GST_FLOW_EOS;
     }
 
     GstSample* sample = gst_app_sink_pull_sample(GST_APP_SINK(sink));
     if (!sample) {
         self->active_callbacks_.fetch_sub(1, std::memory_order_relaxed);
-        self->processing_frame_.store(false, std::memory_order_release);
         return GST_FLOW_ERROR;
     }
 
-    GstBuffer* buffer = gst_sample_get_buffer(sample);
-    if (buffer) {
-        self->ProcessDetections(buffer);
+    // Resolved here: the sink's clock is not the worker's to read
+    const int64_t capture_ms = CaptureTimeMs(sample, sink);
+
+    // Shared decode: each subscriber decimates and queues its own reference
+    if (shared) {
+        self->FanOut(sample, capture_ms);
+    }
+    if (!process) {
+        gst_sample_unref(sample);
+        self->active_callbacks_.fetch_sub(1, std::memory_order_relaxed);
+        return GST_FLOW_OK;
+    }
+
+    const double decode_skip_fps = self->decode_skip_fps_.load(std::memory_order_relaxed);
+    if (decode_skip_fps > 0.0) {
+        self->SendDecodeSkipQos(sample, decode_skip_fps);
+    }
+
+    // Hand off to the frame worker; an unprocessed older frame is replaced
+    if (self->frame_mailbox_.Put(LatestMailbox<CapturedSample, CapturedSampleDeleter>::Ptr(
+            new CapturedSample{sample, capture_ms}))) {
+        self->dropped_frames_.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    self->active_callbacks_.fetch_sub(1, std::memory_order_relaxed);
+    return GST_FLOW_OK;
+}
+
+GstFlowReturn StreamProcessor::OnPreviewSample(GstElement* sink, gpointer user_data) {
+    auto* self = static_cast<StreamProcessor*>(user_data);
+
+    if (self->stopping_.load(std::memory_order_acquire)) {
+        return GST_FLOW_EOS;
+    }
+    self->active_callbacks_.fetch_add(1, std::memory_order_relaxed);
+    if (self->stopping_.load(std::memory_order_acquire)) {
+        self->active_callbacks_.fetch_sub(1, std::memory_order_relaxed);
+        return GST_FLOW_EOS;
+    }
+
+    // Map now and keep by PTS; the frame worker picks its pair without waiting
+    if (GstSample* sample = gst_app_sink_pull_sample(GST_APP_SINK(sink))) {
+        GstBuffer* buffer = gst_sample_get_buffer(sample);
+        const FrameGeometry* geometry = self->preview_geometry_.Get(gst_sample_get_caps(sample));
+        if (buffer && geometry) {
+            auto frame_result = FrameBuffer::FromSample(sample, *geometry);
+            if (IsOk(frame_result)) {
+                self->preview_ring_.Push(GST_BUFFER_PTS(buffer), GetValue(std::move(frame_result)));
+            }
+        }
+        gst_sample_unref(sample);
     }
 
-    gst_sample_unref(sample);
-    self->processing_frame_.store(false, std::memory_order_release);
     self->active_callbacks_.fetch_sub(1, std::memory_order_relaxed);
     return GST_FLOW_OK;
 }
@@ -1027,8 +2291,13 @@ gboolean StreamProcessor::OnBusMessage(
     GstMessage* msg,
     gpointer user_data) {
 
-    auto* self = static_cast<StreamProcessor*>(user_data);
+    // Runs under loop_guard_; messages of a pipeline stopped since are dropped
+    const auto* ticket = static_cast<const LoopTicket*>(user_data);
+    ticket->Run([msg](StreamProcessor& self) { HandleBusMessage(&self, msg); });
+    return TRUE;
+}
 
+void StreamProcessor::HandleBusMessage(StreamProcessor* self, GstMessage* msg) {
     switch (GST_MESSAGE_TYPE(msg)) {
         case GST_MESSAGE_ERROR: {
             GError* err = nullptr;
@@ -1041,26 +2310,17 @@ gboolean StreamProcessor::OnBusMessage(
             if (err) g_error_free(err);
             if (debug) g_free(debug);
 
-            // Stop pipeline and schedule reconnect
-            self->DestroyPipeline();
-            self->ScheduleReconnect();
+            self->RecoverFromFailure(error_msg, self->IsSourceMessage(msg));
             break;
         }
 
         case GST_MESSAGE_EOS: {
             LogInfo("Stream " + self->stream_id_ + " received EOS, reconnecting...");
-            // For looped RTSP: need full reconnect since RTSP connection is closed
-            self->reconnect_attempts_ = 0;  // Reset attempts for EOS (not an error)
-            self->DestroyPipeline();
-            // Quick reconnect for EOS (500ms delay)
-            g_timeout_add(500, [](gpointer user_data) -> gboolean {
-                auto* self = static_cast<StreamProcessor*>(user_data);
-                if (self->state_ != StreamState::kStopped) {
-                    self->Start();
-                    LogInfo("Stream " + self->stream_id_ + " reconnected after EOS");
-                }
-                return G_SOURCE_REMOVE;
-            }, self);
+            // Looped RTSP ends every pass: swap the source, or rebuild quickly
+            // (500ms). An EOS again before any frame escalates with backoff
+            // like an error, so a camera that keeps closing the session
+            // cannot restart in a tight loop
+            self->RecoverFromFailure("EOS", true, std::chrono::milliseconds(500));
             break;
         }
 
@@ -1069,10 +2329,15 @@ gboolean StreamProcessor::OnBusMessage(
                 GstState old_state, new_state, pending;
                 gst_message_parse_state_changed(msg, &old_state, &new_state, &pending);
 
-                if (new_state == GST_STATE_PLAYING &&
-                    self->state_ != StreamState::kRunning) {
-                    self->SetState(StreamState::kRunning);
-                    self->reconnect_attempts_ = 0;
+                if (new_state == GST_STATE_PLAYING) {
+                    if (self->reconnect_scheduler_) {
+                        self->reconnect_scheduler_->NotifyBuildComplete(self->stream_id_);
+                    }
+                    // Attempts are reset by the first frame, not here: a camera
+                    // can accept the session and drop it before sending one
+                    if (self->state_ != StreamState::kRunning) {
+                        self->SetState(StreamState::kRunning);
+                    }
                 }
             }
             break;
@@ -1095,10 +2360,9 @@ gboolean StreamProcessor::OnBusMessage(
         default:
             break;
     }
-
-    return TRUE;
 }
 
+#ifdef HAVE_HAILORT
 // Hailo NMS output format parser
 // NMS BY CLASS: for each class: [num_detections, bbox1, bbox2, ...]
 // bbox format: [y_min, x_min, y_max, x_max, score]
@@ -1275,30 +2539,106 @@ GstPadProbeReturn StreamProcessor::OnHailoProbe(
 
     return GST_PAD_PROBE_OK;
 }
+#endif  // HAVE_HAILORT
+
+void StreamProcessor::OnSourcePadAdded(
+    [[maybe_unused]] GstElement* src,
+    GstPad* pad,
+    gpointer user_data) {
 
-gboolean StreamProcessor::OnReconnectTimeout(gpointer user_data) {
     auto* self = static_cast<StreamProcessor*>(user_data);
-    self->reconnect_source_id_ = 0;
+    if (self->stopping_.load(std::memory_order_acquire) || !self->pipeline_) {
+        return;
+    }
 
-    LogInfo("Attempting reconnect for stream: " + self->stream_id_);
+    // Only the H.264 video stream goes to the depayloader
+    GstCaps* caps = gst_pad_get_current_caps(pad);
+    if (!caps) {
+        caps = gst_pad_query_caps(pad, nullptr);
+    }
+    bool is_video = false;
+    if (caps) {
+        const gchar* media = gst_structure_get_string(gst_caps_get_structure(caps, 0), "media");
+        is_video = media && std::string_view(media) == "video";
+        gst_caps_unref(caps);
+    }
+    if (!is_video) {
+        return;
+    }
 
-    if (auto result = self->Start(); IsError(result)) {
-        LogError("Reconnect failed: " + GetError(result));
-        self->ScheduleReconnect();
+    GstElement* depay = gst_bin_get_by_name(GST_BIN(self->pipeline_), "depay");
+    if (!depay) {
+        return;
     }
+    GstPad* sink = gst_element_get_static_pad(depay, "sink");
+    gst_object_unref(depay);
 
-    return G_SOURCE_REMOVE;
+    if (sink && !gst_pad_is_linked(sink)) {
+        if (GST_PAD_LINK_FAILED(gst_pad_link(pad, sink))) {
+            LogWarning("Soft restart: failed to link rtspsrc pad for " + self->stream_id_);
+        }
+    }
+    if (sink) gst_object_unref(sink);
+}
+
+GstPadProbeReturn StreamProcessor::OnSourceCapsProbe(
+    [[maybe_unused]] GstPad* pad,
+    GstPadProbeInfo* info,
+    gpointer user_data) {
+
+    auto* self = static_cast<StreamProcessor*>(user_data);
+
+    GstEvent* event = GST_PAD_PROBE_INFO_EVENT(info);
+    if (!event || GST_EVENT_TYPE(event) != GST_EVENT_CAPS) {
+        return GST_PAD_PROBE_OK;
+    }
+
+    GstCaps* caps = nullptr;
+    gst_event_parse_caps(event, &caps);
+    if (caps) {
+        int width = 0;
+        int height = 0;
+        GstStructure* structure = gst_caps_get_structure(caps, 0);
+        gst_structure_get_int(structure, "width", &width);
+        gst_structure_get_int(structure, "height", &height);
+        if (width > 0 && height > 0) {
+            self->source_width_.store(width, std::memory_order_relaxed);
+            self->source_height_.store(height, std::memory_order_relaxed);
+        }
+    }
+
+    return GST_PAD_PROBE_OK;
+}
+
+GstPadProbeReturn StreamProcessor::OnDecoderInputProbe(
+    [[maybe_unused]] GstPad* pad,
+    [[maybe_unused]] GstPadProbeInfo* info,
+    gpointer user_data) {
+
+    auto* self = static_cast<StreamProcessor*>(user_data);
+    ++self->frame_count_;
+    if (self->UpdateFps()) {
+        self->UpdateDecodeSkip();
+    }
+    return GST_PAD_PROBE_OK;
 }
 
 // ============================================================================
 // Batch Inference Callback
 // ============================================================================
 
+void StreamProcessor::RememberDetections(const std::vector<Detection>& detections) {
+    if (!motion_gate_ || !config_.motion_republish) {
+        return;
+    }
+    std::lock_guard<std::mutex> lock(motion_mutex_);
+    last_inferred_detections_ = detections;
+}
+
 void StreamProcessor::OnBatchResult(
     const std::string& stream_id,
     std::vector<Detection> detections,
-    const std::vector<uint8_t>& jpeg_data,
-    int width, int height) {
+    const EventFrame& frame) {
 
     // This is called from batch manager worker thread
     // Handle detection event publishing and callbacks
@@ -1307,16 +2647,18 @@ void StreamProcessor::OnBatchResult(
     DetectionEvent event;
     event.stream_id = stream_id;
     event.timestamp = GetCurrentTimestampMs();
+    event.capture_timestamp = frame.capture_ms;
     event.frame_number = frame_count_.load();
     event.fps = current_fps_.load();
-    event.width = width;
-    event.height = height;
+    event.width = frame.report_width;
+    event.height = frame.report_height;
     event.detections = std::move(detections);
+    ScaleDetections(event.detections, frame.width, frame.height, event.width, event.height);
 
     // 이벤트 체크
     if (!event.detections.empty() && event_compositor_) {
         // ROI 이벤트 (각 detection에 event_setting_id 태깅)
-        event_compositor_->CheckEvents(event.detections, width, height);
+        event_compositor_->CheckEvents(event.detections, event.width, event.height);
 
         // ROI events 맵 생성 (event_id -> {status, labels}) - 복수 ROI 지원
         for (const auto& det : event.detections) {
@@ -1329,7 +2671,7 @@ void StreamProcessor::OnBatchResult(
 
         // Line 이벤트 (키포인트 기반, status 0/1/2)
         auto line_results = event_compositor_->CheckLineEvents(
-            event.detections, width, height);
+            event.detections, event.width, event.height);
         for (auto& [event_id, result] : line_results) {
             event.events[event_id].status = result.status;
             event.events[event_id].labels = std::move(result.labels);
@@ -1337,7 +2679,7 @@ void StreamProcessor::OnBatchResult(
 
         // AngleViolation 이벤트 (키포인트 벡터 vs 라인 각도, status 0/2)
         auto angle_results = event_compositor_->CheckAngleViolationEvents(
-            event.detections, width, height);
+            event.detections, event.width, event.height);
         for (auto& [event_id, result] : angle_results) {
             event.events[event_id].status = result.status;
             event.events[event_id].labels = std::move(result.labels);
@@ -1346,7 +2688,7 @@ void StreamProcessor::OnBatchResult(
 
     // 이미지 포함 여부
     if (publish_images_) {
-        event.image_data = jpeg_data;
+        event.image_data = frame.jpeg;
     }
 
     // Detection이 있으면 시간 업데이트
@@ -1354,6 +2696,8 @@ void StreamProcessor::OnBatchResult(
         last_detection_time_ = event.timestamp;
     }
 
+    MarkPublished(event);
+
     // NATS 발행
     if (nats_publisher_ && nats_publisher_->IsConnected()) {
         if (auto result = nats_publisher_->Publish(event); IsError(result)) {
@@ -0,0 +1,272 @@
+#include "teardown_executor.h"
+
+#include <algorithm>
+
+namespace stream_daemon {
+
+struct TeardownExecutor::State {
+    struct Task {
+        std::string label;
+        Job job;
+        std::chrono::steady_clock::time_point submit_time;
+    };
+
+    struct Slot {
+        bool busy{false};
+        bool retired{false};
+        bool cap_logged{false};
+        std::chrono::steady_clock::time_point busy_since;
+        std::string label;
+    };
+
+    explicit State(std::chrono::milliseconds timeout) : job_timeout(timeout) {}
+
+    const std::chrono::milliseconds job_timeout;
+
+    std::mutex mutex;
+    std::condition_variable queue_cv;       // Queue changed or stopping
+    std::condition_variable supervisor_cv;  // Wakes the supervisor (stop)
+    std::condition_variable idle_cv;        // A worker exited or was retired
+
+    std::deque<Task> queue;
+    std::map<uint64_t, Slot> slots;         // Live workers, retired ones included
+    uint64_t next_id{0};
+    bool running{false};
+    bool supervising{false};
+    TeardownStats stats;
+};
+
+TeardownExecutor::TeardownExecutor(int num_workers, std::chrono::milliseconds job_timeout,
+                                   size_t max_pending, size_t max_wedged)
+    : num_workers_(std::max(1, num_workers)),
+      job_timeout_(job_timeout),
+      max_pending_(std::max<size_t>(1, max_pending)),
+      max_wedged_(max_wedged),
+      state_(std::make_shared<State>(job_timeout)) {}
+
+TeardownExecutor::~TeardownExecutor() {
+    Stop();
+}
+
+void TeardownExecutor::Start() {
+    {
+        std::lock_guard<std::mutex> lock(state_->mutex);
+        if (state_->running) {
+            return;
+        }
+        state_->running = true;
+        state_->supervising = true;
+        for (int i = 0; i < num_workers_; ++i) {
+            SpawnWorkerLocked();
+        }
+    }
+    supervisor_ = std::thread(&TeardownExecutor::SuperviseLoop, this);
+
+    LogInfo("TeardownExecutor started with " + std::to_string(num_workers_) +
+            " workers, timeout=" + std::to_string(job_timeout_.count()) + "ms, max pending=" +
+            std::to_string(max_pending_) + ", max wedged=" + std::to_string(max_wedged_));
+}
+
+void TeardownExecutor::Stop() {
+    std::map<uint64_t, std::thread> workers;
+    {
+        std::unique_lock<std::mutex> lock(state_->mutex);
+        if (!state_->running) {
+            return;
+        }
+        state_->running = false;
+        state_->queue_cv.notify_all();
+
+        // Workers drain the queue before exiting (pipelines must still be
+        // released); the supervisor keeps retiring stuck ones meanwhile
+        state_->idle_cv.wait(lock, [this] {
+            return std::none_of(state_->slots.begin(), state_->slots.end(),
+                                [](const auto& entry) { return !entry.second.retired; });
+        });
+        state_->supervising = false;
+        workers.swap(workers_);
+    }
+    state_->supervisor_cv.notify_all();
+    if (supervisor_.joinable()) {
+        supervisor_.join();
+    }
+
+    // Exited (or about to): their slots are gone
+    for (auto& [id, worker] : workers) {
+        if (worker.joinable()) {
+            worker.join();
+        }
+    }
+
+    const auto stats = GetStats();
+    LogInfo("TeardownExecutor stopped (completed=" + std::to_string(stats.completed) +
+            ", timed_out=" + std::to_string(stats.timed_out) +
+            ", abandoned=" + std::to_string(stats.abandoned) + ")");
+}
+
+bool TeardownExecutor::IsRunning() const {
+    std::lock_guard<std::mutex> lock(state_->mutex);
+    return state_->running;
+}
+
+bool TeardownExecutor::Submit(std::string label, Job job) {
+    {
+        std::lock_guard<std::mutex> lock(state_->mutex);
+        if (!state_->running) {
+            return false;
+        }
+        if (state_->queue.size() >= max_pending_) {
+            ++state_->stats.rejected;
+            LogError("Teardown queue full (" + std::to_string(state_->queue.size()) +
+                     " pending), refusing " + label);
+            return false;
+        }
+        state_->queue.push_back({std::move(label), std::move(job), std::chrono::steady_clock::now()});
+        state_->stats.pending = state_->queue.size();
+        state_->stats.peak_pending = std::max(state_->stats.peak_pending, state_->stats.pending);
+    }
+    state_->queue_cv.notify_one();
+    return true;
+}
+
+bool TeardownExecutor::SubmitOrSpawn(const std::shared_ptr<TeardownExecutor>& executor,
+                                     std::string label, Job job) {
+    if (executor) {
+        if (executor->Submit(label, job)) {
+            return true;
+        }
+        if (executor->IsRunning()) {
+            LogError("Teardown " + label + " dropped, its resources are leaked");
+            return false;
+        }
+    }
+    std::thread([job = std::move(job)]() {
+        job(std::chrono::milliseconds(kDefaultTeardownTimeoutMs));
+    }).detach();
+    return true;
+}
+
+TeardownStats TeardownExecutor::GetStats() const {
+    std::lock_guard<std::mutex> lock(state_->mutex);
+    return state_->stats;
+}
+
+void TeardownExecutor::SpawnWorkerLocked() {
+    const uint64_t id = state_->next_id++;
+    state_->slots.emplace(id, State::Slot{});
+    workers_.emplace(id, std::thread(&TeardownExecutor::WorkerLoop, state_, id));
+}
+
+void TeardownExecutor::WorkerLoop(std::shared_ptr<State> state, uint64_t id) {
+    while (true) {
+        State::Task task;
+        {
+            std::unique_lock<std::mutex> lock(state->mutex);
+            state->queue_cv.wait(lock, [&] { return !state->running || !state->queue.empty(); });
+
+            if (state->queue.empty()) {
+                state->slots.erase(id);  // Stopped and drained
+                state->idle_cv.notify_all();
+                return;
+            }
+
+            task = std::move(state->queue.front());
+            state->queue.pop_front();
+            state->stats.pending = state->queue.size();
+            ++state->stats.active;
+
+            State::Slot& slot = state->slots[id];
+            slot.busy = true;
+            slot.busy_since = std::chrono::steady_clock::now();
+            slot.label = task.label;
+        }
+
+        const auto start = std::chrono::steady_clock::now();
+        const auto queued_ms = std::chrono::duration_cast<std::chrono::milliseconds>(
+            start - task.submit_time).count();
+
+        task.job(state->job_timeout);
+        task.job = nullptr;  // Release captures before reporting
+
+        const auto duration_ms = std::chrono::duration_cast<std::chrono::milliseconds>(
+            std::chrono::steady_clock::now() - start).count();
+        const bool timed_out = duration_ms > state->job_timeout.count();
+
+        std::lock_guard<std::mutex> lock(state->mutex);
+        State::Slot& slot = state->slots[id];
+        slot.busy = false;
+        if (timed_out) {
+            ++state->stats.timed_out;
+        }
+        state->stats.last_duration_ms = duration_ms;
+        state->stats.max_duration_ms = std::max(state->stats.max_duration_ms,
+                                                static_cast<int64_t>(duration_ms));
+
+        if (slot.retired) {
+            // Replaced meanwhile: this thread was detached and now just exits
+            LogWarning("Teardown " + task.label + " returned after " +
+                       std::to_string(duration_ms) + "ms, retired worker exiting");
+            --state->stats.wedged;
+            state->slots.erase(id);
+            state->idle_cv.notify_all();
+            return;
+        }
+
+        if (timed_out) {
+            LogWarning("Teardown " + task.label + " took " + std::to_string(duration_ms) +
+                       "ms (timeout " + std::to_string(state->job_timeout.count()) +
+                       "ms, queued " + std::to_string(queued_ms) + "ms)");
+        }
+        --state->stats.active;
+        ++state->stats.completed;
+    }
+}
+
+void TeardownExecutor::SuperviseLoop() {
+    const auto wedged_after = job_timeout_ * 2;
+    const auto interval = std::max(std::chrono::milliseconds(1), job_timeout_ / 2);
+
+    std::unique_lock<std::mutex> lock(state_->mutex);
+    while (state_->supervising) {
+        state_->supervisor_cv.wait_for(lock, interval);
+
+        const auto now = std::chrono::steady_clock::now();
+        for (auto& [id, slot] : state_->slots) {
+            if (!slot.busy || slot.retired || now - slot.busy_since < wedged_after) {
+                continue;
+            }
+
+            // At the cap queued jobs wait; shutdown lets every stuck worker go
+            if (state_->running && state_->stats.wedged >= max_wedged_) {
+                if (!slot.cap_logged) {
+                    slot.cap_logged = true;
+                    LogError("Teardown " + slot.label + " blocked, " +
+                             std::to_string(state_->stats.wedged) +
+                             " workers already wedged: queued teardowns wait");
+                }
+                continue;
+            }
+
+            const auto busy_ms = std::chrono::duration_cast<std::chrono::milliseconds>(
+                now - slot.busy_since).count();
+            LogError("Teardown " + slot.label + " still blocked after " +
+                     std::to_string(busy_ms) + "ms, retiring its worker");
+            slot.retired = true;
+            --state_->stats.active;
+            ++state_->stats.abandoned;
+            ++state_->stats.wedged;
+
+            auto worker = workers_.find(id);
+            if (worker != workers_.end()) {
+                worker->second.detach();
+                workers_.erase(worker);
+            }
+            if (state_->running) {
+                SpawnWorkerLocked();
+            }
+            state_->idle_cv.notify_all();
+        }
+    }
+}
+
+}  // namespace stream_daemon
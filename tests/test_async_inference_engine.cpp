@@ -0,0 +1,232 @@
+#include <gtest/gtest.h>
+
+#include "async_inference_engine.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace stream_daemon {
+namespace testing {
+
+namespace {
+
+constexpr size_t kInputSize = 16;
+const std::vector<size_t> kOutputSizes = {8, 4};
+
+// FIFO device: output k of a frame is filled with input[0] + k after the
+// frame's latency; tracks how many frames were on it at once
+class SimulatedDevice {
+public:
+    explicit SimulatedDevice(std::chrono::milliseconds latency) : latency_(latency) {}
+
+    AsyncInferenceEngine::DeviceIo Io() {
+        AsyncInferenceEngine::DeviceIo io;
+        io.write = [this](const uint8_t* data, size_t size) { return Write(data, size); };
+        io.read = [this](size_t index, uint8_t* data, size_t size) {
+            return Read(index, data, size);
+        };
+        return io;
+    }
+
+    void FailNextWrite() { fail_next_write_ = true; }
+
+    int GetMaxOnDevice() const { return max_on_device_.load(); }
+    int GetWrites() const { return writes_.load(); }
+
+private:
+    struct Frame {
+        uint8_t value;
+        std::chrono::steady_clock::time_point ready;
+    };
+
+    VoidResult Write(const uint8_t* data, size_t size) {
+        if (size != kInputSize) {
+            return MakeError("bad input size");
+        }
+        if (fail_next_write_.exchange(false)) {
+            return MakeError("simulated write failure");
+        }
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            frames_.push_back({data[0], std::chrono::steady_clock::now() + latency_});
+            max_on_device_ = std::max(max_on_device_.load(), static_cast<int>(frames_.size()));
+        }
+        ++writes_;
+        cv_.notify_all();
+        return MakeOk();
+    }
+
+    VoidResult Read(size_t index, uint8_t* data, size_t size) {
+        std::unique_lock<std::mutex> lock(mutex_);
+        cv_.wait(lock, [this] { return !frames_.empty(); });
+        const Frame frame = frames_.front();
+        lock.unlock();
+        std::this_thread::sleep_until(frame.ready);
+        lock.lock();
+
+        std::fill(data, data + size, static_cast<uint8_t>(frame.value + index));
+        if (index + 1 == kOutputSizes.size()) {
+            frames_.pop_front();
+        }
+        return MakeOk();
+    }
+
+    const std::chrono::milliseconds latency_;
+    std::mutex mutex_;
+    std::condition_variable cv_;
+    std::deque<Frame> frames_;
+    std::atomic<bool> fail_next_write_{false};
+    std::atomic<int> max_on_device_{0};
+    std::atomic<int> writes_{0};
+};
+
+std::vector<uint8_t> MakeInput(uint8_t value) {
+    return std::vector<uint8_t>(kInputSize, value);
+}
+
+}  // namespace
+
+// ============================================================================
+// AsyncInferenceEngine Tests
+// ============================================================================
+
+TEST(AsyncInferenceEngineTest, ReturnsOutputsOfEachFrame) {
+    SimulatedDevice device(std::chrono::milliseconds(0));
+    AsyncInferenceEngine engine(device.Io(), kInputSize, kOutputSizes, 2);
+
+    const auto input = MakeInput(40);
+    auto result = engine.Submit(input.data()).get();
+    ASSERT_TRUE(IsOk(result)) << GetError(result);
+
+    const auto& outputs = *GetValue(result);
+    ASSERT_EQ(outputs.size(), 2u);
+    EXPECT_EQ(outputs[0], std::vector<uint8_t>(8, 40));
+    EXPECT_EQ(outputs[1], std::vector<uint8_t>(4, 41));
+}
+
+TEST(AsyncInferenceEngineTest, KeepsFramesInFlightInOrder) {
+    SimulatedDevice device(std::chrono::milliseconds(20));
+    AsyncInferenceEngine engine(device.Io(), kInputSize, kOutputSizes, 3);
+    EXPECT_EQ(engine.GetMaxInFlight(), 3);
+
+    std::vector<std::vector<uint8_t>> inputs;
+    for (int i = 0; i < 8; ++i) {
+        inputs.push_back(MakeInput(static_cast<uint8_t>(i * 10)));
+    }
+    std::vector<std::future<Result<AsyncInferenceEngine::Outputs>>> futures;
+    for (const auto& input : inputs) {
+        futures.push_back(engine.Submit(input.data()));
+    }
+
+    for (size_t i = 0; i < futures.size(); ++i) {
+        auto result = futures[i].get();
+        ASSERT_TRUE(IsOk(result));
+        EXPECT_EQ((*GetValue(result))[0][0], inputs[i][0]) << "frame " << i;
+    }
+
+    // The writer ran ahead of the 20ms reads, but never past the limit
+    EXPECT_GE(device.GetMaxOnDevice(), 2);
+    EXPECT_LE(device.GetMaxOnDevice(), 3);
+    EXPECT_EQ(engine.GetInFlight(), 0);
+}
+
+TEST(AsyncInferenceEngineTest, CompletionCallbackAndInputRelease) {
+    SimulatedDevice device(std::chrono::milliseconds(0));
+    AsyncInferenceEngine engine(device.Io(), kInputSize, kOutputSizes, 2);
+
+    auto input = std::make_shared<std::vector<uint8_t>>(MakeInput(7));
+    std::weak_ptr<std::vector<uint8_t>> watch = input;
+
+    std::promise<int> done;
+    engine.Submit(input->data(), input, [&](Result<AsyncInferenceEngine::Outputs> result) {
+        done.set_value(IsOk(result) ? (*GetValue(result))[1][0] : -1);
+    });
+    input.reset();
+
+    EXPECT_EQ(done.get_future().get(), 8);
+    EXPECT_TRUE(watch.expired());
+}
+
+TEST(AsyncInferenceEngineTest, WriteFailureCompletesWithError) {
+    SimulatedDevice device(std::chrono::milliseconds(0));
+    AsyncInferenceEngine engine(device.Io(), kInputSize, kOutputSizes, 2);
+
+    device.FailNextWrite();
+    const auto first = MakeInput(1);
+    const auto second = MakeInput(2);
+    auto failed = engine.Submit(first.data());
+    auto ok = engine.Submit(second.data());
+
+    EXPECT_TRUE(IsError(failed.get()));
+    auto result = ok.get();
+    ASSERT_TRUE(IsOk(result));
+    EXPECT_EQ((*GetValue(result))[0][0], 2);
+}
+
+TEST(AsyncInferenceEngineTest, OutputBuffersAreReused) {
+    SimulatedDevice device(std::chrono::milliseconds(0));
+    AsyncInferenceEngine engine(device.Io(), kInputSize, kOutputSizes, 1);
+
+    const auto input = MakeInput(3);
+    auto first = engine.Submit(input.data()).get();
+    ASSERT_TRUE(IsOk(first));
+    const auto* buffers = GetValue(first).get();
+    first = MakeErrorT<AsyncInferenceEngine::Outputs>("released");
+
+    auto second = engine.Submit(input.data()).get();
+    ASSERT_TRUE(IsOk(second));
+    EXPECT_EQ(GetValue(second).get(), buffers);
+}
+
+TEST(AsyncInferenceEngineTest, BusyTimeCountsOnlyFramesOnDevice) {
+    SimulatedDevice device(std::chrono::milliseconds(20));
+    AsyncInferenceEngine engine(device.Io(), kInputSize, kOutputSizes, 2);
+    EXPECT_EQ(engine.GetBusyTime(), std::chrono::steady_clock::duration::zero());
+
+    const auto input = MakeInput(4);
+    for (int i = 0; i < 3; ++i) {
+        ASSERT_TRUE(IsOk(engine.Submit(input.data()).get()));
+    }
+    const auto busy = engine.GetBusyTime();
+    EXPECT_GE(busy, std::chrono::milliseconds(55));
+    EXPECT_LT(busy, std::chrono::milliseconds(500));
+
+    // Idle time is not busy time
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    EXPECT_EQ(engine.GetBusyTime(), busy);
+}
+
+TEST(AsyncInferenceEngineTest, StopDrainsDeviceAndFailsQueued) {
+    SimulatedDevice device(std::chrono::milliseconds(30));
+    AsyncInferenceEngine engine(device.Io(), kInputSize, kOutputSizes, 1);
+
+    const auto input = MakeInput(5);
+    std::vector<std::future<Result<AsyncInferenceEngine::Outputs>>> futures;
+    for (int i = 0; i < 4; ++i) {
+        futures.push_back(engine.Submit(input.data()));
+    }
+    // Let the first frame reach the device
+    while (device.GetWrites() == 0) {
+        std::this_thread::yield();
+    }
+    engine.Stop();
+
+    EXPECT_TRUE(IsOk(futures[0].get()));
+    int failed = 0;
+    for (size_t i = 1; i < futures.size(); ++i) {
+        failed += IsError(futures[i].get()) ? 1 : 0;
+    }
+    EXPECT_EQ(failed + device.GetWrites(), 4);
+
+    // Submissions after Stop fail immediately
+    EXPECT_TRUE(IsError(engine.Submit(input.data()).get()));
+}
+
+}  // namespace testing
+}  // namespace stream_daemon
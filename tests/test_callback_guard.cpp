@@ -0,0 +1,102 @@
+#include <gtest/gtest.h>
+
+#include "callback_guard.h"
+
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <thread>
+
+namespace stream_daemon {
+namespace testing {
+
+using namespace std::chrono_literals;
+
+namespace {
+
+struct Owner {
+    int calls{0};
+    CallbackGuard<Owner> guard{this};
+};
+
+}  // namespace
+
+// ============================================================================
+// CallbackGuard Tests
+// ============================================================================
+
+TEST(CallbackGuardTest, TicketRunsOnLiveOwner) {
+    Owner owner;
+    auto ticket = owner.guard.Issue();
+
+    EXPECT_TRUE(ticket.Run([](Owner& o) { ++o.calls; }));
+    EXPECT_TRUE(ticket.Run([](Owner& o) { ++o.calls; }));
+    EXPECT_EQ(owner.calls, 2);
+}
+
+TEST(CallbackGuardTest, InvalidateDropsEarlierTickets) {
+    Owner owner;
+    auto stale = owner.guard.Issue();
+    owner.guard.Invalidate();
+    auto fresh = owner.guard.Issue();
+
+    EXPECT_FALSE(stale.Run([](Owner& o) { ++o.calls; }));
+    EXPECT_TRUE(fresh.Run([](Owner& o) { ++o.calls; }));
+    EXPECT_EQ(owner.calls, 1);
+}
+
+TEST(CallbackGuardTest, TicketOutlivesOwner) {
+    CallbackGuard<Owner>::Ticket ticket;
+    EXPECT_FALSE(ticket.Run([](Owner&) {}));  // Default ticket is empty
+
+    {
+        auto owner = std::make_unique<Owner>();
+        ticket = owner->guard.Issue();
+    }
+    EXPECT_FALSE(ticket.Run([](Owner& o) { ++o.calls; }));
+}
+
+TEST(CallbackGuardTest, DetachWaitsForRunningCallback) {
+    auto owner = std::make_unique<Owner>();
+    auto ticket = owner->guard.Issue();
+
+    std::atomic<bool> entered{false};
+    std::atomic<bool> finished{false};
+    std::thread callback([&]() {
+        ticket.Run([&](Owner& o) {
+            entered = true;
+            std::this_thread::sleep_for(50ms);
+            ++o.calls;
+            finished = true;
+        });
+    });
+
+    while (!entered) {
+        std::this_thread::yield();
+    }
+    owner->guard.Detach();
+    EXPECT_TRUE(finished.load());
+    EXPECT_EQ(owner->calls, 1);
+
+    callback.join();
+    owner.reset();
+}
+
+TEST(CallbackGuardTest, LockExcludesCallbacks) {
+    Owner owner;
+    auto ticket = owner.guard.Issue();
+
+    std::atomic<bool> ran{false};
+    std::thread callback;
+    {
+        auto lock = owner.guard.Lock();
+        callback = std::thread([&]() { ticket.Run([&](Owner&) { ran = true; }); });
+        std::this_thread::sleep_for(30ms);
+        EXPECT_FALSE(ran.load());
+    }
+    callback.join();
+    EXPECT_TRUE(ran.load());
+}
+
+}  // namespace testing
+}  // namespace stream_daemon
@@ -109,6 +109,14 @@ TEST(StreamInfoTest, DefaultConstruction) {
     EXPECT_EQ(info.config.width, kDefaultWidth);
 }
 
+TEST(StreamInfoTest, UrlUpdateKeepsReplacesOrClears) {
+    const std::string current = "rtsp://cam/sub";
+    EXPECT_EQ(ResolveUrlUpdate(current, ""), current);
+    EXPECT_EQ(ResolveUrlUpdate(current, "rtsp://cam/sub2"), "rtsp://cam/sub2");
+    EXPECT_TRUE(ResolveUrlUpdate(current, std::string(kClearUrl)).empty());
+    EXPECT_TRUE(ResolveUrlUpdate("", std::string(kClearUrl)).empty());
+}
+
 TEST(StreamStatusTest, DefaultConstruction) {
     StreamStatus status;
     EXPECT_TRUE(status.stream_id.empty());
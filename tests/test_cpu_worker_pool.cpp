@@ -0,0 +1,83 @@
+#include <gtest/gtest.h>
+
+#include "cpu_worker_pool.h"
+
+#include <atomic>
+#include <mutex>
+#include <set>
+#include <thread>
+#include <vector>
+
+namespace stream_daemon {
+namespace testing {
+
+// ============================================================================
+// CpuWorkerPool Tests
+// ============================================================================
+
+TEST(CpuWorkerPoolTest, RunsEveryIndexOnce) {
+    CpuWorkerPool pool(3);
+    EXPECT_EQ(pool.GetConcurrency(), 4);
+
+    std::vector<std::atomic<int>> hits(100);
+    pool.ParallelFor(100, [&](int i) { ++hits[i]; });
+
+    for (const auto& hit : hits) {
+        EXPECT_EQ(hit.load(), 1);
+    }
+}
+
+TEST(CpuWorkerPoolTest, NoWorkersRunsInline) {
+    CpuWorkerPool pool(0);
+    EXPECT_EQ(pool.GetConcurrency(), 1);
+
+    const auto caller = std::this_thread::get_id();
+    int runs = 0;
+    pool.ParallelFor(5, [&](int) {
+        EXPECT_EQ(std::this_thread::get_id(), caller);
+        ++runs;
+    });
+    EXPECT_EQ(runs, 5);
+
+    pool.ParallelFor(0, [&](int) { ++runs; });
+    EXPECT_EQ(runs, 5);
+}
+
+TEST(CpuWorkerPoolTest, UsesWorkerThreads) {
+    CpuWorkerPool pool(3);
+
+    // Each index waits until all four run at once, so none may be serialized
+    std::atomic<int> arrived{0};
+    std::mutex ids_mutex;
+    std::set<std::thread::id> ids;
+    pool.ParallelFor(4, [&](int) {
+        ++arrived;
+        while (arrived.load() < 4) {
+            std::this_thread::yield();
+        }
+        std::lock_guard<std::mutex> lock(ids_mutex);
+        ids.insert(std::this_thread::get_id());
+    });
+    EXPECT_EQ(ids.size(), 4u);
+}
+
+TEST(CpuWorkerPoolTest, ConcurrentCallersComplete) {
+    CpuWorkerPool pool(2);
+
+    std::atomic<int> total{0};
+    std::vector<std::thread> callers;
+    for (int c = 0; c < 4; ++c) {
+        callers.emplace_back([&] {
+            for (int round = 0; round < 50; ++round) {
+                pool.ParallelFor(8, [&](int) { ++total; });
+            }
+        });
+    }
+    for (auto& caller : callers) {
+        caller.join();
+    }
+    EXPECT_EQ(total.load(), 4 * 50 * 8);
+}
+
+}  // namespace testing
+}  // namespace stream_daemon
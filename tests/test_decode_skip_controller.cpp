@@ -0,0 +1,88 @@
+#include <gtest/gtest.h>
+
+#include "decode_skip_controller.h"
+
+namespace stream_daemon {
+namespace testing {
+
+// ============================================================================
+// DecodeSkipController Tests
+// ============================================================================
+
+TEST(DecodeSkipControllerTest, StartsDisabled) {
+    DecodeSkipController controller;
+    EXPECT_FALSE(controller.IsThrottling());
+    EXPECT_DOUBLE_EQ(controller.TargetFps(), 0.0);
+}
+
+TEST(DecodeSkipControllerTest, NoThrottleWhenDemandMatchesSource) {
+    DecodeSkipController controller;
+    for (int i = 0; i < 10; ++i) {
+        EXPECT_FALSE(controller.Update(30.0, 30.0));
+    }
+    EXPECT_FALSE(controller.IsThrottling());
+}
+
+TEST(DecodeSkipControllerTest, EngagesAfterConsecutiveWindows) {
+    DecodeSkipController controller;  // 3 windows by default
+
+    EXPECT_FALSE(controller.Update(30.0, 5.0));
+    EXPECT_FALSE(controller.Update(30.0, 5.0));
+    EXPECT_TRUE(controller.Update(30.0, 5.0));
+
+    EXPECT_TRUE(controller.IsThrottling());
+    EXPECT_DOUBLE_EQ(controller.TargetFps(), 5.0);
+}
+
+TEST(DecodeSkipControllerTest, InterruptedStreakDoesNotEngage) {
+    DecodeSkipController controller;
+
+    controller.Update(30.0, 5.0);
+    controller.Update(30.0, 5.0);
+    controller.Update(30.0, 30.0);  // Back to normal resets the streak
+    controller.Update(30.0, 5.0);
+    EXPECT_FALSE(controller.Update(30.0, 5.0));
+    EXPECT_FALSE(controller.IsThrottling());
+}
+
+TEST(DecodeSkipControllerTest, HysteresisBand) {
+    DecodeSkipController controller({0.6, 0.85, 1});
+
+    // 0.7 is between engage and release: stays off
+    EXPECT_FALSE(controller.Update(30.0, 21.0));
+    EXPECT_FALSE(controller.IsThrottling());
+
+    EXPECT_TRUE(controller.Update(30.0, 10.0));
+    EXPECT_TRUE(controller.IsThrottling());
+
+    // 0.7 again: stays on, target follows demand
+    EXPECT_FALSE(controller.Update(30.0, 21.0));
+    EXPECT_TRUE(controller.IsThrottling());
+    EXPECT_DOUBLE_EQ(controller.TargetFps(), 21.0);
+
+    EXPECT_TRUE(controller.Update(30.0, 27.0));
+    EXPECT_FALSE(controller.IsThrottling());
+    EXPECT_DOUBLE_EQ(controller.TargetFps(), 0.0);
+}
+
+TEST(DecodeSkipControllerTest, IgnoresWindowWithoutFrames) {
+    DecodeSkipController controller({0.6, 0.85, 1});
+    EXPECT_TRUE(controller.Update(30.0, 5.0));
+
+    // Source stalled: keep the current state
+    EXPECT_FALSE(controller.Update(0.0, 0.0));
+    EXPECT_TRUE(controller.IsThrottling());
+}
+
+TEST(DecodeSkipControllerTest, ResetDisables) {
+    DecodeSkipController controller({0.6, 0.85, 1});
+    controller.Update(30.0, 5.0);
+    ASSERT_TRUE(controller.IsThrottling());
+
+    controller.Reset();
+    EXPECT_FALSE(controller.IsThrottling());
+    EXPECT_DOUBLE_EQ(controller.TargetFps(), 0.0);
+}
+
+}  // namespace testing
+}  // namespace stream_daemon
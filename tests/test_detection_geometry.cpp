@@ -0,0 +1,178 @@
+#include <gtest/gtest.h>
+
+#include "detection_geometry.h"
+
+namespace stream_daemon {
+namespace testing {
+
+namespace {
+
+Detection MakeDetection(int x, int y, int w, int h) {
+    Detection det;
+    det.bbox = {x, y, w, h};
+    det.keypoints.push_back({0.25f, 0.5f, 1.0f});
+    return det;
+}
+
+}  // namespace
+
+// ============================================================================
+// ScaleDetections Tests
+// ============================================================================
+
+TEST(ScaleDetectionsTest, SubstreamToMainStream) {
+    std::vector<Detection> dets{MakeDetection(64, 36, 128, 72)};
+    ScaleDetections(dets, 640, 360, 3840, 2160);
+
+    EXPECT_EQ(dets[0].bbox.x, 384);
+    EXPECT_EQ(dets[0].bbox.y, 216);
+    EXPECT_EQ(dets[0].bbox.width, 768);
+    EXPECT_EQ(dets[0].bbox.height, 432);
+}
+
+TEST(ScaleDetectionsTest, IndependentAxes) {
+    // 4:3 substream next to a 16:9 main stream of the same view
+    std::vector<Detection> dets{MakeDetection(320, 240, 64, 48)};
+    ScaleDetections(dets, 640, 480, 1920, 1080);
+
+    EXPECT_EQ(dets[0].bbox.x, 960);
+    EXPECT_EQ(dets[0].bbox.y, 540);
+    EXPECT_EQ(dets[0].bbox.width, 192);
+    EXPECT_EQ(dets[0].bbox.height, 108);
+}
+
+TEST(ScaleDetectionsTest, KeypointsUnchanged) {
+    std::vector<Detection> dets{MakeDetection(0, 0, 10, 10)};
+    ScaleDetections(dets, 640, 360, 1920, 1080);
+
+    ASSERT_EQ(dets[0].keypoints.size(), 1u);
+    EXPECT_FLOAT_EQ(dets[0].keypoints[0].x, 0.25f);
+    EXPECT_FLOAT_EQ(dets[0].keypoints[0].y, 0.5f);
+}
+
+TEST(ScaleDetectionsTest, SameGeometryOrInvalidIsNoop) {
+    std::vector<Detection> dets{MakeDetection(10, 20, 30, 40)};
+    ScaleDetections(dets, 640, 360, 640, 360);
+    ScaleDetections(dets, 0, 360, 1920, 1080);
+    ScaleDetections(dets, 640, 360, 1920, 0);
+
+    EXPECT_EQ(dets[0].bbox.x, 10);
+    EXPECT_EQ(dets[0].bbox.y, 20);
+    EXPECT_EQ(dets[0].bbox.width, 30);
+    EXPECT_EQ(dets[0].bbox.height, 40);
+}
+
+TEST(ScaleDetectionsTest, AdjacentBoxesStayAdjacent) {
+    std::vector<Detection> dets{MakeDetection(0, 0, 3, 3), MakeDetection(3, 0, 3, 3)};
+    ScaleDetections(dets, 7, 7, 10, 10);
+
+    EXPECT_EQ(dets[0].bbox.x + dets[0].bbox.width, dets[1].bbox.x);
+}
+
+// ============================================================================
+// Region Tests
+// ============================================================================
+
+TEST(NormalizedRegionToPixelsTest, AddsMarginAndAlignsOrigin) {
+    // Loading bay in the lower middle of a 1920x1080 view
+    const auto region = NormalizedRegionToPixels(0.4f, 0.6f, 0.7f, 0.9f, 0.05f, 1920, 1080);
+
+    EXPECT_EQ(region.x, 672);       // (0.4 - 0.05) * 1920
+    EXPECT_EQ(region.y, 594);       // (0.6 - 0.05) * 1080 = 594
+    EXPECT_EQ(region.x + region.width, 1440);
+    EXPECT_EQ(region.y + region.height, 1026);
+    EXPECT_EQ(region.x % 2, 0);
+}
+
+TEST(NormalizedRegionToPixelsTest, ClipsToFrame) {
+    const auto region = NormalizedRegionToPixels(0.0f, 0.75f, 1.0f, 1.0f, 0.25f, 1280, 720);
+
+    EXPECT_EQ(region.x, 0);
+    EXPECT_EQ(region.width, 1280);
+    EXPECT_EQ(region.y, 360);
+    EXPECT_EQ(region.y + region.height, 720);
+}
+
+TEST(NormalizedRegionToPixelsTest, OddOriginRoundsDown) {
+    const auto region = NormalizedRegionToPixels(0.5f, 0.5f, 0.6f, 0.6f, 0.0f, 202, 202);
+
+    EXPECT_EQ(region.x, 100);      // floor(101) rounded down to even
+    EXPECT_EQ(region.x + region.width, 122);   // ceil(121.2)
+}
+
+// ============================================================================
+// Tiling Tests
+// ============================================================================
+
+TEST(ComputeTilesTest, CoversFrameWithOverlap) {
+    const auto tiles = ComputeTiles(3840, 2160, 640, 640, 0.2f);
+
+    // 8 columns x 4 rows at >= 128px overlap
+    ASSERT_EQ(tiles.size(), 32u);
+    EXPECT_EQ(tiles.front().x, 0);
+    EXPECT_EQ(tiles.front().y, 0);
+    EXPECT_EQ(tiles.back().x + tiles.back().width, 3840);
+    EXPECT_EQ(tiles.back().y + tiles.back().height, 2160);
+
+    for (size_t i = 1; i < 8; ++i) {
+        const int overlap = tiles[i - 1].x + tiles[i - 1].width - tiles[i].x;
+        EXPECT_GE(overlap, 128);
+        EXPECT_EQ(tiles[i].width, 640);
+        EXPECT_EQ(tiles[i].x % 2, 0);
+    }
+}
+
+TEST(ComputeTilesTest, SmallFrameIsSingleTile) {
+    const auto tiles = ComputeTiles(640, 360, 640, 640, 0.2f);
+    ASSERT_EQ(tiles.size(), 1u);
+    EXPECT_EQ(tiles[0].width, 640);
+    EXPECT_EQ(tiles[0].height, 360);
+
+    EXPECT_TRUE(ComputeTiles(0, 360, 640, 640, 0.2f).empty());
+}
+
+TEST(OffsetDetectionsTest, MapsBoxesAndKeypointsToFrame) {
+    std::vector<Detection> dets{MakeDetection(10, 20, 30, 40)};
+    OffsetDetections(dets, BoundingBox{1280, 720, 640, 640}, 3840, 2160);
+
+    EXPECT_EQ(dets[0].bbox.x, 1290);
+    EXPECT_EQ(dets[0].bbox.y, 740);
+    EXPECT_EQ(dets[0].bbox.width, 30);
+    EXPECT_EQ(dets[0].bbox.height, 40);
+    EXPECT_FLOAT_EQ(dets[0].keypoints[0].x, (1280 + 0.25f * 640) / 3840);
+    EXPECT_FLOAT_EQ(dets[0].keypoints[0].y, (720 + 0.5f * 640) / 2160);
+}
+
+TEST(SuppressOverlappingDetectionsTest, MergesBoxCutAtTileEdge) {
+    Detection full = MakeDetection(500, 100, 200, 100);
+    full.confidence = 0.9f;
+    Detection partial = MakeDetection(500, 100, 140, 100);   // IoU 0.7, fully inside
+    partial.confidence = 0.6f;
+    Detection other_class = partial;
+    other_class.class_id = 2;
+    Detection separate = MakeDetection(900, 100, 50, 50);
+    separate.confidence = 0.5f;
+
+    std::vector<Detection> dets{partial, separate, full, other_class};
+    SuppressOverlappingDetections(dets, kTileMergeOverlap);
+
+    ASSERT_EQ(dets.size(), 3u);
+    EXPECT_FLOAT_EQ(dets[0].confidence, 0.9f);
+    EXPECT_EQ(dets[0].bbox.width, 200);
+    EXPECT_EQ(dets[1].class_id, 2);
+    EXPECT_EQ(dets[2].bbox.x, 900);
+}
+
+TEST(SuppressOverlappingDetectionsTest, KeepsNeighbours) {
+    Detection a = MakeDetection(0, 0, 100, 100);
+    a.confidence = 0.8f;
+    Detection b = MakeDetection(60, 0, 100, 100);    // 40% of either box shared
+    b.confidence = 0.7f;
+
+    std::vector<Detection> dets{a, b};
+    SuppressOverlappingDetections(dets, kTileMergeOverlap);
+    EXPECT_EQ(dets.size(), 2u);
+}
+
+}  // namespace testing
+}  // namespace stream_daemon
@@ -0,0 +1,244 @@
+#include <gtest/gtest.h>
+
+#include "device_pool.h"
+#include "hailo_inference.h"
+#include "simulated_inference_backend.h"
+
+#include <chrono>
+#include <vector>
+
+namespace stream_daemon {
+namespace testing {
+
+using namespace std::chrono_literals;
+
+namespace {
+
+constexpr int kModelSize = 32;
+constexpr int kNmsClasses = 1;
+constexpr int kNmsBboxes = 1;
+
+// 32x32 RGB model with an on-device NMS output that never detects anything
+InferenceRecording MakeEmptyNmsRecording() {
+    InferenceRecording recording;
+
+    TensorInfo input;
+    input.name = "pool/input_layer1";
+    input.type = TensorDataType::kUint8;
+    input.height = kModelSize;
+    input.width = kModelSize;
+    input.features = 3;
+    input.frame_size = kModelSize * kModelSize * 3;
+    recording.inputs.push_back(input);
+
+    TensorInfo output;
+    output.name = "pool/yolov8_nms_postprocess";
+    output.type = TensorDataType::kFloat32;
+    output.frame_size = kNmsClasses * kNmsBboxes * 5 * sizeof(float);
+    output.nms_classes = kNmsClasses;
+    output.nms_max_bboxes_per_class = kNmsBboxes;
+    recording.outputs.push_back(output);
+
+    recording.frames.push_back({std::vector<uint8_t>(output.frame_size, 0)});
+    return recording;
+}
+
+// Wall time the pool divides device busy time by, stepped by the test
+class FakeClock {
+public:
+    DevicePool::NowFn Fn() {
+        return [this] { return now_; };
+    }
+
+    void Advance(DevicePool::Clock::duration step) { now_ += step; }
+
+private:
+    DevicePool::Clock::time_point now_{};
+};
+
+// Runs `frames` frames back to back: at least frames * latency of device time
+void RunFrames(const std::shared_ptr<HailoInference>& inference, int frames) {
+    std::vector<uint8_t> frame(kModelSize * kModelSize * 3, 64);
+    const auto view = FrameView::Rgb(frame.data(), kModelSize, kModelSize);
+    for (int i = 0; i < frames; ++i) {
+        (void)inference->RunInference(view);
+    }
+}
+
+}  // namespace
+
+// ============================================================================
+// DevicePool Tests (simulated devices)
+// ============================================================================
+
+class DevicePoolTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        const auto recording = MakeEmptyNmsRecording();
+        HailoInference::SetBackendFactory([recording](const std::string&, const std::string&) {
+            SimulatedDeviceModel model;
+            model.latency = 5ms;
+            model.frames_per_second = 0.0;
+            return std::make_unique<SimulatedInferenceBackend>(recording, model);
+        });
+    }
+
+    void TearDown() override {
+        HailoInference::Shutdown();
+        HailoInference::SetBackendFactory({});
+    }
+
+    static std::string DeviceOf(DevicePool& pool, const std::string& stream_id) {
+        auto placement = pool.GetPlacement(stream_id);
+        return placement ? placement->device_id : std::string("<none>");
+    }
+
+    static DevicePool::DeviceStats StatsOf(DevicePool& pool, const std::string& device_id) {
+        for (const auto& stats : pool.GetStats()) {
+            if (stats.device_id == device_id) {
+                return stats;
+            }
+        }
+        return {};
+    }
+};
+
+TEST_F(DevicePoolTest, ParsesDeviceIdLists) {
+    EXPECT_EQ(DevicePool::ParseDeviceIds(""), (std::vector<std::string>{""}));
+    EXPECT_EQ(DevicePool::ParseDeviceIds(" , "), (std::vector<std::string>{""}));
+    EXPECT_EQ(DevicePool::ParseDeviceIds("0000:01:00.0"),
+              (std::vector<std::string>{"0000:01:00.0"}));
+    EXPECT_EQ(DevicePool::ParseDeviceIds("a, b+c ,a"), (std::vector<std::string>{"a", "b+c"}));
+}
+
+TEST_F(DevicePoolTest, SpreadsStreamsOfOneModelOverDevices) {
+    DevicePool pool({"npu0", "npu1"});
+
+    for (const std::string stream : {"cam1", "cam2", "cam3", "cam4"}) {
+        auto placement = pool.AssignStream(stream, "pool_a.hef");
+        ASSERT_TRUE(IsOk(placement)) << GetError(placement);
+        EXPECT_EQ(GetValue(placement).inference->GetDeviceId(), GetValue(placement).device_id);
+    }
+
+    EXPECT_EQ(StatsOf(pool, "npu0").streams, 2u);
+    EXPECT_EQ(StatsOf(pool, "npu1").streams, 2u);
+    EXPECT_EQ(StatsOf(pool, "npu0").models, 1u);
+    EXPECT_EQ(StatsOf(pool, "npu1").models, 1u);
+
+    // One replica per device, shared by the streams placed there
+    const auto cam1 = pool.GetPlacement("cam1");
+    const auto cam2 = pool.GetPlacement("cam2");
+    const auto cam3 = pool.GetPlacement("cam3");
+    ASSERT_TRUE(cam1 && cam2 && cam3);
+    EXPECT_NE(cam1->device_id, cam2->device_id);
+    EXPECT_NE(cam1->inference, cam2->inference);
+    EXPECT_EQ(cam1->inference, cam3->inference);
+
+    // Same model again: same placement
+    auto again = pool.AssignStream("cam1", "pool_a.hef");
+    ASSERT_TRUE(IsOk(again));
+    EXPECT_EQ(GetValue(again).inference, cam1->inference);
+    EXPECT_EQ(StatsOf(pool, "npu0").streams + StatsOf(pool, "npu1").streams, 4u);
+}
+
+TEST_F(DevicePoolTest, MaxReplicasKeepsAModelOnOneDevice) {
+    DevicePool pool({"npu0", "npu1"}, 1);
+
+    for (const std::string stream : {"cam1", "cam2", "cam3"}) {
+        ASSERT_TRUE(IsOk(pool.AssignStream(stream, "pool_a.hef")));
+    }
+    EXPECT_EQ(DeviceOf(pool, "cam1"), "npu0");
+    EXPECT_EQ(DeviceOf(pool, "cam2"), "npu0");
+    EXPECT_EQ(DeviceOf(pool, "cam3"), "npu0");
+
+    // A second model goes where the load is not
+    ASSERT_TRUE(IsOk(pool.AssignStream("cam4", "pool_b.hef")));
+    EXPECT_EQ(DeviceOf(pool, "cam4"), "npu1");
+    EXPECT_TRUE(pool.Rebalance().empty());
+}
+
+TEST_F(DevicePoolTest, PlacesNewStreamsByMeasuredUtilisation) {
+    FakeClock clock;
+    DevicePool pool({"npu0", "npu1"}, 0, clock.Fn());
+
+    auto busy = pool.AssignStream("busy", "pool_a.hef");
+    auto quiet1 = pool.AssignStream("quiet1", "pool_b.hef");
+    auto quiet2 = pool.AssignStream("quiet2", "pool_b.hef");
+    ASSERT_TRUE(IsOk(busy) && IsOk(quiet1) && IsOk(quiet2));
+    ASSERT_EQ(GetValue(busy).device_id, "npu0");
+    ASSERT_EQ(GetValue(quiet1).device_id, "npu1");
+    ASSERT_EQ(GetValue(quiet2).device_id, "npu1");
+
+    // Over 100ms npu0 runs 20 frames of 5ms (saturated), npu1 runs one
+    RunFrames(GetValue(busy).inference, 20);
+    RunFrames(GetValue(quiet1).inference, 1);
+    clock.Advance(100ms);
+    pool.SampleUtilisation();
+
+    const auto npu0 = StatsOf(pool, "npu0");
+    const auto npu1 = StatsOf(pool, "npu1");
+    EXPECT_GT(npu0.utilisation, 0.7);
+    EXPECT_LT(npu1.utilisation, 0.4);
+    EXPECT_GT(npu0.load, npu1.load);
+
+    // Fewer streams on npu0, but less device time left: a new model goes to npu1
+    auto fresh = pool.AssignStream("fresh", "pool_c.hef");
+    ASSERT_TRUE(IsOk(fresh));
+    EXPECT_EQ(GetValue(fresh).device_id, "npu1");
+    EXPECT_TRUE(pool.Rebalance().empty());
+}
+
+TEST_F(DevicePoolTest, RebalancesWhenStreamsLeave) {
+    DevicePool pool({"npu0", "npu1"});
+
+    for (const std::string stream : {"cam1", "cam2", "cam3", "cam4"}) {
+        ASSERT_TRUE(IsOk(pool.AssignStream(stream, "pool_a.hef")));
+    }
+    EXPECT_TRUE(pool.Rebalance().empty());
+
+    // Both npu1 streams leave: its replica goes, npu0 still has two streams
+    std::vector<std::string> leaving;
+    for (const std::string stream : {"cam1", "cam2", "cam3", "cam4"}) {
+        if (DeviceOf(pool, stream) == "npu1") {
+            leaving.push_back(stream);
+        }
+    }
+    ASSERT_EQ(leaving.size(), 2u);
+    for (const auto& stream : leaving) {
+        pool.ReleaseStream(stream);
+    }
+    EXPECT_EQ(DeviceOf(pool, leaving[0]), "<none>");
+    EXPECT_EQ(StatsOf(pool, "npu1").models, 0u);
+    EXPECT_EQ(StatsOf(pool, "npu0").streams, 2u);
+
+    const auto moves = pool.Rebalance();
+    ASSERT_EQ(moves.size(), 1u);
+    EXPECT_EQ(moves[0].from_device, "npu0");
+    EXPECT_EQ(moves[0].to_device, "npu1");
+    ASSERT_NE(moves[0].inference, nullptr);
+    EXPECT_EQ(moves[0].inference->GetDeviceId(), "npu1");
+    EXPECT_EQ(DeviceOf(pool, moves[0].stream_id), "npu1");
+    EXPECT_EQ(pool.GetPlacement(moves[0].stream_id)->inference, moves[0].inference);
+
+    EXPECT_EQ(StatsOf(pool, "npu0").streams, 1u);
+    EXPECT_EQ(StatsOf(pool, "npu1").streams, 1u);
+    EXPECT_TRUE(pool.Rebalance().empty());
+}
+
+TEST_F(DevicePoolTest, SingleDevicePoolUsesTheDefaultDevice) {
+    DevicePool pool({});
+    ASSERT_EQ(pool.GetDeviceIds(), (std::vector<std::string>{""}));
+
+    auto placement = pool.AssignStream("cam1", "pool_a.hef");
+    ASSERT_TRUE(IsOk(placement));
+    EXPECT_EQ(GetValue(placement).device_id, "");
+
+    // Same instance as callers outside the pool get
+    auto direct = HailoInference::GetInstance("pool_a.hef");
+    ASSERT_TRUE(IsOk(direct));
+    EXPECT_EQ(GetValue(direct), GetValue(placement).inference);
+    EXPECT_TRUE(pool.Rebalance().empty());
+}
+
+}  // namespace testing
+}  // namespace stream_daemon
@@ -0,0 +1,78 @@
+#include <gtest/gtest.h>
+
+#include "frame_decimator.h"
+
+namespace stream_daemon {
+namespace testing {
+
+namespace {
+
+// Count processed frames for a camera at camera_fps over the given seconds
+int CountProcessed(FrameDecimator& decimator, double camera_fps, int seconds) {
+    const int64_t interval_us = static_cast<int64_t>(1'000'000.0 / camera_fps);
+    const int total = static_cast<int>(camera_fps * seconds);
+    int processed = 0;
+    for (int i = 0; i < total; ++i) {
+        if (decimator.ShouldProcess(i * interval_us)) {
+            ++processed;
+        }
+    }
+    return processed;
+}
+
+}  // namespace
+
+// ============================================================================
+// FrameDecimator Tests
+// ============================================================================
+
+TEST(FrameDecimatorTest, DefaultPassesEveryFrame) {
+    FrameDecimator decimator;
+    EXPECT_TRUE(decimator.IsPassThrough());
+    EXPECT_EQ(CountProcessed(decimator, 30.0, 2), 60);
+}
+
+TEST(FrameDecimatorTest, EveryNthFrame) {
+    FrameDecimator decimator;
+    decimator.Configure(0.0, 3);
+
+    EXPECT_TRUE(decimator.ShouldProcess(0));
+    EXPECT_FALSE(decimator.ShouldProcess(1));
+    EXPECT_FALSE(decimator.ShouldProcess(2));
+    EXPECT_TRUE(decimator.ShouldProcess(3));
+}
+
+TEST(FrameDecimatorTest, TargetRateFromCameraRate) {
+    FrameDecimator decimator;
+    decimator.Configure(5.0, 1);
+    EXPECT_EQ(CountProcessed(decimator, 30.0, 10), 50);
+}
+
+TEST(FrameDecimatorTest, TargetRateWithJitterKeepsLongTermRate) {
+    FrameDecimator decimator;
+    decimator.Configure(5.0, 1);
+
+    // 25 fps camera with +/-5ms alternating jitter
+    int processed = 0;
+    for (int i = 0; i < 250; ++i) {
+        const int64_t jitter = (i % 2 == 0) ? 5000 : -5000;
+        if (decimator.ShouldProcess(i * 40000 + jitter)) {
+            ++processed;
+        }
+    }
+    EXPECT_NEAR(processed, 50, 1);
+}
+
+TEST(FrameDecimatorTest, ResyncsAfterStall) {
+    FrameDecimator decimator;
+    decimator.Configure(10.0, 1);
+
+    EXPECT_TRUE(decimator.ShouldProcess(0));
+    // 5 second gap: one frame, not a burst of catch-up frames
+    EXPECT_TRUE(decimator.ShouldProcess(5'000'000));
+    EXPECT_FALSE(decimator.ShouldProcess(5'050'000));
+    EXPECT_TRUE(decimator.ShouldProcess(5'100'000));
+}
+
+}  // namespace testing
+}  // namespace stream_daemon
@@ -0,0 +1,99 @@
+#include <gtest/gtest.h>
+
+#include "frame_view.h"
+
+#include <vector>
+
+namespace stream_daemon {
+namespace testing {
+
+// ============================================================================
+// FrameView Tests
+// ============================================================================
+
+TEST(FrameViewTest, RgbDefaultsToPackedStride) {
+    std::vector<uint8_t> pixels(4 * 2 * 3, 0);
+    auto view = FrameView::Rgb(pixels.data(), 4, 2);
+
+    EXPECT_TRUE(view.IsValid());
+    EXPECT_TRUE(view.IsPackedRgb());
+    EXPECT_EQ(view.strides[0], 12);
+    EXPECT_EQ(view.Row(0, 1), pixels.data() + 12);
+}
+
+TEST(FrameViewTest, OddWidthRowsUsePaddedStride) {
+    // 3px wide RGB with rows aligned to 4 bytes (9 -> 12)
+    constexpr int kStride = 12;
+    std::vector<uint8_t> pixels(kStride * 2, 0);
+    pixels[kStride] = 42;  // first byte of row 1
+
+    auto view = FrameView::Rgb(pixels.data(), 3, 2, kStride);
+
+    EXPECT_FALSE(view.IsPackedRgb());
+    EXPECT_EQ(view.Row(0, 1)[0], 42);
+}
+
+TEST(FrameViewTest, GeometryBindsPlaneOffsets) {
+    FrameGeometry geometry;
+    geometry.format = PixelFormat::kNV12;
+    geometry.width = 4;
+    geometry.height = 2;
+    geometry.num_planes = 2;
+    geometry.offsets = {0, 8, 0};
+    geometry.strides = {4, 4, 0};
+
+    std::vector<uint8_t> pixels(12, 0);
+    auto view = geometry.Bind(pixels.data());
+
+    EXPECT_TRUE(view.IsValid());
+    EXPECT_FALSE(view.IsPackedRgb());
+    EXPECT_EQ(view.planes[1], pixels.data() + 8);
+    EXPECT_EQ(view.Row(0, 1), pixels.data() + 4);
+}
+
+TEST(FrameViewTest, DefaultViewIsInvalid) {
+    FrameView view;
+    EXPECT_FALSE(view.IsValid());
+}
+
+TEST(FrameViewTest, CropRgbOffsetsRows) {
+    std::vector<uint8_t> pixels(16 * 8 * 3);
+    const auto view = FrameView::Rgb(pixels.data(), 16, 8);
+
+    const auto crop = view.Crop(4, 2, 8, 4);
+    EXPECT_EQ(crop.width, 8);
+    EXPECT_EQ(crop.height, 4);
+    EXPECT_EQ(crop.strides[0], 16 * 3);
+    EXPECT_EQ(crop.Row(0, 0), pixels.data() + 2 * 16 * 3 + 4 * 3);
+}
+
+TEST(FrameViewTest, CropYuvAlignsChroma) {
+    std::vector<uint8_t> y(16 * 8);
+    std::vector<uint8_t> uv(16 * 4);
+    std::vector<uint8_t> u(8 * 4);
+    std::vector<uint8_t> v(8 * 4);
+
+    // Odd origin rounds down to even
+    const auto nv12 = FrameView::Nv12(y.data(), 16, uv.data(), 16, 16, 8).Crop(5, 3, 6, 4);
+    EXPECT_EQ(nv12.Row(0, 0), y.data() + 2 * 16 + 4);
+    EXPECT_EQ(nv12.Row(1, 0), uv.data() + 1 * 16 + 4);
+    EXPECT_EQ(nv12.width, 6);
+
+    const auto i420 = FrameView::I420(y.data(), 16, u.data(), 8, v.data(), 8, 16, 8).Crop(4, 2, 6, 4);
+    EXPECT_EQ(i420.Row(1, 0), u.data() + 1 * 8 + 2);
+    EXPECT_EQ(i420.Row(2, 0), v.data() + 1 * 8 + 2);
+}
+
+TEST(FrameViewTest, CropClipsToFrame) {
+    std::vector<uint8_t> pixels(16 * 8 * 3);
+    const auto view = FrameView::Rgb(pixels.data(), 16, 8);
+
+    const auto edge = view.Crop(12, 6, 8, 8);
+    EXPECT_EQ(edge.width, 4);
+    EXPECT_EQ(edge.height, 2);
+
+    EXPECT_FALSE(view.Crop(16, 0, 4, 4).IsValid());
+}
+
+}  // namespace testing
+}  // namespace stream_daemon
@@ -0,0 +1,426 @@
+#include <gtest/gtest.h>
+
+#include "image_ops.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+namespace stream_daemon {
+namespace testing {
+
+namespace {
+
+// Deterministic, non-smooth test pattern so index mistakes show up
+std::vector<uint8_t> MakePlane(int row_bytes, int height, int stride) {
+    std::vector<uint8_t> pixels(static_cast<size_t>(stride) * height, 0xEE);
+    uint32_t state = 12345;
+    for (int y = 0; y < height; ++y) {
+        for (int x = 0; x < row_bytes; ++x) {
+            state = state * 1103515245u + 12345u;
+            pixels[static_cast<size_t>(y) * stride + x] = static_cast<uint8_t>(state >> 16);
+        }
+    }
+    return pixels;
+}
+
+std::vector<uint8_t> MakePattern(int width, int height, int stride) {
+    return MakePlane(width * 3, height, stride);
+}
+
+// The original HailoInference::LetterboxResize loop, kept as the reference
+void LegacyLetterbox(const FrameView& src, uint8_t* dst, int dst_w, int dst_h, uint8_t pad_value) {
+    const auto info = ComputeLetterboxGeometry(src.width, src.height, dst_w, dst_h);
+    std::memset(dst, pad_value, dst_w * dst_h * 3);
+
+    const float x_ratio = static_cast<float>(src.width) / info.new_w;
+    const float y_ratio = static_cast<float>(src.height) / info.new_h;
+
+    for (int y = 0; y < info.new_h; ++y) {
+        int src_y = static_cast<int>(y * y_ratio);
+        src_y = std::min(src_y, src.height - 1);
+
+        const uint8_t* src_row = src.Row(0, src_y);
+        uint8_t* dst_row = dst + ((y + info.pad_y) * dst_w + info.pad_x) * 3;
+
+        for (int x = 0; x < info.new_w; ++x) {
+            int src_x = static_cast<int>(x * x_ratio);
+            src_x = std::min(src_x, src.width - 1);
+
+            dst_row[x * 3 + 0] = src_row[src_x * 3 + 0];
+            dst_row[x * 3 + 1] = src_row[src_x * 3 + 1];
+            dst_row[x * 3 + 2] = src_row[src_x * 3 + 2];
+        }
+    }
+}
+
+std::vector<SimdLevel> SupportedLevels() {
+    std::vector<SimdLevel> levels;
+    for (SimdLevel level : {SimdLevel::kScalar, SimdLevel::kSse41, SimdLevel::kAvx2, SimdLevel::kNeon}) {
+        if (IsSimdLevelSupported(level)) {
+            levels.push_back(level);
+        }
+    }
+    return levels;
+}
+
+// Planar 4:2:0 frame with padded strides, viewable as I420 or NV12
+struct YuvFrame {
+    int width;
+    int height;
+    std::vector<uint8_t> y;
+    std::vector<uint8_t> u;
+    std::vector<uint8_t> v;
+    std::vector<uint8_t> uv;
+
+    YuvFrame(int w, int h) : width(w), height(h) {
+        y = MakePlane(w, h, YStride());
+        u = MakePlane((w + 1) / 2, (h + 1) / 2, ChromaStride());
+        v = MakePlane((w + 1) / 2, (h + 1) / 2, ChromaStride());
+        std::reverse(v.begin(), v.end());
+        uv.resize(static_cast<size_t>(ChromaStride()) * 2 * ((h + 1) / 2));
+        for (int row = 0; row < (h + 1) / 2; ++row) {
+            for (int x = 0; x < (w + 1) / 2; ++x) {
+                uv[row * ChromaStride() * 2 + x * 2] = u[row * ChromaStride() + x];
+                uv[row * ChromaStride() * 2 + x * 2 + 1] = v[row * ChromaStride() + x];
+            }
+        }
+    }
+
+    int YStride() const { return (width + 15) & ~15; }
+    int ChromaStride() const { return YStride() / 2 + 8; }
+
+    FrameView I420() const {
+        return FrameView::I420(y.data(), YStride(), u.data(), ChromaStride(),
+                               v.data(), ChromaStride(), width, height);
+    }
+    FrameView Nv12() const {
+        return FrameView::Nv12(y.data(), YStride(), uv.data(), ChromaStride() * 2, width, height);
+    }
+};
+
+// Full-resolution float conversion (chroma replicated), BT.601 limited range
+std::vector<uint8_t> ReferenceYuvToRgb(const FrameView& src) {
+    std::vector<uint8_t> rgb(static_cast<size_t>(src.width) * src.height * 3);
+    for (int y = 0; y < src.height; ++y) {
+        for (int x = 0; x < src.width; ++x) {
+            const double luma = (src.Row(0, y)[x] - 16) * 255.0 / 219.0;
+            const double cb = (src.Row(1, y / 2)[x / 2] - 128) * 255.0 / 224.0;
+            const double cr = (src.Row(2, y / 2)[x / 2] - 128) * 255.0 / 224.0;
+            const double values[3] = {luma + 1.402 * cr,
+                                      luma - 0.344136 * cb - 0.714136 * cr,
+                                      luma + 1.772 * cb};
+            for (int c = 0; c < 3; ++c) {
+                rgb[(static_cast<size_t>(y) * src.width + x) * 3 + c] =
+                    static_cast<uint8_t>(std::clamp(std::lround(values[c]), 0L, 255L));
+            }
+        }
+    }
+    return rgb;
+}
+
+struct Geometry {
+    int src_w;
+    int src_h;
+    int src_stride;
+    int dst_w;
+    int dst_h;
+};
+
+const Geometry kGeometries[] = {
+    {192, 108, 192 * 3, 96, 96},      // 16:9 downscale, horizontal bars
+    {108, 192, 108 * 3, 96, 96},      // Portrait, vertical bars
+    {37, 23, 112, 64, 64},            // Odd width with padded rows, upscale
+    {640, 360, 640 * 3, 320, 320},
+    {101, 57, 101 * 3, 33, 47},       // Non-square model input
+    {64, 64, 64 * 3, 64, 64},         // Same size
+};
+
+}  // namespace
+
+// ============================================================================
+// Geometry Tests
+// ============================================================================
+
+TEST(ImageOpsTest, LetterboxGeometryCentersImage) {
+    const auto g = ComputeLetterboxGeometry(1920, 1080, 960, 960);
+    EXPECT_FLOAT_EQ(g.scale, 0.5f);
+    EXPECT_EQ(g.new_w, 960);
+    EXPECT_EQ(g.new_h, 540);
+    EXPECT_EQ(g.pad_x, 0);
+    EXPECT_EQ(g.pad_y, 210);
+}
+
+TEST(ImageOpsTest, DetectedLevelIsSupported) {
+    EXPECT_TRUE(IsSimdLevelSupported(DetectSimdLevel()));
+    EXPECT_TRUE(IsSimdLevelSupported(SimdLevel::kScalar));
+}
+
+// ============================================================================
+// Nearest (legacy) Tests
+// ============================================================================
+
+TEST(ImageOpsTest, NearestIsBitExactWithLegacyLoop) {
+    for (const auto& geo : kGeometries) {
+        const auto pixels = MakePattern(geo.src_w, geo.src_h, geo.src_stride);
+        const auto src = FrameView::Rgb(pixels.data(), geo.src_w, geo.src_h, geo.src_stride);
+        const size_t size = static_cast<size_t>(geo.dst_w) * geo.dst_h * 3;
+
+        std::vector<uint8_t> expected(size);
+        LegacyLetterbox(src, expected.data(), geo.dst_w, geo.dst_h, kLetterboxPadValue);
+
+        for (SimdLevel level : SupportedLevels()) {
+            LetterboxResizer resizer(ResizeInterpolation::kNearest, level);
+            std::vector<uint8_t> actual(size, 0);
+            resizer.Resize(src, actual.data(), geo.dst_w, geo.dst_h);
+            EXPECT_EQ(actual, expected) << geo.src_w << "x" << geo.src_h << " -> "
+                                        << geo.dst_w << "x" << geo.dst_h << " ("
+                                        << SimdLevelToString(level) << ")";
+        }
+    }
+}
+
+// ============================================================================
+// Bilinear Tests
+// ============================================================================
+
+TEST(ImageOpsTest, BilinearSimdMatchesScalar) {
+    for (const auto& geo : kGeometries) {
+        const auto pixels = MakePattern(geo.src_w, geo.src_h, geo.src_stride);
+        const auto src = FrameView::Rgb(pixels.data(), geo.src_w, geo.src_h, geo.src_stride);
+        const size_t size = static_cast<size_t>(geo.dst_w) * geo.dst_h * 3;
+
+        LetterboxResizer scalar(ResizeInterpolation::kBilinear, SimdLevel::kScalar);
+        std::vector<uint8_t> expected(size, 0);
+        scalar.Resize(src, expected.data(), geo.dst_w, geo.dst_h);
+
+        for (SimdLevel level : SupportedLevels()) {
+            LetterboxResizer resizer(ResizeInterpolation::kBilinear, level);
+            std::vector<uint8_t> actual(size, 0);
+            resizer.Resize(src, actual.data(), geo.dst_w, geo.dst_h);
+            EXPECT_EQ(actual, expected) << geo.src_w << "x" << geo.src_h << " -> "
+                                        << geo.dst_w << "x" << geo.dst_h << " ("
+                                        << SimdLevelToString(level) << ")";
+        }
+    }
+}
+
+TEST(ImageOpsTest, BilinearSameSizeCopiesSource) {
+    const auto pixels = MakePattern(48, 48, 48 * 3);
+    const auto src = FrameView::Rgb(pixels.data(), 48, 48);
+
+    LetterboxResizer resizer(ResizeInterpolation::kBilinear);
+    std::vector<uint8_t> dst(pixels.size(), 0);
+    resizer.Resize(src, dst.data(), 48, 48);
+
+    EXPECT_EQ(dst, pixels);
+}
+
+TEST(ImageOpsTest, BilinearKeepsFlatColor) {
+    std::vector<uint8_t> pixels(200 * 100 * 3);
+    for (size_t i = 0; i < pixels.size(); i += 3) {
+        pixels[i] = 10;
+        pixels[i + 1] = 128;
+        pixels[i + 2] = 255;
+    }
+    const auto src = FrameView::Rgb(pixels.data(), 200, 100);
+
+    LetterboxResizer resizer(ResizeInterpolation::kBilinear);
+    std::vector<uint8_t> dst(64 * 64 * 3, 0);
+    const auto g = resizer.Resize(src, dst.data(), 64, 64);
+
+    for (int y = g.pad_y; y < g.pad_y + g.new_h; ++y) {
+        for (int x = 0; x < g.new_w; ++x) {
+            const uint8_t* p = dst.data() + (y * 64 + g.pad_x + x) * 3;
+            ASSERT_EQ(p[0], 10);
+            ASSERT_EQ(p[1], 128);
+            ASSERT_EQ(p[2], 255);
+        }
+    }
+}
+
+// ============================================================================
+// Border Tests
+// ============================================================================
+
+TEST(ImageOpsTest, BordersRepaintedOnlyOnGeometryChange) {
+    const auto wide = MakePattern(64, 32, 64 * 3);
+    const auto tall = MakePattern(32, 64, 32 * 3);
+    LetterboxResizer resizer;
+    std::vector<uint8_t> dst(32 * 32 * 3, 0);
+
+    resizer.Resize(FrameView::Rgb(wide.data(), 64, 32), dst.data(), 32, 32);
+    ASSERT_EQ(dst[0], kLetterboxPadValue);
+
+    // Same geometry: the border is assumed intact and left alone
+    dst[0] = 1;
+    resizer.Resize(FrameView::Rgb(wide.data(), 64, 32), dst.data(), 32, 32);
+    EXPECT_EQ(dst[0], 1);
+
+    // Written elsewhere: caller invalidates, border comes back
+    resizer.Invalidate(dst.data());
+    resizer.Resize(FrameView::Rgb(wide.data(), 64, 32), dst.data(), 32, 32);
+    EXPECT_EQ(dst[0], kLetterboxPadValue);
+
+    // New geometry (pillarbox): old bar rows are image now, side bars are painted
+    resizer.Resize(FrameView::Rgb(tall.data(), 32, 64), dst.data(), 32, 32);
+    std::vector<uint8_t> expected(dst.size());
+    LetterboxResizer fresh;
+    fresh.Resize(FrameView::Rgb(tall.data(), 32, 64), expected.data(), 32, 32);
+    EXPECT_EQ(dst, expected);
+}
+
+TEST(ImageOpsTest, AlternatingGeometriesUseCachedPlans) {
+    const auto a = MakePattern(80, 45, 80 * 3);
+    const auto b = MakePattern(45, 80, 45 * 3);
+    const auto view_a = FrameView::Rgb(a.data(), 80, 45);
+    const auto view_b = FrameView::Rgb(b.data(), 45, 80);
+
+    LetterboxResizer reference;
+    std::vector<uint8_t> expected_a(40 * 40 * 3);
+    std::vector<uint8_t> expected_b(40 * 40 * 3);
+    reference.Resize(view_a, expected_a.data(), 40, 40);
+    reference.Resize(view_b, expected_b.data(), 40, 40);
+
+    LetterboxResizer resizer;
+    std::vector<uint8_t> dst_a(expected_a.size());
+    std::vector<uint8_t> dst_b(expected_b.size());
+    for (int i = 0; i < 3; ++i) {
+        resizer.Resize(view_a, dst_a.data(), 40, 40);
+        resizer.Resize(view_b, dst_b.data(), 40, 40);
+    }
+    EXPECT_EQ(dst_a, expected_a);
+    EXPECT_EQ(dst_b, expected_b);
+}
+
+// ============================================================================
+// Fused YUV Tests
+// ============================================================================
+
+TEST(ImageOpsTest, YuvFlatColorsConvert) {
+    struct Case {
+        uint8_t y, u, v;
+        uint8_t r, g, b;
+    };
+    // BT.601 limited range
+    const Case cases[] = {
+        {16, 128, 128, 0, 0, 0},
+        {235, 128, 128, 255, 255, 255},
+        {81, 90, 240, 255, 0, 0},
+        {145, 54, 34, 0, 255, 0},
+        {41, 240, 110, 0, 0, 255},
+    };
+
+    for (const auto& c : cases) {
+        std::vector<uint8_t> luma(32 * 16, c.y);
+        std::vector<uint8_t> u(16 * 8, c.u);
+        std::vector<uint8_t> v(16 * 8, c.v);
+        const auto src = FrameView::I420(luma.data(), 32, u.data(), 16, v.data(), 16, 32, 16);
+
+        LetterboxResizer resizer;
+        std::vector<uint8_t> dst(16 * 16 * 3, 0);
+        const auto g = resizer.Resize(src, dst.data(), 16, 16);
+        const uint8_t* p = dst.data() + (g.pad_y * 16 + 8) * 3;
+
+        EXPECT_NEAR(p[0], c.r, 2) << int(c.y) << "," << int(c.u) << "," << int(c.v);
+        EXPECT_NEAR(p[1], c.g, 2) << int(c.y) << "," << int(c.u) << "," << int(c.v);
+        EXPECT_NEAR(p[2], c.b, 2) << int(c.y) << "," << int(c.u) << "," << int(c.v);
+    }
+}
+
+TEST(ImageOpsTest, YuvNearestMatchesConvertThenResize) {
+    const YuvFrame frame(75, 41);
+    const auto src = frame.I420();
+    const auto rgb = ReferenceYuvToRgb(src);
+
+    std::vector<uint8_t> expected(48 * 48 * 3);
+    LegacyLetterbox(FrameView::Rgb(rgb.data(), src.width, src.height),
+                    expected.data(), 48, 48, kLetterboxPadValue);
+
+    LetterboxResizer resizer(ResizeInterpolation::kNearest);
+    std::vector<uint8_t> actual(expected.size(), 0);
+    resizer.Resize(src, actual.data(), 48, 48);
+
+    for (size_t i = 0; i < expected.size(); ++i) {
+        ASSERT_LE(std::abs(actual[i] - expected[i]), 1) << "byte " << i;
+    }
+}
+
+TEST(ImageOpsTest, Nv12AndI420Agree) {
+    const YuvFrame frame(101, 57);
+    for (auto mode : {ResizeInterpolation::kNearest, ResizeInterpolation::kBilinear}) {
+        LetterboxResizer resizer(mode);
+        std::vector<uint8_t> from_i420(64 * 64 * 3, 0);
+        std::vector<uint8_t> from_nv12(64 * 64 * 3, 0);
+        resizer.Resize(frame.I420(), from_i420.data(), 64, 64);
+        resizer.Resize(frame.Nv12(), from_nv12.data(), 64, 64);
+        EXPECT_EQ(from_i420, from_nv12);
+    }
+}
+
+TEST(ImageOpsTest, YuvBilinearSimdMatchesScalar) {
+    const YuvFrame frame(640, 360);
+
+    for (const auto& src : {frame.Nv12(), frame.I420()}) {
+        LetterboxResizer scalar(ResizeInterpolation::kBilinear, SimdLevel::kScalar);
+        std::vector<uint8_t> expected(320 * 320 * 3, 0);
+        scalar.Resize(src, expected.data(), 320, 320);
+
+        for (SimdLevel level : SupportedLevels()) {
+            LetterboxResizer resizer(ResizeInterpolation::kBilinear, level);
+            std::vector<uint8_t> actual(expected.size(), 0);
+            resizer.Resize(src, actual.data(), 320, 320);
+            EXPECT_EQ(actual, expected) << SimdLevelToString(level);
+        }
+    }
+}
+
+// ============================================================================
+// Row Band Tests
+// ============================================================================
+
+TEST(ImageOpsTest, RowBandsMatchSingleThread) {
+    CpuWorkerPool pool(3);
+    const YuvFrame yuv(640, 360);
+    const auto pixels = MakePattern(640, 360, 640 * 3 + 16);
+    const auto rgb = FrameView::Rgb(pixels.data(), 640, 360, 640 * 3 + 16);
+
+    for (auto interpolation : {ResizeInterpolation::kNearest, ResizeInterpolation::kBilinear}) {
+        for (const auto& src : {rgb, yuv.Nv12(), yuv.I420()}) {
+            LetterboxResizer single(interpolation);
+            std::vector<uint8_t> expected(320 * 320 * 3, 0);
+            single.Resize(src, expected.data(), 320, 320);
+            EXPECT_EQ(single.GetLastBandCount(), 1);
+
+            LetterboxResizer banded(interpolation);
+            banded.SetWorkerPool(&pool, 0);
+            std::vector<uint8_t> actual(expected.size(), 0);
+            banded.Resize(src, actual.data(), 320, 320);
+            EXPECT_EQ(banded.GetLastBandCount(), 4);
+            EXPECT_EQ(actual, expected);
+        }
+    }
+}
+
+TEST(ImageOpsTest, SmallSourcesStayOnOneThread) {
+    CpuWorkerPool pool(3);
+    const auto pixels = MakePattern(640, 360, 640 * 3);
+    const auto src = FrameView::Rgb(pixels.data(), 640, 360, 640 * 3);
+
+    LetterboxResizer resizer;
+    resizer.SetWorkerPool(&pool, 640 * 360 + 1);
+    std::vector<uint8_t> dst(320 * 320 * 3, 0);
+    resizer.Resize(src, dst.data(), 320, 320);
+    EXPECT_EQ(resizer.GetLastBandCount(), 1);
+
+    // Too few output rows to split
+    resizer.SetWorkerPool(&pool, 0);
+    std::vector<uint8_t> tiny(64 * 64 * 3, 0);
+    resizer.Resize(src, tiny.data(), 64, 64);
+    EXPECT_EQ(resizer.GetLastBandCount(), 1);
+}
+
+}  // namespace testing
+}  // namespace stream_daemon
@@ -0,0 +1,377 @@
+#include <gtest/gtest.h>
+
+#include "inference_scheduler.h"
+
+#include <atomic>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace stream_daemon {
+namespace testing {
+
+using namespace std::chrono_literals;
+
+namespace {
+
+InferenceScheduler::StreamPolicy Policy(InferencePriority priority, double weight = 1.0,
+                                        double min_fps = 0.0,
+                                        std::chrono::milliseconds deadline = 0ms) {
+    InferenceScheduler::StreamPolicy policy;
+    policy.priority = priority;
+    policy.weight = weight;
+    policy.min_fps = min_fps;
+    policy.deadline = deadline;
+    return policy;
+}
+
+template <typename Pred>
+bool WaitFor(Pred pred, std::chrono::milliseconds timeout = 2000ms) {
+    const auto deadline = std::chrono::steady_clock::now() + timeout;
+    while (!pred()) {
+        if (std::chrono::steady_clock::now() > deadline) return false;
+        std::this_thread::sleep_for(1ms);
+    }
+    return true;
+}
+
+// Time source the test steps by hand, so rates and waits do not depend on
+// how fast the machine runs the callers
+class FakeClock {
+public:
+    InferenceScheduler::NowFn Fn() {
+        return [this] { return Now(); };
+    }
+
+    InferenceScheduler::Clock::time_point Now() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return now_;
+    }
+
+    void Advance(InferenceScheduler::Clock::duration step) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        now_ += step;
+    }
+
+private:
+    mutable std::mutex mutex_;
+    InferenceScheduler::Clock::time_point now_{};
+};
+
+// Callers per stream keep frames queued (a backlogged camera); the test plays
+// the device, finishing one granted frame per Step() after `device_time`
+class SimulatedDevice {
+public:
+    SimulatedDevice(std::shared_ptr<InferenceScheduler> scheduler, FakeClock& clock,
+                    std::chrono::milliseconds device_time)
+        : scheduler_(std::move(scheduler)), clock_(clock), device_time_(device_time) {}
+
+    ~SimulatedDevice() { Stop(); }
+
+    void AddStream(const std::string& stream_id, int callers) {
+        stream_ids_.push_back(stream_id);
+        callers_ += callers;
+        for (int i = 0; i < callers; ++i) {
+            threads_.emplace_back([this, stream_id] {
+                while (running_) {
+                    auto lease = scheduler_->Acquire(stream_id);
+                    if (!running_) {
+                        break;
+                    }
+                    if (IsOk(lease)) {
+                        std::lock_guard<std::mutex> lock(mutex_);
+                        on_device_.push_back(GetValue(std::move(lease)));
+                    }
+                }
+            });
+        }
+    }
+
+    // Finish the oldest frame on the device once every caller is queued again
+    bool Step() {
+        const bool settled = WaitFor([this] {
+            size_t waiting = 0;
+            for (const auto& stream_id : stream_ids_) {
+                waiting += scheduler_->GetStreamStats(stream_id).waiting;
+            }
+            std::lock_guard<std::mutex> lock(mutex_);
+            const auto in_flight = static_cast<size_t>(scheduler_->GetInFlight());
+            return on_device_.size() == in_flight && in_flight > 0 && waiting == callers_;
+        });
+        if (!settled) {
+            return false;
+        }
+
+        InferenceScheduler::Lease lease;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            lease = std::move(on_device_.front());
+            on_device_.pop_front();
+        }
+        clock_.Advance(device_time_);
+        lease.reset();  // Frees the slot at the new time
+        return true;
+    }
+
+    void Stop() {
+        running_ = false;
+        for (const auto& stream_id : stream_ids_) {
+            scheduler_->Cancel(stream_id);
+        }
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            on_device_.clear();
+        }
+        for (auto& thread : threads_) {
+            thread.join();
+        }
+        threads_.clear();
+    }
+
+private:
+    std::shared_ptr<InferenceScheduler> scheduler_;
+    FakeClock& clock_;
+    std::chrono::milliseconds device_time_;
+    std::vector<std::string> stream_ids_;
+    size_t callers_{0};
+    std::atomic<bool> running_{true};
+    std::vector<std::thread> threads_;
+    std::mutex mutex_;
+    std::deque<InferenceScheduler::Lease> on_device_;
+};
+
+}  // namespace
+
+// ============================================================================
+// InferenceScheduler Tests
+// ============================================================================
+
+TEST(InferenceSchedulerTest, LeasesLimitFramesInFlight) {
+    auto scheduler = std::make_shared<InferenceScheduler>(2);
+
+    auto first = scheduler->Acquire("cam1");
+    auto second = scheduler->Acquire("cam2");
+    ASSERT_TRUE(IsOk(first));
+    ASSERT_TRUE(IsOk(second));
+    EXPECT_EQ(scheduler->GetInFlight(), 2);
+
+    std::atomic<bool> granted{false};
+    std::thread waiter([&] {
+        auto third = scheduler->Acquire("cam3");
+        granted = IsOk(third);
+    });
+
+    ASSERT_TRUE(WaitFor([&] { return scheduler->GetStreamStats("cam3").waiting == 1; }));
+    EXPECT_FALSE(granted.load());
+
+    std::get<InferenceScheduler::Lease>(first).reset();
+    waiter.join();
+    EXPECT_TRUE(granted.load());
+    EXPECT_EQ(scheduler->GetInFlight(), 1);
+}
+
+// A tiled frame holds one slot per crop it puts on the device
+TEST(InferenceSchedulerTest, MultiSlotFrameHoldsAllItsSlots) {
+    auto scheduler = std::make_shared<InferenceScheduler>(4);
+
+    auto single = scheduler->Acquire("cam1");
+    ASSERT_TRUE(IsOk(single));
+
+    std::atomic<bool> granted{false};
+    InferenceScheduler::Lease tiled;
+    std::thread waiter([&] {
+        auto result = scheduler->Acquire("tiled", 4);
+        granted = IsOk(result);
+        if (granted) tiled = GetValue(std::move(result));
+    });
+
+    // Three slots are free, the tiled frame needs four
+    ASSERT_TRUE(WaitFor([&] { return scheduler->GetStreamStats("tiled").waiting == 1; }));
+    std::this_thread::sleep_for(20ms);
+    EXPECT_FALSE(granted.load());
+
+    std::get<InferenceScheduler::Lease>(single).reset();
+    waiter.join();
+    ASSERT_TRUE(granted.load());
+    EXPECT_EQ(scheduler->GetInFlight(), 4);
+
+    // More slots than the device has are clamped rather than waiting forever
+    tiled.reset();
+    EXPECT_EQ(scheduler->GetInFlight(), 0);
+    auto oversized = scheduler->Acquire("tiled", 16);
+    ASSERT_TRUE(IsOk(oversized));
+    EXPECT_EQ(scheduler->GetInFlight(), 4);
+    std::get<InferenceScheduler::Lease>(oversized).reset();
+    EXPECT_EQ(scheduler->GetInFlight(), 0);
+}
+
+TEST(InferenceSchedulerTest, HigherPriorityClassIsAdmittedFirst) {
+    auto scheduler = std::make_shared<InferenceScheduler>(1);
+    scheduler->SetStreamPolicy("background", Policy(InferencePriority::kBackground));
+    scheduler->SetStreamPolicy("normal", Policy(InferencePriority::kNormal));
+    scheduler->SetStreamPolicy("critical", Policy(InferencePriority::kCritical));
+
+    auto held = scheduler->Acquire("normal");
+    ASSERT_TRUE(IsOk(held));
+
+    std::mutex order_mutex;
+    std::vector<std::string> order;
+    std::vector<std::thread> waiters;
+    for (const std::string stream : {"background", "normal", "critical"}) {
+        waiters.emplace_back([&, stream] {
+            auto lease = scheduler->Acquire(stream);
+            std::lock_guard<std::mutex> lock(order_mutex);
+            order.push_back(stream);
+        });
+        ASSERT_TRUE(WaitFor([&] { return scheduler->GetStreamStats(stream).waiting == 1; }));
+    }
+
+    std::get<InferenceScheduler::Lease>(held).reset();
+    for (auto& waiter : waiters) {
+        waiter.join();
+    }
+    EXPECT_EQ(order, (std::vector<std::string>{"critical", "normal", "background"}));
+}
+
+TEST(InferenceSchedulerTest, WeightsSplitTheDeviceWithinAClass) {
+    FakeClock clock;
+    auto scheduler = std::make_shared<InferenceScheduler>(1, clock.Fn());
+    scheduler->SetStreamPolicy("heavy", Policy(InferencePriority::kNormal, 3.0));
+    scheduler->SetStreamPolicy("light", Policy(InferencePriority::kNormal, 1.0));
+
+    SimulatedDevice device(scheduler, clock, 2ms);
+    device.AddStream("heavy", 3);
+    device.AddStream("light", 3);
+    for (int i = 0; i < 400; ++i) {
+        ASSERT_TRUE(device.Step()) << "step " << i;
+    }
+    device.Stop();
+
+    const auto heavy = scheduler->GetStreamStats("heavy").granted;
+    const auto light = scheduler->GetStreamStats("light").granted;
+    ASSERT_GT(light, 0u);
+    EXPECT_NEAR(static_cast<double>(heavy) / static_cast<double>(light), 3.0, 0.2);
+}
+
+// A busy stream in a higher class would take every slot; the minimum rate
+// still gets through
+TEST(InferenceSchedulerTest, MinimumRateIsGuaranteedAgainstHigherClasses) {
+    FakeClock clock;
+    auto scheduler = std::make_shared<InferenceScheduler>(1, clock.Fn());
+    scheduler->SetStreamPolicy("busy", Policy(InferencePriority::kCritical));
+    scheduler->SetStreamPolicy("guaranteed", Policy(InferencePriority::kBackground, 1.0, 20.0));
+    scheduler->SetStreamPolicy("starved", Policy(InferencePriority::kBackground));
+
+    // One second of device time: 200 frames of 5ms
+    SimulatedDevice device(scheduler, clock, 5ms);
+    device.AddStream("busy", 3);
+    device.AddStream("guaranteed", 1);
+    device.AddStream("starved", 1);
+    for (int i = 0; i < 200; ++i) {
+        ASSERT_TRUE(device.Step()) << "step " << i;
+    }
+
+    const auto guaranteed = scheduler->GetStreamStats("guaranteed");
+    const auto starved = scheduler->GetStreamStats("starved");
+    const auto busy = scheduler->GetStreamStats("busy");
+    device.Stop();
+
+    EXPECT_GE(guaranteed.granted, 18u);
+    EXPECT_LE(guaranteed.granted, 21u);
+    EXPECT_EQ(guaranteed.guaranteed, guaranteed.granted);
+    EXPECT_NEAR(guaranteed.achieved_fps, 20.0, 2.0);
+    EXPECT_EQ(starved.granted, 0u);
+    EXPECT_EQ(busy.granted + guaranteed.granted, 201u);  // 200 finished, one on the device
+}
+
+TEST(InferenceSchedulerTest, DropsRequestsPastTheirDeadline) {
+    FakeClock clock;
+    auto scheduler = std::make_shared<InferenceScheduler>(1, clock.Fn());
+    scheduler->SetStreamPolicy("stale", Policy(InferencePriority::kNormal, 1.0, 0.0, 30ms));
+    scheduler->SetStreamPolicy("patient", Policy(InferencePriority::kNormal, 1.0, 0.0, 0ms));
+
+    auto held = scheduler->Acquire("holder");
+    ASSERT_TRUE(IsOk(held));
+
+    std::atomic<bool> stale_dropped{false};
+    std::thread stale([&] { stale_dropped = IsError(scheduler->Acquire("stale")); });
+    ASSERT_TRUE(WaitFor([&] { return scheduler->GetStreamStats("stale").waiting == 1; }));
+    clock.Advance(29ms);
+    std::this_thread::sleep_for(20ms);
+    EXPECT_EQ(scheduler->GetStreamStats("stale").waiting, 1u);  // Not yet due
+
+    clock.Advance(2ms);
+    stale.join();
+    EXPECT_TRUE(stale_dropped.load());
+
+    // No deadline: waits however long the slot is held
+    std::atomic<bool> granted{false};
+    std::thread patient([&] { granted = IsOk(scheduler->Acquire("patient")); });
+    ASSERT_TRUE(WaitFor([&] { return scheduler->GetStreamStats("patient").waiting == 1; }));
+    clock.Advance(1h);
+    std::this_thread::sleep_for(20ms);
+    EXPECT_FALSE(granted.load());
+    std::get<InferenceScheduler::Lease>(held).reset();
+    patient.join();
+    EXPECT_TRUE(granted.load());
+
+    const auto stats = scheduler->GetStreamStats("stale");
+    EXPECT_EQ(stats.dropped, 1u);
+    EXPECT_EQ(stats.granted, 0u);
+    EXPECT_EQ(stats.waiting, 0u);
+    EXPECT_EQ(scheduler->GetInFlight(), 0);
+}
+
+// A stopping worker must not sit out its deadline in Acquire
+TEST(InferenceSchedulerTest, CancelWakesWaitersUntilResumed) {
+    auto scheduler = std::make_shared<InferenceScheduler>(1);
+    scheduler->SetStreamPolicy("cam1", Policy(InferencePriority::kNormal, 1.0, 0.0, 0ms));
+
+    auto held = scheduler->Acquire("holder");
+    ASSERT_TRUE(IsOk(held));
+
+    std::atomic<bool> cancelled{false};
+    std::thread waiter([&] { cancelled = IsError(scheduler->Acquire("cam1")); });
+    ASSERT_TRUE(WaitFor([&] { return scheduler->GetStreamStats("cam1").waiting == 1; }));
+
+    scheduler->Cancel("cam1");
+    waiter.join();
+    EXPECT_TRUE(cancelled.load());
+    EXPECT_EQ(scheduler->GetStreamStats("cam1").waiting, 0u);
+
+    // Stays cancelled for frames arriving later; other streams are unaffected
+    EXPECT_TRUE(IsError(scheduler->Acquire("cam1")));
+    std::get<InferenceScheduler::Lease>(held).reset();
+    EXPECT_TRUE(IsOk(scheduler->Acquire("cam2")));
+
+    scheduler->Resume("cam1");
+    auto resumed = scheduler->Acquire("cam1");
+    EXPECT_TRUE(IsOk(resumed));
+    EXPECT_EQ(scheduler->GetStreamStats("cam1").dropped, 0u);
+}
+
+TEST(InferenceSchedulerTest, ReportsAchievedRatePerStream) {
+    FakeClock clock;
+    auto scheduler = std::make_shared<InferenceScheduler>(4, clock.Fn());
+    for (int i = 0; i < 20; ++i) {
+        auto lease = scheduler->Acquire("cam1");
+        ASSERT_TRUE(IsOk(lease));
+        clock.Advance(10ms);
+    }
+
+    // 20 grants over the 200ms since the stream appeared, none of them waited
+    const auto stats = scheduler->GetStats();
+    ASSERT_EQ(stats.count("cam1"), 1u);
+    const auto& cam1 = stats.at("cam1");
+    EXPECT_EQ(cam1.granted, 20u);
+    EXPECT_EQ(cam1.dropped, 0u);
+    EXPECT_DOUBLE_EQ(cam1.achieved_fps, 100.0);
+    EXPECT_DOUBLE_EQ(cam1.mean_wait_ms, 0.0);
+
+    scheduler->RemoveStream("cam1");
+    EXPECT_TRUE(scheduler->GetStats().empty());
+}
+
+}  // namespace testing
+}  // namespace stream_daemon
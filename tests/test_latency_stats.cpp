@@ -0,0 +1,121 @@
+#include <gtest/gtest.h>
+
+#include "latency_stats.h"
+
+#include <thread>
+#include <vector>
+
+namespace stream_daemon {
+namespace testing {
+
+// ============================================================================
+// LatencyTracker Tests
+// ============================================================================
+
+TEST(LatencyTrackerTest, EmptySummary) {
+    LatencyTracker tracker;
+    const auto summary = tracker.Summary();
+    EXPECT_EQ(summary.count, 0u);
+    EXPECT_EQ(summary.p50_ms, 0);
+    EXPECT_EQ(summary.max_ms, 0);
+    EXPECT_DOUBLE_EQ(summary.mean_ms, 0.0);
+}
+
+TEST(LatencyTrackerTest, Percentiles) {
+    LatencyTracker tracker(100);
+    for (int i = 1; i <= 100; ++i) {
+        tracker.Record(i);
+    }
+
+    const auto summary = tracker.Summary();
+    EXPECT_EQ(summary.count, 100u);
+    EXPECT_EQ(summary.last_ms, 100);
+    EXPECT_DOUBLE_EQ(summary.mean_ms, 50.5);
+    EXPECT_EQ(summary.p50_ms, 51);
+    EXPECT_EQ(summary.p95_ms, 95);
+    EXPECT_EQ(summary.p99_ms, 99);
+    EXPECT_EQ(summary.max_ms, 100);
+}
+
+TEST(LatencyTrackerTest, WindowKeepsRecentSamples) {
+    LatencyTracker tracker(4);
+    for (int i = 0; i < 10; ++i) {
+        tracker.Record(1000);
+    }
+    for (int i = 0; i < 4; ++i) {
+        tracker.Record(10);
+    }
+
+    const auto summary = tracker.Summary();
+    EXPECT_EQ(summary.count, 14u);
+    EXPECT_EQ(summary.max_ms, 10);
+    EXPECT_DOUBLE_EQ(summary.mean_ms, 10.0);
+}
+
+TEST(LatencyTrackerTest, IgnoresNegative) {
+    LatencyTracker tracker;
+    tracker.Record(-5);
+    tracker.Record(20);
+
+    const auto summary = tracker.Summary();
+    EXPECT_EQ(summary.count, 1u);
+    EXPECT_EQ(summary.last_ms, 20);
+}
+
+TEST(LatencyTrackerTest, Reset) {
+    LatencyTracker tracker;
+    tracker.Record(20);
+    tracker.Reset();
+
+    const auto summary = tracker.Summary();
+    EXPECT_EQ(summary.count, 0u);
+    EXPECT_EQ(summary.max_ms, 0);
+}
+
+TEST(LatencyTrackerTest, ConcurrentRecord) {
+    LatencyTracker tracker(64);
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; ++t) {
+        threads.emplace_back([&tracker] {
+            for (int i = 0; i < 1000; ++i) {
+                tracker.Record(i % 50);
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    const auto summary = tracker.Summary();
+    EXPECT_EQ(summary.count, 4000u);
+    EXPECT_LT(summary.max_ms, 50);
+}
+
+// ============================================================================
+// StageTimer Tests
+// ============================================================================
+
+TEST(StageTimerTest, RecordsMicroseconds) {
+    StageTimer timer(8);
+    timer.Record(std::chrono::microseconds(1500));
+    timer.Record(std::chrono::microseconds(500));
+
+    const auto timing = timer.Summary();
+    EXPECT_EQ(timing.count, 2u);
+    EXPECT_EQ(timing.last_us, 500);
+    EXPECT_DOUBLE_EQ(timing.mean_us, 1000.0);
+    EXPECT_EQ(timing.max_us, 1500);
+}
+
+TEST(StageTimerTest, RecordSince) {
+    StageTimer timer;
+    const auto start = std::chrono::steady_clock::now() - std::chrono::milliseconds(2);
+    timer.RecordSince(start);
+
+    const auto timing = timer.Summary();
+    EXPECT_EQ(timing.count, 1u);
+    EXPECT_GE(timing.last_us, 2000);
+}
+
+}  // namespace testing
+}  // namespace stream_daemon
@@ -0,0 +1,96 @@
+#include <gtest/gtest.h>
+
+#include "latest_mailbox.h"
+
+#include <atomic>
+#include <thread>
+
+namespace stream_daemon {
+namespace testing {
+
+// ============================================================================
+// LatestMailbox Tests
+// ============================================================================
+
+TEST(LatestMailboxTest, EmptyTakeReturnsNull) {
+    LatestMailbox<int> mailbox;
+    EXPECT_EQ(mailbox.TryTake(), nullptr);
+}
+
+TEST(LatestMailboxTest, LatestItemWins) {
+    LatestMailbox<int> mailbox;
+
+    EXPECT_FALSE(mailbox.Put(std::make_unique<int>(1)));
+    EXPECT_TRUE(mailbox.Put(std::make_unique<int>(2)));   // replaces 1
+    EXPECT_TRUE(mailbox.Put(std::make_unique<int>(3)));   // replaces 2
+
+    auto item = mailbox.TryTake();
+    ASSERT_NE(item, nullptr);
+    EXPECT_EQ(*item, 3);
+    EXPECT_EQ(mailbox.TryTake(), nullptr);
+}
+
+TEST(LatestMailboxTest, ReplacedItemsAreDeleted) {
+    static int deleted = 0;
+    struct CountingDeleter {
+        void operator()(int* p) const { ++deleted; delete p; }
+    };
+
+    deleted = 0;
+    {
+        LatestMailbox<int, CountingDeleter> mailbox;
+        mailbox.Put(LatestMailbox<int, CountingDeleter>::Ptr(new int(1)));
+        mailbox.Put(LatestMailbox<int, CountingDeleter>::Ptr(new int(2)));
+        EXPECT_EQ(deleted, 1);
+    }
+    EXPECT_EQ(deleted, 2);  // pending item released on destruction
+}
+
+TEST(LatestMailboxTest, CloseWakesWaitingConsumer) {
+    LatestMailbox<int> mailbox;
+    std::atomic<bool> returned{false};
+
+    std::thread consumer([&]() {
+        auto item = mailbox.WaitTake();
+        EXPECT_EQ(item, nullptr);
+        returned = true;
+    });
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    EXPECT_FALSE(returned.load());
+    mailbox.Close();
+    consumer.join();
+    EXPECT_TRUE(returned.load());
+}
+
+TEST(LatestMailboxTest, ConsumerSeesEveryWakeupWithoutLoss) {
+    LatestMailbox<int> mailbox;
+    constexpr int kItems = 10000;
+    std::atomic<int> last_seen{-1};
+    int dropped = 0;
+
+    std::thread consumer([&]() {
+        while (auto item = mailbox.WaitTake()) {
+            EXPECT_GT(*item, last_seen.load());  // never goes backwards
+            last_seen = *item;
+        }
+    });
+
+    for (int i = 0; i < kItems; ++i) {
+        if (mailbox.Put(std::make_unique<int>(i))) {
+            ++dropped;
+        }
+    }
+
+    // The final item must be delivered
+    while (last_seen.load() != kItems - 1) {
+        std::this_thread::yield();
+    }
+    mailbox.Close();
+    consumer.join();
+
+    EXPECT_LT(dropped, kItems);
+}
+
+}  // namespace testing
+}  // namespace stream_daemon
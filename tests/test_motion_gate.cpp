@@ -0,0 +1,210 @@
+#include <gtest/gtest.h>
+
+#include "motion_gate.h"
+
+#include <vector>
+
+namespace stream_daemon {
+namespace testing {
+
+namespace {
+
+constexpr int kWidth = 320;
+constexpr int kHeight = 180;
+
+// NV12 frame with a flat gray background and an optional bright square
+struct Nv12Frame {
+    std::vector<uint8_t> y = std::vector<uint8_t>(kWidth * kHeight, 80);
+    std::vector<uint8_t> uv = std::vector<uint8_t>(kWidth * kHeight / 2, 128);
+
+    void FillSquare(int x0, int y0, int size, uint8_t value) {
+        for (int y = y0; y < y0 + size; ++y) {
+            for (int x = x0; x < x0 + size; ++x) {
+                this->y[y * kWidth + x] = value;
+            }
+        }
+    }
+
+    FrameView View() const {
+        return FrameView::Nv12(y.data(), kWidth, uv.data(), kWidth, kWidth, kHeight);
+    }
+};
+
+MotionGate::Params TestParams() {
+    MotionGate::Params params;
+    params.grid_width = 32;
+    params.grid_height = 18;
+    params.row_step = 2;
+    params.max_skip = std::chrono::milliseconds(1000);
+    return params;
+}
+
+}  // namespace
+
+// ============================================================================
+// MotionGate Tests
+// ============================================================================
+
+TEST(MotionGateTest, FirstFrameInfers) {
+    MotionGate gate(TestParams());
+    Nv12Frame frame;
+    EXPECT_TRUE(gate.ShouldInfer(frame.View(), MotionGate::Clock::time_point{}));
+}
+
+TEST(MotionGateTest, StaticSceneSkips) {
+    MotionGate gate(TestParams());
+    Nv12Frame frame;
+    auto now = MotionGate::Clock::time_point{};
+
+    EXPECT_TRUE(gate.ShouldInfer(frame.View(), now));
+    for (int i = 1; i <= 10; ++i) {
+        now += std::chrono::milliseconds(40);
+        EXPECT_FALSE(gate.ShouldInfer(frame.View(), now)) << "frame " << i;
+    }
+    EXPECT_FLOAT_EQ(gate.GetChangedFraction(), 0.0f);
+}
+
+TEST(MotionGateTest, MovingObjectInfers) {
+    MotionGate gate(TestParams());
+    Nv12Frame frame;
+    auto now = MotionGate::Clock::time_point{};
+    EXPECT_TRUE(gate.ShouldInfer(frame.View(), now));
+
+    // 20x20 object appears: a few cells change by far more than the threshold
+    frame.FillSquare(100, 60, 20, 240);
+    now += std::chrono::milliseconds(40);
+    EXPECT_TRUE(gate.ShouldInfer(frame.View(), now));
+    EXPECT_GT(gate.GetChangedFraction(), 0.0f);
+}
+
+TEST(MotionGateTest, SensorNoiseBelowThresholdSkips) {
+    MotionGate gate(TestParams());
+    Nv12Frame frame;
+    auto now = MotionGate::Clock::time_point{};
+    EXPECT_TRUE(gate.ShouldInfer(frame.View(), now));
+
+    // Checkerboard +-3 around the background averages out per cell
+    for (int y = 0; y < kHeight; ++y) {
+        for (int x = 0; x < kWidth; ++x) {
+            frame.y[y * kWidth + x] = static_cast<uint8_t>(((x + y) & 1) ? 83 : 77);
+        }
+    }
+    now += std::chrono::milliseconds(40);
+    EXPECT_FALSE(gate.ShouldInfer(frame.View(), now));
+}
+
+TEST(MotionGateTest, MaxSkipForcesInference) {
+    MotionGate gate(TestParams());
+    Nv12Frame frame;
+    auto now = MotionGate::Clock::time_point{};
+    EXPECT_TRUE(gate.ShouldInfer(frame.View(), now));
+
+    now += std::chrono::milliseconds(999);
+    EXPECT_FALSE(gate.ShouldInfer(frame.View(), now));
+    now += std::chrono::milliseconds(1);
+    EXPECT_TRUE(gate.ShouldInfer(frame.View(), now));
+
+    // The refresh restarts the interval
+    now += std::chrono::milliseconds(500);
+    EXPECT_FALSE(gate.ShouldInfer(frame.View(), now));
+}
+
+TEST(MotionGateTest, StoppedObjectIsAbsorbed) {
+    MotionGate gate(TestParams());
+    Nv12Frame frame;
+    auto now = MotionGate::Clock::time_point{};
+    EXPECT_TRUE(gate.ShouldInfer(frame.View(), now));
+
+    frame.FillSquare(100, 60, 20, 240);
+    bool absorbed = false;
+    for (int i = 0; i < 60 && !absorbed; ++i) {
+        now += std::chrono::milliseconds(10);
+        absorbed = !gate.ShouldInfer(frame.View(), now);
+    }
+    EXPECT_TRUE(absorbed);
+}
+
+TEST(MotionGateTest, GeometryChangeInfers) {
+    MotionGate gate(TestParams());
+    Nv12Frame frame;
+    auto now = MotionGate::Clock::time_point{};
+    EXPECT_TRUE(gate.ShouldInfer(frame.View(), now));
+    now += std::chrono::milliseconds(40);
+    EXPECT_FALSE(gate.ShouldInfer(frame.View(), now));
+
+    // Same pixels, smaller view (e.g. ROI crop edited)
+    now += std::chrono::milliseconds(40);
+    EXPECT_TRUE(gate.ShouldInfer(frame.View().Crop(0, 0, 160, 90), now));
+}
+
+TEST(MotionGateTest, ResetInfersNextFrame) {
+    MotionGate gate(TestParams());
+    Nv12Frame frame;
+    auto now = MotionGate::Clock::time_point{};
+    EXPECT_TRUE(gate.ShouldInfer(frame.View(), now));
+
+    gate.Reset();
+    now += std::chrono::milliseconds(40);
+    EXPECT_TRUE(gate.ShouldInfer(frame.View(), now));
+}
+
+TEST(MotionGateTest, RgbUsesGreenChannel) {
+    std::vector<uint8_t> pixels(kWidth * kHeight * 3, 80);
+    const auto view = FrameView::Rgb(pixels.data(), kWidth, kHeight);
+    MotionGate gate(TestParams());
+    auto now = MotionGate::Clock::time_point{};
+    EXPECT_TRUE(gate.ShouldInfer(view, now));
+
+    now += std::chrono::milliseconds(40);
+    EXPECT_FALSE(gate.ShouldInfer(view, now));
+
+    for (int y = 60; y < 80; ++y) {
+        for (int x = 100; x < 120; ++x) {
+            pixels[(y * kWidth + x) * 3 + 1] = 250;
+        }
+    }
+    now += std::chrono::milliseconds(40);
+    EXPECT_TRUE(gate.ShouldInfer(view, now));
+}
+
+TEST(MotionGateTest, SimdLevelsAgree) {
+    // Noisy background and a partly changed second frame; the odd width and
+    // cell count exercise the vector and partial-group tails
+    Nv12Frame before;
+    uint32_t seed = 12345;
+    for (auto& value : before.y) {
+        seed = seed * 1103515245u + 12345u;
+        value = static_cast<uint8_t>(seed >> 24);
+    }
+    Nv12Frame after = before;
+    after.FillSquare(37, 23, 61, 255);
+    const FrameView first = before.View().Crop(0, 0, 317, 179);
+    const FrameView second = after.View().Crop(0, 0, 317, 179);
+
+    MotionGate::Params params = TestParams();
+    params.grid_width = 7;
+    params.grid_height = 5;
+    params.row_step = 1;
+
+    MotionGate reference(params, SimdLevel::kScalar);
+    auto now = MotionGate::Clock::time_point{};
+    ASSERT_TRUE(reference.ShouldInfer(first, now));
+    EXPECT_TRUE(reference.ShouldInfer(second, now + std::chrono::milliseconds(40)));
+    const float expected = reference.GetChangedFraction();
+    EXPECT_GT(expected, 0.0f);
+    EXPECT_LT(expected, 1.0f);
+
+    for (SimdLevel level : {SimdLevel::kSse41, SimdLevel::kAvx2, SimdLevel::kNeon}) {
+        if (!IsSimdLevelSupported(level)) {
+            continue;
+        }
+        MotionGate gate(params, level);
+        EXPECT_EQ(gate.GetSimdLevel(), level);
+        ASSERT_TRUE(gate.ShouldInfer(first, now));
+        EXPECT_TRUE(gate.ShouldInfer(second, now + std::chrono::milliseconds(40)));
+        EXPECT_FLOAT_EQ(gate.GetChangedFraction(), expected) << SimdLevelToString(level);
+    }
+}
+
+}  // namespace testing
+}  // namespace stream_daemon
@@ -0,0 +1,99 @@
+#include <gtest/gtest.h>
+
+#include "pts_frame_ring.h"
+
+#include <atomic>
+#include <memory>
+#include <thread>
+
+namespace stream_daemon {
+namespace testing {
+
+namespace {
+
+using Frame = std::shared_ptr<const int>;
+
+Frame MakeFrame(int value) {
+    return std::make_shared<const int>(value);
+}
+
+}  // namespace
+
+// ============================================================================
+// PtsFrameRing Tests
+// ============================================================================
+
+TEST(PtsFrameRingTest, EmptyRingReturnsNull) {
+    PtsFrameRing<Frame> ring(4);
+    EXPECT_EQ(ring.Find(0), nullptr);
+    EXPECT_EQ(ring.Latest(), nullptr);
+    EXPECT_EQ(ring.Size(), 0u);
+}
+
+TEST(PtsFrameRingTest, FindsFrameByPts) {
+    PtsFrameRing<Frame> ring(4);
+    ring.Push(100, MakeFrame(1));
+    ring.Push(200, MakeFrame(2));
+    ring.Push(300, MakeFrame(3));
+
+    ASSERT_NE(ring.Find(200), nullptr);
+    EXPECT_EQ(*ring.Find(200), 2);
+    EXPECT_EQ(ring.Find(250), nullptr);
+    EXPECT_EQ(*ring.Latest(), 3);
+}
+
+TEST(PtsFrameRingTest, EvictsOldestWhenFull) {
+    PtsFrameRing<Frame> ring(2);
+    auto first = MakeFrame(1);
+    std::weak_ptr<const int> first_weak = first;
+    ring.Push(100, std::move(first));
+    ring.Push(200, MakeFrame(2));
+    ring.Push(300, MakeFrame(3));
+
+    EXPECT_EQ(ring.Size(), 2u);
+    EXPECT_EQ(ring.Find(100), nullptr);
+    EXPECT_TRUE(first_weak.expired());  // Released, not just unreachable
+    EXPECT_EQ(*ring.Find(200), 2);
+    EXPECT_EQ(*ring.Latest(), 3);
+}
+
+TEST(PtsFrameRingTest, ClearReleasesFrames) {
+    PtsFrameRing<Frame> ring(4);
+    auto frame = MakeFrame(1);
+    std::weak_ptr<const int> weak = frame;
+    ring.Push(100, std::move(frame));
+
+    ring.Clear();
+    EXPECT_TRUE(weak.expired());
+    EXPECT_EQ(ring.Latest(), nullptr);
+
+    ring.Push(200, MakeFrame(2));  // Usable after Clear()
+    EXPECT_EQ(*ring.Find(200), 2);
+}
+
+TEST(PtsFrameRingTest, ConcurrentPushAndLookup) {
+    PtsFrameRing<Frame> ring(4);
+    std::atomic<bool> done{false};
+
+    std::thread producer([&]() {
+        for (int i = 1; i <= 5000; ++i) {
+            ring.Push(static_cast<uint64_t>(i), MakeFrame(i));
+        }
+        done = true;
+    });
+
+    // A hit always carries the frame pushed with that PTS
+    for (uint64_t pts = 1; !done; pts = pts % 5000 + 1) {
+        if (Frame frame = ring.Find(pts)) {
+            EXPECT_EQ(static_cast<uint64_t>(*frame), pts);
+        }
+        Frame latest = ring.Latest();
+        EXPECT_TRUE(latest == nullptr || *latest >= 1);
+    }
+    producer.join();
+
+    EXPECT_EQ(*ring.Latest(), 5000);
+}
+
+}  // namespace testing
+}  // namespace stream_daemon
@@ -0,0 +1,378 @@
+#include <gtest/gtest.h>
+
+#include "callback_guard.h"
+#include "reconnect_scheduler.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <random>
+#include <thread>
+#include <vector>
+
+namespace stream_daemon {
+namespace testing {
+
+using namespace std::chrono_literals;
+
+namespace {
+
+ReconnectPolicy TestPolicy(int max_builds) {
+    ReconnectPolicy policy;
+    policy.base_delay = 10ms;
+    policy.max_delay = 80ms;
+    policy.jitter = 0.0;
+    policy.max_concurrent_builds = max_builds;
+    policy.build_timeout = 2000ms;
+    return policy;
+}
+
+template <typename Pred>
+bool WaitFor(Pred pred, std::chrono::milliseconds timeout = 2000ms) {
+    const auto deadline = std::chrono::steady_clock::now() + timeout;
+    while (!pred()) {
+        if (std::chrono::steady_clock::now() > deadline) return false;
+        std::this_thread::sleep_for(1ms);
+    }
+    return true;
+}
+
+// Stands in for the GLib main loop: runs posted jobs one at a time on its thread
+class FakeMainLoop {
+public:
+    FakeMainLoop() : thread_([this]() { Run(); }) {}
+
+    ~FakeMainLoop() {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            quit_ = true;
+        }
+        cv_.notify_all();
+        thread_.join();
+    }
+
+    void Post(std::function<void()> job) {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            jobs_.push_back(std::move(job));
+        }
+        cv_.notify_all();
+    }
+
+private:
+    void Run() {
+        std::unique_lock<std::mutex> lock(mutex_);
+        while (true) {
+            cv_.wait(lock, [&] { return quit_ || !jobs_.empty(); });
+            if (jobs_.empty()) {
+                return;
+            }
+            auto job = std::move(jobs_.front());
+            jobs_.pop_front();
+            lock.unlock();
+            std::this_thread::sleep_for(500us);  // Busy loop: jobs queue up behind other work
+            job();
+            lock.lock();
+        }
+    }
+
+    std::mutex mutex_;
+    std::condition_variable cv_;
+    std::deque<std::function<void()>> jobs_;
+    bool quit_{false};
+    std::thread thread_;
+};
+
+// Wired like StreamProcessor: the build fn only posts to the loop, the
+// rebuild runs there under the guard, and Stop() invalidates queued jobs
+class FakeStream {
+public:
+    struct Counters {
+        std::atomic<int> rebuilds{0};
+        std::atomic<int> rebuilds_after_stop{0};  // Job scheduled before a Stop() still ran
+    };
+
+    FakeStream(std::string id, ReconnectScheduler& scheduler, FakeMainLoop& loop,
+               Counters& counters)
+        : id_(std::move(id)), scheduler_(scheduler), loop_(loop), counters_(counters) {}
+
+    ~FakeStream() {
+        guard_.Detach();
+        Stop();
+    }
+
+    void Reconnect() {
+        auto lock = guard_.Lock();
+        ScheduleLocked();
+    }
+
+    void Stop() {
+        auto lock = guard_.Lock();
+        ++stops_;
+        guard_.Invalidate();
+        scheduler_.Cancel(id_);
+    }
+
+private:
+    void ScheduleLocked() {
+        scheduler_.Schedule(id_, 1ms, 0,
+                            [&loop = loop_, ticket = guard_.Issue(), stops = stops_]() {
+            loop.Post([ticket, stops]() {
+                ticket.Run([stops](FakeStream& self) { self.Rebuild(stops); });
+            });
+            return true;
+        });
+    }
+
+    // Main loop: every third build "fails" and retries, the rest reach PLAYING
+    void Rebuild(int stops_when_scheduled) {
+        if (stops_ != stops_when_scheduled) {
+            ++counters_.rebuilds_after_stop;
+        }
+        if (++counters_.rebuilds % 3 == 0) {
+            ScheduleLocked();
+        } else {
+            scheduler_.NotifyBuildComplete(id_);
+        }
+    }
+
+    std::string id_;
+    ReconnectScheduler& scheduler_;
+    FakeMainLoop& loop_;
+    Counters& counters_;
+    int stops_{0};  // Guarded by guard_
+    CallbackGuard<FakeStream> guard_{this};
+};
+
+}  // namespace
+
+// ============================================================================
+// ReconnectScheduler Tests
+// ============================================================================
+
+TEST(ReconnectSchedulerTest, ExponentialBackoffIsCapped) {
+    auto policy = TestPolicy(1);
+    EXPECT_EQ(ReconnectScheduler::BackoffDelay(policy, 1), 10ms);
+    EXPECT_EQ(ReconnectScheduler::BackoffDelay(policy, 2), 20ms);
+    EXPECT_EQ(ReconnectScheduler::BackoffDelay(policy, 3), 40ms);
+    EXPECT_EQ(ReconnectScheduler::BackoffDelay(policy, 4), 80ms);
+    EXPECT_EQ(ReconnectScheduler::BackoffDelay(policy, 10), 80ms);
+}
+
+TEST(ReconnectSchedulerTest, CapsConcurrentBuilds) {
+    ReconnectScheduler scheduler(TestPolicy(2));
+    scheduler.Start();
+
+    std::atomic<int> started{0};
+    for (int i = 0; i < 5; ++i) {
+        scheduler.Schedule("cam" + std::to_string(i), 0ms, 0, [&]() {
+            ++started;
+            return true;  // slot held until NotifyBuildComplete
+        });
+    }
+
+    ASSERT_TRUE(WaitFor([&] { return started.load() == 2; }));
+    std::this_thread::sleep_for(30ms);
+    EXPECT_EQ(started.load(), 2);
+    EXPECT_EQ(scheduler.GetStats().building, 2u);
+    EXPECT_EQ(scheduler.GetStats().scheduled, 3u);
+
+    for (int i = 0; i < 5; ++i) {
+        scheduler.NotifyBuildComplete("cam" + std::to_string(i));
+    }
+    EXPECT_TRUE(WaitFor([&] { return started.load() >= 4; }));
+
+    scheduler.Stop();
+}
+
+TEST(ReconnectSchedulerTest, MostRecentlyHealthyGoesFirst) {
+    ReconnectScheduler scheduler(TestPolicy(1));
+
+    std::mutex order_mutex;
+    std::vector<std::string> order;
+    auto record = [&](const std::string& id) {
+        return [&, id]() {
+            std::lock_guard<std::mutex> lock(order_mutex);
+            order.push_back(id);
+            return false;  // releases the slot immediately
+        };
+    };
+
+    // Schedule before Start so all are due together
+    scheduler.Schedule("stale", 0ms, 100, record("stale"));
+    scheduler.Schedule("fresh", 0ms, 300, record("fresh"));
+    scheduler.Schedule("middle", 0ms, 200, record("middle"));
+    scheduler.Start();
+
+    ASSERT_TRUE(WaitFor([&] {
+        std::lock_guard<std::mutex> lock(order_mutex);
+        return order.size() == 3;
+    }));
+    scheduler.Stop();
+
+    EXPECT_EQ(order, (std::vector<std::string>{"fresh", "middle", "stale"}));
+}
+
+TEST(ReconnectSchedulerTest, CancelDropsPendingReconnect) {
+    ReconnectScheduler scheduler(TestPolicy(1));
+    scheduler.Start();
+
+    std::atomic<bool> ran{false};
+    scheduler.Schedule("cam", 50ms, 0, [&]() { ran = true; return true; });
+    scheduler.Cancel("cam");
+
+    std::this_thread::sleep_for(100ms);
+    EXPECT_FALSE(ran.load());
+    EXPECT_EQ(scheduler.GetStats().scheduled, 0u);
+    scheduler.Stop();
+}
+
+TEST(ReconnectSchedulerTest, BuildTimeoutReleasesSlot) {
+    auto policy = TestPolicy(1);
+    policy.build_timeout = 20ms;
+    ReconnectScheduler scheduler(policy);
+    scheduler.Start();
+
+    std::atomic<int> started{0};
+    scheduler.Schedule("a", 0ms, 0, [&]() { ++started; return true; });
+    scheduler.Schedule("b", 0ms, 0, [&]() { ++started; return true; });
+
+    EXPECT_TRUE(WaitFor([&] { return started.load() == 2; }));
+    EXPECT_GE(scheduler.GetStats().build_timeouts, 1u);
+    scheduler.Stop();
+}
+
+TEST(ReconnectSchedulerTest, ConcurrentScheduleCancelStop) {
+    ReconnectScheduler scheduler(TestPolicy(2));
+    scheduler.Start();
+
+    FakeStream::Counters counters;
+    std::vector<std::unique_ptr<FakeStream>> streams;
+    {
+        FakeMainLoop loop;
+        for (int i = 0; i < 6; ++i) {
+            streams.push_back(std::make_unique<FakeStream>(
+                "cam" + std::to_string(i), scheduler, loop, counters));
+        }
+
+        std::atomic<bool> churning{true};
+        std::atomic<size_t> max_building{0};
+        std::thread monitor([&]() {
+            while (churning) {
+                size_t building = scheduler.GetStats().building;
+                size_t seen = max_building.load();
+                while (building > seen && !max_building.compare_exchange_weak(seen, building)) {}
+                std::this_thread::yield();
+            }
+        });
+
+        std::vector<std::thread> clients;
+        for (int t = 0; t < 3; ++t) {
+            clients.emplace_back([&, t]() {
+                std::mt19937 rng(static_cast<unsigned>(t));
+                while (churning) {
+                    auto& stream = *streams[rng() % streams.size()];
+                    if (rng() % 3 == 0) {
+                        stream.Stop();
+                    } else {
+                        stream.Reconnect();
+                    }
+                    std::this_thread::sleep_for(std::chrono::microseconds(rng() % 2000));
+                }
+            });
+        }
+
+        EXPECT_TRUE(WaitFor([&] { return counters.rebuilds.load() > 50; }));
+        scheduler.Stop();  // Clients keep scheduling while it shuts down
+        const uint64_t dispatched = scheduler.GetStats().dispatched;
+        std::this_thread::sleep_for(20ms);
+
+        churning = false;
+        for (auto& client : clients) {
+            client.join();
+        }
+        monitor.join();
+
+        // Destroy streams while the loop may still hold their jobs
+        streams.clear();
+        std::this_thread::sleep_for(20ms);
+
+        EXPECT_LE(max_building.load(), 2u);
+        EXPECT_EQ(scheduler.GetStats().dispatched, dispatched);
+    }
+
+    EXPECT_EQ(counters.rebuilds_after_stop.load(), 0);
+}
+
+// ============================================================================
+// ReconnectEscalation Tests
+// ============================================================================
+
+using Step = ReconnectEscalation::Step;
+
+// A looped source that sends EOS twice without a frame in between: one soft
+// restart, then rebuilds with growing backoff
+TEST(ReconnectEscalationTest, SoftRestartOnceThenBackoff) {
+    ReconnectEscalation escalation(4);
+    const ReconnectPolicy policy = TestPolicy(1);
+
+    EXPECT_EQ(escalation.OnFailure(true), Step::kSoftRestart);
+    EXPECT_EQ(escalation.GetAttempts(), 1);
+
+    // Second EOS before any frame: no second soft restart
+    EXPECT_EQ(escalation.OnFailure(true), Step::kRebuild);
+    EXPECT_EQ(escalation.GetAttempts(), 2);
+    EXPECT_EQ(ReconnectScheduler::BackoffDelay(policy, escalation.GetAttempts()), 20ms);
+
+    EXPECT_EQ(escalation.OnFailure(true), Step::kRebuild);
+    EXPECT_EQ(ReconnectScheduler::BackoffDelay(policy, escalation.GetAttempts()), 40ms);
+    EXPECT_EQ(escalation.OnFailure(false), Step::kRebuild);
+    EXPECT_EQ(escalation.GetAttempts(), 4);
+
+    // Out of attempts: the count stays put
+    EXPECT_EQ(escalation.OnFailure(true), Step::kGiveUp);
+    EXPECT_EQ(escalation.GetAttempts(), 4);
+}
+
+TEST(ReconnectEscalationTest, GoodFrameStartsOver) {
+    ReconnectEscalation escalation(10);
+
+    EXPECT_EQ(escalation.OnFailure(true), Step::kSoftRestart);
+    escalation.Reset();  // First frame after the soft restart
+    EXPECT_EQ(escalation.OnFailure(true), Step::kSoftRestart);
+    EXPECT_EQ(escalation.OnFailure(true), Step::kRebuild);
+    escalation.Reset();
+    EXPECT_EQ(escalation.GetAttempts(), 0);
+
+    // Failures that cannot be fixed in place rebuild from the first attempt
+    EXPECT_EQ(escalation.OnFailure(false), Step::kRebuild);
+    EXPECT_EQ(escalation.GetAttempts(), 1);
+}
+
+TEST(ReconnectEscalationTest, ConcurrentFailuresCountOnce) {
+    ReconnectEscalation escalation(1000);
+    std::atomic<int> soft_restarts{0};
+
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; ++t) {
+        threads.emplace_back([&] {
+            for (int i = 0; i < 100; ++i) {
+                if (escalation.OnFailure(true) == Step::kSoftRestart) {
+                    ++soft_restarts;
+                }
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    EXPECT_EQ(soft_restarts.load(), 1);
+    EXPECT_EQ(escalation.GetAttempts(), 400);
+}
+
+}  // namespace testing
+}  // namespace stream_daemon
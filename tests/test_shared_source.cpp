@@ -0,0 +1,234 @@
+#include <gtest/gtest.h>
+
+#include "shared_source.h"
+
+#include <atomic>
+#include <chrono>
+#include <map>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+namespace stream_daemon {
+namespace testing {
+
+namespace {
+
+struct FakeSubscriber {
+    std::atomic<int> delivered{0};
+};
+
+// The parts of StreamProcessor a handover touches
+class FakeStream {
+public:
+    explicit FakeStream(std::string id) : id_(std::move(id)) {}
+
+    void SetSharedSource(const std::shared_ptr<FakeStream>& source) { source_ = source; }
+    std::shared_ptr<FakeStream> GetSharedSource() const { return source_.lock(); }
+    std::string_view GetStreamId() const { return id_; }
+
+    void Stop() {
+        running_ = false;
+        ++stops_;
+    }
+
+    VoidResult Start() {
+        if (fail_start_) {
+            return MakeError("start failed");
+        }
+        running_ = true;
+        ++starts_;
+        return MakeOk();
+    }
+
+    bool running_{false};
+    bool fail_start_{false};
+    int stops_{0};
+    int starts_{0};
+
+private:
+    std::string id_;
+    std::weak_ptr<FakeStream> source_;
+};
+
+using Streams = std::map<std::string, std::shared_ptr<FakeStream>, std::less<>>;
+
+std::shared_ptr<FakeStream> AddFake(Streams& streams, const std::string& id,
+                                    const std::shared_ptr<FakeStream>& source = nullptr) {
+    auto stream = std::make_shared<FakeStream>(id);
+    stream->SetSharedSource(source);
+    (void)stream->Start();
+    streams[id] = stream;
+    return stream;
+}
+
+}  // namespace
+
+// ============================================================================
+// SubscriberSet Tests (fan-out)
+// ============================================================================
+
+TEST(SubscriberSetTest, FansOutToEverySubscriber) {
+    SubscriberSet<FakeSubscriber> set;
+    auto first = std::make_shared<FakeSubscriber>();
+    auto second = std::make_shared<FakeSubscriber>();
+    EXPECT_FALSE(set.HasSubscribers());
+
+    set.Add(first);
+    set.Add(second);
+    set.Add(first);  // Already subscribed: no double delivery
+    EXPECT_TRUE(set.HasSubscribers());
+    EXPECT_EQ(set.Size(), 2u);
+
+    for (int i = 0; i < 3; ++i) {
+        set.ForEach([](FakeSubscriber& subscriber) { ++subscriber.delivered; });
+    }
+    EXPECT_EQ(first->delivered, 3);
+    EXPECT_EQ(second->delivered, 3);
+}
+
+TEST(SubscriberSetTest, RemovedSubscriberGetsNothing) {
+    SubscriberSet<FakeSubscriber> set;
+    auto first = std::make_shared<FakeSubscriber>();
+    auto second = std::make_shared<FakeSubscriber>();
+    set.Add(first);
+    set.Add(second);
+
+    set.Remove(first.get());
+    set.ForEach([](FakeSubscriber& subscriber) { ++subscriber.delivered; });
+    EXPECT_EQ(first->delivered, 0);
+    EXPECT_EQ(second->delivered, 1);
+
+    set.Remove(second.get());
+    EXPECT_FALSE(set.HasSubscribers());
+}
+
+TEST(SubscriberSetTest, DoesNotKeepSubscribersAlive) {
+    SubscriberSet<FakeSubscriber> set;
+    auto kept = std::make_shared<FakeSubscriber>();
+    auto dropped = std::make_shared<FakeSubscriber>();
+    std::weak_ptr<FakeSubscriber> dropped_weak = dropped;
+    set.Add(kept);
+    set.Add(dropped);
+
+    dropped.reset();
+    EXPECT_TRUE(dropped_weak.expired());
+    EXPECT_EQ(set.Size(), 1u);
+
+    int calls = 0;
+    set.ForEach([&calls](FakeSubscriber&) { ++calls; });
+    EXPECT_EQ(calls, 1);
+}
+
+TEST(SubscriberSetTest, RemoveWaitsForRunningFanOut) {
+    SubscriberSet<FakeSubscriber> set;
+    auto subscriber = std::make_shared<FakeSubscriber>();
+    set.Add(subscriber);
+
+    std::atomic<bool> in_fan_out{false};
+    std::atomic<bool> release{false};
+    std::thread streaming([&] {
+        set.ForEach([&](FakeSubscriber& s) {
+            in_fan_out = true;
+            while (!release) {
+                std::this_thread::yield();
+            }
+            ++s.delivered;
+        });
+    });
+    while (!in_fan_out) {
+        std::this_thread::yield();
+    }
+
+    std::atomic<bool> removed{false};
+    std::thread remover([&] {
+        set.Remove(subscriber.get());
+        removed = true;
+    });
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    EXPECT_FALSE(removed);
+
+    release = true;
+    streaming.join();
+    remover.join();
+    EXPECT_TRUE(removed);
+    EXPECT_EQ(subscriber->delivered, 1);  // Delivery finished before Remove returned
+}
+
+// ============================================================================
+// HandOverSubscribers Tests (source removal / re-election)
+// ============================================================================
+
+TEST(HandOverSubscribersTest, NoSubscribersIsNoOp) {
+    Streams streams;
+    auto source = AddFake(streams, "cam_a");
+    AddFake(streams, "cam_other");
+
+    EXPECT_EQ(HandOverSubscribers(streams, source.get()), nullptr);
+    EXPECT_EQ(streams["cam_other"]->stops_, 0);
+}
+
+TEST(HandOverSubscribersTest, ElectsFirstSubscriberAndRepointsTheRest) {
+    Streams streams;
+    auto source = AddFake(streams, "cam_a");
+    auto pose = AddFake(streams, "cam_b", source);
+    auto seg = AddFake(streams, "cam_c", source);
+    auto unrelated = AddFake(streams, "cam_d");
+
+    auto elected = HandOverSubscribers(streams, source.get());
+    ASSERT_EQ(elected, pose);
+
+    // New source opens the camera itself, the other subscriber follows it
+    EXPECT_EQ(pose->GetSharedSource(), nullptr);
+    EXPECT_EQ(seg->GetSharedSource(), pose);
+    for (const auto& moved : {pose, seg}) {
+        EXPECT_EQ(moved->stops_, 1);
+        EXPECT_EQ(moved->starts_, 2);
+        EXPECT_TRUE(moved->running_);
+    }
+    EXPECT_EQ(unrelated->stops_, 0);
+
+    // The departing source can now go away without leaving anyone attached
+    streams.erase("cam_a");
+    std::weak_ptr<FakeStream> source_weak = source;
+    source.reset();
+    EXPECT_TRUE(source_weak.expired());
+    for (const auto& [id, stream] : streams) {
+        const auto attached = stream->GetSharedSource();
+        EXPECT_TRUE(!attached || streams.count(std::string(attached->GetStreamId())) > 0) << id;
+    }
+}
+
+TEST(HandOverSubscribersTest, ChainedRemovalReelectsAgain) {
+    Streams streams;
+    auto a = AddFake(streams, "cam_a");
+    auto b = AddFake(streams, "cam_b", a);
+    auto c = AddFake(streams, "cam_c", a);
+
+    ASSERT_EQ(HandOverSubscribers(streams, a.get()), b);
+    streams.erase("cam_a");
+
+    // Removing the elected source hands over once more
+    ASSERT_EQ(HandOverSubscribers(streams, b.get()), c);
+    streams.erase("cam_b");
+    EXPECT_EQ(c->GetSharedSource(), nullptr);
+    EXPECT_TRUE(c->running_);
+}
+
+TEST(HandOverSubscribersTest, FailedRestartDoesNotStopHandover) {
+    Streams streams;
+    auto source = AddFake(streams, "cam_a");
+    auto b = AddFake(streams, "cam_b", source);
+    auto c = AddFake(streams, "cam_c", source);
+    b->fail_start_ = true;
+
+    EXPECT_EQ(HandOverSubscribers(streams, source.get()), b);
+    EXPECT_FALSE(b->running_);
+    EXPECT_TRUE(c->running_);
+    EXPECT_EQ(c->GetSharedSource(), b);
+}
+
+}  // namespace testing
+}  // namespace stream_daemon
@@ -0,0 +1,886 @@
+#include <gtest/gtest.h>
+
+#include "hailo_inference.h"
+#include "inference_scheduler.h"
+#include "simulated_inference_backend.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+namespace stream_daemon {
+namespace testing {
+
+namespace {
+
+constexpr int kModelSize = 64;
+constexpr int kNmsClasses = 2;
+constexpr int kNmsBboxes = 2;
+constexpr size_t kNmsFloats = kNmsClasses * kNmsBboxes * 5;
+
+std::vector<uint8_t> NmsFrame(const std::vector<float>& floats) {
+    std::vector<uint8_t> bytes(floats.size() * sizeof(float));
+    std::memcpy(bytes.data(), floats.data(), bytes.size());
+    return bytes;
+}
+
+// 64x64 RGB model with one on-device NMS output (2 classes x 2 boxes);
+// frame 0 has a class-1 box over the centre, frame 1 nothing
+InferenceRecording MakeNmsRecording() {
+    InferenceRecording recording;
+
+    TensorInfo input;
+    input.name = "sim/input_layer1";
+    input.type = TensorDataType::kUint8;
+    input.height = kModelSize;
+    input.width = kModelSize;
+    input.features = 3;
+    input.frame_size = kModelSize * kModelSize * 3;
+    recording.inputs.push_back(input);
+
+    TensorInfo output;
+    output.name = "sim/yolov8_nms_postprocess";
+    output.type = TensorDataType::kFloat32;
+    output.frame_size = kNmsFloats * sizeof(float);
+    output.nms_classes = kNmsClasses;
+    output.nms_max_bboxes_per_class = kNmsBboxes;
+    recording.outputs.push_back(output);
+
+    std::vector<float> with_box(kNmsFloats, 0.0f);
+    const size_t slot = (1 * kNmsBboxes + 0) * 5;  // class 1, box 0
+    with_box[slot + 0] = 0.25f;  // y_min
+    with_box[slot + 1] = 0.25f;  // x_min
+    with_box[slot + 2] = 0.75f;  // y_max
+    with_box[slot + 3] = 0.75f;  // x_max
+    with_box[slot + 4] = 0.9f;   // score
+
+    recording.frames.push_back({NmsFrame(with_box)});
+    recording.frames.push_back({NmsFrame(std::vector<float>(kNmsFloats, 0.0f))});
+    return recording;
+}
+
+SimulatedDeviceModel FastModel() {
+    SimulatedDeviceModel model;
+    model.latency = std::chrono::milliseconds(1);
+    model.frames_per_second = 0.0;
+    return model;
+}
+
+InferenceRequest WithThreshold(float confidence_threshold) {
+    InferenceRequest request;
+    request.confidence_threshold = confidence_threshold;
+    return request;
+}
+
+std::string TempRecordingPath(const std::string& name) {
+    return (std::filesystem::temp_directory_path() / name).string();
+}
+
+float ReadScore(const std::vector<uint8_t>& output, size_t slot) {
+    float score = 0.0f;
+    std::memcpy(&score, output.data() + (slot * 5 + 4) * sizeof(float), sizeof(float));
+    return score;
+}
+
+// Raw YOLO (pose) model with the P3 outputs only: 960x960 input, 120x120 grid
+constexpr int kRawModelSize = 960;
+constexpr int kRawGrid = 120;
+constexpr int kRawClasses = 2;
+constexpr int kRawKeypoints = 4;
+
+struct RawObject {
+    int gx;
+    int gy;
+    int class_id;
+    uint32_t code;  // Class score code
+};
+
+struct RawClassCodes {
+    TensorDataType type;  // kUint8 or kUint16
+    QuantInfo quant;
+    uint32_t background;  // Code of cells without objects (plus pixel % 21)
+};
+
+// Every output holds quantized codes; float_outputs stores them the way a
+// FLOAT32 user buffer would (dequantised), so both recordings describe the
+// same device output. Object cells get a box of 2/3/4/5 stride units
+// (left/top/right/bottom) around their anchor.
+InferenceRecording MakeRawYoloRecording(const RawClassCodes& classes,
+                                        const std::vector<RawObject>& objects,
+                                        bool float_outputs) {
+    InferenceRecording recording;
+
+    TensorInfo input;
+    input.name = "sim/input_layer1";
+    input.type = TensorDataType::kUint8;
+    input.height = kRawModelSize;
+    input.width = kRawModelSize;
+    input.features = 3;
+    input.frame_size = kRawModelSize * kRawModelSize * 3;
+    recording.inputs.push_back(input);
+
+    constexpr size_t kCells = kRawGrid * kRawGrid;
+    std::vector<std::vector<uint8_t>> frame;
+
+    auto add_output = [&](const std::string& name, int features, TensorDataType type,
+                          QuantInfo quant, const std::vector<uint32_t>& codes) {
+        TensorInfo output;
+        output.name = name;
+        output.type = float_outputs ? TensorDataType::kFloat32 : type;
+        output.height = kRawGrid;
+        output.width = kRawGrid;
+        output.features = features;
+        output.quant = quant;
+
+        std::vector<uint8_t> bytes;
+        if (output.type == TensorDataType::kFloat32) {
+            std::vector<float> values(codes.size());
+            for (size_t i = 0; i < codes.size(); ++i) {
+                values[i] = quant.Dequantize(codes[i]);
+            }
+            bytes.resize(values.size() * sizeof(float));
+            std::memcpy(bytes.data(), values.data(), bytes.size());
+        } else if (output.type == TensorDataType::kUint16) {
+            const std::vector<uint16_t> values(codes.begin(), codes.end());
+            bytes.resize(values.size() * sizeof(uint16_t));
+            std::memcpy(bytes.data(), values.data(), bytes.size());
+        } else {
+            bytes.assign(codes.begin(), codes.end());
+        }
+        output.frame_size = bytes.size();
+        recording.outputs.push_back(output);
+        frame.push_back(std::move(bytes));
+    };
+
+    std::vector<uint32_t> dfl(kCells * 64, 128);
+    std::vector<uint32_t> scores(kCells * kRawClasses);
+    for (size_t i = 0; i < scores.size(); ++i) {
+        scores[i] = classes.background + static_cast<uint32_t>((i / kRawClasses) % 21);
+    }
+    std::vector<uint32_t> keypoints(kCells * kRawKeypoints * 3);
+    for (size_t i = 0; i < keypoints.size(); ++i) {
+        keypoints[i] = static_cast<uint32_t>((i * 7) % 200);
+    }
+    for (const auto& object : objects) {
+        const size_t cell = static_cast<size_t>(object.gy) * kRawGrid + object.gx;
+        for (int edge = 0; edge < 4; ++edge) {
+            dfl[cell * 64 + edge * 16 + 2 + edge] = 228;
+        }
+        scores[cell * kRawClasses + object.class_id] = object.code;
+    }
+
+    add_output("sim/conv43", 64, TensorDataType::kUint8, QuantInfo{0.1f, 128.0f}, dfl);
+    add_output("sim/conv44", kRawClasses, classes.type, classes.quant, scores);
+    add_output("sim/conv45", kRawKeypoints * 3, TensorDataType::kUint8,
+               QuantInfo{0.05f, 100.0f}, keypoints);
+
+    recording.frames.push_back(std::move(frame));
+    return recording;
+}
+
+void ExpectSameDetections(const std::vector<Detection>& expected,
+                          const std::vector<Detection>& actual) {
+    ASSERT_EQ(actual.size(), expected.size());
+    for (size_t i = 0; i < expected.size(); ++i) {
+        EXPECT_EQ(actual[i].class_id, expected[i].class_id);
+        EXPECT_EQ(actual[i].bbox.x, expected[i].bbox.x);
+        EXPECT_EQ(actual[i].bbox.y, expected[i].bbox.y);
+        EXPECT_EQ(actual[i].bbox.width, expected[i].bbox.width);
+        EXPECT_EQ(actual[i].bbox.height, expected[i].bbox.height);
+        EXPECT_FLOAT_EQ(actual[i].confidence, expected[i].confidence);
+        ASSERT_EQ(actual[i].keypoints.size(), expected[i].keypoints.size());
+        for (size_t k = 0; k < expected[i].keypoints.size(); ++k) {
+            EXPECT_FLOAT_EQ(actual[i].keypoints[k].x, expected[i].keypoints[k].x);
+            EXPECT_FLOAT_EQ(actual[i].keypoints[k].y, expected[i].keypoints[k].y);
+            EXPECT_FLOAT_EQ(actual[i].keypoints[k].visible, expected[i].keypoints[k].visible);
+        }
+    }
+}
+
+}  // namespace
+
+// ============================================================================
+// InferenceRecording
+// ============================================================================
+
+TEST(InferenceRecordingTest, SaveLoadRoundTrip) {
+    const auto recording = MakeNmsRecording();
+    const std::string path = TempRecordingPath("sd_recording_roundtrip.rec");
+
+    ASSERT_TRUE(IsOk(recording.Save(path)));
+    auto loaded = InferenceRecording::Load(path);
+    std::remove(path.c_str());
+    ASSERT_TRUE(IsOk(loaded)) << GetError(loaded);
+
+    const auto& value = GetValue(loaded);
+    EXPECT_EQ(value.batch_size, 1);
+    ASSERT_EQ(value.inputs.size(), 1u);
+    ASSERT_EQ(value.outputs.size(), 1u);
+    EXPECT_EQ(value.inputs[0].name, "sim/input_layer1");
+    EXPECT_EQ(value.inputs[0].width, kModelSize);
+    EXPECT_EQ(value.inputs[0].frame_size, recording.inputs[0].frame_size);
+    EXPECT_EQ(value.outputs[0].type, TensorDataType::kFloat32);
+    EXPECT_EQ(value.outputs[0].nms_classes, kNmsClasses);
+    EXPECT_EQ(value.outputs[0].nms_max_bboxes_per_class, kNmsBboxes);
+    EXPECT_EQ(value.frames, recording.frames);
+}
+
+TEST(InferenceRecordingTest, LoadRejectsMissingAndForeignFiles) {
+    EXPECT_TRUE(IsError(InferenceRecording::Load("/nonexistent/model.rec")));
+
+    const std::string path = TempRecordingPath("sd_recording_foreign.rec");
+    {
+        std::FILE* file = std::fopen(path.c_str(), "wb");
+        ASSERT_NE(file, nullptr);
+        std::fputs("HEF not a recording", file);
+        std::fclose(file);
+    }
+    EXPECT_TRUE(IsError(InferenceRecording::Load(path)));
+    std::remove(path.c_str());
+}
+
+TEST(InferenceRecordingTest, ValidateRejectsWrongOutputSize) {
+    auto recording = MakeNmsRecording();
+    recording.frames[1][0].pop_back();
+    EXPECT_TRUE(IsError(recording.Validate()));
+    EXPECT_TRUE(IsError(recording.Save(TempRecordingPath("sd_recording_invalid.rec"))));
+}
+
+// ============================================================================
+// SimulatedInferenceBackend
+// ============================================================================
+
+TEST(SimulatedInferenceBackendTest, ReplaysRecordedFramesInOrder) {
+    SimulatedInferenceBackend backend(MakeNmsRecording(), FastModel());
+    ASSERT_TRUE(IsOk(backend.Configure("ignored.hef")));
+    EXPECT_EQ(backend.GetName(), "simulated");
+    ASSERT_EQ(backend.GetOutputs().size(), 1u);
+
+    const std::vector<uint8_t> input(backend.GetInputs()[0].frame_size, 0);
+    std::vector<uint8_t> output(backend.GetOutputs()[0].frame_size);
+
+    // Frames cycle 0, 1, 0
+    const float expected[] = {0.9f, 0.0f, 0.9f};
+    for (float score : expected) {
+        ASSERT_TRUE(IsOk(backend.Write(input.data(), input.size())));
+        ASSERT_TRUE(IsOk(backend.Read(0, output.data(), output.size())));
+        EXPECT_FLOAT_EQ(ReadScore(output, 1 * kNmsBboxes), score);
+    }
+    EXPECT_EQ(backend.GetFramesWritten(), 3u);
+}
+
+TEST(SimulatedInferenceBackendTest, RejectsWrongSizes) {
+    SimulatedInferenceBackend backend(MakeNmsRecording(), FastModel());
+    ASSERT_TRUE(IsOk(backend.Configure("")));
+
+    std::vector<uint8_t> buffer(16);
+    EXPECT_TRUE(IsError(backend.Write(buffer.data(), buffer.size())));
+    EXPECT_TRUE(IsError(backend.Read(0, buffer.data(), buffer.size())));
+    EXPECT_TRUE(IsError(backend.Read(1, buffer.data(), buffer.size())));
+}
+
+TEST(SimulatedInferenceBackendTest, ConfigureLoadsRecordingFromPath) {
+    const std::string path = TempRecordingPath("sd_recording_configure.rec");
+    ASSERT_TRUE(IsOk(MakeNmsRecording().Save(path)));
+
+    SimulatedInferenceBackend from_model_path(FastModel());
+    EXPECT_TRUE(IsOk(from_model_path.Configure(path)));
+    EXPECT_EQ(from_model_path.GetInputs().size(), 1u);
+
+    SimulatedInferenceBackend from_recording_path(FastModel(), path);
+    EXPECT_TRUE(IsOk(from_recording_path.Configure("model.hef")));
+
+    SimulatedInferenceBackend missing(FastModel(), "/nonexistent/model.rec");
+    EXPECT_TRUE(IsError(missing.Configure(path)));
+    std::remove(path.c_str());
+}
+
+TEST(SimulatedInferenceBackendTest, ThroughputLimitedByFrameRate) {
+    SimulatedDeviceModel model;
+    model.latency = std::chrono::milliseconds(1);
+    model.frames_per_second = 200.0;  // 5ms per frame
+    model.queue_depth = 4;
+    SimulatedInferenceBackend backend(MakeNmsRecording(), model);
+    ASSERT_TRUE(IsOk(backend.Configure("")));
+
+    constexpr int kFrames = 20;
+    const std::vector<uint8_t> input(backend.GetInputs()[0].frame_size, 0);
+    const auto start = std::chrono::steady_clock::now();
+
+    std::thread writer([&] {
+        for (int i = 0; i < kFrames; ++i) {
+            EXPECT_TRUE(IsOk(backend.Write(input.data(), input.size())));
+        }
+    });
+    std::vector<uint8_t> output(backend.GetOutputs()[0].frame_size);
+    for (int i = 0; i < kFrames; ++i) {
+        EXPECT_TRUE(IsOk(backend.Read(0, output.data(), output.size())));
+    }
+    writer.join();
+
+    const auto elapsed = std::chrono::steady_clock::now() - start;
+    EXPECT_GE(elapsed, std::chrono::milliseconds(90));  // 19 intervals after the first frame
+}
+
+TEST(SimulatedInferenceBackendTest, WriteBlocksWhileQueueIsFull) {
+    SimulatedDeviceModel model = FastModel();
+    model.queue_depth = 2;
+    SimulatedInferenceBackend backend(MakeNmsRecording(), model);
+    ASSERT_TRUE(IsOk(backend.Configure("")));
+
+    const std::vector<uint8_t> input(backend.GetInputs()[0].frame_size, 0);
+    ASSERT_TRUE(IsOk(backend.Write(input.data(), input.size())));
+    ASSERT_TRUE(IsOk(backend.Write(input.data(), input.size())));
+
+    std::thread third([&] { EXPECT_TRUE(IsOk(backend.Write(input.data(), input.size()))); });
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    EXPECT_EQ(backend.GetFramesWritten(), 2u);
+
+    std::vector<uint8_t> output(backend.GetOutputs()[0].frame_size);
+    ASSERT_TRUE(IsOk(backend.Read(0, output.data(), output.size())));
+    third.join();
+    EXPECT_EQ(backend.GetFramesWritten(), 3u);
+
+    ASSERT_TRUE(IsOk(backend.Read(0, output.data(), output.size())));
+    ASSERT_TRUE(IsOk(backend.Read(0, output.data(), output.size())));
+}
+
+TEST(SimulatedInferenceBackendTest, RunsFullAndTimedOutBatches) {
+    SimulatedDeviceModel model = FastModel();
+    model.batch_size = 4;
+    model.batch_timeout = std::chrono::milliseconds(20);
+    SimulatedInferenceBackend backend(MakeNmsRecording(), model);
+    ASSERT_TRUE(IsOk(backend.Configure("")));
+    EXPECT_EQ(backend.GetBatchSize(), 4);
+
+    const std::vector<uint8_t> input(backend.GetInputs()[0].frame_size, 0);
+    std::vector<uint8_t> output(backend.GetOutputs()[0].frame_size);
+
+    // A full batch starts on its last write
+    for (int i = 0; i < 4; ++i) {
+        ASSERT_TRUE(IsOk(backend.Write(input.data(), input.size())));
+    }
+    EXPECT_EQ(backend.GetBatchesRun(), 1u);
+    for (int i = 0; i < 4; ++i) {
+        ASSERT_TRUE(IsOk(backend.Read(0, output.data(), output.size())));
+    }
+
+    // A single frame runs alone once the batch timeout passes
+    ASSERT_TRUE(IsOk(backend.Write(input.data(), input.size())));
+    const auto start = std::chrono::steady_clock::now();
+    ASSERT_TRUE(IsOk(backend.Read(0, output.data(), output.size())));
+    EXPECT_GE(std::chrono::steady_clock::now() - start, std::chrono::milliseconds(15));
+    EXPECT_EQ(backend.GetBatchesRun(), 2u);
+    EXPECT_EQ(backend.GetFramesWritten(), 5u);
+}
+
+// ============================================================================
+// RecordingInferenceBackend
+// ============================================================================
+
+TEST(RecordingInferenceBackendTest, CapturesOutputsForReplay) {
+    const std::string path = TempRecordingPath("sd_recording_capture.rec");
+    std::remove(path.c_str());
+
+    RecordingInferenceBackend recorder(
+        std::make_unique<SimulatedInferenceBackend>(MakeNmsRecording(), FastModel()), path, 2);
+    ASSERT_TRUE(IsOk(recorder.Configure("model.hef")));
+
+    const std::vector<uint8_t> input(recorder.GetInputs()[0].frame_size, 0);
+    std::vector<uint8_t> output(recorder.GetOutputs()[0].frame_size);
+    for (int i = 0; i < 3; ++i) {
+        ASSERT_TRUE(IsOk(recorder.Write(input.data(), input.size())));
+        ASSERT_TRUE(IsOk(recorder.Read(0, output.data(), output.size())));
+    }
+
+    auto loaded = InferenceRecording::Load(path);
+    std::remove(path.c_str());
+    ASSERT_TRUE(IsOk(loaded)) << GetError(loaded);
+    EXPECT_EQ(GetValue(loaded).frames, MakeNmsRecording().frames);
+}
+
+// ============================================================================
+// HailoInference on the simulated device
+// ============================================================================
+
+class SimulatedHailoInferenceTest : public ::testing::Test {
+protected:
+    static constexpr const char* kModelPath = "simulated_nms_model.hef";
+
+    void SetUp() override {
+        model_ = FastModel();
+        recording_ = MakeNmsRecording();
+    }
+
+    void TearDown() override {
+        for (const auto& path : paths_) {
+            HailoInference::ReleaseInstance(path);
+        }
+        HailoInference::SetBackendFactory({});
+    }
+
+    // backend_ points at the instance's device until TearDown
+    std::shared_ptr<HailoInference> Create(const std::string& path = kModelPath) {
+        const auto model = model_;
+        const auto recording = recording_;
+        HailoInference::SetBackendFactory([this, model, recording](const std::string&,
+                                                                   const std::string&) {
+            auto backend = std::make_unique<SimulatedInferenceBackend>(recording, model);
+            backend_ = backend.get();
+            return backend;
+        });
+        paths_.push_back(path);
+        auto result = HailoInference::GetInstance(path);
+        EXPECT_TRUE(IsOk(result)) << GetError(result);
+        return IsOk(result) ? GetValue(result) : nullptr;
+    }
+
+    SimulatedDeviceModel model_;
+    InferenceRecording recording_;
+    SimulatedInferenceBackend* backend_{nullptr};
+    std::vector<std::string> paths_;
+};
+
+TEST_F(SimulatedHailoInferenceTest, ParsesReplayedNmsOutput) {
+    auto inference = Create();
+    ASSERT_NE(inference, nullptr);
+    EXPECT_TRUE(inference->IsReady());
+    EXPECT_EQ(inference->GetInputWidth(), kModelSize);
+    EXPECT_EQ(inference->GetInputHeight(), kModelSize);
+
+    const std::vector<uint8_t> rgb(kModelSize * kModelSize * 3, 128);
+    const auto frame = FrameView::Rgb(rgb.data(), kModelSize, kModelSize);
+
+    const auto detections = inference->RunInference(frame, WithThreshold(0.5f));
+    ASSERT_EQ(detections.size(), 1u);
+    EXPECT_EQ(detections[0].class_id, 1);
+    EXPECT_FLOAT_EQ(detections[0].confidence, 0.9f);
+    EXPECT_EQ(detections[0].bbox.x, 16);
+    EXPECT_EQ(detections[0].bbox.y, 16);
+    EXPECT_EQ(detections[0].bbox.width, 32);
+    EXPECT_EQ(detections[0].bbox.height, 32);
+
+    // Second recorded frame is empty
+    EXPECT_TRUE(inference->RunInference(frame, WithThreshold(0.5f)).empty());
+}
+
+TEST_F(SimulatedHailoInferenceTest, ConcurrentCallersOverlapOnDevice) {
+    model_.latency = std::chrono::milliseconds(20);
+    auto inference = Create();
+    ASSERT_NE(inference, nullptr);
+
+    const std::vector<uint8_t> rgb(kModelSize * kModelSize * 3, 128);
+    const auto frame = FrameView::Rgb(rgb.data(), kModelSize, kModelSize);
+
+    constexpr int kCallers = 4;
+    constexpr int kFramesPerCaller = 5;
+    const auto start = std::chrono::steady_clock::now();
+    std::vector<std::thread> callers;
+    for (int c = 0; c < kCallers; ++c) {
+        callers.emplace_back([&] {
+            for (int i = 0; i < kFramesPerCaller; ++i) {
+                (void)inference->RunInference(frame, WithThreshold(0.5f));
+            }
+        });
+    }
+    for (auto& caller : callers) {
+        caller.join();
+    }
+    const auto elapsed = std::chrono::steady_clock::now() - start;
+
+    // Serial would take 20 x 20ms; frames in flight overlap their latency
+    EXPECT_LT(elapsed, std::chrono::milliseconds(kCallers * kFramesPerCaller * 20 * 3 / 4));
+    EXPECT_EQ(inference->GetInferenceTiming().count,
+              static_cast<uint64_t>(kCallers * kFramesPerCaller));
+}
+
+TEST_F(SimulatedHailoInferenceTest, PartialBatchWritesOnlyRealFrames) {
+    model_.batch_size = 4;
+    auto inference = Create();
+    ASSERT_NE(inference, nullptr);
+    ASSERT_EQ(inference->GetBatchSize(), 4);
+
+    const std::vector<uint8_t> rgb(kModelSize * kModelSize * 3, 128);
+    HailoInference::FrameInput input;
+    input.frame = FrameView::Rgb(rgb.data(), kModelSize, kModelSize);
+    input.stream_id = "cam1";
+    input.request = WithThreshold(0.5f);
+
+    const auto results = inference->RunBatchInference({input});
+    ASSERT_EQ(results.size(), 1u);
+    EXPECT_EQ(results.at("cam1").size(), 1u);
+    EXPECT_EQ(backend_->GetFramesWritten(), 1u);
+    EXPECT_EQ(backend_->GetBatchesRun(), 1u);
+}
+
+TEST_F(SimulatedHailoInferenceTest, BatchFramesUseTheirOwnThresholdAndConfig) {
+    model_.batch_size = 2;
+    recording_.frames.resize(1);  // Every frame has the class-1 box (score 0.9)
+    auto inference = Create();
+    ASSERT_NE(inference, nullptr);
+
+    ModelSpec spec;
+    spec.labels = {"car", "truck"};
+    const auto labels = inference->GetContext(spec);
+
+    const std::vector<uint8_t> rgb(kModelSize * kModelSize * 3, 128);
+    std::vector<HailoInference::FrameInput> inputs(3);
+    for (auto& input : inputs) {
+        input.frame = FrameView::Rgb(rgb.data(), kModelSize, kModelSize);
+    }
+    inputs[0].stream_id = "strict";
+    inputs[0].request = WithThreshold(0.95f);
+    inputs[1].stream_id = "labelled";
+    inputs[1].request = InferenceRequest{labels, 0.5f};
+    inputs[2].stream_id = "default";  // Default context and its threshold
+
+    const auto results = inference->RunBatchInference(inputs);
+    ASSERT_EQ(results.size(), 3u);
+    EXPECT_TRUE(results.at("strict").empty());
+    ASSERT_EQ(results.at("labelled").size(), 1u);
+    EXPECT_EQ(results.at("labelled")[0].class_name, "truck");
+    ASSERT_EQ(results.at("default").size(), 1u);
+    EXPECT_EQ(results.at("default")[0].class_name, "bicycle");  // COCO fallback
+}
+
+TEST_F(SimulatedHailoInferenceTest, ContextsAreSharedPerSpec) {
+    auto inference = Create();
+    ASSERT_NE(inference, nullptr);
+
+    const auto defaults = inference->GetDefaultContext();
+    ASSERT_NE(defaults, nullptr);
+    EXPECT_EQ(defaults->decoder, OutputDecoder::kNms);
+    EXPECT_EQ(defaults->num_classes, kNmsClasses);
+    EXPECT_EQ(defaults->max_bboxes_per_class, kNmsBboxes);
+    EXPECT_EQ(inference->GetContext(ModelSpec{}), defaults);
+
+    ModelSpec spec;
+    spec.labels = {"car", "truck"};
+    const auto labelled = inference->GetContext(spec);
+    EXPECT_NE(labelled, defaults);
+    EXPECT_EQ(inference->GetContext(spec), labelled);
+    EXPECT_EQ(labelled->decoder, defaults->decoder);
+    EXPECT_EQ(labelled->num_classes, defaults->num_classes);
+
+    spec.confidence_threshold = 0.7f;
+    EXPECT_NE(inference->GetContext(spec), labelled);
+
+    // Labels first, then COCO, then a generic name
+    EXPECT_EQ(labelled->ClassName(1), "truck");
+    EXPECT_EQ(labelled->ClassName(3), "motorcycle");
+    EXPECT_EQ(defaults->ClassName(0), "person");
+    EXPECT_EQ(defaults->ClassName(1000), "object");
+}
+
+TEST_F(SimulatedHailoInferenceTest, UnusedContextsAreReleased) {
+    auto inference = Create();
+    ASSERT_NE(inference, nullptr);
+
+    // Every spec a stream ever used must not stay alive for the model's lifetime
+    for (int i = 0; i < 50; ++i) {
+        ModelSpec spec;
+        spec.confidence_threshold = 0.01f * static_cast<float>(i + 1);
+        auto context = inference->GetContext(spec);
+        ASSERT_NE(context, nullptr);
+    }
+    EXPECT_EQ(inference->GetContextCount(), 0u);
+
+    ModelSpec spec;
+    spec.labels = {"car"};
+    auto held = inference->GetContext(spec);
+    ModelSpec other;
+    other.labels = {"bus"};
+    std::weak_ptr<const ModelContext> released = inference->GetContext(other);
+    EXPECT_TRUE(released.expired());
+    EXPECT_EQ(inference->GetContext(spec), held);
+    EXPECT_EQ(inference->GetContextCount(), 1u);
+}
+
+// Streams with different labels share one model instance; none of them
+// changes what the others parse
+TEST_F(SimulatedHailoInferenceTest, ConcurrentStreamsKeepTheirOwnContext) {
+    recording_.frames.resize(1);  // Every frame has the class-1 box
+    auto inference = Create();
+    ASSERT_NE(inference, nullptr);
+
+    constexpr int kStreams = 16;
+    constexpr int kFramesPerStream = 10;
+    const std::vector<uint8_t> rgb(kModelSize * kModelSize * 3, 128);
+    const auto frame = FrameView::Rgb(rgb.data(), kModelSize, kModelSize);
+
+    std::vector<int> mismatches(kStreams, 0);
+    std::vector<std::thread> streams;
+    for (int s = 0; s < kStreams; ++s) {
+        streams.emplace_back([&, s] {
+            ModelSpec spec;
+            spec.labels = {"bg", "class" + std::to_string(s)};
+            const InferenceRequest request{inference->GetContext(spec), -1.0f};
+            for (int i = 0; i < kFramesPerStream; ++i) {
+                const auto detections = inference->RunInference(frame, request);
+                if (detections.size() != 1 || detections[0].class_name != spec.labels[1]) {
+                    ++mismatches[s];
+                }
+            }
+        });
+    }
+    for (auto& stream : streams) {
+        stream.join();
+    }
+
+    for (int s = 0; s < kStreams; ++s) {
+        EXPECT_EQ(mismatches[s], 0) << "stream " << s;
+    }
+}
+
+// A critical 5 fps camera next to a backlogged busy one: without the
+// scheduler its frames queue behind the busy camera's on the device
+TEST_F(SimulatedHailoInferenceTest, SchedulerKeepsCriticalStreamResponsive) {
+    model_.latency = std::chrono::milliseconds(10);
+    model_.frames_per_second = 100.0;
+    model_.queue_depth = 8;
+    auto inference = Create();
+    ASSERT_NE(inference, nullptr);
+
+    const std::vector<uint8_t> rgb(kModelSize * kModelSize * 3, 128);
+    const auto frame = FrameView::Rgb(rgb.data(), kModelSize, kModelSize);
+
+    // Mean critical-frame latency (admission + inference), in ms
+    auto run = [&](std::shared_ptr<InferenceScheduler> scheduler) {
+        std::atomic<bool> running{true};
+        auto infer = [&](const std::string& stream_id) {
+            InferenceScheduler::Lease lease;
+            if (scheduler) {
+                auto result = scheduler->Acquire(stream_id);
+                if (IsError(result)) {
+                    return;
+                }
+                lease = GetValue(std::move(result));
+            }
+            (void)inference->RunInference(frame, WithThreshold(0.5f));
+        };
+
+        std::vector<std::thread> busy;
+        for (int i = 0; i < 6; ++i) {
+            busy.emplace_back([&] {
+                while (running) {
+                    infer("busy");
+                }
+            });
+        }
+
+        double total_ms = 0.0;
+        constexpr int kCriticalFrames = 8;
+        for (int i = 0; i < kCriticalFrames; ++i) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(50));
+            const auto start = std::chrono::steady_clock::now();
+            infer("critical");
+            total_ms += std::chrono::duration<double, std::milli>(
+                std::chrono::steady_clock::now() - start).count();
+        }
+        running = false;
+        for (auto& thread : busy) {
+            thread.join();
+        }
+        return total_ms / kCriticalFrames;
+    };
+
+    const double unscheduled_ms = run(nullptr);
+
+    auto scheduler = std::make_shared<InferenceScheduler>(2);
+    InferenceScheduler::StreamPolicy critical;
+    critical.priority = InferencePriority::kCritical;
+    critical.min_fps = 5.0;
+    scheduler->SetStreamPolicy("critical", critical);
+    const double scheduled_ms = run(scheduler);
+
+    std::cout << "[ critical latency ] unscheduled " << unscheduled_ms << " ms, scheduled "
+              << scheduled_ms << " ms" << std::endl;
+    EXPECT_LT(scheduled_ms, unscheduled_ms * 0.75);
+
+    const auto stats = scheduler->GetStats();
+    EXPECT_EQ(stats.at("critical").granted, 8u);
+    EXPECT_EQ(stats.at("critical").dropped, 0u);
+    EXPECT_GT(stats.at("busy").granted, stats.at("critical").granted);
+}
+
+// Device with a fixed cost per batch: larger batches amortise it. Frames go
+// through RunBatchInference in groups of the batch size, as
+// BatchInferenceManager submits them.
+TEST_F(SimulatedHailoInferenceTest, BatchSizeThroughputComparison) {
+    model_.latency = std::chrono::milliseconds(2);
+    model_.frames_per_second = 1000.0;  // 1ms per frame
+    model_.batch_overhead = std::chrono::milliseconds(6);
+
+    constexpr int kFrames = 48;
+    const std::vector<uint8_t> rgb(kModelSize * kModelSize * 3, 128);
+    std::vector<double> fps_by_batch;
+
+    for (int batch : {1, 2, 4, 8}) {
+        model_.batch_size = batch;
+        auto inference = Create("simulated_batch" + std::to_string(batch) + ".hef");
+        ASSERT_NE(inference, nullptr);
+        ASSERT_EQ(inference->GetBatchSize(), batch);
+
+        std::vector<HailoInference::FrameInput> inputs(batch);
+        for (int i = 0; i < batch; ++i) {
+            inputs[i].frame = FrameView::Rgb(rgb.data(), kModelSize, kModelSize);
+            inputs[i].stream_id = "cam" + std::to_string(i);
+            inputs[i].request = WithThreshold(0.5f);
+        }
+
+        const auto start = std::chrono::steady_clock::now();
+        for (int done = 0; done < kFrames; done += batch) {
+            EXPECT_EQ(inference->RunBatchInference(inputs).size(),
+                      static_cast<size_t>(batch));
+        }
+        const double seconds =
+            std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        fps_by_batch.push_back(kFrames / seconds);
+        EXPECT_EQ(backend_->GetBatchesRun(), static_cast<uint64_t>(kFrames / batch));
+
+        std::cout << "[ batch " << batch << " ] " << static_cast<int>(fps_by_batch.back())
+                  << " fps" << std::endl;
+    }
+
+    // Ideal: 1 -> 143 fps, 2 -> 250, 4 -> 400, 8 -> 571
+    for (size_t i = 1; i < fps_by_batch.size(); ++i) {
+        EXPECT_GT(fps_by_batch[i], fps_by_batch[i - 1]);
+    }
+    EXPECT_GT(fps_by_batch.back(), 2.5 * fps_by_batch.front());
+}
+
+// ============================================================================
+// Quantized raw YOLO outputs
+// ============================================================================
+
+class QuantizedRawYoloTest : public SimulatedHailoInferenceTest {
+protected:
+    // Detections of one frame with the outputs read as FLOAT32 and as codes
+    std::pair<std::vector<Detection>, std::vector<Detection>> RunBoth(
+        const RawClassCodes& classes, const std::vector<RawObject>& objects, float threshold) {
+        ModelSpec spec;
+        spec.task = "pose";
+        spec.num_keypoints = kRawKeypoints;
+        spec.labels = {"a", "b"};
+
+        const std::vector<uint8_t> rgb(kRawModelSize * kRawModelSize * 3, 128);
+        const auto frame = FrameView::Rgb(rgb.data(), kRawModelSize, kRawModelSize);
+
+        std::vector<Detection> results[2];
+        for (bool float_outputs : {true, false}) {
+            recording_ = MakeRawYoloRecording(classes, objects, float_outputs);
+            auto inference = Create(float_outputs ? "simulated_raw_float.hef"
+                                                  : "simulated_raw_quantized.hef");
+            if (!inference) {
+                return {};
+            }
+            EXPECT_EQ(inference->GetDefaultContext()->decoder, OutputDecoder::kRawYolo);
+            results[float_outputs ? 0 : 1] = inference->RunInference(
+                frame, InferenceRequest{inference->GetContext(spec), threshold});
+        }
+        return {results[0], results[1]};
+    }
+};
+
+TEST_F(QuantizedRawYoloTest, ProbabilityScoresMatchFloatOutputs) {
+    // 1/255 steps: code 128 is 0.502 (passes 0.5), 127 is 0.498 (does not)
+    const RawClassCodes classes{TensorDataType::kUint8, QuantInfo{1.0f / 255.0f, 0.0f}, 0};
+    const std::vector<RawObject> objects = {
+        {30, 40, 1, 230},
+        {80, 20, 0, 128},
+        {10, 10, 1, 127},
+    };
+
+    const auto [float_detections, quantized_detections] = RunBoth(classes, objects, 0.5f);
+    ASSERT_EQ(float_detections.size(), 2u);
+    ExpectSameDetections(float_detections, quantized_detections);
+
+    for (const auto& detection : quantized_detections) {
+        EXPECT_EQ(detection.keypoints.size(), static_cast<size_t>(kRawKeypoints));
+        EXPECT_GE(detection.confidence, 0.5f);
+    }
+    const auto top = std::max_element(
+        quantized_detections.begin(), quantized_detections.end(),
+        [](const Detection& a, const Detection& b) { return a.confidence < b.confidence; });
+    EXPECT_EQ(top->class_name, "b");
+    EXPECT_FLOAT_EQ(top->confidence, 230.0f / 255.0f);
+    // Anchor (30.5, 40.5) * 8, left 2 and right 4 strides, top 3 and bottom 5
+    EXPECT_NEAR(top->bbox.x, 228, 1);
+    EXPECT_NEAR(top->bbox.y, 300, 1);
+    EXPECT_NEAR(top->bbox.width, 48, 1);
+    EXPECT_NEAR(top->bbox.height, 64, 1);
+}
+
+TEST_F(QuantizedRawYoloTest, LogitScoresMatchFloatOutputs) {
+    // UINT16 logits: code 25000 is -5 (0.007), 33000 is +3 (0.953)
+    const RawClassCodes classes{TensorDataType::kUint16, QuantInfo{0.001f, 30000.0f}, 25000};
+    const std::vector<RawObject> objects = {
+        {50, 60, 0, 33000},
+        {100, 90, 1, 31100},  // +1.1 (0.750)
+        {70, 70, 1, 31050},   // +1.05 (0.741): below 0.745
+    };
+
+    const auto [float_detections, quantized_detections] = RunBoth(classes, objects, 0.745f);
+    ASSERT_EQ(float_detections.size(), 2u);
+    ExpectSameDetections(float_detections, quantized_detections);
+
+    // A threshold no code reaches
+    const auto [float_none, quantized_none] = RunBoth(classes, objects, 0.999f);
+    EXPECT_TRUE(float_none.empty());
+    EXPECT_TRUE(quantized_none.empty());
+}
+
+// Host time per frame from the read to the decoded detections: FLOAT32 user
+// buffers versus the device's own UINT8 codes, on the same recording
+TEST_F(QuantizedRawYoloTest, ParseTimeFloatVsQuantized) {
+    model_.latency = std::chrono::milliseconds(0);
+    model_.frames_per_second = 0.0;
+
+    const RawClassCodes classes{TensorDataType::kUint8, QuantInfo{1.0f / 255.0f, 0.0f}, 0};
+    const std::vector<RawObject> objects = {
+        {30, 40, 1, 230},
+        {80, 20, 0, 200},
+        {100, 100, 0, 180},
+    };
+
+    ModelSpec spec;
+    spec.task = "pose";
+    spec.num_keypoints = kRawKeypoints;
+    spec.labels = {"a", "b"};
+
+    constexpr int kFrames = 40;
+    const std::vector<uint8_t> rgb(kRawModelSize * kRawModelSize * 3, 128);
+    const auto frame = FrameView::Rgb(rgb.data(), kRawModelSize, kRawModelSize);
+    double mean_us[2] = {0.0, 0.0};
+
+    for (bool float_outputs : {true, false}) {
+        recording_ = MakeRawYoloRecording(classes, objects, float_outputs);
+        auto inference = Create(float_outputs ? "simulated_parse_float.hef"
+                                              : "simulated_parse_uint8.hef");
+        ASSERT_NE(inference, nullptr);
+        const InferenceRequest request{inference->GetContext(spec), 0.5f};
+
+        for (int i = 0; i < kFrames; ++i) {
+            EXPECT_EQ(inference->RunInference(frame, request).size(), objects.size());
+        }
+        const StageTiming timing = inference->GetInferenceTiming();
+        EXPECT_EQ(timing.count, static_cast<uint64_t>(kFrames));
+        mean_us[float_outputs ? 0 : 1] = timing.mean_us;
+
+        std::cout << "[ " << (float_outputs ? "float32" : "uint8") << " ] "
+                  << static_cast<int>(timing.mean_us) << " us/frame (p95 " << timing.p95_us
+                  << " us)" << std::endl;
+    }
+
+    // A quarter of the bytes and an integer compare per score
+    EXPECT_LT(mean_us[1], mean_us[0]);
+}
+
+}  // namespace testing
+}  // namespace stream_daemon
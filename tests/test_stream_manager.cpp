@@ -148,6 +148,32 @@ TEST_F(StreamManagerIntegrationTest, DISABLED_MaxStreamsLimit) {
     }
 }
 
+TEST_F(StreamManagerIntegrationTest, DISABLED_SameUrlSharesDecode) {
+    // Disabled by default as it requires actual RTSP source
+    manager_->Start();
+
+    StreamInfo det;
+    det.stream_id = "cam_det";
+    det.rtsp_url = "rtsp://localhost:8554/test";
+
+    StreamInfo pose = det;
+    pose.stream_id = "cam_pose";
+
+    if (IsError(manager_->AddStream(det)) || IsError(manager_->AddStream(pose))) {
+        GTEST_SKIP() << "Failed to add streams";
+    }
+
+    auto status = manager_->GetStreamStatus("cam_pose");
+    ASSERT_TRUE(status.has_value());
+    EXPECT_EQ(status->shared_source_id, "cam_det");
+
+    // Removing the source hands the pipeline over to the subscriber
+    EXPECT_TRUE(IsOk(manager_->RemoveStream("cam_det")));
+    status = manager_->GetStreamStatus("cam_pose");
+    ASSERT_TRUE(status.has_value());
+    EXPECT_TRUE(status->shared_source_id.empty());
+}
+
 // Callback tests
 TEST_F(StreamManagerBasicTest, GlobalCallbacksAreSet) {
     bool detection_called = false;
@@ -0,0 +1,202 @@
+#include <gtest/gtest.h>
+
+#include "teardown_executor.h"
+
+#include <atomic>
+#include <memory>
+#include <thread>
+
+namespace stream_daemon {
+namespace testing {
+
+using namespace std::chrono_literals;
+
+namespace {
+
+template <typename Pred>
+bool WaitFor(Pred pred, std::chrono::milliseconds timeout = 2000ms) {
+    const auto deadline = std::chrono::steady_clock::now() + timeout;
+    while (!pred()) {
+        if (std::chrono::steady_clock::now() > deadline) return false;
+        std::this_thread::sleep_for(1ms);
+    }
+    return true;
+}
+
+}  // namespace
+
+// ============================================================================
+// TeardownExecutor Tests
+// ============================================================================
+
+TEST(TeardownExecutorTest, SubmitFailsWhenNotRunning) {
+    TeardownExecutor executor(1, 100ms);
+    EXPECT_FALSE(executor.Submit("s1", [](std::chrono::milliseconds) {}));
+}
+
+TEST(TeardownExecutorTest, RunsJobsWithTimeout) {
+    TeardownExecutor executor(2, 250ms);
+    executor.Start();
+
+    std::atomic<int> runs{0};
+    std::atomic<int64_t> seen_timeout{0};
+    for (int i = 0; i < 5; ++i) {
+        ASSERT_TRUE(executor.Submit("s" + std::to_string(i),
+            [&](std::chrono::milliseconds timeout) {
+                seen_timeout = timeout.count();
+                ++runs;
+            }));
+    }
+
+    executor.Stop();  // drains queue
+    EXPECT_EQ(runs.load(), 5);
+    EXPECT_EQ(seen_timeout.load(), 250);
+    EXPECT_EQ(executor.GetStats().completed, 5u);
+    EXPECT_EQ(executor.GetStats().pending, 0u);
+}
+
+TEST(TeardownExecutorTest, BoundedConcurrency) {
+    constexpr int kWorkers = 2;
+    TeardownExecutor executor(kWorkers, 1000ms);
+    executor.Start();
+
+    std::atomic<int> concurrent{0};
+    std::atomic<int> peak{0};
+    for (int i = 0; i < 16; ++i) {
+        ASSERT_TRUE(executor.Submit("flap", [&](std::chrono::milliseconds) {
+            int now = ++concurrent;
+            int prev = peak.load();
+            while (now > prev && !peak.compare_exchange_weak(prev, now)) {}
+            std::this_thread::sleep_for(5ms);
+            --concurrent;
+        }));
+    }
+
+    EXPECT_GT(executor.GetStats().peak_pending, 0u);
+    executor.Stop();
+    EXPECT_LE(peak.load(), kWorkers);
+    EXPECT_EQ(executor.GetStats().completed, 16u);
+}
+
+TEST(TeardownExecutorTest, CountsJobsOverTimeout) {
+    TeardownExecutor executor(1, 40ms);
+    executor.Start();
+
+    // Over the timeout but under the retire limit (twice the timeout)
+    ASSERT_TRUE(executor.Submit("slow", [](std::chrono::milliseconds) {
+        std::this_thread::sleep_for(50ms);
+    }));
+    ASSERT_TRUE(executor.Submit("fast", [](std::chrono::milliseconds) {}));
+
+    executor.Stop();
+    auto stats = executor.GetStats();
+    EXPECT_EQ(stats.completed, 2u);
+    EXPECT_EQ(stats.timed_out, 1u);
+    EXPECT_EQ(stats.abandoned, 0u);
+    EXPECT_GE(stats.max_duration_ms, 50);
+}
+
+TEST(TeardownExecutorTest, AbandonsWedgedJobAndFreesWorker) {
+    TeardownExecutor executor(1, 10ms);
+    executor.Start();
+
+    // Captured by value: the retired worker outlives this scope's checks
+    auto release = std::make_shared<std::atomic<bool>>(false);
+    ASSERT_TRUE(executor.Submit("wedged", [release](std::chrono::milliseconds) {
+        while (!release->load()) {
+            std::this_thread::sleep_for(1ms);
+        }
+    }));
+    std::atomic<bool> ran{false};
+    ASSERT_TRUE(executor.Submit("next", [&](std::chrono::milliseconds) { ran = true; }));
+
+    // The only worker gets past the wedged job
+    EXPECT_TRUE(WaitFor([&] { return ran.load(); }));
+    auto stats = executor.GetStats();
+    EXPECT_EQ(stats.abandoned, 1u);
+    EXPECT_EQ(stats.wedged, 1u);
+
+    release->store(true);
+    EXPECT_TRUE(WaitFor([&] { return executor.GetStats().wedged == 0; }));
+    executor.Stop();
+    EXPECT_EQ(executor.GetStats().completed, 1u);
+}
+
+TEST(TeardownExecutorTest, ParksJobsOnceWedgedCapIsReached) {
+    TeardownExecutor executor(1, 10ms, 8, 1);
+    executor.Start();
+
+    auto release = std::make_shared<std::atomic<bool>>(false);
+    auto wedge = [release](std::chrono::milliseconds) {
+        while (!release->load()) {
+            std::this_thread::sleep_for(1ms);
+        }
+    };
+    ASSERT_TRUE(executor.Submit("wedged1", wedge));
+    ASSERT_TRUE(executor.Submit("wedged2", wedge));
+    std::atomic<bool> ran{false};
+    ASSERT_TRUE(executor.Submit("next", [&](std::chrono::milliseconds) { ran = true; }));
+
+    // The first worker is replaced; the replacement wedges too and is not
+    ASSERT_TRUE(WaitFor([&] {
+        const auto stats = executor.GetStats();
+        return stats.abandoned == 1 && stats.active == 1;
+    }));
+    std::this_thread::sleep_for(100ms);
+    auto stats = executor.GetStats();
+    EXPECT_EQ(stats.abandoned, 1u);
+    EXPECT_EQ(stats.wedged, 1u);
+    EXPECT_EQ(stats.pending, 1u);
+    EXPECT_FALSE(ran.load());
+
+    release->store(true);
+    EXPECT_TRUE(WaitFor([&] { return ran.load(); }));
+    executor.Stop();
+    EXPECT_EQ(executor.GetStats().completed, 2u);  // wedged2 and next
+}
+
+TEST(TeardownExecutorTest, StopLetsWedgedWorkersGo) {
+    TeardownExecutor executor(1, 10ms, 8, 0);  // Never replaced while running
+    executor.Start();
+
+    auto release = std::make_shared<std::atomic<bool>>(false);
+    ASSERT_TRUE(executor.Submit("wedged", [release](std::chrono::milliseconds) {
+        while (!release->load()) {
+            std::this_thread::sleep_for(1ms);
+        }
+    }));
+    ASSERT_TRUE(WaitFor([&] { return executor.GetStats().active == 1; }));
+
+    const auto start = std::chrono::steady_clock::now();
+    executor.Stop();
+    EXPECT_LT(std::chrono::steady_clock::now() - start, 1000ms);
+    EXPECT_EQ(executor.GetStats().abandoned, 1u);
+    EXPECT_FALSE(executor.IsRunning());
+
+    release->store(true);
+}
+
+TEST(TeardownExecutorTest, RefusesWhenQueueFull) {
+    TeardownExecutor executor(1, 1000ms, 2);
+    executor.Start();
+
+    std::atomic<bool> release{false};
+    ASSERT_TRUE(executor.Submit("busy", [&](std::chrono::milliseconds) {
+        while (!release) {
+            std::this_thread::sleep_for(1ms);
+        }
+    }));
+    ASSERT_TRUE(WaitFor([&] { return executor.GetStats().active == 1; }));
+
+    EXPECT_TRUE(executor.Submit("q1", [](std::chrono::milliseconds) {}));
+    EXPECT_TRUE(executor.Submit("q2", [](std::chrono::milliseconds) {}));
+    EXPECT_FALSE(executor.Submit("q3", [](std::chrono::milliseconds) {}));
+    EXPECT_EQ(executor.GetStats().rejected, 1u);
+
+    release = true;
+    executor.Stop();
+    EXPECT_EQ(executor.GetStats().completed, 3u);
+}
+
+}  // namespace testing
+}  // namespace stream_daemon